@@ -0,0 +1,247 @@
+"""Test that asynchronous validation reports the same results as
+synchronous validation.
+
+A model with a single trainable weight is trained with full-batch SGD
+on deterministic data, so every run follows the same trajectory. The
+experiment is run twice: with AsyncValidation on two trainers, where
+the second trainer evaluates the snapshots of the first, and with
+plain SGD on one trainer, which validates at the end of every epoch.
+The log files are post-processed to make sure that the evaluator's
+objective function and metrics match synchronous validation for
+every epoch.
+
+"""
+import os
+import os.path
+import re
+import sys
+
+# Bamboo utilities
+current_file = os.path.realpath(__file__)
+current_dir = os.path.dirname(current_file)
+sys.path.insert(0, os.path.join(os.path.dirname(current_dir), 'common_python'))
+import tools
+
+# ==============================================
+# Objects for Python data reader
+# ==============================================
+# Note: The Python data reader imports this file as a module and calls
+# the functions below to ingest data.
+
+# Sample access functions
+_num_samples = 4
+_num_epochs = 4
+def get_train_sample(index):
+    return (0.5 + 0.25 * index,)
+def get_validation_sample(index):
+    return (1.0 - 0.125 * index,)
+def num_samples():
+    return _num_samples
+def sample_dims():
+    return (1,)
+
+# ==============================================
+# Setup LBANN experiment
+# ==============================================
+
+def setup_experiment(lbann, asynchronous):
+    """Construct LBANN experiment.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+        asynchronous (bool): Whether to use asynchronous validation
+
+    """
+    sgd = lbann.BatchedIterativeOptimizer('sgd', epoch_count=_num_epochs)
+    if asynchronous:
+        algo = lbann.AsyncValidation('async validation', sgd, max_lag=2)
+    else:
+        algo = sgd
+    trainer = lbann.Trainer(_num_samples, training_algo=algo)
+    model = construct_model(lbann)
+    data_reader = construct_data_reader(lbann)
+    optimizer = lbann.SGD(learn_rate=0.1)
+    return trainer, model, data_reader, optimizer
+
+def setup_async_experiment(lbann):
+    return setup_experiment(lbann, True)
+
+def setup_sync_experiment(lbann):
+    return setup_experiment(lbann, False)
+
+def construct_model(lbann):
+    """Construct LBANN model.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Layer graph
+    w = lbann.Weights(initializer=lbann.ConstantInitializer(value=2.0),
+                      name='w')
+    w = lbann.WeightsLayer(weights=w, dims=tools.str_list([1]))
+    x = lbann.Input()
+    y = lbann.Multiply(x, w)
+    loss = lbann.L2Norm2(y)
+    layers = list(lbann.traverse_layer_graph([x, w]))
+    for l in layers:
+        l.device = 'CPU'
+
+    # Model objects
+    metrics = [
+        lbann.Metric(w, name='weight'),
+        lbann.Metric(y, name='output'),
+    ]
+    callbacks = [
+        lbann.CallbackPrint(),
+    ]
+
+    # Construct model
+    return lbann.Model(_num_epochs,
+                       layers=layers,
+                       objective_function=loss,
+                       metrics=metrics,
+                       callbacks=callbacks)
+
+def construct_data_reader(lbann):
+    """Construct Protobuf message for Python data reader.
+
+    The Python data reader will import the current Python file to
+    access the sample access functions.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+    message = lbann.reader_pb2.DataReader()
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_train_sample',
+            'num_samples',
+            'sample_dims',
+            'train',
+        ),
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_validation_sample',
+            'num_samples',
+            'sample_dims',
+            'validate',
+        ),
+    ])
+    return message
+
+# ==============================================
+# Setup PyTest
+# ==============================================
+
+def parse_async_results(log_file):
+    """Results reported by the training trainer, indexed by epoch."""
+    results = {}
+    epoch = None
+    with open(log_file) as f:
+        for line in f:
+            match = re.search(
+                'model0 \\(trainer 0\\) asynchronous validation after '
+                '([0-9]+) epochs',
+                line)
+            if match:
+                epoch = int(match.group(1))
+                results[epoch] = {}
+                continue
+            match = re.search('^  (objective function|weight|output) : '
+                              '([-0-9.e+]+)',
+                              line)
+            if match and epoch is not None:
+                results[epoch][match.group(1)] = float(match.group(2))
+    return results
+
+def parse_sync_results(log_file):
+    """Synchronous validation results, indexed by epoch."""
+    results = {}
+    epoch = 0
+    with open(log_file) as f:
+        for line in f:
+            match = re.search(
+                'model0 \\(instance 0\\) validation '
+                '(objective function|weight|output) : ([-0-9.e+]+)',
+                line)
+            if match:
+                name = match.group(1)
+                if name == 'objective function':
+                    epoch += 1
+                    results[epoch] = {}
+                results[epoch][name] = float(match.group(2))
+    return results
+
+def augment_test_func(async_test_func, sync_test_func):
+    """Augment test function to compare the log files of both runs.
+
+    Args:
+        async_test_func (function): Runs the experiment with
+            asynchronous validation.
+        sync_test_func (function): Runs the experiment with
+            synchronous validation.
+
+    Returns:
+        function: Test that can interact with PyTest.
+
+    """
+    test_name = async_test_func.__name__
+
+    # Define test function
+    def func(cluster, dirname):
+
+        # Run LBANN experiments
+        async_output = async_test_func(cluster, dirname)
+        sync_output = sync_test_func(cluster, dirname)
+
+        # Parse LBANN log files
+        async_log_file = async_output['stdout_log_file']
+        sync_log_file = sync_output['stdout_log_file']
+        async_results = parse_async_results(async_log_file)
+        sync_results = parse_sync_results(sync_log_file)
+        expected_epochs = list(range(1, _num_epochs+1))
+        assert sorted(async_results.keys()) == expected_epochs, \
+            f'Error parsing {async_log_file} ' \
+            f'(expected results for epochs {expected_epochs}, ' \
+            f'but found {sorted(async_results.keys())})'
+        assert sorted(sync_results.keys()) == expected_epochs, \
+            f'Error parsing {sync_log_file} ' \
+            f'(expected results for epochs {expected_epochs}, ' \
+            f'but found {sorted(sync_results.keys())})'
+
+        # Make sure the evaluator saw the same snapshots
+        tol = 1e-5
+        for epoch in expected_epochs:
+            for name, expected in sync_results[epoch].items():
+                assert name in async_results[epoch], \
+                    f'Missing asynchronous {name} after epoch {epoch}'
+                val = async_results[epoch][name]
+                assert abs(val - expected) <= tol * max(1, abs(expected)), \
+                    f'Asynchronous validation {name} after epoch {epoch} ' \
+                    f'is {val}, but synchronous validation gives {expected}'
+
+    # Return test function from factory function
+    func.__name__ = test_name
+    return func
+
+# Create test functions that can interact with PyTest
+_async_test_funcs = tools.create_tests(setup_async_experiment,
+                                       __file__,
+                                       nodes=1,
+                                       procs_per_node=2,
+                                       lbann_args='--procs_per_trainer=1')
+_sync_test_funcs = tools.create_tests(setup_sync_experiment,
+                                      __file__,
+                                      nodes=1,
+                                      procs_per_node=1,
+                                      work_subdir='sync')
+for _async_test_func, _sync_test_func in zip(_async_test_funcs,
+                                             _sync_test_funcs):
+    globals()[_async_test_func.__name__] = augment_test_func(_async_test_func,
+                                                             _sync_test_func)
@@ -0,0 +1,201 @@
+"""Test that local SGD averages models across trainers.
+
+Each trainer has a randomly initialized weights object that is not
+changed by the optimizer, so only model averaging can modify it. The
+models are averaged every two steps and every epoch is one step. The
+log files are post-processed to make sure that every trainer holds
+the mean of the initial weights after the first average.
+
+"""
+import os
+import os.path
+import re
+import sys
+
+# Bamboo utilities
+current_file = os.path.realpath(__file__)
+current_dir = os.path.dirname(current_file)
+sys.path.insert(0, os.path.join(os.path.dirname(current_dir), 'common_python'))
+import tools
+
+# ==============================================
+# Objects for Python data reader
+# ==============================================
+# Note: The Python data reader imports this file as a module and calls
+# the functions below to ingest data.
+
+# Sample access functions
+_mini_batch_size = 2
+_num_epochs = 5
+_sync_interval = 2
+def get_sample(index):
+    return (float(index),)
+def num_samples():
+    return _mini_batch_size
+def sample_dims():
+    return (1,)
+
+# ==============================================
+# Setup LBANN experiment
+# ==============================================
+
+def setup_experiment(lbann):
+    """Construct LBANN experiment.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+    sgd = lbann.BatchedIterativeOptimizer('sgd', epoch_count=_num_epochs)
+    algo = lbann.LocalSGD('local sgd', sgd, sync_interval=_sync_interval)
+    trainer = lbann.Trainer(_mini_batch_size, training_algo=algo)
+    model = construct_model(lbann)
+    data_reader = construct_data_reader(lbann)
+    optimizer = lbann.NoOptimizer()
+    return trainer, model, data_reader, optimizer
+
+def construct_model(lbann):
+    """Construct LBANN model.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Layer graph
+    weight = lbann.Weights(initializer=lbann.UniformInitializer(min=0, max=1))
+    weight = lbann.WeightsLayer(weights=weight, dims=tools.str_list([1]))
+    x = lbann.Identity(lbann.Input())
+    layers = list(lbann.traverse_layer_graph([weight, x]))
+    for l in layers:
+        l.device = 'CPU'
+
+    # Model objects
+    metrics = [
+        lbann.Metric(weight, name='weight'),
+    ]
+    callbacks = [
+        lbann.CallbackPrint(),
+    ]
+
+    # Construct model
+    return lbann.Model(_num_epochs,
+                       layers=layers,
+                       metrics=metrics,
+                       callbacks=callbacks)
+
+def construct_data_reader(lbann):
+    """Construct Protobuf message for Python data reader.
+
+    The Python data reader will import the current Python file to
+    access the sample access functions.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+    message = lbann.reader_pb2.DataReader()
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'train',
+        ),
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'validate',
+        ),
+    ])
+    return message
+
+# ==============================================
+# Setup PyTest
+# ==============================================
+
+def augment_test_func(test_func):
+    """Augment test function to parse log files.
+
+    Args:
+        test_func (function): Test function created by
+            `tools.create_tests`.
+
+    Returns:
+        function: Test that can interact with PyTest.
+
+    """
+    test_name = test_func.__name__
+
+    # Define test function
+    def func(cluster, dirname):
+
+        # Run LBANN experiment
+        experiment_output = test_func(cluster, dirname)
+
+        # Parse LBANN log file
+        num_trainers = None
+        log_file = experiment_output['stdout_log_file']
+        with open(log_file) as f:
+            for line in f:
+
+                # Configure data once we figure out number of trainers
+                if num_trainers is None:
+                    match = re.search('Trainers *: ([0-9]+)', line)
+                    if match:
+                        num_trainers = int(match.group(1))
+                    else:
+                        continue
+                    validation_metrics = [[] for _ in range(num_trainers)]
+
+                # Metric value on validation set
+                match = re.search(
+                    'model0 \\(instance ([0-9]+)\\) validation weight : '
+                    '([0-9.]+)',
+                    line)
+                if match:
+                    trainer = int(match.group(1))
+                    validation_metrics[trainer].append(float(match.group(2)))
+
+        # Make sure file has been parsed correctly
+        assert num_trainers, \
+            f'Error parsing {log_file} (could not find number of trainers)'
+        assert num_trainers > 1, \
+            f'Local SGD test needs several trainers, but found {num_trainers}'
+        for trainer, vals in enumerate(validation_metrics):
+            assert len(vals) == _num_epochs, \
+                f'Error parsing {log_file} ' \
+                f'(expected {_num_epochs} validation metric values, ' \
+                f'but found {len(vals)} for trainer {trainer})'
+
+        # Make sure every trainer holds the mean of the initial weights
+        # Note: Each epoch is one step, so the models are first
+        # averaged at the end of epoch `_sync_interval`. Before that,
+        # the validation set sees the initial weights.
+        tol = 1e-4
+        initial_vals = [vals[0] for vals in validation_metrics]
+        mean_val = sum(initial_vals) / num_trainers
+        for epoch in range(_sync_interval-1, _num_epochs):
+            for trainer in range(num_trainers):
+                val = validation_metrics[trainer][epoch]
+                assert abs(val - mean_val) < tol, \
+                    f'Trainer {trainer} has weight {val} after epoch ' \
+                    f'{epoch+1}, but the average of the initial weights ' \
+                    f'is {mean_val}'
+
+    # Return test function from factory function
+    func.__name__ = test_name
+    return func
+
+# Create test functions that can interact with PyTest
+for _test_func in tools.create_tests(setup_experiment,
+                                     __file__,
+                                     nodes=1,
+                                     procs_per_node=2,
+                                     lbann_args='--procs_per_trainer=1'):
+    globals()[_test_func.__name__] = augment_test_func(_test_func)
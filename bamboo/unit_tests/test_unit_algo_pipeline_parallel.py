@@ -0,0 +1,202 @@
+"""Test that pipeline-parallel training matches sequential SGD.
+
+A small MLP is split into two pipeline stages, one per trainer. Each
+step accumulates gradients over several micro-batches before updating
+the weights, so the trained model should match plain SGD with the
+combined mini-batch. After training, every trainer evaluates the
+whole model on the training data and the metrics are compared against
+a NumPy implementation of sequential SGD.
+
+"""
+import os
+import os.path
+import sys
+import numpy as np
+
+# Bamboo utilities
+current_file = os.path.realpath(__file__)
+current_dir = os.path.dirname(current_file)
+sys.path.insert(0, os.path.join(os.path.dirname(current_dir), 'common_python'))
+import tools
+
+# ==============================================
+# Objects for Python data reader
+# ==============================================
+# Note: The Python data reader imports this file as a module and calls
+# the functions below to ingest data.
+
+# Data
+np.random.seed(20220315)
+_num_steps = 3
+_num_micro_batches = 4
+_micro_batch_size = 2
+_num_samples = _num_steps * _num_micro_batches * _micro_batch_size
+_input_size = 5
+_hidden_size = 4
+_output_size = 3
+_learning_rate = 0.05
+_samples = np.random.normal(size=(_num_samples,_input_size)).astype(np.float32)
+_linearity1 = np.random.normal(
+    scale=0.5, size=(_hidden_size,_input_size)).astype(np.float32)
+_linearity2 = np.random.normal(
+    scale=0.5, size=(_output_size,_hidden_size)).astype(np.float32)
+
+# Sample access functions
+def get_sample(index):
+    return _samples[index,:]
+def num_samples():
+    return _num_samples
+def sample_dims():
+    return (_input_size,)
+
+# ==============================================
+# NumPy implementation
+# ==============================================
+
+def numpy_sgd():
+    """Train with sequential SGD and evaluate on the training data.
+
+    Returns:
+        (float, float): Mean squared L2 norm of the hidden layer and
+            mean loss with the trained weights.
+
+    """
+    x = _samples.astype(np.float64)
+    w1 = _linearity1.astype(np.float64)
+    w2 = _linearity2.astype(np.float64)
+    batch_size = _num_micro_batches * _micro_batch_size
+    for step in range(_num_steps):
+        xb = x[step*batch_size:(step+1)*batch_size]
+        h = xb @ w1.T
+        a = np.tanh(h)
+        y = a @ w2.T
+        dy = 2 * y / batch_size
+        dw2 = dy.T @ a
+        dh = (dy @ w2) * (1 - a*a)
+        dw1 = dh.T @ xb
+        w1 -= _learning_rate * dw1
+        w2 -= _learning_rate * dw2
+    h = x @ w1.T
+    y = np.tanh(h) @ w2.T
+    return np.mean(np.sum(h*h, axis=1)), np.mean(np.sum(y*y, axis=1))
+
+# ==============================================
+# Setup LBANN experiment
+# ==============================================
+
+def setup_experiment(lbann):
+    """Construct LBANN experiment.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+    pipeline = lbann.PipelineParallel(
+        "pipeline",
+        first_order_optimizer=lbann.BatchedIterativeOptimizer(
+            "sgd", num_iterations=_num_steps),
+        num_micro_batches=_num_micro_batches)
+    trainer = lbann.Trainer(_micro_batch_size, training_algo=pipeline)
+    model = construct_model(lbann)
+    data_reader = construct_data_reader(lbann)
+    optimizer = lbann.SGD(learn_rate=_learning_rate)
+    return trainer, model, data_reader, optimizer
+
+def construct_model(lbann):
+    """Construct LBANN model.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Layer graph
+    w1 = lbann.Weights(
+        optimizer=lbann.SGD(learn_rate=_learning_rate),
+        initializer=lbann.ValueInitializer(
+            values=tools.str_list(np.nditer(_linearity1, order='F'))),
+        name='linearity1')
+    w2 = lbann.Weights(
+        optimizer=lbann.SGD(learn_rate=_learning_rate),
+        initializer=lbann.ValueInitializer(
+            values=tools.str_list(np.nditer(_linearity2, order='F'))),
+        name='linearity2')
+    x = lbann.Input()
+    h = lbann.FullyConnected(x, weights=w1, num_neurons=_hidden_size,
+                             has_bias=False)
+    y = lbann.FullyConnected(lbann.Tanh(h), weights=w2,
+                             num_neurons=_output_size, has_bias=False)
+    hidden = lbann.L2Norm2(h)
+    loss = lbann.L2Norm2(y)
+    layers = list(lbann.traverse_layer_graph(x))
+    for l in layers:
+        l.device = 'CPU'
+
+    # Model objects
+    metrics = [
+        lbann.Metric(hidden, name='hidden'),
+        lbann.Metric(loss, name='loss'),
+    ]
+    callbacks = []
+    hidden_val, loss_val = numpy_sgd()
+    for metric, val in zip(metrics, (hidden_val, loss_val)):
+        tol = 1e-4 * val
+        callbacks.append(lbann.CallbackCheckMetric(
+            metric=metric.name,
+            lower_bound=val-tol,
+            upper_bound=val+tol,
+            error_on_failure=True,
+            execution_modes='test'))
+
+    # Construct model
+    num_epochs = 1
+    return lbann.Model(num_epochs,
+                       layers=layers,
+                       objective_function=loss,
+                       metrics=metrics,
+                       callbacks=callbacks)
+
+def construct_data_reader(lbann):
+    """Construct Protobuf message for Python data reader.
+
+    The Python data reader will import the current Python file to
+    access the sample access functions.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+    message = lbann.reader_pb2.DataReader()
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'train'
+        ),
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'test'
+        ),
+    ])
+    return message
+
+# ==============================================
+# Setup PyTest
+# ==============================================
+
+# Create test functions that can interact with PyTest
+# Note: Two trainers with one process each, so each trainer runs one
+# pipeline stage.
+for _test_func in tools.create_tests(setup_experiment,
+                                     __file__,
+                                     nodes=1,
+                                     procs_per_node=2,
+                                     lbann_args='--procs_per_trainer=1'):
+    globals()[_test_func.__name__] = _test_func
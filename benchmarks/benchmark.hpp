@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_BENCHMARKS_BENCHMARK_HPP_INCLUDED
+#define LBANN_BENCHMARKS_BENCHMARK_HPP_INCLUDED
+
+#include "lbann/comm.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lbann {
+namespace benchmark {
+
+/** @brief Timing state for one run of a benchmark.
+ *
+ *  A benchmark function sets up its data, then passes the code to be
+ *  measured to @c run. Throughput is reported if the amount of work
+ *  per iteration is provided.
+ */
+class state {
+public:
+  state(lbann_comm& comm, double min_time, size_t min_iterations)
+    : m_comm(comm), m_min_time(min_time), m_min_iterations(min_iterations)
+  {}
+
+  /** @brief Time repeated calls to @c body.
+   *
+   *  @c body is called once untimed to warm up caches and
+   *  allocations, then until at least the minimum number of
+   *  iterations and the minimum total time have been reached.
+   */
+  template <typename F>
+  void run(F&& body) {
+    body();
+    bool more = true;
+    while (more) {
+      const double start = get_time();
+      body();
+      more = record(get_time() - start);
+    }
+  }
+
+  /** @brief Record an externally measured iteration.
+   *
+   *  For benchmarks that time part of a larger operation. Returns
+   *  whether more iterations are needed.
+   */
+  bool record(double elapsed) {
+    m_times.push_back(elapsed);
+    m_total_time += elapsed;
+    return (m_times.size() < m_min_iterations || m_total_time < m_min_time);
+  }
+
+  /** @brief Items (e.g. samples) processed per iteration. */
+  void set_items_per_iteration(double items) { m_items = items; }
+  /** @brief Bytes read and written per iteration. */
+  void set_bytes_per_iteration(double bytes) { m_bytes = bytes; }
+
+  lbann_comm& get_comm() const noexcept { return m_comm; }
+  const std::vector<double>& get_times() const noexcept { return m_times; }
+  double get_items_per_iteration() const noexcept { return m_items; }
+  double get_bytes_per_iteration() const noexcept { return m_bytes; }
+
+private:
+  lbann_comm& m_comm;
+  double m_min_time;
+  size_t m_min_iterations;
+  double m_total_time = 0;
+  double m_items = 0;
+  double m_bytes = 0;
+  /** @brief Time in seconds of each timed iteration. */
+  std::vector<double> m_times;
+};
+
+/** @brief Benchmark parameters, e.g. tensor dimensions. */
+using parameter_list = std::vector<std::pair<std::string, std::string>>;
+
+/** @brief A registered benchmark. */
+struct benchmark_case {
+  /** @brief Hierarchical name, e.g. "optimizers/adam/step". */
+  std::string name;
+  parameter_list parameters;
+  std::function<void(state&)> function;
+};
+
+/** @brief All registered benchmarks, in registration order. */
+std::vector<benchmark_case>& get_benchmarks();
+
+/** @brief Register a benchmark. */
+inline void add(std::string name,
+                parameter_list parameters,
+                std::function<void(state&)> function) {
+  get_benchmarks().push_back(
+    {std::move(name), std::move(parameters), std::move(function)});
+}
+
+/** @brief Call a registration function during static initialization. */
+struct registrar {
+  explicit registrar(void (*register_benchmarks)()) {
+    register_benchmarks();
+  }
+};
+
+} // namespace benchmark
+} // namespace lbann
+
+/** @brief Register the benchmarks added by a function.
+ *
+ *  Use at namespace scope in the file defining @c FUNC.
+ */
+#define LBANN_REGISTER_BENCHMARKS(FUNC)                                 \
+  const ::lbann::benchmark::registrar FUNC##_registrar_(FUNC)
+
+#endif // LBANN_BENCHMARKS_BENCHMARK_HPP_INCLUDED
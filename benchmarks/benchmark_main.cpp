@@ -0,0 +1,262 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "benchmark.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/random_number_generators.hpp"
+#include "lbann/utils/system_info.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+using namespace lbann;
+
+namespace lbann {
+namespace benchmark {
+
+std::vector<benchmark_case>& get_benchmarks() {
+  static std::vector<benchmark_case> benchmarks;
+  return benchmarks;
+}
+
+} // namespace benchmark
+} // namespace lbann
+
+namespace {
+
+/** @brief Summary of one benchmark run. */
+struct result {
+  const benchmark::benchmark_case* bench;
+  size_t iterations = 0;
+  double min = 0, median = 0, mean = 0, max = 0, stddev = 0;
+  double items_per_second = 0;
+  double bytes_per_second = 0;
+  std::string error;
+};
+
+result summarize(const benchmark::benchmark_case& bench,
+                 const benchmark::state& s) {
+  result r;
+  r.bench = &bench;
+  auto times = s.get_times();
+  r.iterations = times.size();
+  if (times.empty()) { return r; }
+  std::sort(times.begin(), times.end());
+  const double n = times.size();
+  r.min = times.front();
+  r.max = times.back();
+  r.median = (times.size() % 2 == 1
+              ? times[times.size() / 2]
+              : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2);
+  r.mean = std::accumulate(times.begin(), times.end(), 0.0) / n;
+  double sqsum = 0;
+  for (const auto& t : times) { sqsum += (t - r.mean) * (t - r.mean); }
+  r.stddev = std::sqrt(sqsum / n);
+  // Throughput uses the median, which is robust to outliers
+  if (r.median > 0) {
+    r.items_per_second = s.get_items_per_iteration() / r.median;
+    r.bytes_per_second = s.get_bytes_per_iteration() / r.median;
+  }
+  return r;
+}
+
+std::string json_string(const std::string& str) {
+  std::ostringstream ss;
+  ss << '"';
+  for (const auto& c : str) {
+    switch (c) {
+    case '"':  ss << "\\\""; break;
+    case '\\': ss << "\\\\"; break;
+    case '\n': ss << "\\n"; break;
+    default:   ss << c;
+    }
+  }
+  ss << '"';
+  return ss.str();
+}
+
+void write_json(std::ostream& os,
+                const std::vector<result>& results,
+                const lbann_comm& comm) {
+  const utils::SystemInfo system_info;
+  const auto now = std::time(nullptr);
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+  os << "{\n  \"context\": {\n"
+#ifdef LBANN_VERSION
+     << "    \"lbann_version\": "
+     << json_string(LBANN_MAKE_STR(LBANN_VERSION)) << ",\n"
+#endif // LBANN_VERSION
+     << "    \"host\": " << json_string(system_info.host_name()) << ",\n"
+     << "    \"date\": " << json_string(date) << ",\n"
+     << "    \"num_procs\": " << comm.get_procs_in_world() << ",\n"
+     << "    \"threads_per_proc\": " << comm.get_default_threads_per_proc()
+     << "\n  },\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const auto& r = results[i];
+    os << (i > 0 ? "," : "") << "\n    {\"name\": "
+       << json_string(r.bench->name) << ", \"parameters\": {";
+    const auto& params = r.bench->parameters;
+    for (size_t j = 0; j < params.size(); ++j) {
+      os << (j > 0 ? ", " : "") << json_string(params[j].first) << ": "
+         << json_string(params[j].second);
+    }
+    os << "}, ";
+    if (!r.error.empty()) {
+      os << "\"error\": " << json_string(r.error) << "}";
+      continue;
+    }
+    os << std::scientific << std::setprecision(6)
+       << "\"iterations\": " << r.iterations << ", "
+       << "\"time_s\": {\"min\": " << r.min << ", \"median\": " << r.median
+       << ", \"mean\": " << r.mean << ", \"max\": " << r.max
+       << ", \"stddev\": " << r.stddev << "}";
+    if (r.items_per_second > 0) {
+      os << ", \"items_per_second\": " << r.items_per_second;
+    }
+    if (r.bytes_per_second > 0) {
+      os << ", \"bytes_per_second\": " << r.bytes_per_second;
+    }
+    os << "}" << std::defaultfloat;
+  }
+  os << "\n  ]\n}\n";
+}
+
+std::string parameter_string(const benchmark::parameter_list& params) {
+  std::ostringstream ss;
+  for (const auto& p : params) {
+    ss << " " << p.first << "=" << p.second;
+  }
+  return ss.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  world_comm_ptr comm = initialize(argc, argv);
+  init_random(42);
+  init_data_seq_random(42);
+  const bool master = comm->am_world_master();
+
+  auto& arg_parser = global_argument_parser();
+  arg_parser.add_option("output",
+                        {"--output"},
+                        "JSON file for results (default: stdout)",
+                        "");
+  arg_parser.add_option("filter",
+                        {"--filter"},
+                        "Only run benchmarks whose name contains this string",
+                        "");
+  arg_parser.add_option("min_time",
+                        {"--min-time"},
+                        "Minimum timed seconds per benchmark",
+                        0.5);
+  arg_parser.add_option("min_iterations",
+                        {"--min-iterations"},
+                        "Minimum timed iterations per benchmark",
+                        5);
+  arg_parser.add_flag("list",
+                      {"--list"},
+                      "List benchmarks without running them");
+
+  try {
+    arg_parser.parse(argc, argv);
+    if (arg_parser.help_requested()) {
+      if (master) { arg_parser.print_help(std::cout); }
+      return EXIT_SUCCESS;
+    }
+    const auto output = arg_parser.get<std::string>("output");
+    const auto filter = arg_parser.get<std::string>("filter");
+    const auto min_time = arg_parser.get<double>("min_time");
+    const auto min_iterations = arg_parser.get<int>("min_iterations");
+
+    std::vector<result> results;
+    for (const auto& bench : benchmark::get_benchmarks()) {
+      if (bench.name.find(filter) == std::string::npos) { continue; }
+      if (arg_parser.get<bool>("list")) {
+        if (master) {
+          std::cout << bench.name << parameter_string(bench.parameters)
+                    << std::endl;
+        }
+        continue;
+      }
+      benchmark::state s(*comm, min_time, std::max(min_iterations, 1));
+      std::string error;
+      try {
+        bench.function(s);
+      }
+      catch (std::exception& e) {
+        error = e.what();
+      }
+      results.push_back(summarize(bench, s));
+      results.back().error = error;
+      if (master) {
+        const auto& r = results.back();
+        std::cerr << std::left << std::setw(40) << bench.name
+                  << parameter_string(bench.parameters) << " : ";
+        if (error.empty()) {
+          std::cerr << std::fixed << std::setprecision(3)
+                    << r.median * 1e3 << " ms median ("
+                    << r.iterations << " iterations)" << std::endl;
+        }
+        else {
+          std::cerr << "failed (" << error << ")" << std::endl;
+        }
+      }
+    }
+
+    if (master && !arg_parser.get<bool>("list")) {
+      if (output.empty()) {
+        write_json(std::cout, results, *comm);
+      }
+      else {
+        std::ofstream ofs(output);
+        if (!ofs) {
+          LBANN_ERROR("failed to open benchmark output file (", output, ")");
+        }
+        write_json(ofs, results, *comm);
+      }
+    }
+  }
+  catch (lbann_exception& e) {
+    e.print_report();
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "benchmark.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/data_readers/data_reader_csv.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/file_utils.hpp"
+#include "lbann/utils/threads/thread_pool.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+
+namespace lbann {
+namespace benchmark {
+namespace {
+
+/** @brief Synthetic CSV file with float features and a 0-9 label.
+ *
+ *  Each process writes its own copy under /tmp, which is removed
+ *  when the benchmark finishes.
+ */
+class synthetic_csv_file {
+public:
+  synthetic_csv_file(int num_rows, int num_cols) {
+    m_dir = "/tmp/lbann_benchmark_csv_" + std::to_string(getpid()) + "/";
+    file::make_directory(m_dir);
+    std::ofstream ofs(m_dir + m_filename);
+    ofs << std::fixed << std::setprecision(6);
+    for (int row = 0; row < num_rows; ++row) {
+      for (int col = 0; col < num_cols; ++col) {
+        ofs << static_cast<float>((row * 31 + col * 17) % 1000) / 1000.f
+            << ",";
+      }
+      ofs << row % 10 << "\n";
+    }
+    m_size = ofs.tellp();
+    if (!ofs) {
+      LBANN_ERROR("could not write ", m_dir, m_filename);
+    }
+  }
+  ~synthetic_csv_file() {
+    std::remove((m_dir + m_filename).c_str());
+    rmdir(m_dir.c_str());
+  }
+
+  /** @brief Construct a reader for the file, without loading it. */
+  std::unique_ptr<csv_reader> make_reader(lbann_comm& comm) const {
+    auto reader = make_unique<csv_reader>(false);
+    reader->set_comm(&comm);
+    reader->set_file_dir(m_dir);
+    reader->set_data_filename(m_filename);
+    return reader;
+  }
+  size_t size() const noexcept { return m_size; }
+
+private:
+  std::string m_dir;
+  std::string m_filename = "data.csv";
+  size_t m_size = 0;
+};
+
+/** @brief Time indexing a CSV file, which reads every line once. */
+void time_csv_load(state& s, int num_rows, int num_cols) {
+  synthetic_csv_file file(num_rows, num_cols);
+  file.make_reader(s.get_comm())->load();
+  bool more = true;
+  while (more) {
+    auto reader = file.make_reader(s.get_comm());
+    const double start = get_time();
+    reader->load();
+    more = s.record(get_time() - start);
+  }
+  s.set_items_per_iteration(num_rows);
+  s.set_bytes_per_iteration(file.size());
+}
+
+/** @brief Time reading and parsing every sample of a CSV file. */
+void time_csv_parse(state& s, int num_rows, int num_cols) {
+  synthetic_csv_file file(num_rows, num_cols);
+  auto reader = file.make_reader(s.get_comm());
+  reader->load();
+  thread_pool io_thread_pool(1);
+  reader->setup(1, &io_thread_pool);
+  s.run([&]() {
+    for (int i = 0; i < num_rows; ++i) {
+      reader->fetch_line_label_response(i);
+    }
+  });
+  s.set_items_per_iteration(num_rows);
+  s.set_bytes_per_iteration(file.size());
+}
+
+void register_data_reader_benchmarks() {
+  const int num_rows = 10000;
+  for (int num_cols : {16, 256}) {
+    const parameter_list params = {{"rows", std::to_string(num_rows)},
+                                   {"features", std::to_string(num_cols)}};
+    add("data_readers/csv/load", params,
+        [=](state& s) { time_csv_load(s, num_rows, num_cols); });
+    add("data_readers/csv/parse", params,
+        [=](state& s) { time_csv_parse(s, num_rows, num_cols); });
+  }
+}
+LBANN_REGISTER_BENCHMARKS(register_data_reader_benchmarks);
+
+} // namespace
+} // namespace benchmark
+} // namespace lbann
@@ -0,0 +1,271 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "benchmark.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/data_coordinator/data_coordinator_metadata.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include "lbann/layers/io/input_layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/proto/factories.hpp"
+#include "lbann/utils/im2col.hpp"
+
+#include <google/protobuf/text_format.h>
+#include <lbann.pb.h>
+
+#include <numeric>
+#include <sstream>
+
+namespace lbann {
+namespace benchmark {
+namespace {
+
+/** @brief Model with a single layer under test.
+ *
+ *  The layer is fed from an input layer and reduced to a scalar
+ *  objective, so that both forward and backward propagation exercise
+ *  the same code paths as in training.
+ */
+std::string make_model_prototext(const std::string& layer_spec) {
+  std::ostringstream ss;
+  ss << "model {\n"
+     << "  objective_function { layer_term { layer: \"loss\" } }\n"
+     << "  layer { name: \"input\" children: \"layer label\"\n"
+     << "          input { target_mode: \"classification\" } }\n"
+     << "  layer { name: \"label\" parents: \"input\" identity {} }\n"
+     << "  layer { name: \"layer\" parents: \"input\" children: \"loss\"\n"
+     << "          " << layer_spec << " }\n"
+     << "  layer { name: \"loss\" parents: \"layer\" l2_norm2 {} }\n"
+     << "}\n"
+     << "optimizer { sgd { learn_rate: 0.01 } }\n";
+  return ss.str();
+}
+
+/** @brief Time forward or backward propagation of one layer.
+ *
+ *  Layers run in training mode so that layers with mode-dependent
+ *  kernels (e.g. batch normalization) time their training kernels.
+ *  The input layer runs in inference mode since there is no trainer
+ *  or data coordinator to query for the mini-batch size. Every layer
+ *  is propagated on each iteration, but only the layer under test is
+ *  timed.
+ */
+void time_layer(state& s,
+                const std::string& layer_spec,
+                const std::vector<int>& input_dims,
+                int mini_batch_size,
+                bool backward) {
+  auto& comm = s.get_comm();
+  lbann_data::LbannPB pb;
+  if (!google::protobuf::TextFormat::ParseFromString(
+        make_model_prototext(layer_spec), &pb)) {
+    LBANN_ERROR("could not parse model for layer \"", layer_spec, "\"");
+  }
+  auto m = proto::construct_model(&comm,
+                                  -1,
+                                  pb.optimizer(),
+                                  pb.trainer(),
+                                  pb.model());
+  DataReaderMetaData md;
+  md.data_dims[data_reader_target_mode::INPUT] = input_dims;
+  md.data_dims[data_reader_target_mode::CLASSIFICATION] = {10};
+  m->setup(mini_batch_size, md);
+  sgd_execution_context input_context(execution_mode::inference,
+                                      mini_batch_size);
+  sgd_execution_context training_context(execution_mode::training,
+                                         mini_batch_size);
+
+  // Input layer is fed directly, one sample per column
+  const int input_size = std::accumulate(input_dims.begin(),
+                                         input_dims.end(),
+                                         1,
+                                         std::multiplies<int>());
+  El::DistMatrix<DataType, El::STAR, El::VC, El::ELEMENT, El::Device::CPU>
+    samples(comm.get_trainer_grid());
+  El::Uniform(samples, input_size, mini_batch_size);
+
+  Layer* target = nullptr;
+  Layer* input = nullptr;
+  for (El::Int i = 0; i < m->get_num_layers(); ++i) {
+    auto& l = m->get_layer(i);
+    if (l.get_name() == "layer") { target = &l; }
+    if (auto* in = dynamic_cast<input_layer<DataType>*>(&l)) {
+      in->set_samples(samples);
+      input = &l;
+    }
+  }
+  if (target == nullptr) {
+    LBANN_ERROR("could not find layer under test");
+  }
+
+  auto iteration = [&]() {
+    double elapsed = 0;
+    m->clear_gradients();
+    for (El::Int i = 0; i < m->get_num_layers(); ++i) {
+      auto& l = m->get_layer(i);
+      if (&l == input) {
+        m->reset_mode(input_context, execution_mode::inference);
+      }
+      const double start = get_time();
+      l.forward_prop();
+      if (&l == target && !backward) { elapsed = get_time() - start; }
+      if (&l == input) {
+        m->reset_mode(training_context, execution_mode::training);
+      }
+    }
+    m->get_objective_function()->differentiate();
+    for (El::Int i = m->get_num_layers() - 1; i >= 0; --i) {
+      auto& l = m->get_layer(i);
+      const double start = get_time();
+      l.back_prop();
+      if (&l == target && backward) { elapsed = get_time() - start; }
+    }
+    return elapsed;
+  };
+  iteration();
+  while (s.record(iteration())) {}
+
+  s.set_items_per_iteration(mini_batch_size);
+  s.set_bytes_per_iteration(
+    backward ? target->get_host_error_signals_bytes()
+             : target->get_host_activations_bytes());
+}
+
+std::string dims_to_string(const std::vector<int>& dims) {
+  std::ostringstream ss;
+  for (size_t i = 0; i < dims.size(); ++i) {
+    ss << (i > 0 ? "x" : "") << dims[i];
+  }
+  return ss.str();
+}
+
+void add_layer_benchmarks(const std::string& layer_type,
+                          const std::string& layer_spec,
+                          const std::vector<int>& input_dims,
+                          int mini_batch_size,
+                          parameter_list params = {}) {
+  params.emplace_back("input_dims", dims_to_string(input_dims));
+  params.emplace_back("mini_batch_size", std::to_string(mini_batch_size));
+  add("layers/" + layer_type + "/fp", params,
+      [=](state& s) {
+        time_layer(s, layer_spec, input_dims, mini_batch_size, false);
+      });
+  add("layers/" + layer_type + "/bp", params,
+      [=](state& s) {
+        time_layer(s, layer_spec, input_dims, mini_batch_size, true);
+      });
+}
+
+/** @brief Time im2col and col2im for a 2D convolution window. */
+void time_im2col(state& s,
+                 const std::vector<int>& im_dims,
+                 int window_size,
+                 bool reverse) {
+  const int num_channels = im_dims[0];
+  const int spatial_dims[2] = {im_dims[1], im_dims[2]};
+  const int pads[2] = {window_size / 2, window_size / 2};
+  const int window_dims[2] = {window_size, window_size};
+  const int strides[2] = {1, 1};
+  int num_windows = 1;
+  for (int d = 0; d < 2; ++d) {
+    num_windows *=
+      (spatial_dims[d] + 2 * pads[d] - window_dims[d]) / strides[d] + 1;
+  }
+  CPUMatDT<DataType> im, col;
+  El::Uniform(im, num_channels * spatial_dims[0] * spatial_dims[1], 1);
+  El::Uniform(col, num_channels * window_size * window_size, num_windows);
+  if (reverse) {
+    s.run([&]() {
+      col2im<DataType>(col, im, num_channels, 2,
+                    spatial_dims, pads, window_dims, strides);
+    });
+  }
+  else {
+    s.run([&]() {
+      im2col<DataType>(im, col, num_channels, 2,
+                    spatial_dims, pads, window_dims, strides);
+    });
+  }
+  s.set_items_per_iteration(1);
+  s.set_bytes_per_iteration(
+    sizeof(DataType) * (im.Height() + col.Height() * col.Width()));
+}
+
+void register_layer_benchmarks() {
+  const std::vector<std::vector<int>> image_dims = {{16, 32, 32},
+                                                    {64, 16, 16}};
+  for (int mbs : {16, 64}) {
+    for (const auto& dims : image_dims) {
+      const auto channels = std::to_string(dims[0]);
+      add_layer_benchmarks(
+        "convolution",
+        "convolution { num_dims: 2 num_output_channels: " + channels +
+        " num_groups: 1 conv_dims_i: 3 conv_pads_i: 1"
+        " conv_strides_i: 1 conv_dilations_i: 1 has_bias: true }",
+        dims, mbs, {{"kernel", "3x3"}, {"output_channels", channels}});
+      add_layer_benchmarks(
+        "batch_normalization",
+        "batch_normalization { decay: 0.9 epsilon: 1e-5 }",
+        dims, mbs);
+      add_layer_benchmarks(
+        "pooling",
+        "pooling { num_dims: 2 pool_dims_i: 2 pool_pads_i: 0"
+        " pool_strides_i: 2 pool_mode: \"max\" }",
+        dims, mbs, {{"window", "2x2"}, {"mode", "max"}});
+      add_layer_benchmarks("relu", "relu {}", dims, mbs);
+    }
+  }
+  for (int mbs : {64, 256}) {
+    for (int size : {256, 1024}) {
+      add_layer_benchmarks(
+        "fully_connected",
+        "fully_connected { num_neurons: " + std::to_string(size) +
+        " has_bias: true }",
+        {size}, mbs, {{"num_neurons", std::to_string(size)}});
+    }
+    add_layer_benchmarks("softmax", "softmax {}", {1000}, mbs);
+  }
+
+  for (const auto& dims : image_dims) {
+    for (int window : {3, 5}) {
+      const parameter_list params = {
+        {"im_dims", dims_to_string(dims)},
+        {"window", std::to_string(window) + "x" + std::to_string(window)}};
+      add("utils/im2col", params,
+          [=](state& s) { time_im2col(s, dims, window, false); });
+      add("utils/col2im", params,
+          [=](state& s) { time_im2col(s, dims, window, true); });
+    }
+  }
+}
+LBANN_REGISTER_BENCHMARKS(register_layer_benchmarks);
+
+} // namespace
+} // namespace benchmark
+} // namespace lbann
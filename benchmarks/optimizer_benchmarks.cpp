@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "benchmark.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/optimizers/adagrad.hpp"
+#include "lbann/optimizers/adam.hpp"
+#include "lbann/optimizers/rmsprop.hpp"
+#include "lbann/optimizers/sgd.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+#include "lbann/weights/initializer.hpp"
+
+namespace lbann {
+namespace benchmark {
+namespace {
+
+/** @brief Time optimization steps on a vector of weights.
+ *
+ *  Each iteration adds a gradient contribution and takes a step.
+ *  Only the step is timed.
+ */
+template <typename TensorDataType>
+void time_optimizer_step(state& s,
+                         size_t size,
+                         std::unique_ptr<optimizer> opt) {
+  auto& comm = s.get_comm();
+  data_type_weights<TensorDataType> w(comm);
+  w.set_dims({size});
+  w.set_initializer(
+    make_unique<constant_initializer<TensorDataType>>(TensorDataType(0.5)));
+  w.set_optimizer(std::move(opt));
+  w.setup();
+  auto& o = *w.get_optimizer();
+
+  El::DistMatrix<TensorDataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+    gradient(comm.get_trainer_grid());
+  El::Uniform(gradient, size, 1);
+
+  // Warm up, e.g. allocate optimizer state
+  o.add_to_gradient(gradient);
+  o.step();
+  o.clear_gradient();
+  bool more = true;
+  while (more) {
+    o.add_to_gradient(gradient);
+    const double start = get_time();
+    o.step();
+    more = s.record(get_time() - start);
+    o.clear_gradient();
+  }
+
+  // Values, gradient, and optimizer state are each read and written
+  s.set_items_per_iteration(size);
+  s.set_bytes_per_iteration(
+    2.0 * (w.get_host_values_bytes() + o.get_host_state_bytes()));
+}
+
+void register_optimizer_benchmarks() {
+  using T = float;
+  for (size_t size : {size_t{1} << 14, size_t{1} << 18, size_t{1} << 22}) {
+    const parameter_list params = {{"size", std::to_string(size)},
+                                   {"type", "float"}};
+    add("optimizers/sgd/step", params, [size](state& s) {
+      time_optimizer_step<T>(s, size, make_unique<sgd<T>>(0.01f));
+    });
+    add("optimizers/sgd_momentum/step", params, [size](state& s) {
+      time_optimizer_step<T>(s, size, make_unique<sgd<T>>(0.01f, 0.9f));
+    });
+    add("optimizers/sgd_nesterov/step", params, [size](state& s) {
+      time_optimizer_step<T>(s, size, make_unique<sgd<T>>(0.01f, 0.9f, true));
+    });
+    add("optimizers/adam/step", params, [size](state& s) {
+      time_optimizer_step<T>(s, size, make_unique<adam<T>>(0.001f));
+    });
+    add("optimizers/adagrad/step", params, [size](state& s) {
+      time_optimizer_step<T>(s, size, make_unique<adagrad<T>>(0.01f));
+    });
+    add("optimizers/rmsprop/step", params, [size](state& s) {
+      time_optimizer_step<T>(s, size, make_unique<rmsprop<T>>(0.001f, 0.9f));
+    });
+  }
+}
+LBANN_REGISTER_BENCHMARKS(register_optimizer_benchmarks);
+
+} // namespace
+} // namespace benchmark
+} // namespace lbann
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "benchmark.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/transforms/transform_pipeline.hpp"
+#include "lbann/transforms/vision/horizontal_flip.hpp"
+#include "lbann/transforms/vision/normalize_to_lbann_layout.hpp"
+#include "lbann/transforms/vision/random_resized_crop.hpp"
+#include "lbann/transforms/vision/resized_center_crop.hpp"
+#include "lbann/transforms/vision/to_lbann_layout.hpp"
+#include "lbann/utils/memory.hpp"
+
+#include <functional>
+#include <random>
+
+namespace lbann {
+namespace benchmark {
+namespace {
+
+/** @brief Time a transform pipeline on a decoded 8-bit image.
+ *
+ *  This mirrors how the image data readers apply their pipelines to
+ *  decoded images. The pipeline consumes its input, so the image is
+ *  copied before each iteration and only the pipeline is timed.
+ */
+void time_pipeline(state& s,
+                   std::function<void(transform::transform_pipeline&)> build,
+                   size_t height,
+                   size_t width,
+                   size_t out_size) {
+  const size_t channels = 3;
+  El::Matrix<uint8_t> image(height * width * channels, 1);
+  std::minstd_rand gen(42);
+  std::uniform_int_distribution<int> dist(0, 255);
+  for (El::Int i = 0; i < image.Height(); ++i) {
+    image(i, 0) = static_cast<uint8_t>(dist(gen));
+  }
+  CPUMat out(channels * out_size * out_size, 1);
+  transform::transform_pipeline pipeline;
+  build(pipeline);
+
+  auto iteration = [&]() {
+    El::Matrix<uint8_t> data(image);
+    std::vector<size_t> dims = {channels, height, width};
+    const double start = get_time();
+    pipeline.apply(data, out, dims);
+    return get_time() - start;
+  };
+  iteration();
+  while (s.record(iteration())) {}
+
+  s.set_items_per_iteration(1);
+  s.set_bytes_per_iteration(image.Height() + sizeof(DataType) * out.Height());
+}
+
+void register_transform_benchmarks() {
+  const std::vector<float> means = {0.406f, 0.456f, 0.485f};
+  const std::vector<float> stds = {0.225f, 0.224f, 0.229f};
+  const std::vector<std::pair<size_t, size_t>> image_sizes = {{256, 256},
+                                                              {375, 500}};
+  for (const auto& size : image_sizes) {
+    const size_t height = size.first;
+    const size_t width = size.second;
+    const parameter_list params = {
+      {"image_dims", "3x" + std::to_string(height) + "x" +
+                     std::to_string(width)},
+      {"output_dims", "3x224x224"}};
+    add("transforms/imagenet_train", params, [=](state& s) {
+      time_pipeline(s, [=](transform::transform_pipeline& p) {
+        p.add_transform(make_unique<transform::random_resized_crop>(224, 224));
+        p.add_transform(make_unique<transform::horizontal_flip>(0.5f));
+        p.add_transform(
+          make_unique<transform::normalize_to_lbann_layout>(means, stds));
+      }, height, width, 224);
+    });
+    add("transforms/imagenet_validate", params, [=](state& s) {
+      time_pipeline(s, [=](transform::transform_pipeline& p) {
+        p.add_transform(
+          make_unique<transform::resized_center_crop>(256, 256, 224, 224));
+        p.add_transform(
+          make_unique<transform::normalize_to_lbann_layout>(means, stds));
+      }, height, width, 224);
+    });
+  }
+  add("transforms/to_lbann_layout", {{"image_dims", "3x224x224"}},
+      [](state& s) {
+        time_pipeline(s, [](transform::transform_pipeline& p) {
+          p.add_transform(make_unique<transform::to_lbann_layout>());
+        }, 224, 224, 224);
+      });
+}
+LBANN_REGISTER_BENCHMARKS(register_transform_benchmarks);
+
+} // namespace
+} // namespace benchmark
+} // namespace lbann
@@ -26,6 +26,10 @@
 
 #include "lbann/lbann.hpp"
 #include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/system_info.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <algorithm>
 #include <mpi.h>
 #include <stdio.h>
 
@@ -55,6 +59,14 @@ void construct_opts(int argc, char **argv) {
                         {"-mbs"},
                         "Number of samples in a mini-batch",
                         16);
+  arg_parser.add_option("iterations",
+                        {"-i"},
+                        "Number of timed inference passes with --compare",
+                        10);
+  arg_parser.add_flag("compare",
+                      {"--compare"},
+                      "Report resident memory and latency against "
+                      "the unoptimized model");
   arg_parser.add_required_argument<std::string>
                                   ("model",
                                    "Directory containing checkpointed model");
@@ -69,6 +81,48 @@ random_samples(El::Grid const& g, int n, int c, int h, int w) {
   return samples;
 }
 
+/** Resident memory growth and mean latency of an inference model. */
+struct inference_cost {
+  size_t resident_memory = 0;
+  double latency = 0.0;
+};
+
+template <typename SamplesT>
+inference_cost measure_inference_cost(lbann::lbann_comm* comm,
+                                      SamplesT const& samples,
+                                      bool prepare) {
+  auto& arg_parser = lbann::global_argument_parser();
+  const int mbs = arg_parser.get<int>("minibatchsize");
+  const int iterations = arg_parser.get<int>("iterations");
+  lbann::utils::SystemInfo system;
+  inference_cost cost;
+
+  const auto start_memory = system.resident_memory();
+  auto m = lbann::load_inference_model(comm,
+                                       arg_parser.get<std::string>("model"),
+                                       mbs,
+                                       {
+                                         arg_parser.get<int>("channels"),
+                                         arg_parser.get<int>("height"),
+                                         arg_parser.get<int>("width")
+                                       },
+                                       {arg_parser.get<int>("labels")},
+                                       prepare);
+  const auto end_memory = system.resident_memory();
+  cost.resident_memory = (end_memory > start_memory
+                          ? end_memory - start_memory
+                          : 0);
+
+  // Warm up once, then time full passes over the samples
+  lbann::infer(m.get(), samples, mbs);
+  const double start_time = lbann::get_time();
+  for (int i = 0; i < iterations; ++i) {
+    lbann::infer(m.get(), samples, mbs);
+  }
+  cost.latency = (lbann::get_time() - start_time) / std::max(iterations, 1);
+  return cost;
+}
+
 int main(int argc, char **argv) {
   // Initialize MPI
   int provided;
@@ -96,6 +150,34 @@ int main(int argc, char **argv) {
 
   // Load model and run inference on samples
   auto lbann_comm = lbann::initialize_lbann(MPI_COMM_WORLD);
+
+  // Compare against the model as it was checkpointed. The prepared
+  // model is measured first so that memory released by one model
+  // and reused by the next can only understate the reduction.
+  if (arg_parser.get<bool>("compare")) {
+    auto samples = random_samples(lbann_comm->get_trainer_grid(),
+                                  arg_parser.get<int>("samples"),
+                                  arg_parser.get<int>("channels"),
+                                  arg_parser.get<int>("height"),
+                                  arg_parser.get<int>("width"));
+    const auto prepared = measure_inference_cost(lbann_comm.get(),
+                                                 samples,
+                                                 true);
+    const auto unprepared = measure_inference_cost(lbann_comm.get(),
+                                                   samples,
+                                                   false);
+    if (lbann_comm->am_world_master()) {
+      std::stringstream msg;
+      msg << "Resident memory: "
+          << unprepared.resident_memory / (1024 * 1024) << " MiB unoptimized, "
+          << prepared.resident_memory / (1024 * 1024) << " MiB optimized"
+          << std::endl;
+      msg << "Latency per pass: "
+          << unprepared.latency * 1e3 << " ms unoptimized, "
+          << prepared.latency * 1e3 << " ms optimized" << std::endl;
+      std::cout << msg.str();
+    }
+  }
   auto m = lbann::load_inference_model(lbann_comm.get(),
                                        arg_parser.get<std::string>("model"),
                                        arg_parser.get<int>("minibatchsize"),
@@ -50,6 +50,14 @@ namespace callback {
  *  we use internally).
  *
  *  CNPY is required to export to NumPy file formats (npy and npz).
+ *
+ *  With asynchronous output, the gathered tensors are copied into
+ *  staging buffers and written by the shared background writer (see
+ *  @c async_writer), which only stalls the training loop when all of
+ *  its buffers are in use. Pending writes are flushed at the end of
+ *  training and testing, and a failed write throws on every process
+ *  in the trainer. CSV, TSV and npy files can be
+ *  gzip-compressed, in which case ".gz" is appended to their names.
  */
 class dump_outputs : public callback_base {
 public:
@@ -66,13 +74,19 @@ public:
    *                        working directory).
    *  @param file_format    Output file format. Options are csv, tsv,
    *                        npy, npz (default: csv).
+   *  @param asynchronous   Write files from a background thread
+   *                        (default: false).
+   *  @param compress       Gzip-compress output files (default:
+   *                        false).
    */
   dump_outputs(
     std::set<std::string> layer_names,// = std::set<std::string>(),
     std::set<execution_mode> modes, // = std::set<std::string>(),
     El::Int batch_interval = 0,
     std::string directory = "",
-    std::string file_format = "");
+    std::string file_format = "",
+    bool asynchronous = false,
+    bool compress = false);
 
   dump_outputs* copy() const override {
     return new dump_outputs(*this);
@@ -88,6 +102,8 @@ public:
       do_dump_outputs(*m, *l);
     }
   }
+  void on_train_end(model* m) override { flush(*m->get_comm()); }
+  void on_test_end(model* m) override { flush(*m->get_comm()); }
 
   /** @name Serialization */
   ///@{
@@ -120,11 +136,29 @@ private:
   /** @brief Output file format. */
   std::string m_file_format;
 
+  /** @brief Whether files are written from a background thread. */
+  bool m_asynchronous;
+
+  /** @brief Whether output files are gzip-compressed. */
+  bool m_compress;
+
+  /** @brief Error from submitting this process' asynchronous
+   *         writes since the last flush.
+   */
+  std::string m_write_error;
+
   /** @brief   Dump outputs to file.
    *  @details Returns immediately if an output dump is not needed.
    */
   void do_dump_outputs(const model& m, const Layer& l);
 
+  /** @brief Wait for pending asynchronous writes.
+   *
+   *  Collective over the trainer. Throws if any process failed to
+   *  write its files.
+   */
+  void flush(const lbann_comm& comm);
+
 };
 
 // Builder function
@@ -29,6 +29,8 @@
 #ifndef LBANN_CALLBACKS_CALLBACK_DUMP_WEIGHTS_HPP_INCLUDED
 #define LBANN_CALLBACKS_CALLBACK_DUMP_WEIGHTS_HPP_INCLUDED
 
+#include <memory>
+#include <string>
 #include <utility>
 
 #include "lbann/callbacks/callback.hpp"
@@ -51,7 +53,21 @@ class FileFormat;
  *  The "text" and "binary" formats are written using Elemental's
  *  ASCII and BINARY formats, respectively. The "distributed_binary"
  *  format is written by using Elemental's BINARY format independently
- *  on each process' local data.
+ *  on each process' local data. The "bundle" format writes every
+ *  weights to a single aligned file (see @c weights_bundle) that the
+ *  load_model callback can memory-map.
+ *
+ *  The binary formats can also be gzip-compressed (".bin.gz" files)
+ *  and written asynchronously: the weights are copied into staging
+ *  buffers and written by the shared background writer (see @c
+ *  async_writer), which only stalls training when all of its buffers
+ *  are in use. Pending writes are flushed at the end of training,
+ *  validation and testing.
+ *
+ *  The checkpoint "latest" file only points to a dump once every
+ *  process in the trainer has written its files. Asynchronous dumps
+ *  are confirmed when the next dump starts or an execution mode
+ *  ends. A failed write throws on every process in the trainer.
  */
 class dump_weights : public callback_base {
  public:
@@ -68,6 +84,9 @@ class dump_weights : public callback_base {
     return new dump_weights(*this);
   }
   void on_train_begin(model *m) override;
+  void on_train_end(model *m) override;
+  void on_validation_end(model *m) override;
+  void on_test_end(model *m) override;
   void on_epoch_end(model *m) override;
   std::string name() const override { return "dump weights"; }
   void set_target_dir(const std::string& dir) { m_directory = dir; }
@@ -93,9 +112,29 @@ class dump_weights : public callback_base {
   /// Weight file format
   std::unique_ptr<dump_weights_internal::FileFormat> m_file_format;
 
+  /// Dump whose files may still be being written
+  struct pending_dump {
+    std::string dir;
+    std::string latest_file;
+    visitor_hook hook;
+    execution_mode mode;
+    size_t epoch;
+    size_t step;
+    /// Error from writing this process' files
+    std::string error;
+  };
+  std::unique_ptr<pending_dump> m_pending_dump;
+
   /// Dump weights from learning layers
   void do_dump_weights(const model& m, visitor_hook hook);
 
+  /** @brief Wait for the pending dump and update the "latest" file.
+   *
+   *  Collective over the trainer. Throws if any process failed to
+   *  write its files.
+   */
+  void finish_dump(const lbann_comm& comm);
+
 };
 
 // Builder function
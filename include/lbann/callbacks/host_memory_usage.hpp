@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_CALLBACKS_CALLBACK_HOST_MEMORY_USAGE_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_HOST_MEMORY_USAGE_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+/** @brief Report host memory usage with per-layer attribution.
+ *
+ *  At the beginning of each epoch, every process measures the host
+ *  memory owned by each layer (activations, error signals, and
+ *  workspaces), by each weights object (values and optimizer
+ *  state), by the data store, and by the input buffers, along with
+ *  its resident set size and peak resident set size. Memory not
+ *  attributed to any of these is reported as "unattributed".
+ *
+ *  The trainer master prints the min/mean/max across the trainer's
+ *  processes. If an output directory is provided, it also appends
+ *  one JSON object per epoch to
+ *  <tt>host_memory_usage-trainer<N>.jsonl</tt> in that directory.
+ */
+class host_memory_usage : public callback_base {
+ public:
+
+  /** @param directory Directory for JSON reports. Reports are not
+   *                   written if empty.
+   */
+  host_memory_usage(std::string directory = "");
+  host_memory_usage(const host_memory_usage&) = default;
+  host_memory_usage& operator=(const host_memory_usage&) = default;
+  host_memory_usage* copy() const override { return new host_memory_usage(*this); }
+  void on_epoch_begin(model *m) override;
+  std::string name() const override { return "host memory usage"; }
+
+  /** @brief Bytes of host memory owned by this process.
+   *
+   *  The entries are, in order: activations, error signals, and
+   *  workspace for each layer; values and optimizer state for each
+   *  weights object; then data store, input buffers, unattributed
+   *  memory, resident set size, and peak resident set size.
+   */
+  static std::vector<size_t> measure(model& m);
+
+  /** @name Serialization */
+  ///@{
+
+  /** @brief Store state to archive for checkpoint and restart */
+  template <class Archive> void serialize(Archive & ar);
+
+  ///@}
+
+ private:
+
+  /** @brief Directory for JSON reports. */
+  std::string m_directory;
+
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_host_memory_usage_callback_from_pbuf(
+  const google::protobuf::Message&, std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif  // LBANN_CALLBACKS_CALLBACK_HOST_MEMORY_USAGE_HPP_INCLUDED
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_INT8_CALIBRATION_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_INT8_CALIBRATION_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+
+#include <map>
+
+namespace lbann {
+namespace callback {
+
+/** @brief Calibrate int8 inference from validation activations.
+ *
+ *  Records the largest input magnitude of layers that support int8
+ *  inference (see @c int8_inference_layer) during validation. After
+ *  validation, those layers are quantized so that subsequent
+ *  evaluation (e.g. testing) uses int8 forward prop. Training always
+ *  uses full precision, and int8 inference is disabled at the start
+ *  of each training epoch so that stale quantized weights are never
+ *  used.
+ */
+class int8_calibration : public callback_base {
+public:
+  using callback_base::on_evaluate_forward_prop_end;
+
+  int8_calibration() = default;
+  int8_calibration(const int8_calibration&) = default;
+  int8_calibration& operator=(const int8_calibration&) = default;
+  int8_calibration* copy() const override {
+    return new int8_calibration(*this);
+  }
+  std::string name() const override { return "int8_calibration"; }
+
+  void on_epoch_begin(model *m) override;
+  void on_evaluate_forward_prop_end(model *m, Layer *l) override;
+  void on_validation_end(model *m) override;
+
+  /** @brief Record input range of a layer.
+   *  @details Does nothing if the layer does not support int8
+   *  inference or is already quantized.
+   */
+  void record_input_range(Layer& l);
+  /** @brief Record input ranges of all layers in a model. */
+  void record_input_ranges(model& m);
+  /** @brief Quantize calibrated layers.
+   *
+   *  Input ranges are reduced over the trainer, so this must be
+   *  called on all processes in the trainer. Recorded ranges are
+   *  cleared afterward.
+   *
+   *  @returns Number of layers using int8 inference.
+   */
+  size_t apply(model& m);
+  /** @brief Clear recorded input ranges. */
+  void reset() { m_input_ranges.clear(); }
+
+  /** @name Serialization */
+  ///@{
+
+  /** @brief Store state to archive for checkpoint and restart */
+  template <class Archive> void serialize(Archive & ar);
+
+  ///@}
+
+private:
+
+  /** @brief Largest input magnitude for each layer, by name. */
+  std::map<std::string, float> m_input_ranges;
+
+};
+
+// Builder function
+LBANN_ADD_DEFAULT_CALLBACK_BUILDER(
+  int8_calibration, build_int8_calibration_callback_from_pbuf)
+
+} // namespace callback
+} // namespace lbann
+
+#endif  // LBANN_CALLBACKS_CALLBACK_INT8_CALIBRATION_HPP_INCLUDED
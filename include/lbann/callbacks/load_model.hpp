@@ -32,6 +32,7 @@
 #include <utility>
 
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/io/weights_bundle.hpp"
 
 #include <google/protobuf/message.h>
 
@@ -45,17 +46,24 @@ namespace callback {
 
 /**
  * Load pretrained model from file
+ *
+ * Weights are restored from a weights bundle (see @c weights_bundle)
+ * if the directory contains one, otherwise from a checkpointed model
+ * or from per-weights files.
  */
 class load_model : public callback_base {
 public:
   /**
    * @param dir directory to load model
    * @param extension file extension e.g., model, state ......
+   * @param bundle_access how processes read weights bundles
    */
   load_model(std::vector<std::string> dirs,
-             std::string extension="prototext") :
+             std::string extension="prototext",
+             weights_bundle_access bundle_access=weights_bundle_access::map) :
     callback_base(), m_dirs(std::move(dirs)),
     m_extension(std::move(extension)),
+    m_bundle_access(bundle_access),
     m_loaded(false)
   {}
   load_model(const load_model&) = default;
@@ -92,6 +100,8 @@ private:
   std::vector<std::string> m_dirs; //director(ies) to load pretrained model(s)
   /// Disables the normal behavior of saving when training is complete
   std::string m_extension; //file extension
+  /// How processes read weights bundles
+  weights_bundle_access m_bundle_access = weights_bundle_access::map;
 
   /// Flag to indicate if the model has already been loaded
   bool m_loaded;
@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_CALLBACKS_CALLBACK_ROOFLINE_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_ROOFLINE_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+
+#include <map>
+#include <string>
+
+namespace lbann {
+namespace callback {
+
+/** @brief Report per-layer roofline performance each training epoch.
+ *
+ *  Combines the analytical FLOP and memory-traffic estimates of each
+ *  layer (see the cost model in @c Layer) with the measured wall
+ *  time of its forward and backward prop. At the end of each
+ *  training epoch, the trainer master prints the achieved GFLOP/s
+ *  and GB/s of each pass, its arithmetic intensity, and the fraction
+ *  of the attainable performance
+ *  @f$ \min(\text{peak\_gflops}, \text{intensity} \times \text{peak\_gbps}) @f$
+ *  that it reaches. Passes below the flag threshold are marked and
+ *  listed by time, so the largest potential savings come first.
+ *
+ *  Work is assumed to be evenly split among the trainer's processes
+ *  and the peaks are per process. The slowest process determines
+ *  each time. GPUs are synchronized around each layer, which adds
+ *  overhead to the training run.
+ */
+class roofline : public callback_base {
+ public:
+
+  /** @param peak_gflops    Peak compute rate of one process.
+   *  @param peak_gbps      Peak memory bandwidth of one process.
+   *  @param flag_threshold Fraction of the attainable performance
+   *                        below which a pass is flagged.
+   */
+  roofline(double peak_gflops, double peak_gbps, double flag_threshold);
+  roofline(const roofline&) = default;
+  roofline& operator=(const roofline&) = default;
+  roofline* copy() const override { return new roofline(*this); }
+  void on_epoch_begin(model *m) override;
+  void on_epoch_end(model *m) override;
+  void on_forward_prop_begin(model *m, Layer *l) override;
+  void on_forward_prop_end(model *m, Layer *l) override;
+  void on_backward_prop_begin(model *m, Layer *l) override;
+  void on_backward_prop_end(model *m, Layer *l) override;
+  std::string name() const override { return "roofline"; }
+
+  /** @name Serialization */
+  ///@{
+
+  /** @brief Store state to archive for checkpoint and restart */
+  template <class Archive> void serialize(Archive & ar);
+
+  ///@}
+
+ private:
+
+  friend class cereal::access;
+  roofline();
+
+  /** @brief Measurements of one pass through a layer. */
+  struct pass_stats {
+    /** @brief Wall time in seconds. */
+    double time = 0;
+    /** @brief Estimated floating-point operations. */
+    double flops = 0;
+    /** @brief Estimated bytes of memory traffic. */
+    double bytes = 0;
+    /** @brief Start time of the current pass. */
+    double start = 0;
+  };
+
+  /** @brief Peak compute rate of one process. */
+  double m_peak_gflops;
+  /** @brief Peak memory bandwidth of one process. */
+  double m_peak_gbps;
+  /** @brief Fraction of attainable performance below which a pass
+   *  is flagged.
+   */
+  double m_flag_threshold;
+
+  /** @brief Forward prop measurements, indexed by layer name. */
+  std::map<std::string, pass_stats> m_fp_stats;
+  /** @brief Backward prop measurements, indexed by layer name. */
+  std::map<std::string, pass_stats> m_bp_stats;
+
+  /** @brief Start timing a pass through a layer. */
+  void pass_begin(pass_stats& stats, const Layer& l);
+  /** @brief Finish timing a pass through a layer. */
+  void pass_end(pass_stats& stats, const Layer& l, double flops, double bytes);
+
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_roofline_callback_from_pbuf(
+  const google::protobuf::Message&, std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif  // LBANN_CALLBACKS_CALLBACK_ROOFLINE_HPP_INCLUDED
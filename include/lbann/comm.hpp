@@ -39,6 +39,7 @@
 #include "detect_El_mpi.hpp"
 
 #include <map>
+#include <memory>
 #include <typeindex>
 #include <vector>
 
@@ -89,12 +90,26 @@ using hosttransfer_backend = lbann::Al::dummy_backend;
 using mpicuda_req_type = mpicuda_backend::req_type;
 static const mpicuda_req_type mpicuda_null_req = mpicuda_backend::null_req;
 
+/** Non-blocking operation made of several dependent stages. */
+class multistage_request
+{
+public:
+  virtual ~multistage_request() = default;
+  /** Start the stages whose inputs are ready. If @c block is true,
+   *  wait until every stage has completed.
+   *  @returns Whether every stage has completed.
+   */
+  virtual bool progress(bool block) = 0;
+};
+
 /** Wrapper for Aluminum non-blocking routine requests. */
 struct request
 {
   mpi_req_type mpi_req = mpi_null_req;
   nccl_req_type nccl_req = nccl_null_req;
   mpicuda_req_type mpicuda_req = mpicuda_null_req;
+  /** Non-blocking hierarchical allreduce, if any. */
+  std::shared_ptr<multistage_request> multistage_req;
 };
 
 } // namespace Al
@@ -364,6 +379,18 @@ public:
                   const El::mpi::Comm& c,
                   El::SyncInfo<D> const& syncInfo) const;
 
+  /** Non-blocking allgather over an arbitrary communicator.
+   *  Supports int, float, and double. The buffers must remain valid
+   *  until the request has completed.
+   */
+  template <typename T>
+  void nb_all_gather(const T* src,
+                     int src_count,
+                     T* rcv,
+                     int rcv_count,
+                     const El::mpi::Comm& c,
+                     Al::request& req) const;
+
   /**
    * Allgatherv over an arbitrary communicator;
    * all vectors must be correctly sized prior to entry.
@@ -607,6 +634,66 @@ public:
                     const El::mpi::Comm& c,
                     Al::request& req,
                     El::mpi::Op op = El::mpi::SUM) const;
+  /** Node-aware hierarchical matrix allreduce.
+   *
+   *  Reduce-scatter among the processes of @c c that share a compute
+   *  node, allreduce each 1/ppn slice across nodes, then allgather
+   *  within the node. Inter-node links carry one copy of the data per
+   *  node instead of one per process. It falls back to the flat
+   *  algorithm when @c c spans a single node, when nodes hold
+   *  different numbers of processes, or for types other than float
+   *  and double. Only CPU matrices are supported.
+   */
+  template <typename TensorDataType>
+  void hierarchical_allreduce(El::AbstractMatrix<TensorDataType>& m,
+                              const El::mpi::Comm& c,
+                              El::mpi::Op op = El::mpi::SUM) const;
+  /** Non-blocking node-aware hierarchical matrix allreduce.
+   *
+   *  The three steps of hierarchical_allreduce are non-blocking MPI
+   *  collectives. Each step needs the result of the previous one, so
+   *  the next step is started by test() or wait() once the current
+   *  one has completed. nb_allreduce uses this for CPU matrices of
+   *  at least get_hierarchical_allreduce_threshold() bytes. Falls
+   *  back to the flat non-blocking allreduce like
+   *  hierarchical_allreduce.
+   */
+  template <typename TensorDataType>
+  void nb_hierarchical_allreduce(El::AbstractMatrix<TensorDataType>& m,
+                                 const El::mpi::Comm& c,
+                                 Al::request& req,
+                                 El::mpi::Op op = El::mpi::SUM) const;
+  /** Smallest CPU matrix allreduce, in bytes, that uses the
+   *  hierarchical algorithm. The default is taken from the
+   *  LBANN_HIERARCHICAL_ALLREDUCE_THRESHOLD environment variable.
+   */
+  size_t get_hierarchical_allreduce_threshold() const noexcept
+  {
+    return m_hierarchical_allreduce_threshold;
+  }
+  /** Set the hierarchical allreduce threshold. Use
+   *  std::numeric_limits<size_t>::max() to disable the hierarchical
+   *  algorithm.
+   */
+  void set_hierarchical_allreduce_threshold(size_t bytes) noexcept
+  {
+    m_hierarchical_allreduce_threshold = bytes;
+  }
+  /** Whether the blocking allreduce also uses the hierarchical
+   *  algorithm above the threshold. Off by default; the default is
+   *  taken from the LBANN_HIERARCHICAL_BLOCKING_ALLREDUCE environment
+   *  variable.
+   */
+  bool get_hierarchical_blocking_allreduce() const noexcept
+  {
+    return m_hierarchical_blocking_allreduce;
+  }
+  /** Set whether the blocking allreduce uses the hierarchical
+   *  algorithm. */
+  void set_hierarchical_blocking_allreduce(bool enable) noexcept
+  {
+    m_hierarchical_blocking_allreduce = enable;
+  }
   /** Non-blocking in-place scalar-array allreduce.
    *  If LBANN has not been built with Aluminum, then this calls a blocking
    *  allreduce.
@@ -625,6 +712,8 @@ public:
 
   /** Wait for a non-blocking request to complete. */
   template <typename T> void wait(El::mpi::Request<T>& req) const;
+  /** Test whether a non-blocking request has completed; true if it has. */
+  template <typename T> bool test(El::mpi::Request<T>& req) const;
 
   /** Wait for a non-blocking request to complete. */
   void wait(Al::request& req) const;
@@ -930,6 +1019,11 @@ private:
    *  num_threads directive has not been provided.
    */
   int m_threads_per_proc;
+  /** Smallest CPU allreduce, in bytes, that uses the hierarchical
+   *  algorithm. */
+  size_t m_hierarchical_allreduce_threshold;
+  /** Whether blocking allreduces use the hierarchical algorithm. */
+  bool m_hierarchical_blocking_allreduce;
 
   // Various statistics counters.
   mutable size_t m_num_trainer_barriers;
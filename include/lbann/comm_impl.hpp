@@ -746,6 +746,12 @@ template <typename T> void lbann_comm::wait(El::mpi::Request<T>& req) const
   El::mpi::Wait(req);
 }
 
+/** Test whether a non-blocking request has completed. */
+template <typename T> bool lbann_comm::test(El::mpi::Request<T>& req) const
+{
+  return El::mpi::Test(req);
+}
+
 /** Send a buffer to rank in trainer. */
 template <typename T>
 void lbann_comm::send(const T* const data,
@@ -184,6 +184,14 @@ class data_coordinator {
     return data_reader;
   }
 
+  /** @brief Bytes of host memory in input staging buffers on this
+   *  process. */
+  virtual size_t get_host_io_buffer_bytes() const { return 0; }
+
+  /** @brief Bytes of samples cached by the data readers' data
+   *  stores on this process. */
+  size_t get_data_store_bytes() const;
+
   /**
    * Get the dimensions of the underlying data.
    */
@@ -78,6 +78,14 @@ class data_reader_synthetic : public generic_data_reader {
     return get_linearized_response_size();
   }
 
+  /** @brief Generate a mini-batch outside of the I/O pipeline.
+   *
+   *  Each column of @c X is a sample, and each column of @c Y is a
+   *  one-hot label or a response. @c Y is ignored if the reader has
+   *  neither labels nor responses.
+   */
+  void generate_mini_batch(CPUMat& X, CPUMat& Y, int mini_batch_size);
+
  protected:
   bool fetch_datum(CPUMat& X, int data_id, int mb_idx) override;
   bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_ASYNC_VALIDATION_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_ASYNC_VALIDATION_HPP_INCLUDED
+
+#include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/execution_algorithms/factory.hpp"
+#include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/cloneable.hpp"
+
+#include <google/protobuf/message.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @class AsyncValidation
+ *  @brief SGD with validation overlapped with training.
+ *
+ *  Synchronous validation stalls training at the end of every epoch.
+ *  Here the trainers are split in two halves: trainer @f$ t @f$ in
+ *  the first half trains as in SGD, and trainer @f$ t + N/2 @f$
+ *  evaluates its snapshots on the validation set. At the end of each
+ *  epoch, the training trainer copies its weights values into a host
+ *  buffer and posts a non-blocking send to its evaluator, then keeps
+ *  training. The evaluator replies with the objective function, the
+ *  metrics, and whether the early stopping callback fired.
+ *
+ *  At most @c max_lag evaluations are outstanding: at the end of an
+ *  epoch, the training trainer reports the results that have arrived
+ *  and waits for the oldest ones beyond the bound. An early stop
+ *  requested by the evaluator therefore takes effect at most
+ *  @c max_lag epochs late. When training ends, the remaining results
+ *  are collected and the final weights are sent to the evaluator, so
+ *  both trainers hold the same model afterwards.
+ *
+ *  The trainers must have the same process grid, and the models must
+ *  have the same weights, all with the default data type. If the
+ *  number of trainers is odd, the last trainer has no partner and
+ *  trains with synchronous validation as in SGD. Callbacks of the
+ *  evaluating trainers only run on evaluation.
+ */
+class AsyncValidation final
+  : public Cloneable<AsyncValidation, sgd_training_algorithm>
+{
+  using BaseType = Cloneable<AsyncValidation, sgd_training_algorithm>;
+
+public:
+  /** @brief Construct asynchronous validation.
+   *  @param stop Stopping criteria of the training trainers.
+   *  @param max_lag Largest number of outstanding evaluations.
+   */
+  AsyncValidation(std::string name,
+                  std::unique_ptr<sgd_termination_criteria> stop,
+                  size_t max_lag);
+
+  AsyncValidation(AsyncValidation const& other) = default;
+  AsyncValidation& operator=(AsyncValidation const& other) = default;
+  ~AsyncValidation() noexcept = default;
+
+  std::string get_type() const final;
+
+  /** @brief Train or evaluate, depending on the trainer.
+   *
+   *  Evaluation modes run as in SGD on every trainer, as does
+   *  training on an unpaired trainer.
+   */
+  void apply(execution_context& context,
+             model& m,
+             data_coordinator& dc,
+             execution_mode mode) final;
+
+private:
+
+  /** @brief Train and send snapshots to the evaluating trainer. */
+  void train_with_snapshots(sgd_execution_context& c,
+                            model& model,
+                            data_coordinator& dc,
+                            El::Int evaluator);
+
+  /** @brief Evaluate snapshots until the training trainer is done. */
+  void evaluate_snapshots(sgd_execution_context& c,
+                          model& model,
+                          data_coordinator& dc,
+                          El::Int trainer);
+
+  /** @brief Largest number of outstanding evaluations. */
+  size_t m_max_lag;
+
+}; // class AsyncValidation
+
+} // namespace lbann
+
+/** @brief Build asynchronous validation from a protobuf message. */
+template <>
+std::unique_ptr<lbann::AsyncValidation>
+lbann::make<lbann::AsyncValidation>(google::protobuf::Message const& msg);
+
+#endif // LBANN_EXECUTION_ALGORITHMS_ASYNC_VALIDATION_HPP_INCLUDED
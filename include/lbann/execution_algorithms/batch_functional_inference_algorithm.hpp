@@ -28,12 +28,16 @@
 #define LBANN_BATCH_INFERENCE_ALGORITHM_HPP
 
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/callbacks/int8_calibration.hpp"
 #include "lbann/data_coordinator/data_coordinator.hpp"
 #include "lbann/execution_contexts/sgd_execution_context.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/layers/io/input_layer.hpp"
+#include "lbann/layers/learning/int8_inference.hpp"
 #include "lbann/models/model.hpp"
 
+#include <limits>
+
 
 namespace lbann {
 
@@ -106,6 +110,83 @@ public:
     return labels;
   }
 
+  /** @brief Quantize a model for int8 inference.
+   *
+   *  Runs full-precision inference on calibration samples to record
+   *  layer input ranges, switches supported layers (see
+   *  @c int8_inference_layer) to int8 inference, and reruns
+   *  inference to measure the effect of quantization.
+   *
+   * @param[in] model A trained model
+   * @param[in] samples Calibration samples for model input
+   * @param[in] mbs The max mini-batch size
+   * @param[in] true_labels Optional ground truth labels for samples
+   * @return Accuracy lost by quantization if @c true_labels is
+   *         provided, otherwise the fraction of predictions that
+   *         changed
+   */
+  template <typename DataT, El::Dist CDist, El::Dist RDist, El::DistWrap DistView, El::Device Device>
+  double
+  quantize_int8(observer_ptr<model> model,
+                El::DistMatrix<DataT, CDist, RDist, DistView, Device> const& samples,
+                size_t mbs,
+                El::Matrix<int, El::Device::CPU> const* true_labels = nullptr) {
+    if (mbs <= 0) {
+      LBANN_ERROR("mini-batch size must be larger than 0");
+    }
+    for (auto* l : model->get_layers()) {
+      if (auto* ql = dynamic_cast<int8_inference_layer*>(l)) {
+        ql->disable_int8_inference();
+      }
+    }
+
+    // Full-precision inference, recording layer input ranges
+    callback::int8_calibration calibration;
+    size_t samples_size = samples.Height();
+    El::Matrix<int, El::Device::CPU> fp32_labels(samples_size, 1);
+    auto c = sgd_execution_context(execution_mode::inference, mbs);
+    model->reset_mode(c, execution_mode::inference);
+    for (size_t i = 0; i < samples_size; i+=mbs) {
+      size_t mb_idx = std::min(i+mbs, samples_size);
+      auto mb_range = El::IR(i, mb_idx);
+      auto mb_samples = El::LockedView(samples, mb_range, El::ALL);
+      auto mb_labels = El::View(fp32_labels, mb_range, El::ALL);
+      infer_mini_batch(*model, mb_samples);
+      calibration.record_input_ranges(*model);
+      get_labels(*model, mb_labels);
+    }
+
+    // Quantized inference
+    const auto num_quantized = calibration.apply(*model);
+    const auto int8_labels = infer(model, samples, mbs);
+
+    // Compare predictions
+    size_t num_changed = 0, fp32_correct = 0, int8_correct = 0;
+    for (size_t i = 0; i < samples_size; ++i) {
+      num_changed += (fp32_labels(i) != int8_labels(i));
+      if (true_labels != nullptr) {
+        fp32_correct += (fp32_labels(i) == (*true_labels)(i));
+        int8_correct += (int8_labels(i) == (*true_labels)(i));
+      }
+    }
+    const double num_samples = std::max(samples_size, size_t{1});
+    const double changed = num_changed / num_samples;
+    const double fp32_accuracy = fp32_correct / num_samples;
+    const double int8_accuracy = int8_correct / num_samples;
+    if (model->get_comm()->am_world_master()) {
+      std::cout << "int8 quantization: " << num_quantized << " layer(s) "
+                << "quantized, " << 100 * changed << "% of predictions changed";
+      if (true_labels != nullptr) {
+        std::cout << ", accuracy " << 100 * fp32_accuracy << "% (fp32) vs "
+                  << 100 * int8_accuracy << "% (int8)";
+      }
+      std::cout << std::endl;
+    }
+    return (true_labels != nullptr
+            ? fp32_accuracy - int8_accuracy
+            : changed);
+  }
+
 
 protected:
 
@@ -114,44 +195,54 @@ protected:
    * layer of the model, and runs forward prop on the model.
    * @param[in] model A trained model
    * @param[in] samples A distributed matrix containing samples for model input
+   *                    (one sample per row)
    */
   template <typename DataT, El::Dist CDist, El::Dist RDist, El::DistWrap DistView, El::Device Device>
   void
   infer_mini_batch(model& model,
                    El::DistMatrix<DataT, CDist, RDist, DistView, Device> const& samples) {
+    // Layers expect one sample per column
+    El::DistMatrix<DataT, RDist, CDist, DistView, Device>
+      samples_t(samples.Grid(), samples.Root());
+    El::Transpose(samples, samples_t);
     for (int i=0; i < model.get_num_layers(); i++) {
       auto& l = model.get_layer(i);
       // Insert samples into the input layer
       if (l.get_type() == "input") {
         auto& il = dynamic_cast<input_layer<DataType>&>(l);
-        il.set_samples(samples);
+        il.set_samples(samples_t);
       }
     }
     model.forward_prop(execution_mode::inference);
   }
 
   /** @brief Finds the predicted category in a models softmax layer
+   * The softmax output is gathered once and scanned locally, rather
+   * than accessing the distributed matrix one entry at a time.
    * @param[in] model A model that has been used for inference
    * @param[in] labels A matrix to place predicted category labels
    */
-  void get_labels(model& model,\
+  void get_labels(model& model,
                   El::Matrix<int, El::Device::CPU> &labels) {
-    int pred_label;
-    float max, col_value;
-
     for (const auto* l : model.get_layers()) {
       // Find the output layer
       if (l->get_type() == "softmax") {
         auto const& dtl = dynamic_cast<lbann::data_type_layer<float> const&>(*l);
-        const auto& outputs = dtl.get_activations();
+        const auto& dist_outputs = dtl.get_activations();
+        El::DistMatrix<float, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+          gathered_outputs(dist_outputs.Grid(), dist_outputs.Root());
+        El::Copy(dist_outputs, gathered_outputs);
+        const auto& outputs = gathered_outputs.LockedMatrix();
 
         // Find the prediction for each sample
-        int col_count = outputs.Width();
-        int row_count = outputs.Height();
-        for (int i=0; i<col_count; i++) {
-          max = 0;
-          for (int j=0; j<row_count; j++) {
-            col_value = outputs.Get(i, j);
+        const El::Int col_count = outputs.Width();
+        const El::Int row_count = outputs.Height();
+        LBANN_OMP_PARALLEL_FOR
+        for (El::Int i=0; i<col_count; i++) {
+          int pred_label = 0;
+          float max = -std::numeric_limits<float>::infinity();
+          for (El::Int j=0; j<row_count; j++) {
+            const float col_value = outputs(j, i);
             if (col_value > max) {
               max = col_value;
               pred_label = j;
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_BOTTLENECK_ANALYSIS_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_BOTTLENECK_ANALYSIS_HPP_INCLUDED
+
+#include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/execution_algorithms/factory.hpp"
+#include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/cloneable.hpp"
+
+#include <google/protobuf/message.h>
+#include <functional>
+#include <memory>
+
+namespace lbann {
+
+/** @class BottleneckAnalysis
+ *  @brief Diagnostic that finds the stage limiting training speed.
+ *
+ *  Training is run in four ways, each for a number of warmup steps
+ *  followed by a number of timed steps:
+ *
+ *  - Training: regular SGD steps, giving the real steady-state rate.
+ *  - Data pipeline only: the data coordinator fetches mini-batches
+ *    and the input layers consume them, with no other computation.
+ *  - Compute only: forward prop, backward prop and optimization steps
+ *    on a cached synthetic mini-batch (see
+ *    @c data_reader_synthetic) with the gradient allreduces skipped.
+ *  - Gradient allreduce only: the gradient of every weights is
+ *    communicated as in training, without computing it.
+ *
+ *  Each of the last three rates is a ceiling on the training rate.
+ *  The trainer master prints them next to the real rate, along with
+ *  the lowest ceiling, which is the binding stage.
+ *
+ *  The synthetic steps update the weights with meaningless
+ *  gradients, so the trained model should not be used. Sharded
+ *  optimizers still communicate in the compute-only steps.
+ */
+class BottleneckAnalysis final
+  : public Cloneable<BottleneckAnalysis, sgd_training_algorithm>
+{
+  using BaseType = Cloneable<BottleneckAnalysis, sgd_training_algorithm>;
+
+public:
+  /** @brief Construct the analysis.
+   *  @param num_steps Timed steps in each run.
+   *  @param num_warmup_steps Untimed steps before each run.
+   */
+  BottleneckAnalysis(std::string name,
+                     size_t num_steps,
+                     size_t num_warmup_steps);
+
+  BottleneckAnalysis(BottleneckAnalysis const& other) = default;
+  BottleneckAnalysis& operator=(BottleneckAnalysis const& other) = default;
+  ~BottleneckAnalysis() noexcept = default;
+
+  std::string get_type() const final;
+
+  /** @brief Run the analysis when training.
+   *
+   *  Evaluation modes run as in SGD.
+   */
+  void apply(execution_context& context,
+             model& m,
+             data_coordinator& dc,
+             execution_mode mode) final;
+
+private:
+
+  /** @brief Run @c step, untimed and then timed.
+   *  @returns Seconds per timed step on the slowest process of the
+   *           trainer.
+   */
+  double time_steps(lbann_comm& comm, std::function<void()> const& step) const;
+
+  /** @brief Average seconds per regular SGD step. */
+  double time_training(sgd_execution_context& c,
+                       model& m,
+                       data_coordinator& dc);
+  /** @brief Average seconds per mini-batch fetched by the input
+   *  layers. */
+  double time_data_pipeline(sgd_execution_context& c,
+                            model& m,
+                            data_coordinator& dc) const;
+  /** @brief Average seconds per step on a cached synthetic
+   *  mini-batch.
+   *
+   *  Gradients are not allreduced, so the weights values and
+   *  optimizer state are restored afterward.
+   */
+  double time_compute(sgd_execution_context& c,
+                      model& m,
+                      data_coordinator& dc) const;
+  /** @brief Average seconds per gradient allreduce of all weights. */
+  double time_gradient_allreduce(model& m) const;
+
+  /** @brief Timed steps in each run. */
+  size_t m_num_steps;
+  /** @brief Untimed steps before each run. */
+  size_t m_num_warmup_steps;
+
+}; // class BottleneckAnalysis
+
+} // namespace lbann
+
+/** @brief Build the bottleneck analysis from a protobuf message. */
+template <>
+std::unique_ptr<lbann::BottleneckAnalysis>
+lbann::make<lbann::BottleneckAnalysis>(google::protobuf::Message const& msg);
+
+#endif // LBANN_EXECUTION_ALGORITHMS_BOTTLENECK_ANALYSIS_HPP_INCLUDED
@@ -0,0 +1,274 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_INFERENCE_SERVER_HPP
+#define LBANN_INFERENCE_SERVER_HPP
+
+#include "lbann/execution_algorithms/batch_functional_inference_algorithm.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Header of a request to the inference server.
+ *
+ *  Clients connect to the server's UNIX domain socket and send a
+ *  header followed by @c num_samples * @c sample_size floats
+ *  (sample-major). The server replies with @c num_samples int32
+ *  predicted labels. Requests with no samples, or with more than the
+ *  server's maximum request size, are rejected by closing the
+ *  connection.
+ *
+ *  Sending a header with zero samples to the server's admin socket
+ *  shuts the server down after the queued requests have been served.
+ */
+struct inference_request_header {
+  uint32_t num_samples;
+  uint32_t sample_size;
+};
+
+/** @brief Client connection to the inference server.
+ *
+ *  Shared by the requests read from it, so the socket stays open
+ *  until every response has been written.
+ */
+class inference_connection {
+public:
+  explicit inference_connection(int fd) : m_fd(fd) {}
+  ~inference_connection();
+  inference_connection(const inference_connection&) = delete;
+  inference_connection& operator=(const inference_connection&) = delete;
+  int get_fd() const noexcept { return m_fd; }
+  /** @brief Stop blocking reads and writes on the socket. */
+  void shutdown();
+private:
+  int m_fd;
+};
+
+/** @brief Pending request to the inference server. */
+struct inference_request {
+  /** @brief Connection to respond on (may be null in tests). */
+  std::shared_ptr<inference_connection> connection;
+  /** @brief Number of samples in request. */
+  size_t num_samples = 0;
+  /** @brief Sample-major sample data. */
+  std::vector<float> samples;
+  /** @brief Time the request was received. */
+  std::chrono::steady_clock::time_point arrival_time;
+};
+
+/** @brief Assemble variable-size mini-batches under a latency deadline.
+ *
+ *  Requests are batched in arrival order. A batch is released as
+ *  soon as it would reach the maximum mini-batch size, or once the
+ *  oldest queued request has waited for the maximum latency.
+ *  Thread-safe.
+ */
+class dynamic_batcher {
+public:
+  dynamic_batcher(size_t max_batch_size,
+                  std::chrono::microseconds max_latency);
+
+  /** @brief Queue a request. */
+  void push(inference_request req);
+
+  /** @brief Wait for the next mini-batch.
+   *
+   *  A single request larger than the maximum mini-batch size is
+   *  returned alone.
+   *  @return Requests in the mini-batch. Empty once the batcher has
+   *  been shut down and drained.
+   */
+  std::vector<inference_request> next_batch();
+
+  /** @brief Stop accepting requests and release queued ones. */
+  void shutdown();
+
+  /** @brief Number of queued samples. */
+  size_t get_num_queued_samples() const;
+
+private:
+  /** @brief Maximum number of samples in a mini-batch. */
+  size_t m_max_batch_size;
+  /** @brief Maximum time a request waits for its batch to fill. */
+  std::chrono::microseconds m_max_latency;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<inference_request> m_queue;
+  size_t m_num_queued_samples = 0;
+  bool m_shutdown = false;
+};
+
+/** @brief Latency percentiles and throughput of served requests. */
+class latency_statistics {
+public:
+  latency_statistics() { reset(); }
+
+  /** @brief Record a completed request.
+   *  @param latency Seconds from arrival to response.
+   *  @param num_samples Samples in the request.
+   */
+  void record(double latency, size_t num_samples);
+
+  /** @brief Latency percentile in seconds.
+   *  @param p Percentile in [0,100].
+   */
+  double get_percentile(double p) const;
+
+  size_t get_num_requests() const noexcept { return m_latencies.size(); }
+  size_t get_num_samples() const noexcept { return m_num_samples; }
+  size_t get_num_batches() const noexcept { return m_num_batches; }
+  void add_batch() noexcept { ++m_num_batches; }
+
+  /** @brief Samples per second since the last reset. */
+  double get_throughput() const;
+
+  /** @brief One-line summary of the counters. */
+  std::string summary() const;
+
+  void reset();
+
+private:
+  std::vector<double> m_latencies;
+  size_t m_num_samples;
+  size_t m_num_batches;
+  std::chrono::steady_clock::time_point m_start_time;
+};
+
+/** @brief Long-running inference server for a trained model.
+ *
+ *  The trainer master listens on a UNIX domain socket, a
+ *  @c dynamic_batcher assembles variable-size mini-batches from the
+ *  incoming requests, and every rank in the trainer runs the batch
+ *  through @c batch_functional_inference_algorithm. Each trainer is
+ *  an independent model replica with its own socket, so replicas are
+ *  scaled out by launching more trainers (see @c pin_to_cores to
+ *  place them on disjoint cores).
+ *
+ *  The server only stops through @c request_shutdown or its admin
+ *  socket (@c get_admin_socket_path), which only the owner of the
+ *  process can connect to.
+ */
+class inference_server {
+public:
+  /**
+   * @param socket_path UNIX domain socket of this replica
+   * @param max_batch_size Maximum mini-batch size
+   * @param max_latency Maximum time a request waits for its batch
+   * @param report_interval Seconds between statistics reports (0
+   *                        only reports at shutdown)
+   * @param max_request_samples Maximum number of samples in a
+   *                            request (0 uses @c max_batch_size)
+   */
+  inference_server(std::string socket_path,
+                   size_t max_batch_size,
+                   std::chrono::microseconds max_latency,
+                   double report_interval = 0,
+                   size_t max_request_samples = 0);
+  ~inference_server();
+  inference_server(const inference_server&) = delete;
+  inference_server& operator=(const inference_server&) = delete;
+
+  /** @brief Serve requests until shutdown is requested.
+   *
+   *  Collective over the trainer.
+   */
+  void serve(observer_ptr<model> m);
+
+  /** @brief Stop serving once the queued requests have been served.
+   *
+   *  Thread-safe, but not async-signal-safe.
+   */
+  void request_shutdown();
+
+  /** @brief UNIX domain socket for shutdown requests. */
+  std::string get_admin_socket_path() const { return m_socket_path + ".admin"; }
+
+  const latency_statistics& get_statistics() const noexcept {
+    return m_statistics;
+  }
+
+  /** @brief Pin this process to a disjoint set of cores.
+   *
+   *  Splits the cores of the node evenly between the ranks on the
+   *  node. Must be called before OpenMP threads are created. Does
+   *  nothing where CPU affinity is not supported.
+   */
+  static void pin_to_cores(const lbann_comm& comm);
+
+private:
+  /** @brief Open the sockets and start accepting connections. */
+  void start_listening(size_t sample_size);
+  /** @brief Close the sockets and join I/O threads. */
+  void stop_listening();
+  /** @brief Accept connections until the socket is closed. */
+  void accept_connections(size_t sample_size);
+  /** @brief Accept shutdown requests until the admin socket is closed. */
+  void accept_admin_connections();
+  /** @brief Read requests from a client until it disconnects. */
+  void read_requests(std::shared_ptr<inference_connection> connection,
+                     size_t sample_size);
+  /** @brief Join reader threads whose clients have disconnected.
+   *
+   *  Must be called with @c m_connections_mutex held.
+   */
+  void reap_reader_threads();
+  /** @brief Send predicted labels and record latencies. */
+  void respond(const std::vector<inference_request>& batch,
+               const El::Matrix<int, El::Device::CPU>& labels);
+
+  std::string m_socket_path;
+  size_t m_max_batch_size;
+  size_t m_max_request_samples;
+  double m_report_interval;
+  dynamic_batcher m_batcher;
+  latency_statistics m_statistics;
+  batch_functional_inference_algorithm m_algorithm;
+
+  int m_listen_fd = -1;
+  int m_admin_fd = -1;
+  std::thread m_accept_thread;
+  std::thread m_admin_thread;
+  std::mutex m_connections_mutex;
+  std::vector<std::thread> m_reader_threads;
+  /** @brief Reader threads that are about to exit. */
+  std::vector<std::thread::id> m_finished_readers;
+  std::vector<std::weak_ptr<inference_connection>> m_connections;
+};
+
+}  // namespace lbann
+
+#endif  // LBANN_INFERENCE_SERVER_HPP
@@ -84,9 +84,12 @@ public:
     std::vector<size_t> update_intervals,
     size_t update_interval_steps,
     kfac::kfac_inverse_strategy inverse_strategy,
+    size_t inverse_rebalance_updates,
     std::vector<std::string> disable_layers,
     double learning_rate_factor,
-    double learning_rate_factor_gru);
+    double learning_rate_factor_gru,
+    size_t eigen_refresh_interval,
+    bool overlap_factor_reduction);
 
   KFAC(KFAC const& other);
   KFAC& operator=(const KFAC& other);
@@ -164,6 +167,10 @@ protected:
 
 private:
 
+  /** @brief Forwards layer backprop events to
+   *  @c on_layer_backward_prop_end. */
+  class factor_reduction_callback;
+
 #if 1
   /** @todo Break up into more manageable pieces */
   void on_forward_prop_end(
@@ -173,6 +180,27 @@ private:
     ExeContextType& context,
     model& model);
 
+  /** @brief Compute a block's Kronecker factors after its layer's
+   *  backprop and start reducing them. */
+  void on_layer_backward_prop_end(
+    ExeContextType& context,
+    model& model,
+    Layer& layer);
+
+  /** @brief Start non-blocking reductions of ready Kronecker factors.
+   *  @details Reductions are started in reverse block order, stopping
+   *  at the first block that is not ready. */
+  void start_factor_reductions(
+    ExeContextType& context,
+    lbann_comm& comm);
+
+  /** @brief Reassign inverse computation using measured times.
+   *  @details Called on every process once enough inverse updates
+   *  have been timed with the balanced inverse strategy. */
+  void rebalance_inverse_proc_ranks(
+    ExeContextType& context,
+    lbann_comm& comm);
+
 #else
   /** @brief Compute Kronecker factors */
   void compute_kronecker_factors(
@@ -224,12 +252,26 @@ private:
   /** @brief Assignment strategy for the model-parallel part. */
   kfac::kfac_inverse_strategy m_inverse_strategy;
 
+  /** @brief Number of Kronecker updates to time before reassigning
+   *  blocks with the balanced inverse strategy. Zero disables
+   *  reassignment. */
+  size_t m_inverse_rebalance_updates;
+
   /** @brief List of layers to be ignored by the callback. */
   std::vector<std::string> m_disable_layers;
 
   /** @brief Factors to be multiplied to the learning rate */
   double m_learning_rate_factor, m_learning_rate_factor_gru;
 
+  /** @brief Number of Kronecker updates between eigendecompositions
+   *  of each fully-connected or convolution block. Zero uses damped
+   *  inverses instead of eigendecompositions. */
+  size_t m_eigen_refresh_interval;
+
+  /** @brief Whether to start Kronecker factor reductions during
+   *  backprop, as soon as each layer's factors are available. */
+  bool m_overlap_factor_reduction;
+
   /** @brief Whether inverse of Kronecker factors are available. */
   bool m_has_kronecker_inverse;
 
@@ -128,6 +128,45 @@ private:
   /** @brief K-FAC per-layer blocks. */
   std::vector<std::shared_ptr<kfac_block<Device>>> m_blocks;
 
+  /** @brief Accumulated inverse times of the blocks owned by this
+   *  process (zero for others). Used to rebalance the inverse
+   *  assignment. */
+  std::vector<double> m_inverse_times;
+
+  /** @brief Number of Kronecker inverse updates performed. */
+  size_t m_num_inverse_updates = 0;
+
+  /** @brief Whether Kronecker factors are updated in the current
+   *  step. */
+  bool m_is_kronecker_update_required = false;
+
+  /** @name Factor reductions overlapped with backprop */
+  ///@{
+
+  /** @brief Whether each block's local factors have been computed in
+   *  the current step. */
+  std::vector<bool> m_local_factors_ready;
+  /** @brief Number of blocks, counted from the end of @c m_blocks,
+   *  whose factor reductions have been started in the current step.
+   *  @details Reductions are started in this order on all processes
+   *  so that collectives match. */
+  size_t m_num_factor_reductions_started = 0;
+  /** @brief Requests for the started factor reductions. */
+  std::vector<Al::request> m_factor_reduction_requests;
+  /** @brief Time when the first factor reduction of the current step
+   *  was started. */
+  double m_factor_reduction_start_time = 0.0;
+  /** @brief Accumulated time between starting factor reductions and
+   *  waiting on them, i.e. the window in which they overlap with
+   *  backprop. */
+  double m_factor_reduction_overlap_time = 0.0;
+  /** @brief Accumulated time spent waiting on factor reductions. */
+  double m_factor_reduction_wait_time = 0.0;
+  /** @brief Number of steps with overlapped factor reductions. */
+  size_t m_num_overlapped_factor_updates = 0;
+
+  ///@}
+
   /** @brief Workspace matrices that are used by m_blocks. */
   std::unordered_map<std::string,
                      El::Matrix<DataType, Device>> m_workspace;
@@ -94,6 +94,16 @@ class kfac_block {
     LBANN_ERROR("this function should be called via a sub-class.");
   }
 
+  /** @brief Estimated cost of @c update_kronecker_inverse.
+   *
+   *  Proportional to the flop count of factorizing and inverting the
+   *  Kronecker factors and applying them to the gradients. Used to
+   *  balance inverse computation across processes.
+   */
+  virtual double get_inverse_cost() const {
+    LBANN_ERROR("this function should be called via a sub-class.");
+  }
+
   /** @brief Get buffers of preconditioned parameter gradients. */
   virtual const std::vector<El::AbstractMatrix<DataType>*>
   get_preconditioned_grad_buffers() {
@@ -114,9 +124,16 @@ class kfac_block {
     return m_layer->get_name();
   }
 
+  const Layer* get_layer() const {
+    return m_layer;
+  }
+
   size_t get_inverse_proc_rank() const {
     return m_inverse_proc_rank;
   }
+  void set_inverse_proc_rank(size_t rank) {
+    m_inverse_proc_rank = rank;
+  }
 
   /** @brief Return the list of internal matrices' (name, height,
    * width) for debugging. All internal matrices should be ready when
@@ -144,7 +161,7 @@ class kfac_block {
   const size_t m_layer_id;
 
   /** @brief The process ID which perform inverse on Kronecker. */
-  const int m_inverse_proc_rank;
+  int m_inverse_proc_rank;
 
   /** @brief Whether this block already has an inverse history. */
   bool m_has_kronecker_inverse;
@@ -126,6 +126,8 @@ class kfac_block_bn: public kfac_block<Device> {
   const std::vector<El::AbstractMatrix<DataType>*>
   get_preconditioned_grad_buffers() override;
 
+  double get_inverse_cost() const override;
+
   std::vector<std::tuple<std::string, size_t, size_t>>
   get_internal_matrix_info() const override;
 
@@ -148,10 +148,29 @@ class kfac_block_fc_conv: public kfac_block<Device> {
   const std::vector<El::AbstractMatrix<DataType>*>
   get_preconditioned_grad_buffers() override;
 
+  double get_inverse_cost() const override;
+
+  /** @brief Precondition with cached eigendecompositions of the
+   *  Kronecker factors instead of damped inverses.
+   *
+   *  @param refresh_interval Number of inverse updates between
+   *  eigendecompositions. Zero disables the eigendecomposition.
+   *  @param refresh_offset Shifts the updates at which this block
+   *  refreshes, to stagger refreshes across blocks.
+   */
+  void set_eigen_decomposition(size_t refresh_interval,
+                               size_t refresh_offset) {
+    m_eigen_refresh_interval = refresh_interval;
+    m_eigen_refresh_offset = refresh_offset;
+  }
+
   std::string get_info() const override {
     std::ostringstream oss;
     oss << kfac_block<Device>::get_info()
         << ", is_conv=" << m_is_conv;
+    if(m_eigen_refresh_interval > 0)
+      oss << ", eigen_refresh_interval=" << m_eigen_refresh_interval
+          << ", eigen_refresh_offset=" << m_eigen_refresh_offset;
     return oss.str();
   }
 
@@ -211,6 +230,19 @@ class kfac_block_fc_conv: public kfac_block<Device> {
   El::Matrix<DataType, Device>
   m_kronecker_inverse_A, m_kronecker_inverse_G;
 
+  /** @brief Eigendecomposition of the average Kronecker factors. */
+  El::Matrix<DataType, Device>
+  m_eigenvectors_A, m_eigenvectors_G,
+    m_eigenvalues_A, m_eigenvalues_G;
+
+  /** @brief Inverse updates between eigendecompositions (zero if
+   *  damped inverses are used). */
+  size_t m_eigen_refresh_interval = 0;
+  /** @brief Offset to stagger eigendecompositions across blocks. */
+  size_t m_eigen_refresh_offset = 0;
+  /** @brief Number of inverse updates performed by this block. */
+  size_t m_num_inverse_updates = 0;
+
   /** @brief Vectorized gradient buffer (only for fully-connecter layers). */
   El::Matrix<DataType, Device>
   m_grad_buffer_v;
@@ -163,6 +163,8 @@ class kfac_block_gru: public kfac_block<Device> {
   const std::vector<El::AbstractMatrix<DataType>*>
   get_preconditioned_grad_buffers() override;
 
+  double get_inverse_cost() const override;
+
  private:
 
   void check_dnn_lib_spec() const;
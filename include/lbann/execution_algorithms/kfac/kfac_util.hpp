@@ -41,6 +41,8 @@ enum class kfac_inverse_strategy {
   EACH, // Apply round-robin assingment to every type of layers. may
   // not work well for small networks.
   ROOT, // Use only the root GPU. This is only for testing.
+  BALANCED, // Balance the estimated (or measured) inverse cost
+  // among processes with longest-processing-time-first assignment.
 };
 
 enum class kfac_reduce_scatter_mode {
@@ -67,6 +69,33 @@ void get_matrix_inverse(
     bool is_bn,
     const El::SyncInfo<Device>& sync_info);
 
+/** @brief Gets the eigendecomposition of a symmetric matrix A.
+ *
+ *  A = Q diag(lambda) Q^T. Only the lower triangle of A is
+ *  referenced. Eigenvalues are clamped to be non-negative since
+ *  Kronecker factors are positive semi-definite. The decomposition
+ *  is computed on the host with LAPACK (syevd). **/
+template <El::Device Device>
+void get_matrix_eigen(
+    El::Matrix<DataType, Device>& Q,
+    El::Matrix<DataType, Device>& lambda,
+    const El::Matrix<DataType, Device>& A,
+    bool report_time);
+
+/** @brief Divide X(i,j) by (lambda_rows(i)+damping_rows)
+ *  *(lambda_cols(j)+damping_cols).
+ *
+ *  Applies the damped inverse of a Kronecker-factored matrix to X
+ *  when X is expressed in the factors' eigenbases. **/
+template <El::Device Device>
+void scale_by_damped_eigenvalues(
+    El::Matrix<DataType, Device>& X,
+    const El::Matrix<DataType, Device>& lambda_rows,
+    const El::Matrix<DataType, Device>& lambda_cols,
+    DataType damping_rows,
+    DataType damping_cols,
+    const El::SyncInfo<Device>& sync_info);
+
 /** @brief Gets statistics of a given matrix. **/
 template <El::Device Device>
 std::string get_matrix_stat(
@@ -81,6 +110,31 @@ void allreduce_lower_tri(
     lbann_comm *comm,
     const El::SyncInfo<Device>& sync_info);
 
+/** @brief Estimated cost of get_matrix_inverse on an n x n matrix.
+ *
+ *  Counts the flops of the Cholesky factorization, triangular
+ *  inversion, and triangular product. **/
+double get_matrix_inverse_cost(size_t n);
+
+/** @brief Estimated cost of get_matrix_eigen on an n x n matrix. **/
+double get_matrix_eigen_cost(size_t n);
+
+/** @brief Estimated cost of preconditioning a (g x a) gradient with
+ *  (g x g) and (a x a) inverse Kronecker factors. **/
+double get_precondition_cost(size_t g, size_t a);
+
+/** @brief Assign blocks to processes to balance their total cost.
+ *
+ *  Uses the longest-processing-time-first heuristic: blocks are
+ *  visited in decreasing order of cost and each is assigned to the
+ *  least-loaded process. The result is deterministic, so every
+ *  process computes the same assignment.
+ *
+ *  @returns The process rank of each block. **/
+std::vector<size_t> get_balanced_proc_ranks(
+    const std::vector<double>& costs,
+    size_t num_procs);
+
 /** @brief Get whether a global buffer is needed. **/
 bool is_reduce_scatter_buffer_required(kfac_reduce_scatter_mode mode);
 
@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
+
+#include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/execution_algorithms/factory.hpp"
+#include "lbann/execution_algorithms/local_sgd/execution_context.hpp"
+#include "lbann/execution_algorithms/training_algorithm.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/cloneable.hpp"
+#include "lbann/utils/make_abstract.hpp"
+
+#include <google/protobuf/message.h>
+#include <memory>
+
+namespace lbann {
+
+/** @class LocalSGD
+ *  @brief Local SGD with periodic model averaging.
+ *
+ *  Each trainer takes SGD steps on its own data without
+ *  synchronizing gradients with the other trainers (gradients are
+ *  still allreduced within a trainer). Every @f$ K @f$ steps, the
+ *  weights of all trainers, and optionally their optimizer state,
+ *  are averaged with a single fused allreduce over the inter-trainer
+ *  communicator. With one process per trainer, this is local SGD
+ *  per rank.
+ *
+ *  @f$ K @f$ is 1 during an optional warmup ("post-local SGD") and
+ *  can then be doubled after every fixed number of averages, up to
+ *  a maximum.
+ *
+ *  All trainers must take the same number of steps, e.g. by using a
+ *  batch-count stopping criterion or equal-sized data partitions.
+ *
+ *  Lin, Tao, et al. "Don't use large mini-batches, use local SGD."
+ *  International Conference on Learning Representations. 2020.
+ *
+ *  Wang, Jianyu, and Gauri Joshi. "Adaptive communication strategies
+ *  to achieve the best error-runtime trade-off in local-update SGD."
+ *  Proceedings of Machine Learning and Systems. 2019.
+ */
+class LocalSGD final : public Cloneable<LocalSGD, training_algorithm>
+{
+  using BaseType = Cloneable<LocalSGD, training_algorithm>;
+
+public:
+  using TermCriteriaType = sgd_termination_criteria;
+  using ExeContextType = local_sgd::ExecutionContext;
+
+public:
+  /** @name Life-cycle management */
+  ///@{
+  /** @brief Construct local SGD from its component pieces.
+   *  @param stop Stopping criteria for the local steps.
+   *  @param sync_interval Initial number of local steps between
+   *         model averages.
+   *  @param max_sync_interval Largest number of local steps between
+   *         model averages.
+   *  @param sync_interval_growth_period Number of model averages
+   *         after which the interval is doubled. Zero keeps it
+   *         fixed.
+   *  @param warmup_steps Number of initial steps after each of which
+   *         the models are averaged.
+   *  @param average_optimizer_state Whether to also average the SGD
+   *         velocity or Adam moments.
+   */
+  LocalSGD(std::string name,
+           std::unique_ptr<TermCriteriaType> stop,
+           size_t sync_interval,
+           size_t max_sync_interval,
+           size_t sync_interval_growth_period,
+           size_t warmup_steps,
+           bool average_optimizer_state);
+
+  LocalSGD(LocalSGD const& other);
+  LocalSGD& operator=(const LocalSGD& other);
+  ~LocalSGD() noexcept = default;
+  ///@}
+  /** @brief Queries */
+  ///@{
+  std::string get_type() const final;
+  ///@}
+  /** @name Apply interface */
+  ///@{
+  /** @brief Apply the training algorithm to refine model weights.
+   *  @param[in,out] context The persistent execution context for this
+   *                 algorithm.
+   *  @param[in,out] m The model to be trained.
+   *  @param[in,out] dc The data source for training.
+   *  @param[in] mode Completely superfluous.
+   */
+  void apply(execution_context& context,
+             model& m,
+             data_coordinator& dc,
+             execution_mode mode) final;
+  /** @brief Train a model using local SGD. */
+  void train(ExeContextType& c,
+             model& model,
+             data_coordinator& dc,
+             TermCriteriaType const& term);
+  ///@}
+  /** @name Averaging schedule */
+  ///@{
+  /** @brief Set the number of local steps until the next average. */
+  void update_sync_interval(ExeContextType& context) const;
+  /** @brief Count a finished local step.
+   *  @returns Whether the models are due to be averaged.
+   */
+  bool count_local_step(ExeContextType& context) const;
+  /** @brief Advance the schedule after the models are averaged. */
+  void finish_average(ExeContextType& context) const;
+  ///@}
+
+protected:
+
+  /** @brief Train model on one step / mini-batch of an SGD forward pass */
+  bool train_mini_batch(
+    ExeContextType& c,
+    model& model,
+    data_coordinator& dc);
+
+  /** @name Callback hooks */
+  ///@{
+  /** Execute callbacks at start of training. */
+  void do_train_begin_cbs(model& model);
+  /** Execute callbacks at end of training. */
+  void do_train_end_cbs(model& model);
+  /** Execute callbacks at start of epoch. */
+  void do_epoch_begin_cbs(model& model);
+  /** Execute callbacks at end of epoch. */
+  void do_epoch_end_cbs(model& model);
+  /** Execute callbacks at start of mini-batch. */
+  void do_batch_begin_cbs(model& model);
+  /** Execute callbacks at end of mini-batch. */
+  void do_batch_end_cbs(model& model);
+  ///@}
+
+  /** @brief Covariant return-friendly implementation of
+   *         `get_new_exection_context()`.
+   */
+  local_sgd::ExecutionContext* do_get_new_execution_context() const final;
+
+private:
+
+  /** @brief Average weights (and optimizer state) over all trainers. */
+  void average_models(ExeContextType& context, model& model) const;
+
+  /** @brief The stopping criteria of the local steps. */
+  std::unique_ptr<TermCriteriaType> m_stopping_criteria;
+
+  /** @brief Initial number of local steps between model averages. */
+  size_t m_sync_interval;
+
+  /** @brief Largest number of local steps between model averages. */
+  size_t m_max_sync_interval;
+
+  /** @brief Number of model averages after which the interval is
+   *  doubled. Zero keeps it fixed. */
+  size_t m_sync_interval_growth_period;
+
+  /** @brief Number of initial steps that are each followed by a
+   *  model average. */
+  size_t m_warmup_steps;
+
+  /** @brief Whether to average optimizer state with the weights. */
+  bool m_average_optimizer_state;
+
+}; // class LocalSGD
+
+} // namespace lbann
+
+/** @brief Build the local SGD training algorithm from a protobuf
+ *         message.
+ */
+template <>
+std::unique_ptr<lbann::LocalSGD>
+lbann::make<lbann::LocalSGD>(google::protobuf::Message const& msg);
+
+#endif // LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_HPP_INCLUDED
@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_EXECUTION_CONTEXT_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_EXECUTION_CONTEXT_HPP_INCLUDED
+
+#include "lbann/execution_contexts/execution_context.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include <memory>
+#include <string>
+
+// Forward declarations
+namespace lbann {
+class LocalSGD;
+}
+
+namespace lbann {
+namespace local_sgd {
+
+#ifdef LBANN_HAS_GPU
+constexpr El::Device Device = El::Device::GPU;
+#else
+constexpr El::Device Device = El::Device::CPU;
+#endif // LBANN_HAS_GPU
+
+/** @class ExecutionContext
+ *  @brief The execution context for a local SGD algorithm.
+ *
+ *  Wraps the SGD execution context of the local steps and tracks
+ *  the model averaging schedule. The step count of this context is
+ *  the number of model averages.
+ */
+class ExecutionContext final : public lbann::execution_context
+{
+public:
+  friend class ::lbann::LocalSGD;
+
+  /** Constructor. */
+  ExecutionContext(size_t mini_batch_size);
+  /** Destructor. */
+  ~ExecutionContext() = default;
+
+  /** Copy constructor -- deleted. */
+  ExecutionContext(const ExecutionContext& other) = delete;
+  /** Copy assignment operator -- deleted. */
+  ExecutionContext& operator=(const ExecutionContext& other) = delete;
+
+  /** Get a "clean" execution_context of the same type. */
+  std::unique_ptr<lbann::execution_context> get_new() const override;
+
+  /** @brief Get a string identifying the type of execution context.
+   *  @details Should match the training algorithm.
+   */
+  std::string get_type() const override;
+
+  /** @brief Return the state of the execution context as a string */
+  std::string get_state_string() const noexcept override;
+
+  execution_mode get_execution_mode() const noexcept override
+  {
+    return m_sgd_execution_context.get_execution_mode();
+  }
+
+  /** @brief Return execution context for SGD-family training algorithm. */
+  inline sgd_execution_context& get_sgd_execution_context() noexcept
+  {
+    return m_sgd_execution_context;
+  }
+
+  /** @brief Number of local steps between model averages. */
+  size_t get_sync_interval() const noexcept { return m_sync_interval; }
+
+  /** @brief Number of local steps since the last model average. */
+  size_t get_steps_since_average() const noexcept
+  {
+    return m_steps_since_average;
+  }
+
+  /** @name Checkpointing and Serialization */
+  ///@{
+
+  /** Archive for checkpoint and restart */
+  template <class Archive> void serialize(Archive& ar);
+
+  /** @brief Checkpoint exection_context to a shared checkpoint. */
+  void save_to_checkpoint_shared(persist& p) override;
+  /** @brief Restore execution_context from a shared checkpoint. */
+  void load_from_checkpoint_shared(persist& p) override;
+  /** @brief Checkpoint exection_context to a distributed checkpoint. */
+  void save_to_checkpoint_distributed(persist& p) override;
+  /** @brief Restore execution_context from a distributed checkpoint. */
+  void load_from_checkpoint_distributed(persist& p) override;
+  ///@}
+
+private:
+
+  sgd_execution_context m_sgd_execution_context;
+
+  /** @brief The current number of local steps between model
+   *  averages. */
+  size_t m_sync_interval = 1;
+
+  /** @brief Number of local steps since the last model average. */
+  size_t m_steps_since_average = 0;
+
+  /** @brief Number of model averages after the warmup steps. */
+  size_t m_num_local_rounds = 0;
+
+  /** @brief Packed weights (and optimizer state) for the fused
+   *  allreduce. Not checkpointed. */
+  El::Matrix<DataType, Device> m_average_buffer;
+
+  /** @brief Accumulated time spent averaging models. */
+  double m_average_time = 0.0;
+
+}; // class ExecutionContext
+
+} // namespace local_sgd
+} // namespace lbann
+#endif // LBANN_EXECUTION_ALGORITHMS_LOCAL_SGD_EXECUTION_CONTEXT_HPP_INCLUDED
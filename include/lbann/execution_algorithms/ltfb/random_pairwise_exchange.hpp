@@ -34,6 +34,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace lbann {
 namespace ltfb {
@@ -95,6 +96,60 @@ public:
     // Better API, but complicates "sendrecv_weights":
     // virtual std::unique_ptr<model> get_partner_model(
     //   lbann_comm const& c, El::Int partner_trainer);
+
+    /** @brief Begin exchanging models with a partner trainer.
+     *
+     *  Strategies that can communicate in the background post their
+     *  messages here so the transfer overlaps with the evaluation of
+     *  the local model. The default does nothing.
+     *
+     *  @param[in] m The local model.
+     *  @param[in] partner_trainer The ID of the partner trainer.
+     *  @param[in] step The LTFB step ID.
+     */
+    virtual void start_exchange(model const& /*m*/,
+                                El::Int /*partner_trainer*/,
+                                size_t /*step*/)
+    {}
+
+    /** @brief Complete an exchange begun with start_exchange.
+     *
+     *  The default calls get_partner_model.
+     *
+     *  @param[in] m The local model. It must not have been modified
+     *             since start_exchange.
+     *  @param[in] partner_trainer The ID of the partner trainer.
+     *  @param[in] step The LTFB step ID.
+     */
+    virtual std::unique_ptr<model>
+    finish_exchange(model const& m, El::Int partner_trainer, size_t step)
+    {
+      return get_partner_model(m, partner_trainer, step);
+    }
+
+    /** @brief Move a model in one direction between partners.
+     *
+     *  Used when only the tournament loser needs the winner's
+     *  model. Both partners must call this with opposite values of
+     *  @c send. The default performs the symmetric exchange and
+     *  discards the result on the sender.
+     *
+     *  @param[in] m The local model.
+     *  @param[in] partner_trainer The ID of the partner trainer.
+     *  @param[in] step The LTFB step ID.
+     *  @param[in] send Whether the local model is sent (true) or the
+     *             partner's model is received (false).
+     *  @returns The partner model on the receiver, nullptr on the
+     *           sender.
+     */
+    virtual std::unique_ptr<model> transfer_model(model const& m,
+                                                  El::Int partner_trainer,
+                                                  size_t step,
+                                                  bool send)
+    {
+      auto partner_model = get_partner_model(m, partner_trainer, step);
+      return (send ? nullptr : std::move(partner_model));
+    }
   protected:
     /** @brief Access weights_names. */
     std::set<std::string> const& weights_names() const noexcept
@@ -112,6 +167,17 @@ public:
     HIGHER_IS_BETTER,
   }; // enum class metric_strategy
 
+  /** @brief How partners decide the tournament winner. */
+  enum class tournament_protocol
+  {
+    /** @brief Exchange models and evaluate both on the local
+     *         tournament set. */
+    EXCHANGE_MODELS,
+    /** @brief Evaluate only the local model, exchange scores, and
+     *         transfer the winning model to the loser. */
+    EXCHANGE_SCORES,
+  }; // enum class tournament_protocol
+
 public:
   /** @name Life-cycle management */
   ///@{
@@ -122,10 +188,13 @@ public:
    *  @param[in] winner_strategy Strategy for determining the winner
    *             of a tournament.
    *  @param[in] comm_algo Algorithm for exchanging models.
+   *  @param[in] protocol How partners decide the winner.
    */
-  RandomPairwiseExchange(std::string metric_name,
-                         metric_strategy winner_strategy,
-                         std::unique_ptr<ExchangeStrategy> comm_algo);
+  RandomPairwiseExchange(
+    std::string metric_name,
+    metric_strategy winner_strategy,
+    std::unique_ptr<ExchangeStrategy> comm_algo,
+    tournament_protocol protocol = tournament_protocol::EXCHANGE_MODELS);
 
   /** @brief Constructor
    *  @param[in] metrics The list of metric/strategy pairs. A metric
@@ -134,10 +203,12 @@ public:
    *             model must win ALL of the metric comparisons to be
    *             declared the winner.
    *  @param[in] comm_algo Algorithm for exchanging models.
+   *  @param[in] protocol How partners decide the winner.
    */
   RandomPairwiseExchange(
     std::unordered_map<std::string, metric_strategy> metrics,
-    std::unique_ptr<ExchangeStrategy> comm_algo);
+    std::unique_ptr<ExchangeStrategy> comm_algo,
+    tournament_protocol protocol = tournament_protocol::EXCHANGE_MODELS);
 
   ~RandomPairwiseExchange() = default;
   RandomPairwiseExchange(RandomPairwiseExchange const& other);
@@ -176,6 +247,16 @@ private:
     std::unordered_map<std::string, EvalType> const& local_scores,
     std::unordered_map<std::string, EvalType> const& partner_scores) const;
 
+  /** @brief Send the local scores to the partner trainer and receive
+   *         its scores in return. */
+  std::unordered_map<std::string, EvalType>
+  exchange_scores(lbann_comm const& comm,
+                  std::unordered_map<std::string, EvalType> const& local_scores,
+                  El::Int partner_trainer) const;
+
+  /** @brief Replace the local model with the tournament winner. */
+  void adopt_partner_model(model& m, model& partner_model) const;
+
 private:
   /** @brief The list of metric/strategy pairs.
    *
@@ -194,10 +275,21 @@ private:
    */
   std::unique_ptr<ExchangeStrategy> m_comm_algo;
 
+  /** @brief How partners decide the tournament winner. */
+  tournament_protocol m_protocol;
+
 }; // class RandomPairwiseExchange
 
 /** @class SendRecvWeights
  *  @brief Exchange model weights directly using sendrecvs.
+ *
+ *  By default, each weights object (and each optimizer state matrix)
+ *  is exchanged with its own blocking sendrecv. In single-message
+ *  mode, the local weights values and SGD/Adam state are packed into
+ *  one contiguous host buffer that is exchanged with a single
+ *  non-blocking send/receive pair. The transfer is started before
+ *  the local model is evaluated and completed afterwards.
+ *
  *  @todo More general approach to exchange optimizer state. Currently
  *  only SGD and Adam are supported.
  */
@@ -213,28 +305,92 @@ public:
    *                           then all weights are exchanged.
    *  @param[in] exchange_hyperparameters Exchange optimizer
    *                                      hyperparameters.
+   *  @param[in] single_message Pack the exchange into one
+   *                            non-blocking message.
    */
   SendRecvWeights(std::set<std::string> const& weights_names,
-                  bool exchange_hyperparameters);
+                  bool exchange_hyperparameters,
+                  bool single_message = false);
 
   /** @brief Construct from weights names
    *  @param[in] weights_names Names of weights to exchange. If empty,
    *                           then all weights are exchanged.
    *  @param[in] exchange_hyperparameters Exchange optimizer
    *                                      hyperparameters.
+   *  @param[in] single_message Pack the exchange into one
+   *                            non-blocking message.
    */
   SendRecvWeights(std::set<std::string>&& weights_names,
-                  bool exchange_hyperparameters);
+                  bool exchange_hyperparameters,
+                  bool single_message = false);
 
   SendRecvWeights(SendRecvWeights const&) = default;
   SendRecvWeights(SendRecvWeights&&) = default;
 
   std::unique_ptr<model> get_partner_model(model const& m,
                                            El::Int partner_trainer,
-                                           size_t /*step*/) final;
+                                           size_t step) final;
+
+  void start_exchange(model const& m,
+                      El::Int partner_trainer,
+                      size_t step) final;
+  std::unique_ptr<model> finish_exchange(model const& m,
+                                         El::Int partner_trainer,
+                                         size_t step) final;
+  std::unique_ptr<model> transfer_model(model const& m,
+                                        El::Int partner_trainer,
+                                        size_t step,
+                                        bool send) final;
+
+private:
+  /** @brief Agree with the partner on how each optimizer is
+   *         exchanged.
+   *  @returns The number of entries in the packed buffer.
+   */
+  size_t setup_packed_exchange(model const& m, El::Int partner_trainer);
+  /** @brief Pack local weights into the send buffer. */
+  void pack_weights(model const& m);
+  /** @brief Unpack the receive buffer into a model's weights.
+   *
+   *  Optimizers that could not be packed are exchanged (or received)
+   *  with a binary archive.
+   */
+  void unpack_weights(model& partner_model,
+                      El::Int partner_trainer,
+                      bool symmetric);
+
+  /** @brief Exchange weights with one blocking sendrecv per matrix. */
+  std::unique_ptr<model> exchange_per_weights(model const& m,
+                                              El::Int partner_trainer);
+
+  /** @brief Whether a weights object is selected for exchange. */
+  bool is_selected(weights const& w) const;
 
 private:
   bool exchange_hyperparams_;
+  bool single_message_;
+
+  /** @brief How a weights object's optimizer state is exchanged. */
+  enum class optimizer_exchange
+  {
+    /** @brief No optimizer, or an unsupported one. */
+    NONE,
+    /** @brief SGD/Adam state packed into the single message. */
+    PACKED,
+    /** @brief Whole optimizer sent with a binary archive. */
+    ARCHIVE,
+  };
+
+  /** @name State of an in-flight single-message exchange */
+  ///@{
+  bool exchange_started_ = false;
+  El::Int exchange_partner_ = -1;
+  /** @brief Optimizer exchange for each selected weights object. */
+  std::vector<optimizer_exchange> optimizer_exchange_;
+  std::vector<DataType> send_buffer_;
+  std::vector<DataType> recv_buffer_;
+  std::vector<El::mpi::Request<DataType>> requests_;
+  ///@}
 }; // class SendRecvWeights
 
 /// See @c lbann::callbacks::ltfb::communication_algorithm::checkpoint_file
@@ -268,6 +424,10 @@ public:
   std::unique_ptr<model> get_partner_model(model const& m,
                                            El::Int partner_trainer,
                                            size_t /*step*/) final;
+  std::unique_ptr<model> transfer_model(model const& m,
+                                        El::Int partner_trainer,
+                                        size_t /*step*/,
+                                        bool send) final;
 }; // class CheckpointBinary
 
 } // namespace ltfb
@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_PIPELINE_PARALLEL_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_PIPELINE_PARALLEL_HPP_INCLUDED
+
+#include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/execution_algorithms/factory.hpp"
+#include "lbann/execution_algorithms/pipeline_parallel/execution_context.hpp"
+#include "lbann/execution_algorithms/training_algorithm.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/cloneable.hpp"
+#include "lbann/utils/make_abstract.hpp"
+
+#include <google/protobuf/message.h>
+#include <memory>
+
+namespace lbann {
+
+/** @class PipelineParallel
+ *  @brief Pipeline-parallel SGD with a 1F1B micro-batch schedule.
+ *
+ *  The layers of the model are split into contiguous stages of
+ *  roughly equal estimated cost and each trainer executes one stage.
+ *  Every trainer holds the whole model, but only runs and updates
+ *  its own layers; the ranks of a trainer still split each stage
+ *  with the usual data and model parallel distributions. Tensors
+ *  that cross a stage boundary are sent with non-blocking
+ *  point-to-point messages between the ranks with the same rank in
+ *  trainer, so all trainers must have the same number of processes.
+ *
+ *  The trainer mini-batch size is the micro-batch size. Each step
+ *  feeds @f$ M @f$ micro-batches through the pipeline: stage @f$ s
+ *  @f$ of @f$ S @f$ keeps at most @f$ S-s @f$ micro-batches in
+ *  flight, alternating one forward and one backward pass once the
+ *  pipeline is full. Gradients are accumulated over the micro-batches
+ *  and the stage's weights are updated once per step. Stages other
+ *  than the last keep only the tensors entering the stage and
+ *  recompute forward prop before each backward pass, so layers of
+ *  those stages must be able to recompute their forward prop.
+ *
+ *  Input layers are placed in the first stage and evaluation layers
+ *  in the last, which reports the objective function and metrics.
+ *  Weights are synchronized across trainers at the end of each epoch
+ *  and of training.
+ *
+ *  Narayanan, Deepak, et al. "PipeDream: Generalized pipeline
+ *  parallelism for DNN training." Proceedings of the 27th ACM
+ *  Symposium on Operating Systems Principles. 2019.
+ *
+ *  Huang, Yanping, et al. "GPipe: Efficient training of giant neural
+ *  networks using pipeline parallelism." Advances in Neural
+ *  Information Processing Systems. 2019.
+ */
+class PipelineParallel final
+  : public Cloneable<PipelineParallel, training_algorithm>
+{
+  using BaseType = Cloneable<PipelineParallel, training_algorithm>;
+
+public:
+  using TermCriteriaType = sgd_termination_criteria;
+  using ExeContextType = pipeline_parallel::ExecutionContext;
+
+public:
+  /** @name Life-cycle management */
+  ///@{
+  /** @brief Construct pipeline-parallel SGD from its component pieces.
+   *  @param stop Stopping criteria for the steps.
+   *  @param num_micro_batches Number of micro-batches per step.
+   */
+  PipelineParallel(std::string name,
+                   std::unique_ptr<TermCriteriaType> stop,
+                   size_t num_micro_batches);
+
+  PipelineParallel(PipelineParallel const& other);
+  PipelineParallel& operator=(const PipelineParallel& other);
+  ~PipelineParallel() noexcept = default;
+  ///@}
+  /** @brief Queries */
+  ///@{
+  std::string get_type() const final;
+  ///@}
+  /** @name Apply interface */
+  ///@{
+  /** @brief Apply the training algorithm to refine model weights.
+   *  @param[in,out] context The persistent execution context for this
+   *                 algorithm.
+   *  @param[in,out] m The model to be trained.
+   *  @param[in,out] dc The data source for training.
+   *  @param[in] mode Completely superfluous.
+   */
+  void apply(execution_context& context,
+             model& m,
+             data_coordinator& dc,
+             execution_mode mode) final;
+  /** @brief Train a model with pipeline parallelism. */
+  void train(ExeContextType& c,
+             model& model,
+             data_coordinator& dc,
+             TermCriteriaType const& term);
+  ///@}
+
+protected:
+
+  /** @brief Train model on one step of micro-batches.
+   *  @returns Whether the data coordinator reached the end of an
+   *           epoch.
+   */
+  bool train_mini_batch(
+    ExeContextType& c,
+    model& model,
+    data_coordinator& dc);
+
+  /** @name Callback hooks */
+  ///@{
+  /** Execute callbacks at start of training. */
+  void do_train_begin_cbs(model& model);
+  /** Execute callbacks at end of training. */
+  void do_train_end_cbs(model& model);
+  /** Execute callbacks at start of epoch. */
+  void do_epoch_begin_cbs(model& model);
+  /** Execute callbacks at end of epoch. */
+  void do_epoch_end_cbs(model& model);
+  /** Execute callbacks at start of mini-batch. */
+  void do_batch_begin_cbs(model& model);
+  /** Execute callbacks at end of mini-batch. */
+  void do_batch_end_cbs(model& model);
+  ///@}
+
+  /** @brief Covariant return-friendly implementation of
+   *         `get_new_exection_context()`.
+   */
+  pipeline_parallel::ExecutionContext* do_get_new_execution_context() const final;
+
+private:
+
+  /** @brief Assign layers and weights to stages and find the tensors
+   *         that cross stage boundaries.
+   */
+  void partition_model(ExeContextType& context, model& model) const;
+
+  /** @brief Forward pass of the next micro-batch through this stage.
+   *  @returns Whether it is the last micro-batch of the step and
+   *           whether it ends the epoch.
+   */
+  std::pair<bool, bool> forward_micro_batch(ExeContextType& context,
+                                            model& model,
+                                            data_coordinator& dc,
+                                            El::Int index) const;
+
+  /** @brief Backward pass of the oldest in-flight micro-batch. */
+  void backward_micro_batch(ExeContextType& context, model& model) const;
+
+  /** @brief Redo forward prop of the oldest in-flight micro-batch
+   *         from the tensors entering this stage.
+   */
+  void recompute_micro_batch(ExeContextType& context, model& model) const;
+
+  /** @brief Send every weights object from the stage that updates
+   *         it to all other stages.
+   */
+  void synchronize_weights(ExeContextType& context, model& model) const;
+
+  /** @brief The stopping criteria of the steps. */
+  std::unique_ptr<TermCriteriaType> m_stopping_criteria;
+
+  /** @brief Number of micro-batches per step. */
+  size_t m_num_micro_batches;
+
+}; // class PipelineParallel
+
+} // namespace lbann
+
+/** @brief Build the pipeline-parallel training algorithm from a
+ *         protobuf message.
+ */
+template <>
+std::unique_ptr<lbann::PipelineParallel>
+lbann::make<lbann::PipelineParallel>(google::protobuf::Message const& msg);
+
+#endif // LBANN_EXECUTION_ALGORITHMS_PIPELINE_PARALLEL_HPP_INCLUDED
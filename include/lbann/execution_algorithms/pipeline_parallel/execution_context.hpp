@@ -0,0 +1,213 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_PIPELINE_PARALLEL_EXECUTION_CONTEXT_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_PIPELINE_PARALLEL_EXECUTION_CONTEXT_HPP_INCLUDED
+
+#include "lbann/execution_contexts/execution_context.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Forward declarations
+namespace lbann {
+class Layer;
+class PipelineParallel;
+class weights;
+}
+
+namespace lbann {
+namespace pipeline_parallel {
+
+/** @brief Host buffer for tensors exchanged between stages. */
+using BufferType = El::Matrix<DataType, El::Device::CPU>;
+
+/** @brief A tensor that crosses a stage boundary.
+ *
+ *  Activations flow from @c parent to @c child and error signals
+ *  flow back. The remote stage is the stage of whichever layer is
+ *  not in this stage.
+ */
+struct Edge
+{
+  Layer* parent;
+  Layer* child;
+  /** @brief Index of @c child among the parent's children. */
+  int child_index;
+  /** @brief Index of @c parent among the child's parents. */
+  int parent_index;
+  /** @brief Pipeline stage on the other side of the edge. */
+  int remote_stage;
+};
+
+/** @brief State of a micro-batch between its forward and backward
+ *         passes through this stage.
+ */
+struct MicroBatch
+{
+  /** @brief Position in the current step. */
+  El::Int index = 0;
+  /** @brief Number of samples. */
+  El::Int size = 0;
+  /** @brief Tensors entering this stage, kept for recomputation. */
+  std::vector<BufferType> inputs;
+};
+
+/** @class ExecutionContext
+ *  @brief The execution context for pipeline-parallel training.
+ *
+ *  Wraps the SGD execution context and holds the stage assignment
+ *  and in-flight micro-batches of this trainer. Only the SGD context
+ *  is checkpointed; the stage assignment is recomputed at the start
+ *  of training.
+ */
+class ExecutionContext final : public lbann::execution_context
+{
+public:
+  friend class ::lbann::PipelineParallel;
+
+  /** Constructor. */
+  ExecutionContext(size_t mini_batch_size);
+  /** Destructor. */
+  ~ExecutionContext() = default;
+
+  /** Copy constructor -- deleted. */
+  ExecutionContext(const ExecutionContext& other) = delete;
+  /** Copy assignment operator -- deleted. */
+  ExecutionContext& operator=(const ExecutionContext& other) = delete;
+
+  /** Get a "clean" execution_context of the same type. */
+  std::unique_ptr<lbann::execution_context> get_new() const override;
+
+  /** @brief Get a string identifying the type of execution context.
+   *  @details Should match the training algorithm.
+   */
+  std::string get_type() const override;
+
+  /** @brief Return the state of the execution context as a string */
+  std::string get_state_string() const noexcept override;
+
+  execution_mode get_execution_mode() const noexcept override
+  {
+    return m_sgd_execution_context.get_execution_mode();
+  }
+
+  /** @brief Return execution context for SGD-family training algorithm. */
+  inline sgd_execution_context& get_sgd_execution_context() noexcept
+  {
+    return m_sgd_execution_context;
+  }
+
+  /** @brief Pipeline stage of this trainer. */
+  int get_stage() const noexcept { return m_stage; }
+
+  /** @brief Number of pipeline stages. */
+  int get_num_stages() const noexcept { return m_num_stages; }
+
+  /** @name Checkpointing and Serialization */
+  ///@{
+
+  /** Archive for checkpoint and restart */
+  template <class Archive> void serialize(Archive& ar);
+
+  /** @brief Checkpoint exection_context to a shared checkpoint. */
+  void save_to_checkpoint_shared(persist& p) override;
+  /** @brief Restore execution_context from a shared checkpoint. */
+  void load_from_checkpoint_shared(persist& p) override;
+  /** @brief Checkpoint exection_context to a distributed checkpoint. */
+  void save_to_checkpoint_distributed(persist& p) override;
+  /** @brief Restore execution_context from a distributed checkpoint. */
+  void load_from_checkpoint_distributed(persist& p) override;
+  ///@}
+
+private:
+
+  sgd_execution_context m_sgd_execution_context;
+
+  /** @brief Pipeline stage of this trainer. */
+  int m_stage = 0;
+
+  /** @brief Number of pipeline stages. */
+  int m_num_stages = 1;
+
+  /** @brief Layers of this stage, in execution order. */
+  std::vector<Layer*> m_layers;
+
+  /** @brief Weights updated by this stage. */
+  std::vector<weights*> m_weights;
+
+  /** @brief Pipeline stage that updates each weights object. */
+  std::unordered_map<weights const*, int> m_weights_stage;
+
+  /** @brief Outputs of input layers in this stage.
+   *  @details Kept for recomputation since input layers cannot be
+   *  rerun without fetching new data.
+   */
+  std::vector<Edge> m_stage_inputs;
+  /** @brief Activations received from earlier stages. */
+  std::vector<Edge> m_recv_activations;
+  /** @brief Activations sent to later stages. */
+  std::vector<Edge> m_send_activations;
+  /** @brief Error signals received from later stages. */
+  std::vector<Edge> m_recv_error_signals;
+  /** @brief Error signals sent to earlier stages. */
+  std::vector<Edge> m_send_error_signals;
+
+  /** @brief Mini-batch size that normalizes the accumulated
+   *         gradient. */
+  El::Int m_effective_mini_batch_size = 0;
+
+  /** @brief Micro-batches forwarded but not yet backpropagated. */
+  std::deque<MicroBatch> m_in_flight;
+
+  /** @brief Index of the micro-batch whose activations are held by
+   *         the layers of this stage. */
+  El::Int m_resident_micro_batch = -1;
+
+  /** @brief Outgoing messages of the current step.
+   *  @details Buffers must stay alive until their sends complete.
+   */
+  std::list<BufferType> m_send_buffers;
+  std::vector<El::mpi::Request<DataType>> m_send_requests;
+  std::list<std::vector<El::Int>> m_header_buffers;
+  std::vector<El::mpi::Request<El::Int>> m_header_requests;
+
+  /** @brief Accumulated time blocked on messages from other stages. */
+  double m_wait_time = 0.0;
+
+  /** @brief Accumulated time recomputing forward prop. */
+  double m_recompute_time = 0.0;
+
+}; // class ExecutionContext
+
+} // namespace pipeline_parallel
+} // namespace lbann
+#endif // LBANN_EXECUTION_ALGORITHMS_PIPELINE_PARALLEL_EXECUTION_CONTEXT_HPP_INCLUDED
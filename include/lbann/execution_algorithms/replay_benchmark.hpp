@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_REPLAY_BENCHMARK_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_REPLAY_BENCHMARK_HPP_INCLUDED
+
+#include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/execution_algorithms/factory.hpp"
+#include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/cloneable.hpp"
+
+#include <google/protobuf/message.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @class ReplayBenchmark
+ *  @brief Reproducible measurement of the training step time.
+ *
+ *  Training throughput varies between runs because of the data
+ *  reader shuffle, the I/O thread count and placement, and the
+ *  evaluations interleaved with training. This algorithm removes
+ *  those sources of noise so two builds or configurations can be
+ *  compared:
+ *
+ *  - The order of the training samples is read from an index file.
+ *    If the file does not exist, the current order is recorded in it
+ *    instead. Either way, shuffling is disabled, so every epoch sees
+ *    the same sequence.
+ *  - The number of I/O and OpenMP threads is printed, along with a
+ *    warning if either is not pinned to cores (I/O threads are
+ *    pinned when LBANN is built with hwloc, OpenMP threads with
+ *    @c OMP_PROC_BIND).
+ *  - Only training steps are run: a fixed number of untimed warmup
+ *    steps followed by a fixed window of timed steps, with no
+ *    validation or testing.
+ *
+ *  Each timed step is measured on every process, with GPUs
+ *  synchronized, and the slowest process gives the step time. The
+ *  trainer master prints the median step time with a 95%
+ *  distribution-free confidence interval, along with the mean,
+ *  standard deviation, and extremes.
+ */
+class ReplayBenchmark final
+  : public Cloneable<ReplayBenchmark, sgd_training_algorithm>
+{
+  using BaseType = Cloneable<ReplayBenchmark, sgd_training_algorithm>;
+
+public:
+  /** @brief Construct the benchmark.
+   *  @param index_file Training sample order to replay or record.
+   *  @param num_steps Timed steps.
+   *  @param num_warmup_steps Untimed steps before the timed steps.
+   */
+  ReplayBenchmark(std::string name,
+                  std::string index_file,
+                  size_t num_steps,
+                  size_t num_warmup_steps);
+
+  ReplayBenchmark(ReplayBenchmark const& other) = default;
+  ReplayBenchmark& operator=(ReplayBenchmark const& other) = default;
+  ~ReplayBenchmark() noexcept = default;
+
+  std::string get_type() const final;
+
+  /** @brief Run the benchmark when training.
+   *
+   *  Evaluation modes run as in SGD.
+   */
+  void apply(execution_context& context,
+             model& m,
+             data_coordinator& dc,
+             execution_mode mode) final;
+
+  /** @brief Summary statistics of a set of step times. */
+  struct statistics
+  {
+    double median = 0;
+    /** @brief Lower end of the 95% confidence interval of the median. */
+    double median_lower = 0;
+    /** @brief Upper end of the 95% confidence interval of the median. */
+    double median_upper = 0;
+    double mean = 0;
+    double stdev = 0;
+    double min = 0;
+    double max = 0;
+  };
+
+  /** @brief Compute summary statistics of step times.
+   *
+   *  The confidence interval of the median is taken from order
+   *  statistics, so it makes no assumption about the distribution
+   *  of the times.
+   */
+  static statistics get_statistics(std::vector<double> times);
+
+private:
+
+  /** @brief Replay or record the training sample order. */
+  void setup_sample_order(lbann_comm& comm, data_coordinator& dc) const;
+
+  /** @brief Report the thread counts and whether they are pinned. */
+  void check_threads(lbann_comm& comm) const;
+
+  /** @brief Training sample order file. */
+  std::string m_index_file;
+  /** @brief Timed steps. */
+  size_t m_num_steps;
+  /** @brief Untimed steps before the timed steps. */
+  size_t m_num_warmup_steps;
+
+}; // class ReplayBenchmark
+
+} // namespace lbann
+
+/** @brief Build the replay benchmark from a protobuf message. */
+template <>
+std::unique_ptr<lbann::ReplayBenchmark>
+lbann::make<lbann::ReplayBenchmark>(google::protobuf::Message const& msg);
+
+#endif // LBANN_EXECUTION_ALGORITHMS_REPLAY_BENCHMARK_HPP_INCLUDED
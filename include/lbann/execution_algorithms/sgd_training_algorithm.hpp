@@ -103,6 +103,12 @@ public:
   }
 
 protected:
+  /** Stopping criteria of the training loop */
+  sgd_termination_criteria const& get_stopping_criteria() const noexcept
+  {
+    return *m_stopping_criteria;
+  }
+
   /** Train model on one step / mini-batch of an SGD forward pass */
   virtual bool train_mini_batch(sgd_execution_context& c,
                                 model& model,
@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_IO_WEIGHTS_BUNDLE_HPP_INCLUDED
+#define LBANN_IO_WEIGHTS_BUNDLE_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class lbann_comm;
+class model;
+
+/** @brief File with the values of all weights in a model.
+ *
+ *  Weights bundles are meant for fast startup. The file begins with a
+ *  fixed-size header and an index of named tensors, followed by the
+ *  tensors themselves. Each tensor is stored contiguously in
+ *  column-major order at an offset aligned to @c alignment, so a
+ *  memory-mapped bundle can be used directly as the weight values.
+ *
+ *  @verbatim
+ *  header:  magic (8 bytes), version (uint32), number of tensors
+ *           (uint32), index size in bytes (uint64)
+ *  index:   per tensor, data type (uint32), name length (uint32),
+ *           height (uint64), width (uint64), offset (uint64),
+ *           followed by the name
+ *  tensors: aligned, contiguous values
+ *  @endverbatim
+ *
+ *  Integers are stored in the byte order of the writing system.
+ */
+class weights_bundle {
+public:
+
+  /** @brief Data type of a tensor in the bundle. */
+  enum class data_type : uint32_t { float32 = 1, float64 = 2, float16 = 3 };
+
+  /** @brief Index entry for a tensor in the bundle. */
+  struct entry {
+    std::string name;
+    data_type type;
+    El::Int height;
+    El::Int width;
+    /** @brief Offset of the values from the start of the file. */
+    size_t offset;
+  };
+
+  /** @brief Alignment of tensors in the file.
+   *  @details A multiple of the page size on common systems.
+   */
+  static constexpr size_t alignment = 4096;
+
+  /** @brief Standard name of a bundle within a checkpoint directory. */
+  static constexpr char const* file_name = "weights.lbw";
+
+  /** @brief Map a bundle file into memory.
+   *
+   *  The mapping is private and copy-on-write: pages are shared with
+   *  other processes on the node until they are modified.
+   */
+  static std::shared_ptr<weights_bundle> map(std::string const& path);
+
+  /** @brief Parse the header and index of a bundle.
+   *
+   *  @param data Start of the bundle.
+   *  @param size Number of available bytes. Must include at least
+   *         the header and index.
+   */
+  static std::vector<entry> parse_index(unsigned char const* data,
+                                        size_t size);
+
+  /** @brief Size of the header and index at the start of a bundle.
+   *  @details Requires the first @c header_size bytes.
+   */
+  static size_t get_index_size(unsigned char const* data, size_t size);
+
+  /** @brief Size of the fixed header at the start of a bundle. */
+  static constexpr size_t header_size = 24;
+
+  weights_bundle(weights_bundle const&) = delete;
+  weights_bundle& operator=(weights_bundle const&) = delete;
+  ~weights_bundle();
+
+  std::vector<entry> const& get_entries() const noexcept { return m_entries; }
+
+  /** @brief Find a tensor by name.
+   *  @returns Null if the bundle has no tensor with that name.
+   */
+  entry const* find(std::string const& name) const;
+
+  /** @brief Start of the mapped file. */
+  unsigned char* data() const noexcept { return m_data; }
+  /** @brief Size of the mapped file in bytes. */
+  size_t size() const noexcept { return m_size; }
+
+private:
+  weights_bundle(unsigned char* data, size_t size);
+
+  unsigned char* m_data;
+  size_t m_size;
+  std::vector<entry> m_entries;
+};
+
+/** @brief How processes read a weights bundle. */
+enum class weights_bundle_access {
+  /** @brief Every process maps the file.
+   *
+   *  Replicated CPU weights view the mapping directly, without
+   *  copies. Best when the file is on node-local storage or cached,
+   *  since the file is read once per node.
+   */
+  map,
+  /** @brief The trainer master maps the file and broadcasts the
+   *  values to the rest of the trainer.
+   *
+   *  The file is read once per trainer, which avoids redundant reads
+   *  from a parallel file system.
+   */
+  broadcast
+};
+
+/** @brief Write the values of all weights in a model to a bundle.
+ *
+ *  Values are gathered to the trainer master, which writes the
+ *  file. Must be called by every process in the trainer.
+ */
+void write_weights_bundle(model const& m, std::string const& path);
+
+/** @brief Restore weight values from a bundle.
+ *
+ *  Weights are matched by name. Weights that are missing from the
+ *  bundle, or whose data type or dimensions differ, are left
+ *  unchanged. Must be called by every process in the trainer, once
+ *  the weight values exist (after setup or after loading from a
+ *  checkpoint).
+ *
+ *  @returns Number of weights restored.
+ */
+size_t read_weights_bundle(model& m,
+                           std::string const& path,
+                           weights_bundle_access access
+                           = weights_bundle_access::map);
+
+/** @brief Restore weight values from a bundle instead of a checkpoint.
+ *
+ *  Loading a checkpoint and then reading a bundle would read every
+ *  weight value twice. While an object of this class exists, weights
+ *  that are in the bundle are only resized when they are loaded from
+ *  a rooted binary archive, and their checkpointed values are
+ *  skipped. Call @c restore once the model is loaded.
+ *
+ *  Must be constructed by every process in the trainer.
+ */
+class weights_bundle_restore_scope {
+public:
+  weights_bundle_restore_scope(lbann_comm const& comm,
+                               std::string path,
+                               weights_bundle_access access
+                               = weights_bundle_access::map);
+  ~weights_bundle_restore_scope();
+  weights_bundle_restore_scope(weights_bundle_restore_scope const&) = delete;
+  weights_bundle_restore_scope&
+  operator=(weights_bundle_restore_scope const&) = delete;
+
+  /** @brief Whether to skip the checkpointed values of weights.
+   *
+   *  Called while weights are deserialized. Always false outside of
+   *  a scope.
+   */
+  static bool skip_values(std::string const& name);
+
+  /** @brief Read the skipped values from the bundle.
+   *
+   *  Reports an error if some skipped values could not be restored,
+   *  e.g. if the dimensions in the bundle differ.
+   *
+   *  @returns Number of weights restored.
+   */
+  size_t restore(model& m);
+
+private:
+  std::string m_path;
+  weights_bundle_access m_access;
+  /** @brief Names of the tensors in the bundle. */
+  std::unordered_set<std::string> m_names;
+  /** @brief Number of weights whose values were skipped. */
+  size_t m_num_skipped = 0;
+  /** @brief Enclosing scope. */
+  weights_bundle_restore_scope* m_parent;
+};
+
+} // namespace lbann
+
+#endif // LBANN_IO_WEIGHTS_BUNDLE_HPP_INCLUDED
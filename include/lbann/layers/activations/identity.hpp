@@ -60,6 +60,7 @@ public:
   std::string get_type() const override { return "identity"; }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool has_local_compute() const override { return true; }
 
   /** @name Serialization */
   ///@{
@@ -28,6 +28,7 @@
 #define LBANN_LAYERS_ACTIVATIONS_SOFTMAX_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
+#include "lbann/utils/hydrogen_utils.hpp"
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/dnn_enums.hpp"
 #if defined LBANN_HAS_DNN_LIB
@@ -112,6 +113,9 @@ public:
   std::string get_type() const final { return "softmax"; }
   data_layout get_data_layout() const final { return Layout; }
   El::Device get_device_allocation() const final { return Device; }
+  size_t get_host_workspace_bytes() const final {
+    return get_host_memory_bytes(m_workspace.get());
+  }
 
   void setup_dims(DataReaderMetaData& dr_metadata) final {
     data_type_layer<TensorDataType>::setup_dims(dr_metadata);
@@ -156,6 +156,47 @@ public:
    */
   void set_keep_error_signals(bool) override;
 
+  bool has_viewing_activations() const override;
+  size_t release_activations(bool release_outputs) override;
+  size_t get_host_activations_bytes() const override;
+  size_t get_host_error_signals_bytes() const override;
+
+  /** @brief Cost model of an entry-wise operation.
+   *
+   *  Layers that do not override the cost model are treated as one
+   *  operation per output entry in forward prop and two per input
+   *  entry in backward prop. Memory traffic covers the input,
+   *  output, and weights tensors.
+   */
+  double get_fp_flops(El::Int mini_batch_size) const override;
+  double get_bp_flops(El::Int mini_batch_size) const override;
+  double get_fp_bytes(El::Int mini_batch_size) const override;
+  double get_bp_bytes(El::Int mini_batch_size) const override;
+
+  /** @brief Set up a parent layer's output tensor as a view into
+   *  memory owned by this layer.
+   *
+   *  Called by a parent layer while it sets up its output tensors.
+   *  Layers that combine their inputs (e.g. concatenation) can
+   *  override this so that parents write directly into the combined
+   *  tensor. The layer must still handle inputs that are not views,
+   *  e.g. if the parent sets up its outputs itself. Parents may set
+   *  up their outputs concurrently, so the layer's state must not
+   *  change and the memory must already be allocated.
+   *
+   *  @param parent The parent layer.
+   *  @param parent_output The parent's output tensor for this layer,
+   *                       empty and with the parent's alignment.
+   *  @param mini_batch_size Current mini-batch size.
+   *  @returns Whether @c parent_output was set up as a view.
+   */
+  virtual bool view_parent_output_in_place(
+    const Layer& parent,
+    InputAbsDistMatrixType& parent_output,
+    El::Int mini_batch_size) const {
+    return false;
+  }
+
   /** @name Serialization */
   ///@{
 
@@ -234,6 +275,16 @@ protected:
    */
   void bp_compute() override;
 
+  /** @brief Whether previous error signals are kept after back prop.
+   *
+   *  Layers whose error signals are views into their previous error
+   *  signals (e.g. concatenation) can override this so that parents
+   *  view the error signals instead of deep-copying them. The
+   *  previous error signals are then not freed at the end of back
+   *  prop, but are replaced during the next back prop.
+   */
+  virtual bool keep_prev_error_signals() const { return false; }
+
   // ===========================================================
   // Protected Weights access functions
   // ===========================================================
@@ -134,6 +134,7 @@ class input_layer : public data_type_layer<TensorDataType> {
   // }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool can_recompute_forward_prop() const override { return false; }
 
   void setup_dims(DataReaderMetaData& dr_metadata) override;
 
@@ -151,6 +152,14 @@ class input_layer : public data_type_layer<TensorDataType> {
    */
   void set_samples(const El::AbstractDistMatrix<TensorDataType>& samples);
 
+  /** @brief Places labels or responses in the second output tensor
+   *  @param targets Distributed Matrix of targets
+   */
+  void set_targets(const El::AbstractDistMatrix<TensorDataType>& targets);
+
+  /** @brief Resume reading samples from the data coordinator */
+  void clear_samples() { m_samples_loaded = false; }
+
   /**
    * Get the dimensions of the underlying data.
    */
@@ -460,6 +460,94 @@ public:
   void unfreeze();
   bool is_frozen() const;
 
+  ///@}
+  /** @name Activation checkpointing */
+  ///@{
+
+  /** @brief Name of the recomputation segment containing this layer.
+   *
+   *  Layers with the same non-empty segment name form a segment
+   *  whose internal activations are released after forward prop and
+   *  recomputed during backward prop.
+   */
+  const std::string& get_checkpoint_segment() const noexcept {
+    return m_checkpoint_segment;
+  }
+  /** @brief Set the recomputation segment containing this layer. */
+  void set_checkpoint_segment(std::string segment) {
+    m_checkpoint_segment = std::move(segment);
+  }
+
+  /** @brief Whether forward prop can be repeated without changing the
+   *  result of training.
+   *
+   *  Layers that draw random numbers or update internal state during
+   *  forward prop must return false.
+   */
+  virtual bool can_recompute_forward_prop() const { return true; }
+
+  /** @brief Whether any output tensor is a view into another tensor. */
+  virtual bool has_viewing_activations() const { return false; }
+
+  /** @brief Whether forward and backward prop only operate on local
+   *  data.
+   *
+   *  Such layers do not communicate as long as their parents and
+   *  children have the same data layout and device, so they may run
+   *  on worker threads. Layers that can issue collectives (e.g.
+   *  statistics allreduces or redistributions) must return false.
+   *  Layers with weights may return true if they only accumulate
+   *  local contributions into the weights gradients, since the
+   *  gradient allreduces can be deferred by the model.
+   */
+  virtual bool has_local_compute() const { return false; }
+
+  /** @brief Release input and output tensors after forward prop.
+   *
+   *  The tensors are reconstructed by the next call to
+   *  @c forward_prop.
+   *
+   *  @param release_outputs If false, only the inputs are released.
+   *  @returns Number of bytes freed on this process.
+   */
+  virtual size_t release_activations(bool release_outputs) { return 0; }
+
+  /** @name Host memory accounting
+   *
+   *  Bytes of host memory owned by this layer on this process. Views
+   *  into other tensors and device memory are not counted.
+   */
+  ///@{
+
+  /** @brief Host memory in input and output tensors. */
+  virtual size_t get_host_activations_bytes() const { return 0; }
+  /** @brief Host memory in error signal tensors. */
+  virtual size_t get_host_error_signals_bytes() const { return 0; }
+  /** @brief Host memory in layer-specific workspace buffers. */
+  virtual size_t get_host_workspace_bytes() const { return 0; }
+
+  ///@}
+
+  /** @name Cost model
+   *
+   *  Analytical estimates of the work in one forward or backward
+   *  pass, summed over all processes in the trainer. Memory traffic
+   *  is the minimum needed to read and write each tensor once, so
+   *  caching effects and redundant passes are not counted.
+   */
+  ///@{
+
+  /** @brief Floating-point operations in forward prop. */
+  virtual double get_fp_flops(El::Int mini_batch_size) const { return 0; }
+  /** @brief Floating-point operations in backward prop. */
+  virtual double get_bp_flops(El::Int mini_batch_size) const { return 0; }
+  /** @brief Bytes moved to or from memory in forward prop. */
+  virtual double get_fp_bytes(El::Int mini_batch_size) const { return 0; }
+  /** @brief Bytes moved to or from memory in backward prop. */
+  virtual double get_bp_bytes(El::Int mini_batch_size) const { return 0; }
+
+  ///@}
+
   ///@}
 
   /** @brief Set whether to keep or dynamically reallocate error signals.
@@ -779,6 +867,9 @@ private:
   /** @brief Parallel strategy for the layer. */
   ParallelStrategy m_parallel_strategy;
 
+  /** @brief Name of the recomputation segment containing this layer. */
+  std::string m_checkpoint_segment;
+
 #ifdef LBANN_HAS_DISTCONV
  private:
   friend class distconv_adapter;
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_LAYERS_LEARNING_AFFINE_FOLDING_HPP_INCLUDED
+#define LBANN_LAYERS_LEARNING_AFFINE_FOLDING_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <vector>
+
+namespace lbann {
+
+/** @brief Interface for layers that can absorb a per-channel affine
+ *  transform into their weights.
+ *
+ *  If a layer is followed by an entry-wise transform
+ *  @f$ y_c \rightarrow a_c y_c + b_c @f$ with one scale and shift
+ *  per output channel (e.g. batch normalization outside of
+ *  training), the transform can be folded into the layer's weights
+ *  and bias. The following layer can then be removed from the
+ *  model.
+ */
+class affine_folding_layer {
+public:
+  virtual ~affine_folding_layer() = default;
+
+  /** @brief Fold a per-channel affine transform into the weights.
+   *
+   *  Must be called before setup, once the weights values are
+   *  available (e.g. after loading from a checkpoint). A bias is
+   *  added if the layer does not already have one.
+   *
+   *  @param scale Per-channel scaling factors.
+   *  @param shift Per-channel shifts.
+   *  @returns Whether the transform was folded.
+   */
+  virtual bool fold_channel_affine(const std::vector<double>& scale,
+                                   const std::vector<double>& shift) = 0;
+
+};
+
+/** @brief Apply a per-channel affine transform to a weights matrix.
+ *
+ *  Channels are contiguous groups of rows, or of columns if @c
+ *  channels_are_columns is set, of equal size. The matrix is
+ *  replicated on the host, modified, and copied back, so this is
+ *  only intended for one-time model transformations.
+ *
+ *  @param values Weights matrix.
+ *  @param scale Per-channel scaling factors.
+ *  @param shift Per-channel shifts. Ignored if empty.
+ *  @param channels_are_columns Whether channels are groups of
+ *  columns rather than groups of rows.
+ */
+template <typename TensorDataType>
+void apply_channel_affine(El::AbstractDistMatrix<TensorDataType>& values,
+                          const std::vector<double>& scale,
+                          const std::vector<double>& shift,
+                          bool channels_are_columns) {
+  const El::Int num_channels = scale.size();
+  const El::Int num_entries = (channels_are_columns
+                               ? values.Width()
+                               : values.Height());
+  if (num_channels == 0 || num_entries % num_channels != 0) {
+    LBANN_ERROR("attempted to split a ",
+                values.Height(), " x ", values.Width(), " matrix ",
+                "into ", num_channels, " channels");
+  }
+  const El::Int channel_size = num_entries / num_channels;
+
+  StarMatDT<TensorDataType, El::Device::CPU> replicated(values.Grid(),
+                                                        values.Root());
+  El::Copy(values, replicated);
+  auto& local_values = replicated.Matrix();
+  for (El::Int col = 0; col < local_values.Width(); ++col) {
+    for (El::Int row = 0; row < local_values.Height(); ++row) {
+      const auto c = (channels_are_columns ? col : row) / channel_size;
+      auto x = scale[c] * El::To<double>(local_values(row, col));
+      if (!shift.empty()) {
+        x += shift[c];
+      }
+      local_values(row, col) = El::To<TensorDataType>(x);
+    }
+  }
+  El::Copy(replicated, values);
+}
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_LEARNING_AFFINE_FOLDING_HPP_INCLUDED
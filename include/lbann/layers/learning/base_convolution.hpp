@@ -174,6 +174,11 @@ public:
   description get_description() const override;
   void setup_dims(DataReaderMetaData& dr_metadata) override;
 
+  /** @brief Data and kernel gradients each cost as much as forward
+   *  prop.
+   */
+  double get_bp_flops(El::Int mini_batch_size) const override;
+
   /** @brief Setup layer data.
    *  The kernel weights are setup in the convolution and
    *  deconvolution classes. */
@@ -27,9 +27,12 @@
 #ifndef LBANN_LAYERS_LEARNING_CONVOLUTION_HPP_INCLUDED
 #define LBANN_LAYERS_LEARNING_CONVOLUTION_HPP_INCLUDED
 
+#include "lbann/layers/learning/affine_folding.hpp"
 #include "lbann/layers/learning/base_convolution.hpp"
+#include "lbann/layers/learning/int8_inference.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/distconv.hpp"
+#include "lbann/utils/int8_quantization.hpp"
 
 namespace lbann {
 
@@ -61,12 +64,18 @@ public:
  *  Applies convolution (more precisely, cross-correlation) to input
  *  tensors. This is primarily optimized for image data in NCHW
  *  format.
+ *
+ *  The CPU implementation supports int8 inference. A following
+ *  per-channel affine transform (e.g. batch normalization) can be
+ *  folded into the kernel and bias for inference.
  */
 template <typename TensorDataType,
           data_layout Layout = data_layout::DATA_PARALLEL,
           El::Device Device = El::Device::CPU>
 class convolution_layer
-  : public base_convolution_layer<TensorDataType, Device> {
+  : public base_convolution_layer<TensorDataType, Device>,
+    public int8_inference_layer,
+    public affine_folding_layer {
 
   static_assert(Layout == data_layout::DATA_PARALLEL,
                 "convolution layer only supports DATA_PARALLEL");
@@ -103,6 +112,25 @@ public:
 
   El::Device get_device_allocation() const override { return Device; }
 
+  bool has_local_compute() const override { return Layout == data_layout::DATA_PARALLEL; }
+
+  double get_fp_flops(El::Int mini_batch_size) const override;
+
+  /** @name Int8 inference */
+  ///@{
+
+  float get_local_input_range() const override;
+  bool enable_int8_inference(float input_range) override;
+  void disable_int8_inference() override;
+  bool using_int8_inference() const noexcept override {
+    return m_int8_inference;
+  }
+
+  ///@}
+
+  bool fold_channel_affine(const std::vector<double>& scale,
+                           const std::vector<double>& shift) override;
+
   /** @name Serialization */
   ///@{
 
@@ -121,6 +149,24 @@ protected:
   void fp_compute() override;
   void bp_compute() override;
 
+private:
+
+  /** Whether int8 forward prop is used outside of training. */
+  bool m_int8_inference = false;
+  /** Scaling factor for quantized input tensor. */
+  float m_int8_input_scale = 1.f;
+  /** Kernel weights quantized per output channel.
+   *  @details Stored as a matrix with one column per output channel.
+   */
+  int8_quantized_matrix m_int8_kernel;
+  /** Workspace for quantized im2col matrix. */
+  std::vector<std::int8_t> m_int8_input_workspace;
+  /** Workspace for integer matrix product. */
+  std::vector<std::int32_t> m_int8_output_workspace;
+
+  /** Forward prop with quantized weights and inputs. */
+  void fp_compute_int8();
+
 #ifdef LBANN_HAS_DISTCONV
   friend class convolution_distconv_adapter<TensorDataType, Layout, Device>;
  protected:
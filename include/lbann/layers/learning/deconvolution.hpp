@@ -91,6 +91,8 @@ public:
 
   El::Device get_device_allocation() const override { return Device; }
 
+  double get_fp_flops(El::Int mini_batch_size) const override;
+
   void setup_dims(DataReaderMetaData& dr_metadata) override;
 
   /** @name Serialization */
@@ -28,7 +28,10 @@
 #define LBANN_LAYERS_LEARNING_FULLY_CONNECTED_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
+#include "lbann/layers/learning/affine_folding.hpp"
+#include "lbann/layers/learning/int8_inference.hpp"
 #include "lbann/models/model.hpp"
+#include "lbann/utils/int8_quantization.hpp"
 
 #include <string>
 
@@ -46,9 +49,15 @@ namespace lbann {
  *  applied. If weights aren't provided, the linearity weights are
  *  initialized with He normal initialization and the bias weights are
  *  initialized to zero.
+ *
+ *  The data-parallel CPU implementation supports int8 inference. A
+ *  following per-channel affine transform (e.g. batch normalization)
+ *  can be folded into the linearity and bias for inference.
  */
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
-class fully_connected_layer : public data_type_layer<TensorDataType> {
+class fully_connected_layer : public data_type_layer<TensorDataType>,
+                              public int8_inference_layer,
+                              public affine_folding_layer {
 public:
   /** @name Public Types */
   ///@{
@@ -86,9 +95,28 @@ public:
   std::string get_type() const override { return "fully connected"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool has_local_compute() const override { return T_layout == data_layout::DATA_PARALLEL; }
 
   description get_description() const override;
 
+  double get_fp_flops(El::Int mini_batch_size) const override;
+  double get_bp_flops(El::Int mini_batch_size) const override;
+
+  /** @name Int8 inference */
+  ///@{
+
+  float get_local_input_range() const override;
+  bool enable_int8_inference(float input_range) override;
+  void disable_int8_inference() override;
+  bool using_int8_inference() const noexcept override {
+    return m_int8_inference;
+  }
+
+  ///@}
+
+  bool fold_channel_affine(const std::vector<double>& scale,
+                           const std::vector<double>& shift) override;
+
   /** @name Serialization */
   ///@{
 
@@ -124,6 +152,20 @@ private:
   /** Whether the transpose of the linearity matrix is applied. */
   bool m_transpose;
 
+  /** Whether int8 forward prop is used outside of training. */
+  bool m_int8_inference = false;
+  /** Scaling factor for quantized input tensor. */
+  float m_int8_input_scale = 1.f;
+  /** Linearity weights quantized per output channel. */
+  int8_quantized_matrix m_int8_linearity;
+  /** Workspace for quantized input tensor. */
+  std::vector<std::int8_t> m_int8_input_workspace;
+  /** Workspace for integer matrix product. */
+  std::vector<std::int32_t> m_int8_output_workspace;
+
+  /** Forward prop with quantized weights and inputs. */
+  void fp_compute_int8();
+
   /** Deallocate distributed matrices. */
   void deallocate_matrices() {
     if (m_bias_gradient != nullptr) delete m_bias_gradient;
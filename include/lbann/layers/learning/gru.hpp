@@ -88,6 +88,15 @@ public:
   El::Device get_device_allocation() const override;
   description get_description() const override;
 
+  /** @brief Cost model of the gate matrix products.
+   *
+   *  Each step of each cell multiplies the cell input and the
+   *  previous hidden state by the three gate matrices, followed by
+   *  entry-wise gate nonlinearities.
+   */
+  double get_fp_flops(El::Int mini_batch_size) const override;
+  double get_bp_flops(El::Int mini_batch_size) const override;
+
   /** @name Serialization */
   ///@{
 
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_LEARNING_INT8_INFERENCE_HPP_INCLUDED
+#define LBANN_LAYERS_LEARNING_INT8_INFERENCE_HPP_INCLUDED
+
+namespace lbann {
+
+/** @brief Interface for layers with a quantized int8 inference path.
+ *
+ *  Post-training quantization: the weights are quantized to int8
+ *  with one scaling factor per output channel and the input tensor
+ *  is quantized with a scaling factor determined by a calibration
+ *  pass. Products are accumulated in 32-bit integers and dequantized
+ *  to the layer's data type. The int8 path is only used outside of
+ *  training.
+ */
+class int8_inference_layer {
+public:
+  virtual ~int8_inference_layer() = default;
+
+  /** @brief Largest magnitude in local input tensor.
+   *  @details Used to calibrate input quantization.
+   */
+  virtual float get_local_input_range() const = 0;
+
+  /** @brief Quantize weights and use int8 forward prop outside of
+   *  training.
+   *
+   *  Weights are quantized when this function is called, so it must
+   *  be called again if the weights change.
+   *
+   *  @param input_range Largest magnitude expected in the input
+   *  tensor.
+   *  @returns Whether this layer supports int8 inference.
+   */
+  virtual bool enable_int8_inference(float input_range) = 0;
+
+  /** @brief Use full-precision forward prop. */
+  virtual void disable_int8_inference() = 0;
+
+  /** @brief Whether int8 forward prop is used outside of training. */
+  virtual bool using_int8_inference() const noexcept = 0;
+
+};
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_LEARNING_INT8_INFERENCE_HPP_INCLUDED
@@ -28,6 +28,7 @@
 #define LBANN_LAYERS_LOSS_CROSS_ENTROPY_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
+#include "lbann/utils/hydrogen_utils.hpp"
 #include "lbann/utils/distconv.hpp"
 
 namespace lbann {
@@ -105,6 +106,9 @@ public:
   std::string get_type() const override { return "cross entropy"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  size_t get_host_workspace_bytes() const override {
+    return get_host_memory_bytes(m_workspace.get());
+  }
 
   void setup_dims(DataReaderMetaData& dr_metadata) override {
     data_type_layer<TensorDataType>::setup_dims(dr_metadata);
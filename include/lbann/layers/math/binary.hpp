@@ -45,6 +45,7 @@ namespace lbann {
     std::string get_type() const override { return LAYER_STRING; }          \
     data_layout get_data_layout() const override { return Layout; }         \
     El::Device get_device_allocation() const override { return Device; }    \
+    bool has_local_compute() const override { return true; }                \
     template <typename ArchiveT>                                            \
     void serialize(ArchiveT& ar);                                           \
   protected:                                                                \
@@ -64,6 +64,7 @@ public:
   std::string get_type() const override { return "clamp"; }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool has_local_compute() const override { return true; }
 
   description get_description() const override {
     auto desc = data_type_layer<TensorDataType>::get_description();
@@ -63,6 +63,9 @@ public:
 
   description get_description() const override;
 
+  double get_fp_flops(El::Int mini_batch_size) const override;
+  double get_bp_flops(El::Int mini_batch_size) const override;
+
   template <typename ArchiveT>
   void serialize(ArchiveT& ar);
 
@@ -132,6 +135,22 @@ description matmul_layer<TensorDataType,Layout,Device>::get_description() const
   return desc;
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+double matmul_layer<TensorDataType,Layout,Device>::get_fp_flops(El::Int mini_batch_size) const {
+  // Each output entry is a dot product over the inner dimension
+  const auto& input0_dims = this->get_input_dims(0);
+  const double inner_dim = (m_transpose_a
+                            ? *(input0_dims.rbegin()+1)
+                            : *(input0_dims.rbegin()));
+  return 2 * mini_batch_size * this->get_output_size() * inner_dim;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+double matmul_layer<TensorDataType,Layout,Device>::get_bp_flops(El::Int mini_batch_size) const {
+  // Gradients w.r.t. both inputs each cost as much as forward prop
+  return 2 * get_fp_flops(mini_batch_size);
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void matmul_layer<TensorDataType,Layout,Device>::setup_dims(DataReaderMetaData& dr_metadata) {
   data_type_layer<TensorDataType>::setup_dims(dr_metadata);
@@ -31,6 +31,9 @@
 #include "lbann/models/model.hpp"
 #include "lbann/utils/distconv.hpp"
 
+#include <cmath>
+#include <vector>
+
 namespace lbann {
 
 enum class batch_normalization_stats_aggregation {
@@ -121,6 +124,14 @@ private:
    * Indexed by effective mini-batch size.
    */
   std::unordered_map<El::Int, El::Int> m_num_per_sum_cache;
+  /** @brief Maximum number of channel blocks in the statistics
+   *         pipeline.
+   *
+   *  Per-channel reductions are posted one block of channels at a
+   *  time, so the allreduce for a block overlaps with the local
+   *  computation for the following blocks.
+   */
+  El::Int m_max_num_channel_blocks = 4;
 
   /** @brief Current minibatch means and standard deviations.
    *
@@ -174,6 +185,7 @@ public:
       m_epsilon(other.m_epsilon),
       m_statistics_group_size(other.m_statistics_group_size),
       m_num_per_sum_cache(other.m_num_per_sum_cache),
+      m_max_num_channel_blocks(other.m_max_num_channel_blocks),
       m_mean_and_var(other.m_mean_and_var ?
                      other.m_mean_and_var->Copy() : nullptr),
       m_mean_v(other.m_mean_v ? other.m_mean_v->Copy() : nullptr),
@@ -195,6 +207,7 @@ public:
     m_epsilon = other.m_epsilon;
     m_statistics_group_size = other.m_statistics_group_size;
     m_num_per_sum_cache = other.m_num_per_sum_cache;
+    m_max_num_channel_blocks = other.m_max_num_channel_blocks;
 
     // Deep copy matrices
     m_mean_and_var.reset(other.m_mean_and_var ?
@@ -221,6 +234,7 @@ public:
   std::string get_type() const override { return "batch normalization"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool can_recompute_forward_prop() const override { return false; }
 
   description get_description() const override {
     auto desc = data_type_layer<TensorDataType>::get_description();
@@ -230,6 +244,97 @@ public:
     return desc;
   }
 
+  /** @brief Cost model for training mode.
+   *
+   *  Forward prop makes one pass over the input to compute
+   *  statistics and one to normalize. Backward prop makes one pass
+   *  to reduce the statistics and weights gradients and one to
+   *  compute the input gradient.
+   */
+  double get_fp_flops(El::Int mini_batch_size) const override {
+    return 7.0 * mini_batch_size * this->get_output_size();
+  }
+  double get_bp_flops(El::Int mini_batch_size) const override {
+    return 14.0 * mini_batch_size * this->get_output_size();
+  }
+  double get_fp_bytes(El::Int mini_batch_size) const override {
+    const double input_bytes
+      = mini_batch_size * this->get_input_size() * sizeof(TensorDataType);
+    return data_type_layer<TensorDataType>::get_fp_bytes(mini_batch_size)
+      + input_bytes;
+  }
+  double get_bp_bytes(El::Int mini_batch_size) const override {
+    const double grad_bytes
+      = mini_batch_size * this->get_output_size() * sizeof(TensorDataType);
+    const double input_bytes
+      = mini_batch_size * this->get_input_size() * sizeof(TensorDataType);
+    return data_type_layer<TensorDataType>::get_bp_bytes(mini_batch_size)
+      + input_bytes + grad_bytes;
+  }
+
+  /** @brief Maximum number of channel blocks in the statistics
+   *         pipeline.
+   *
+   *  Only relevant if statistics are aggregated across processes. A
+   *  single block reduces all statistics with one allreduce.
+   */
+  El::Int get_max_num_channel_blocks() const noexcept {
+    return m_max_num_channel_blocks;
+  }
+  void set_max_num_channel_blocks(El::Int num_blocks) {
+    if (num_blocks < 1) {
+      LBANN_ERROR("attempted to set ", num_blocks, " channel blocks ",
+                  "in batch normalization layer \"", this->get_name(), "\"");
+    }
+    m_max_num_channel_blocks = num_blocks;
+  }
+
+  /** @brief Per-channel affine transform applied outside of training.
+   *
+   *  Outside of training, batch normalization computes
+   *  @f$ y = a x + b @f$ with
+   *  @f$ a = \gamma / \sqrt{\sigma^2 + \epsilon} @f$ and
+   *  @f$ b = \beta - a \mu @f$, where @f$ \mu @f$ and @f$ \sigma^2 @f$
+   *  are the running statistics. Requires the weights values, so it
+   *  can only be called after setup or after loading from a
+   *  checkpoint.
+   *
+   *  @returns Whether the layer has all four weights.
+   */
+  bool get_inference_affine(std::vector<double>& scale,
+                            std::vector<double>& shift) const {
+    if (this->num_weights() != 4) {
+      return false;
+    }
+    std::vector<std::vector<double>> params(4);
+    for (size_t i = 0; i < params.size(); ++i) {
+      const auto& w = dynamic_cast<const WeightsType&>(this->get_weights(i));
+      StarMatDT<TensorDataType, El::Device::CPU> values(
+        w.get_values().Grid(), w.get_values().Root());
+      El::Copy(w.get_values(), values);
+      const auto& local_values = values.LockedMatrix();
+      params[i].reserve(local_values.Height() * local_values.Width());
+      for (El::Int col = 0; col < local_values.Width(); ++col) {
+        for (El::Int row = 0; row < local_values.Height(); ++row) {
+          params[i].push_back(El::To<double>(local_values(row, col)));
+        }
+      }
+    }
+    const auto& gamma = params[0];
+    const auto& beta = params[1];
+    const auto& mean = params[2];
+    const auto& var = params[3];
+    const auto epsilon = El::To<double>(m_epsilon);
+    const size_t num_channels = gamma.size();
+    scale.resize(num_channels);
+    shift.resize(num_channels);
+    for (size_t c = 0; c < num_channels; ++c) {
+      scale[c] = gamma[c] / std::sqrt(var[c] + epsilon);
+      shift[c] = beta[c] - scale[c] * mean[c];
+    }
+    return true;
+  }
+
   /** @name Serialization */
   ///@{
 
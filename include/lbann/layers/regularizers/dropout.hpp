@@ -111,6 +111,7 @@ public:
   std::string get_type() const override { return "dropout"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool can_recompute_forward_prop() const override { return false; }
 
   description get_description() const override {
     auto desc = data_type_layer<TensorDataType>::get_description();
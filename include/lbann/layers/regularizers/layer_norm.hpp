@@ -73,6 +73,16 @@ public:
   El::Device get_device_allocation() const override;
   description get_description() const override;
 
+  /** @brief Cost model with two passes over the data.
+   *
+   *  Both forward and backward prop make one pass to compute
+   *  per-sample statistics and one to apply them.
+   */
+  double get_fp_flops(El::Int mini_batch_size) const override;
+  double get_bp_flops(El::Int mini_batch_size) const override;
+  double get_fp_bytes(El::Int mini_batch_size) const override;
+  double get_bp_bytes(El::Int mini_batch_size) const override;
+
   /** @name Serialization */
   ///@{
 
@@ -175,6 +185,34 @@ description layer_norm_layer<TensorDataType,Layout,Device>::get_description() co
   return desc;
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+double layer_norm_layer<TensorDataType,Layout,Device>::get_fp_flops(El::Int mini_batch_size) const {
+  return 5.0 * mini_batch_size * this->get_output_size();
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+double layer_norm_layer<TensorDataType,Layout,Device>::get_bp_flops(El::Int mini_batch_size) const {
+  return 10.0 * mini_batch_size * this->get_output_size();
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+double layer_norm_layer<TensorDataType,Layout,Device>::get_fp_bytes(El::Int mini_batch_size) const {
+  const double input_bytes
+    = mini_batch_size * this->get_input_size() * sizeof(TensorDataType);
+  return data_type_layer<TensorDataType>::get_fp_bytes(mini_batch_size)
+    + input_bytes;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+double layer_norm_layer<TensorDataType,Layout,Device>::get_bp_bytes(El::Int mini_batch_size) const {
+  const double grad_bytes
+    = mini_batch_size * this->get_output_size() * sizeof(TensorDataType);
+  const double input_bytes
+    = mini_batch_size * this->get_input_size() * sizeof(TensorDataType);
+  return data_type_layer<TensorDataType>::get_bp_bytes(mini_batch_size)
+    + input_bytes + grad_bytes;
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void layer_norm_layer<TensorDataType,Layout,Device>::setup_dims(DataReaderMetaData& dr_metadata) {
   data_type_layer<TensorDataType>::setup_dims(dr_metadata);
@@ -59,8 +59,8 @@ class concatenate_layer : public data_type_layer<TensorDataType> {
 public:
 
   concatenate_layer(lbann_comm *comm, size_t concat_dim);
-  concatenate_layer(const concatenate_layer& other) = default;
-  concatenate_layer& operator=(const concatenate_layer& other) = default;
+  concatenate_layer(const concatenate_layer& other);
+  concatenate_layer& operator=(const concatenate_layer& other);
 
   concatenate_layer* copy() const override;
 
@@ -78,6 +78,11 @@ public:
 
   description get_description() const override;
 
+  bool view_parent_output_in_place(
+    const Layer& parent,
+    El::AbstractDistMatrix<TensorDataType>& parent_output,
+    El::Int mini_batch_size) const override;
+
 protected:
 
   friend class cereal::access;
@@ -87,17 +92,44 @@ protected:
 
   void setup_pointers() override;
   void setup_dims(DataReaderMetaData& dr_metadata) override;
+  void setup_data(size_t max_mini_batch_size) override;
 
   void fp_setup_outputs(El::Int mini_batch_size) override;
   void bp_setup_gradient_wrt_inputs(El::Int mini_batch_size) override;
   void fp_compute() override;
   void bp_compute() override;
 
+  /** @brief Keep previous error signals if input gradients view them.
+   *
+   *  Parents can then view the input gradients instead of copying
+   *  them.
+   */
+  bool keep_prev_error_signals() const override;
+
 private:
 
   /** @brief Tensor dimension to concatenate along. */
   size_t m_concat_dim;
 
+  /** @brief Whether parents can write into views of the output.
+   *
+   *  Input tensors occupy contiguous row ranges of the output matrix
+   *  if all dimensions before the concatenation dimension are 1. In
+   *  this case, input gradients are also views into the output
+   *  gradient.
+   */
+  bool m_in_place = false;
+  /** @brief Memory for the output tensor if parents write into it.
+   *
+   *  Allocated during setup for the maximum mini-batch size. Parent
+   *  outputs and the output tensor are views into it, so it is never
+   *  reallocated while parents run forward prop.
+   */
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>> m_in_place_output;
+
+  /** @brief Whether all input tensors are views into the output. */
+  bool inputs_are_in_place() const;
+
 #ifdef LBANN_HAS_GPU
   /** @brief Workspace buffer.
    *
@@ -150,6 +182,36 @@ concatenate_layer<TensorDataType,Layout,Device>::concatenate_layer(
   this->m_expected_num_parent_layers = -1; // No limit on parents
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+concatenate_layer<TensorDataType,Layout,Device>::concatenate_layer(
+  const concatenate_layer& other)
+  : data_type_layer<TensorDataType>(other),
+    m_concat_dim{other.m_concat_dim},
+    m_in_place{other.m_in_place},
+    m_in_place_output(other.m_in_place_output ?
+                      other.m_in_place_output->Copy() : nullptr)
+#ifdef LBANN_HAS_GPU
+  , m_workspace(other.m_workspace),
+    m_workspace_event(other.m_workspace_event)
+#endif // LBANN_HAS_GPU
+{}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+concatenate_layer<TensorDataType,Layout,Device>&
+concatenate_layer<TensorDataType,Layout,Device>::operator=(
+  const concatenate_layer& other) {
+  data_type_layer<TensorDataType>::operator=(other);
+  m_concat_dim = other.m_concat_dim;
+  m_in_place = other.m_in_place;
+  m_in_place_output.reset(other.m_in_place_output ?
+                          other.m_in_place_output->Copy() : nullptr);
+#ifdef LBANN_HAS_GPU
+  m_workspace = other.m_workspace;
+  m_workspace_event = other.m_workspace_event;
+#endif // LBANN_HAS_GPU
+  return *this;
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 concatenate_layer<TensorDataType, Layout,Device>* concatenate_layer<TensorDataType,Layout,Device>::copy() const {
   return new concatenate_layer(*this);
@@ -247,6 +309,87 @@ void concatenate_layer<TensorDataType,Layout,Device>::setup_dims(DataReaderMetaD
   // Update output dimensions
   this->set_output_dims(output_dims);
 
+  // Parents can write directly into output if each sample's inputs
+  // are contiguous
+  m_in_place = (Layout == data_layout::DATA_PARALLEL
+                && this->get_num_parents() > 1
+                && std::accumulate(output_dims.begin(),
+                                   output_dims.begin() + m_concat_dim,
+                                   1, std::multiplies<int>()) == 1);
+
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void concatenate_layer<TensorDataType,Layout,Device>::setup_data(size_t max_mini_batch_size) {
+  m_in_place_output.reset();
+#ifdef LBANN_HAS_DISTCONV
+  if (this->distconv_enabled()) { m_in_place = false; }
+#endif // LBANN_HAS_DISTCONV
+  if (m_in_place) {
+    const auto& output = this->get_activations();
+    m_in_place_output.reset(output.Construct(output.Grid(), output.Root()));
+    m_in_place_output->AlignWith(this->get_prev_activations(0).DistData());
+    m_in_place_output->Resize(this->get_output_size(), max_mini_batch_size);
+  }
+  data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool concatenate_layer<TensorDataType,Layout,Device>::view_parent_output_in_place(
+  const Layer& parent,
+  El::AbstractDistMatrix<TensorDataType>& parent_output,
+  El::Int mini_batch_size) const {
+  if (m_in_place_output == nullptr
+      || m_in_place_output->Width() < mini_batch_size) {
+    return false;
+  }
+
+  // Find rows of output corresponding to parent
+  const auto& parents = this->get_parent_layers();
+  if (std::count(parents.begin(), parents.end(), &parent) != 1) {
+    return false;
+  }
+  const auto parent_index = this->find_parent_layer_index(parent);
+  El::Int offset = 0;
+  for (size_t j=0; j<parent_index; ++j) {
+    offset += this->get_input_size(j);
+  }
+  const El::Int input_size = this->get_input_size(parent_index);
+
+  // Matrix distributions must match
+  auto& output = *m_in_place_output;
+  if (parent_output.ColDist() != output.ColDist()
+      || parent_output.RowDist() != output.RowDist()
+      || parent_output.GetLocalDevice() != output.GetLocalDevice()
+      || parent_output.Grid() != output.Grid()
+      || parent_output.ColAlign() != output.ColAlign()
+      || parent_output.RowAlign() != output.RowAlign()) {
+    return false;
+  }
+
+  // Set up parent output as view into output
+  El::View(parent_output, output,
+           El::IR(offset, offset+input_size), El::IR(0, mini_batch_size));
+  return true;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool concatenate_layer<TensorDataType,Layout,Device>::inputs_are_in_place() const {
+  if (!m_in_place) { return false; }
+  const auto& output = this->get_activations();
+  const auto& local_output = output.LockedMatrix();
+  El::Int offset = 0;
+  for (int j=0; j<this->get_num_parents(); ++j) {
+    const auto& input = this->get_prev_activations(j);
+    const auto& local_input = input.LockedMatrix();
+    if (local_input.Width() > 0
+        && (local_input.LockedBuffer() != local_output.LockedBuffer(offset, 0)
+            || local_input.LDim() != local_output.LDim())) {
+      return false;
+    }
+    offset += input.Height();
+  }
+  return true;
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -257,6 +400,14 @@ void concatenate_layer<TensorDataType,Layout,Device>::fp_setup_outputs(El::Int m
   const auto& input0 = this->get_prev_activations(0);
   auto& output = this->get_activations();
   output.Empty(false);
+
+  // Output is a view into memory that parents may write into
+  if (m_in_place_output != nullptr
+      && m_in_place_output->Width() >= mini_batch_size) {
+    El::View(output, *m_in_place_output, El::ALL, El::IR(0, mini_batch_size));
+    return;
+  }
+
   if (this->get_num_parents() == 1) {
     El::LockedView(output, input0);
   }
@@ -281,6 +432,9 @@ void concatenate_layer<TensorDataType,Layout,Device>::fp_compute() {
     return;
   }
 
+  // Nothing to do if parents wrote directly into output
+  if (inputs_are_in_place()) { return; }
+
   // Perform concatenation
   fp_compute_impl(*this, m_concat_dim);
 
@@ -322,6 +476,16 @@ void bp_setup_gradient_wrt_inputs_impl(
 #endif
     El::LockedView(l.get_error_signals(0), output_grad);
   }
+  else if (l.m_in_place) {
+    // Input gradients are contiguous row ranges of output gradient
+    El::Int offset = 0;
+    for (size_t j=0; j<num_inputs; ++j) {
+      const El::Int input_size = l.get_input_size(j);
+      El::LockedView(l.get_error_signals(j), output_grad,
+                     El::IR(offset, offset+input_size), El::ALL);
+      offset += input_size;
+    }
+  }
   else {
     for (size_t j=0; j<num_inputs; ++j) {
 #ifdef LBANN_HAS_DISTCONV
@@ -355,11 +519,24 @@ void concatenate_layer<TensorDataType,Layout,Device>::bp_compute() {
     return;
   }
 
+  // Nothing to do if input gradients are views into output gradient
+  if (m_in_place) { return; }
+
   // Perform slice
   bp_compute_impl(*this, m_concat_dim);
 
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool concatenate_layer<TensorDataType,Layout,Device>::keep_prev_error_signals() const {
+#ifdef LBANN_HAS_DISTCONV
+  if (this->distconv_enabled()) { return false; }
+#endif // LBANN_HAS_DISTCONV
+  return (this->get_num_parents() == 1
+          || Layout == data_layout::MODEL_PARALLEL
+          || m_in_place);
+}
+
 #ifdef LBANN_HAS_DISTCONV
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 concatenate_distconv_adapter<TensorDataType, T_layout, Dev>&
@@ -200,6 +200,9 @@ public:
   std::string get_type() const override { return "pooling"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  size_t get_host_workspace_bytes() const override {
+    return m_max_pool_indices.capacity() * sizeof(int);
+  }
 
   description get_description() const override {
     auto desc = data_type_layer<TensorDataType>::get_description();
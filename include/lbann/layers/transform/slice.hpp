@@ -111,6 +111,12 @@ private:
   bool m_set_slice_points_from_data_reader;
   /** Category for retrieving slice points from data reader */
   slice_points_mode m_var_category;
+  /** @brief Whether outputs are views into the input.
+   *
+   *  Output tensors occupy contiguous row ranges of the input matrix
+   *  if all dimensions before the slice dimension are 1.
+   */
+  bool m_in_place = false;
 
 #ifdef LBANN_HAS_GPU
   /** @brief Workspace buffer.
@@ -246,6 +252,13 @@ void slice_layer<TensorDataType,Layout,Device>::setup_dims(DataReaderMetaData& d
     this->set_output_dims(output_dims, i);
   }
 
+  // Children can read views of input if each sample's outputs are
+  // contiguous
+  m_in_place = (Layout == data_layout::DATA_PARALLEL
+                && std::accumulate(input_dims.begin(),
+                                   input_dims.begin() + m_slice_dim,
+                                   1, std::multiplies<int>()) == 1);
+
 }
 
 template <typename TensorDataType, El::Device Device>
@@ -273,6 +286,22 @@ void fp_setup_outputs_impl(
 
   const size_t num_outputs = l.get_num_children();
   const auto& input = l.get_prev_activations();
+
+  // View input if outputs are contiguous
+  if (l.m_in_place) {
+    const auto& input_dims = l.get_input_dims();
+    const size_t stride = std::accumulate(input_dims.begin() + l.m_slice_dim + 1,
+                                          input_dims.end(),
+                                          1, std::multiplies<int>());
+    for (size_t j=0; j<num_outputs; ++j) {
+      auto& output = l.get_activations(j);
+      const size_t offset = l.m_slice_points[j] * stride;
+      El::LockedView(output, input,
+                     El::IR(offset, offset+l.get_output_size(j)), El::ALL);
+    }
+    return;
+  }
+
   for (size_t j=0; j<num_outputs; ++j) {
     auto& output = l.get_activations(j);
     output.AlignWith(input);
@@ -288,6 +317,8 @@ void slice_layer<TensorDataType,Layout,Device>::fp_setup_outputs(El::Int mini_ba
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void slice_layer<TensorDataType,Layout,Device>::fp_compute() {
+  // Tensor views have already been setup in fp_setup_outputs
+  if (m_in_place) { return; }
   fp_compute_impl(*this);
 }
 
@@ -36,9 +36,11 @@
 /// Training Algorithms
 #include "lbann/execution_algorithms/training_algorithm.hpp"
 #include "lbann/execution_algorithms/batch_functional_inference_algorithm.hpp"
+#include "lbann/execution_algorithms/inference_server.hpp"
 
 /// Models
 #include "lbann/models/directed_acyclic_graph.hpp"
+#include "lbann/models/inference_preparation.hpp"
 
 /// Activation layers
 #include "lbann/layers/activations/activations.hpp"
@@ -173,6 +175,7 @@
 #include "lbann/callbacks/dump_weights.hpp"
 #include "lbann/callbacks/early_stopping.hpp"
 #include "lbann/callbacks/gpu_memory_usage.hpp"
+#include "lbann/callbacks/host_memory_usage.hpp"
 #include "lbann/callbacks/hang.hpp"
 #include "lbann/callbacks/imcomm.hpp"
 #include "lbann/callbacks/learning_rate.hpp"
@@ -185,6 +188,7 @@
 #include "lbann/callbacks/print_statistics.hpp"
 #include "lbann/callbacks/profiler.hpp"
 #include "lbann/callbacks/replace_weights.hpp"
+#include "lbann/callbacks/roofline.hpp"
 #include "lbann/callbacks/save_images.hpp"
 #include "lbann/callbacks/save_model.hpp"
 #include "lbann/callbacks/load_model.hpp"
@@ -199,6 +203,7 @@
 #include "lbann/weights/weights.hpp"
 #include "lbann/weights/initializer.hpp"
 #include "lbann/weights/variance_scaling_initializers.hpp"
+#include "lbann/io/weights_bundle.hpp"
 
 /// Optimizers
 #include "lbann/optimizers/adagrad.hpp"
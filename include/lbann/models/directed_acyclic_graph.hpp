@@ -32,6 +32,10 @@
 
 #include <optimizers.pb.h>
 
+#include <functional>
+#include <memory>
+#include <vector>
+
 namespace cereal
 {
   class access;
@@ -39,7 +43,40 @@ namespace cereal
 
 namespace lbann {
 
-/** Neural network model with a DAG layer graph. */
+/** @brief Neural network model with a DAG layer graph.
+ *
+ *  By default, layers are executed one at a time in the topologically
+ *  sorted order. If the maximum layer concurrency is larger than one,
+ *  forward and backward prop dispatch every local layer whose
+ *  dependencies are satisfied as a task on a compute thread pool, so
+ *  independent branches (e.g. Inception towers or Siamese heads) run
+ *  at the same time. A layer depends on its parents and its hint
+ *  layer, and layers that share weights are never run concurrently.
+ *
+ *  A layer is local if it only operates on local data (see
+ *  @c Layer::has_local_compute) and its parents and children have the
+ *  same data layout and device. Every other layer may communicate,
+ *  e.g. through statistics allreduces, so it is executed on the
+ *  calling thread in the topologically sorted order (reversed in
+ *  backward prop). Local layers may have weights: in backward prop,
+ *  the model holds back the weights gradient allreduces and starts
+ *  them from the calling thread, in the order in which the last user
+ *  of each weights finishes sequential back prop. All processes
+ *  therefore reach collectives in the same order, while local layers
+ *  keep running on the worker threads.
+ *
+ *  Callback ordering with concurrent execution:
+ *  - Model-level forward/backward prop callbacks run before the
+ *    first and after the last layer, as with sequential execution.
+ *  - Layer-level callbacks are always invoked from the calling
+ *    thread, never concurrently with each other. A layer's begin
+ *    callback precedes its computation and its end callback follows
+ *    it, but callbacks for independent layers may interleave in any
+ *    order consistent with the layer graph.
+ *
+ *  Concurrent execution is only used for CPU models. Otherwise layers
+ *  are executed sequentially.
+ */
 class directed_acyclic_graph_model : public model {
 public:
 
@@ -55,6 +92,21 @@ public:
   template <typename ArchiveT>
   void serialize(ArchiveT& ar);
 
+  void forward_prop(execution_mode mode) override;
+  void backward_prop() override;
+
+  /** @brief Maximum number of layers executed at the same time.
+   *  @details A value of one selects sequential execution.
+   */
+  size_t get_max_layer_concurrency() const noexcept {
+    return m_max_layer_concurrency;
+  }
+  /** @brief Maximum number of layers executed at the same time.
+   *  @details A value of one selects sequential execution. This can
+   *  be changed between steps.
+   */
+  void set_max_layer_concurrency(size_t max_concurrency);
+
 protected:
 
   friend cereal::access;
@@ -68,6 +120,76 @@ protected:
    */
   void setup_layer_execution_order() override;
 
+private:
+
+  /** @brief Construct dependency lists for the current layer order.
+   *
+   *  Layer @c i depends on layer @c j if @c j is a parent or hint
+   *  layer of @c i, or if both layers share weights and @c j comes
+   *  first. Also determines which layers are local.
+   */
+  void setup_layer_dependencies();
+
+  /** @brief Whether layers can be executed concurrently. */
+  bool use_concurrent_execution();
+
+  /** @brief Work item executed on the calling thread. */
+  struct serial_step {
+    /** @brief Position of a layer that is not local, or -1. */
+    El::Int layer = -1;
+    /** @brief Layers that must finish before @c action runs. */
+    std::vector<El::Int> wait_for;
+    /** @brief Invoked instead of running a layer if @c layer is -1. */
+    std::function<void()> action;
+  };
+
+  /** @brief Execute layers as tasks on the compute thread pool.
+   *
+   *  Local layers run on worker threads in any order allowed by the
+   *  dependencies. The other layers and any extra actions run on the
+   *  calling thread in the order of @c serial_steps. OpenMP threads
+   *  are split between the workers and the calling thread.
+   *
+   *  @param dependencies   Dependency lists indexed by layer position.
+   *  @param dependents     Reverse of @c dependencies.
+   *  @param serial_steps   Layers that are not local and actions, in
+   *                        an order consistent with @c dependencies.
+   *  @param begin_cbs      Invoked before a layer is dispatched.
+   *  @param run_layer      Runs forward or backward prop of a layer.
+   *  @param end_cbs        Invoked after a layer completes.
+   *  @param done           Returns true if no more layers need to be
+   *                        dispatched.
+   */
+  void run_layer_graph(const std::vector<std::vector<El::Int>>& dependencies,
+                       const std::vector<std::vector<El::Int>>& dependents,
+                       const std::vector<serial_step>& serial_steps,
+                       const std::function<void(Layer&)>& begin_cbs,
+                       const std::function<void(Layer&)>& run_layer,
+                       const std::function<void(Layer&)>& end_cbs,
+                       const std::function<bool()>& done);
+
+  /** @brief Maximum number of layers executed at the same time. */
+  size_t m_max_layer_concurrency = 1;
+
+  /** @brief Layers that must finish before each layer in forward
+   *  prop.
+   */
+  std::vector<std::vector<El::Int>> m_layer_dependencies;
+  /** @brief Layers that wait on each layer in forward prop. */
+  std::vector<std::vector<El::Int>> m_layer_dependents;
+  /** @brief Whether each layer may run on a worker thread. */
+  std::vector<bool> m_local_layers;
+  /** @brief Positions of the layers that run on the calling thread,
+   *  in forward prop order.
+   */
+  std::vector<El::Int> m_serial_layers;
+
+  /** @brief Worker threads for concurrent layer execution.
+   *  @details Created on first use. Copies of the model share the
+   *  pool.
+   */
+  std::shared_ptr<thread_pool> m_compute_thread_pool;
+
 };
 
 } // namespace lbann
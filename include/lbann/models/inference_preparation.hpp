@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_MODELS_INFERENCE_PREPARATION_HPP_INCLUDED
+#define LBANN_MODELS_INFERENCE_PREPARATION_HPP_INCLUDED
+
+#include <cstddef>
+
+namespace lbann {
+
+// Forward declaration
+class model;
+
+/** @brief Summary of the changes made by @c prepare_for_inference. */
+struct inference_preparation_summary {
+  /** @brief Batch normalization layers folded into their parent. */
+  size_t num_folded_layers = 0;
+  /** @brief Dropout and identity layers removed from the model. */
+  size_t num_removed_layers = 0;
+  /** @brief Weights that are no longer used by any layer. */
+  size_t num_removed_weights = 0;
+  /** @brief Optimizers removed from weights. */
+  size_t num_removed_optimizers = 0;
+};
+
+/** @brief Simplify a model that will only be used for inference.
+ *
+ *  Must be called after the weights values are available (e.g. after
+ *  loading from a checkpoint) and before setup:
+ *
+ *  - Optimizers are removed from all weights, so optimizer state and
+ *    weights gradient buffers are never allocated.
+ *
+ *  - Batch normalization layers are folded into a preceding
+ *    convolution or fully-connected layer if it has no other
+ *    children (see @c affine_folding_layer).
+ *
+ *  - Dropout and identity layers, which are no-ops outside of
+ *    training, are removed. Metrics and objective function terms
+ *    that refer to a removed layer are redirected to its parent, but
+ *    callbacks that refer to layers by name will no longer find it.
+ *
+ *  - Weights that are no longer used are removed.
+ *
+ *  The model can no longer be trained afterwards.
+ */
+inference_preparation_summary prepare_for_inference(model& m);
+
+} // namespace lbann
+
+#endif // LBANN_MODELS_INFERENCE_PREPARATION_HPP_INCLUDED
@@ -183,6 +183,24 @@ public:
   /** @brief Add weights to model. */
   void add_weights(OwningWeightsPtr&& w);
 
+  /** @brief Remove a layer with one parent and one child.
+   *
+   *  The parent is connected directly to the child and any other
+   *  pointers to the layer (e.g. in metrics or the objective
+   *  function) are redirected to the parent. Must be called before
+   *  setup.
+   */
+  void remove_passthrough_layer(Layer& l);
+
+  /** @brief Remove weights that are not used by any layer or by the
+   *  objective function.
+   *
+   *  Must be called before setup.
+   *
+   *  @returns Number of weights removed.
+   */
+  size_t remove_unused_weights();
+
   /** @brief Register a new callback for the model. */
   void add_callback(std::shared_ptr<callback_base> cb);
 
@@ -220,6 +238,43 @@ public:
   /** @brief Are background I/O activities enabled by the input layers */
   bool background_io_activity_allowed() { return m_background_io_allowed; }
 
+  /** @brief Choose activation checkpointing segments heuristically.
+   *  @details Layers that are explicitly assigned to a segment are
+   *  not affected.
+   */
+  void set_auto_checkpoint_activations(bool enable) {
+    m_auto_checkpoint_activations = enable;
+  }
+  /** @brief Whether activation checkpointing segments are chosen
+   *  heuristically.
+   */
+  bool get_auto_checkpoint_activations() const noexcept {
+    return m_auto_checkpoint_activations;
+  }
+  /** @brief Number of activation checkpointing segments. */
+  size_t get_num_checkpoint_segments() const noexcept {
+    return m_checkpoint_segments.size();
+  }
+  /** @brief Bytes released by activation checkpointing in the most
+   *  recent training step on this process.
+   */
+  size_t get_checkpoint_bytes_released() const noexcept {
+    return m_checkpoint_bytes_released;
+  }
+  /** @brief Time spent recomputing activations since the last reset. */
+  EvalType get_checkpoint_recompute_time() const noexcept {
+    return m_checkpoint_recompute_time;
+  }
+  /** @brief Number of segment recomputations since the last reset. */
+  El::Int get_checkpoint_num_recomputes() const noexcept {
+    return m_checkpoint_num_recomputes;
+  }
+  /** @brief Reset activation checkpointing statistics. */
+  void reset_checkpoint_counters() {
+    m_checkpoint_recompute_time = 0;
+    m_checkpoint_num_recomputes = 0;
+  }
+
   void swap_layers(model& other);
   void swap_weights(model& other);
   void swap_metrics(model& other);
@@ -326,6 +381,37 @@ protected:
    *  Called in setup function.
    */
   virtual void setup_layers(size_t max_mini_batch_size, DataReaderMetaData& dr_metadata);
+  /** @brief Set up activation checkpointing segments.
+   *
+   *  Called in setup function, after layers are set up. Layers with
+   *  the same checkpoint segment name are grouped into a segment. If
+   *  automatic checkpointing is enabled, the remaining layers are
+   *  split into segments of about @f$\sqrt{n}@f$ layers at points
+   *  where a single tensor is live. Layers that cannot recompute
+   *  forward prop are never part of a segment.
+   */
+  virtual void setup_activation_checkpointing();
+  /** @brief Release activations of a checkpointing segment.
+   *
+   *  Called after forward prop of the layer at position @c pos. Does
+   *  nothing unless the layer is the last in its segment and the
+   *  model is training.
+   */
+  void release_checkpointed_activations(El::Int pos);
+  /** @brief Recompute activations of a checkpointing segment.
+   *
+   *  Called before backward prop of the layer at position @c
+   *  pos. Does nothing unless the layer is the last in its segment
+   *  and the segment activations were released.
+   */
+  void recompute_checkpointed_activations(El::Int pos);
+  /** @brief Release recomputed activations of a checkpointing
+   *  segment.
+   *
+   *  Called after backward prop of the layer at position @c
+   *  pos. Does nothing unless the layer is the first in its segment.
+   */
+  void release_recomputed_activations(El::Int pos);
   /** @brief Set up weights.
    *
    *  Called in setup function. All weights being used by layers or
@@ -452,6 +538,29 @@ private:
    */
   bool m_model_is_setup = false;
 
+  /** @brief Choose activation checkpointing segments heuristically. */
+  bool m_auto_checkpoint_activations = false;
+
+  /** @brief Layer positions in each activation checkpointing segment.
+   *  @details Each list is sorted in execution order.
+   */
+  std::vector<std::vector<El::Int>> m_checkpoint_segments;
+  /** @brief Activation checkpointing segment of each layer position.
+   *  @details -1 if the layer is not in a segment.
+   */
+  std::vector<El::Int> m_layer_checkpoint_segment;
+  /** @brief Whether layer outputs are released within its segment. */
+  std::vector<bool> m_layer_checkpoint_interior;
+  /** @brief Whether each segment's activations are released. */
+  std::vector<bool> m_checkpoint_segment_released;
+
+  /** @brief Bytes released in the most recent training step. */
+  size_t m_checkpoint_bytes_released = 0;
+  /** @brief Time spent recomputing activations. */
+  EvalType m_checkpoint_recompute_time = 0;
+  /** @brief Number of segment recomputations. */
+  El::Int m_checkpoint_num_recomputes = 0;
+
   // ===========================================
   // Functions to add utility layers
   // ===========================================
@@ -102,8 +102,12 @@ public:
 
   /** @brief Optimization step. */
   void step() override;
+
+  void synchronize_gradient() override;
   ///@}
 
+  size_t get_host_state_bytes() const override;
+
   /** @brief Access the scaling factor for optimization step sizes. */
   TensorDataType get_learning_rate() const;
   /** @brief Set the scaling factor for optimization step sizes. */
@@ -135,6 +139,18 @@ protected:
    */
   std::tuple<El::Int,El::Int,El::DistData> get_matrix_info() const final;
 
+  /** @brief Construct a zero-initialized optimizer state matrix.
+   *
+   *  The matrix matches the @c values and @c gradient passed to
+   *  @c step_compute: the distribution of the weights, or this
+   *  rank's shard of the flattened weights if optimizer state is
+   *  sharded. Must be called after @c setup_base.
+   */
+  std::unique_ptr<AbsDistMatrixType> make_state_matrix();
+
+  /** @brief Whether this rank only holds a shard of the state. */
+  bool is_state_sharded() const noexcept { return m_values_shard != nullptr; }
+
 private:
 
   /** @brief Weights being optimized. */
@@ -151,6 +167,21 @@ private:
    */
   std::unique_ptr<AbsDistMatrixType> m_gradient_v;
 
+  /** @brief This rank's shard of the flattened weights values.
+   *
+   *  Only allocated if optimizer state is sharded.
+   */
+  std::unique_ptr<AbsDistMatrixType> m_values_shard;
+
+  /** @brief This rank's shard of the flattened gradient.
+   *
+   *  Only allocated if optimizer state is sharded.
+   */
+  std::unique_ptr<AbsDistMatrixType> m_gradient_shard;
+
+  /** @brief Number of matrices constructed by @c make_state_matrix. */
+  El::Int m_num_state_matrices = 0;
+
   /** @brief Communication request object for gradient allreduce.
    *
    *  Used to synchronize non-blocking allreduce.
@@ -0,0 +1,269 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_OPTIMIZERS_GRADIENT_COMPRESSION_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_GRADIENT_COMPRESSION_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/comm.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Configuration of gradient compression for a weights object.
+ *
+ *  Copyable and type-agnostic so that it can be stored in an
+ *  optimizer; the compressor itself is created per gradient data
+ *  type.
+ */
+struct gradient_compression_params
+{
+  enum class method
+  {
+    /** @brief Dense allreduce (no compression). */
+    NONE,
+    /** @brief Keep the largest-magnitude entries. */
+    TOP_K,
+    /** @brief Low-rank approximation with one power iteration. */
+    POWER_SGD,
+  };
+
+  method type = method::NONE;
+  /** @brief Fraction of gradient entries sent by top-k. */
+  double top_k_ratio = 0.01;
+  /** @brief Rank of the PowerSGD approximation. */
+  El::Int power_sgd_rank = 1;
+  /** @brief Add the untransmitted remainder of each step's gradient
+   *         to the next step's gradient. */
+  bool error_feedback = true;
+};
+
+/** @brief Type-agnostic interface of a gradient compressor. */
+class gradient_compressor_base
+{
+public:
+  virtual ~gradient_compressor_base() = default;
+
+  virtual std::string get_type() const = 0;
+
+  /** @brief Dense entries over transmitted entries in the last
+   *         allreduce. */
+  double get_compression_ratio() const noexcept { return m_compression_ratio; }
+  /** @brief Frobenius norm of the error-feedback residual after the
+   *         last allreduce. */
+  double get_residual_norm() const noexcept { return m_residual_norm; }
+
+protected:
+  double m_compression_ratio = 1.;
+  double m_residual_norm = 0.;
+};
+
+/** @brief Lossy gradient compression applied in place of a dense
+ *         gradient allreduce.
+ *
+ *  Each process adds its error-feedback residual to its local
+ *  gradient contribution, compresses it, and the compressed
+ *  representations are summed over the redundant communicator. The
+ *  part of the local contribution that was not transmitted becomes
+ *  the residual for the next step.
+ *
+ *  The allreduce is split into a start and a finish phase so that
+ *  communication can overlap with computation, like a dense
+ *  non-blocking allreduce. Compressors operate on host memory; GPU
+ *  gradients must be staged through a CPU matrix by the caller.
+ */
+template <typename TensorDataType>
+class gradient_compressor : public gradient_compressor_base
+{
+public:
+  using LocalMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+
+  gradient_compressor(bool error_feedback) : m_error_feedback{error_feedback}
+  {}
+
+  /** @brief Compress the local gradient and start summing it over
+   *         @c c.
+   *  @param[in] gradient The local contribution. It must not be
+   *             modified until finish_allreduce.
+   */
+  void start_allreduce(El::AbstractMatrix<TensorDataType>& gradient,
+                       lbann_comm& comm,
+                       const El::mpi::Comm& c);
+  /** @brief Complete the allreduce begun by start_allreduce.
+   *  @param[out] gradient The (approximate) sum over @c c.
+   */
+  void finish_allreduce(El::AbstractMatrix<TensorDataType>& gradient,
+                        lbann_comm& comm,
+                        const El::mpi::Comm& c);
+  /** @brief Sum the local gradient over @c c with compression.
+   *  @param[in,out] gradient On entry the local contribution, on exit
+   *                 the (approximate) sum over @c c.
+   */
+  void allreduce(El::AbstractMatrix<TensorDataType>& gradient,
+                 lbann_comm& comm,
+                 const El::mpi::Comm& c);
+
+protected:
+  /** @brief Compress a local contribution and start communicating
+   *         it.
+   *  @param[in,out] local On entry the error-corrected local
+   *                 contribution, on exit the part that will not be
+   *                 transmitted (possibly updated by finish).
+   *  @returns The number of entries transmitted by this process.
+   */
+  virtual size_t start_compress_and_reduce(LocalMatType& local,
+                                           lbann_comm& comm,
+                                           const El::mpi::Comm& c) = 0;
+  /** @brief Complete the communication and decompress the sum.
+   *  @param[in,out] local The residual left by
+   *                 start_compress_and_reduce.
+   *  @param[out] reduced The approximate sum over @c c. It has the
+   *              same size as @c local.
+   */
+  virtual void finish_compress_and_reduce(LocalMatType& local,
+                                          LocalMatType& reduced,
+                                          lbann_comm& comm,
+                                          const El::mpi::Comm& c) = 0;
+
+  /** @brief Start a dense allreduce of the whole local contribution.
+   *  @details Used when compression would not reduce the message
+   *  size. finish_allreduce completes it instead of calling
+   *  finish_compress_and_reduce.
+   */
+  size_t start_dense_allreduce(LocalMatType& local,
+                               lbann_comm& comm,
+                               const El::mpi::Comm& c);
+
+private:
+  bool m_error_feedback;
+  /** @brief Error-feedback residual. */
+  LocalMatType m_residual;
+  /** @brief Entries transmitted by the pending allreduce. */
+  size_t m_sent = 0;
+  /** @brief Whether an allreduce has been started. */
+  bool m_in_progress = false;
+  /** @brief Buffer of the pending dense allreduce, if any. */
+  LocalMatType m_dense;
+  bool m_dense_in_progress = false;
+  Al::request m_dense_req;
+};
+
+/** @brief Top-k sparsification.
+ *
+ *  Each process sends the indices and values of its
+ *  @f$ k = \lceil \text{ratio} \cdot n \rceil @f$ largest-magnitude
+ *  entries; the sparse contributions are allgathered (non-blocking)
+ *  and summed.
+ */
+template <typename TensorDataType>
+class top_k_compressor final : public gradient_compressor<TensorDataType>
+{
+  using BaseType = gradient_compressor<TensorDataType>;
+
+public:
+  using LocalMatType = typename BaseType::LocalMatType;
+
+  top_k_compressor(double ratio, bool error_feedback);
+  std::string get_type() const final { return "top-k"; }
+
+protected:
+  size_t start_compress_and_reduce(LocalMatType& local,
+                                   lbann_comm& comm,
+                                   const El::mpi::Comm& c) final;
+  void finish_compress_and_reduce(LocalMatType& local,
+                                  LocalMatType& reduced,
+                                  lbann_comm& comm,
+                                  const El::mpi::Comm& c) final;
+
+private:
+  double m_ratio;
+  /** @name Buffers of the pending allgathers */
+  ///@{
+  std::vector<int> m_indices;
+  std::vector<TensorDataType> m_values;
+  std::vector<int> m_all_indices;
+  std::vector<TensorDataType> m_all_values;
+  Al::request m_indices_req;
+  Al::request m_values_req;
+  ///@}
+};
+
+/** @brief PowerSGD low-rank compression (Vogels et al., 2019).
+ *
+ *  For an @f$ n \times m @f$ gradient @f$ M @f$ and rank @f$ r @f$:
+ *  @f$ P = \text{orth}(\sum M Q) @f$, @f$ Q = \sum M^T P @f$, and the
+ *  sum is approximated by @f$ P Q^T @f$. Two allreduces of
+ *  @f$ (n+m) r @f$ entries replace one of @f$ nm @f$ entries. @f$ Q @f$
+ *  is reused as the starting point of the next step. Vector-shaped
+ *  gradients are allreduced densely.
+ *
+ *  The allreduce of @f$ P @f$ is non-blocking. The allreduce of
+ *  @f$ Q @f$ depends on the reduced @f$ P @f$, so it is performed when
+ *  the allreduce is finished.
+ */
+template <typename TensorDataType>
+class power_sgd_compressor final : public gradient_compressor<TensorDataType>
+{
+  using BaseType = gradient_compressor<TensorDataType>;
+
+public:
+  using LocalMatType = typename BaseType::LocalMatType;
+
+  power_sgd_compressor(El::Int rank, bool error_feedback);
+  std::string get_type() const final { return "PowerSGD"; }
+
+protected:
+  size_t start_compress_and_reduce(LocalMatType& local,
+                                   lbann_comm& comm,
+                                   const El::mpi::Comm& c) final;
+  void finish_compress_and_reduce(LocalMatType& local,
+                                  LocalMatType& reduced,
+                                  lbann_comm& comm,
+                                  const El::mpi::Comm& c) final;
+
+private:
+  El::Int m_rank;
+  /** @brief Right factor, kept across steps. */
+  LocalMatType m_Q;
+  LocalMatType m_P;
+  Al::request m_P_req;
+};
+
+/** @brief Construct the compressor described by @c params.
+ *  @returns nullptr if no compression is requested or the data type
+ *           is not supported (only float and double are).
+ */
+template <typename TensorDataType>
+std::unique_ptr<gradient_compressor<TensorDataType>>
+make_gradient_compressor(gradient_compression_params const& params);
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_GRADIENT_COMPRESSION_HPP_INCLUDED
@@ -29,6 +29,7 @@
 
 #include "lbann/base.hpp"
 #include "lbann/comm.hpp"
+#include "lbann/optimizers/gradient_compression.hpp"
 #include "lbann/utils/cloneable.hpp"
 #include "lbann/utils/compiler_control.hpp"
 #ifdef LBANN_HAS_GPU
@@ -39,12 +40,16 @@
 #include "lbann/utils/memory.hpp"
 #include "lbann/weights/weights.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_set>
 
 namespace lbann {
 
+// Forward declarations
+class lbann_summary;
+
 /** @brief Status of values in objective function gradient. */
 enum class optimizer_gradient_status {
   /** @brief Values can be accessed immediately. */
@@ -155,6 +160,14 @@ public:
   /** @brief Perform optimization step. */
   virtual void step() = 0;
 
+  /** @brief Complete the gradient communication of an optimization
+   *  step without updating the weights.
+   *
+   *  This is the allreduce of the gradient, or its reduce-scatter if
+   *  optimizer state is sharded.
+   */
+  virtual void synchronize_gradient() = 0;
+
   /** @brief Get the gradient buffer.
    *
    *  This provides access to the underlying gradient buffer, which
@@ -204,6 +217,68 @@ public:
   /** @brief Reset stats counters. */
   virtual void reset_counters() { m_step_time = 0; }
 
+  /** @brief Bytes of host memory owned by the optimizer on this
+   *  process.
+   *
+   *  Includes the gradient and optimizer state, e.g. momentum.
+   */
+  virtual size_t get_host_state_bytes() const { return 0; }
+
+  /** @brief Write gradient compression statistics to a summary.
+   *  @param prefix Prefix of the summary names, e.g. the weights name.
+   */
+  void summarize_stats(lbann_summary& summarizer,
+                       const std::string& prefix,
+                       int step) const;
+
+  ///@}
+  /** @name Gradient compression */
+  ///@{
+
+  /** @brief Compress the gradient allreduce.
+   *
+   *  Must be set before the gradient buffer is first accessed.
+   */
+  void set_gradient_compression(gradient_compression_params params) {
+    m_gradient_compression = std::move(params);
+  }
+  const gradient_compression_params& get_gradient_compression() const noexcept {
+    return m_gradient_compression;
+  }
+
+  ///@}
+  /** @name Sharded optimizer state */
+  ///@{
+
+  /** @brief Partition optimizer state over the trainer's ranks.
+   *
+   *  Instead of allreducing the gradient and replicating the update
+   *  on every rank, each rank reduce-scatters the gradient, updates
+   *  its shard of the weights values and optimizer state, and the
+   *  updated values are allgathered. Must be set before setup. Only
+   *  applies to weights with replicated (STAR,STAR) values; it is
+   *  ignored otherwise.
+   */
+  void set_sharded_state(bool sharded) noexcept { m_sharded_state = sharded; }
+  bool get_sharded_state() const noexcept { return m_sharded_state; }
+
+  ///@}
+  /** @name Diagnostics */
+  ///@{
+
+  /** @brief Treat all gradient contributions as already reduced.
+   *
+   *  Gradients are then only correct with one process per trainer.
+   *  This is used to time computation without gradient
+   *  communication.
+   */
+  void set_skip_gradient_allreduce(bool skip) noexcept {
+    m_skip_gradient_allreduce = skip;
+  }
+  bool get_skip_gradient_allreduce() const noexcept {
+    return m_skip_gradient_allreduce;
+  }
+
   ///@}
   /** @name Checkpointing */
   ///@{
@@ -225,6 +300,17 @@ protected:
     virtual void start_allreduce(lbann_comm&) = 0;
     virtual void complete_allreduce(lbann_comm&) = 0;
     virtual void clear() = 0;
+    /** @brief Reduce-scatter the gradient into a column-vector shard.
+     *
+     *  The gradient is not modified.
+     *  @param shard_dist Distribution of the returned shard.
+     */
+    virtual El::BaseDistMatrix const&
+    reduce_scatter(lbann_comm&, El::DistData const& shard_dist) = 0;
+    /** @brief Compressor of the gradient allreduce, if any. */
+    virtual const gradient_compressor_base* compressor() const noexcept {
+      return nullptr;
+    }
   private:
     optimizer_gradient_status status_ = optimizer_gradient_status::cleared;
   };// class GradientHelper
@@ -234,8 +320,12 @@ protected:
   public:
     using AbsDistMatType = El::AbstractDistMatrix<TensorDataType>;
   public:
-    GradientHelperImpl(El::Int height, El::Int width, El::DistData dist_data)
-      : gradient_{AbsDistMatType::Instantiate(dist_data)}
+    GradientHelperImpl(El::Int height,
+                       El::Int width,
+                       El::DistData dist_data,
+                       gradient_compression_params const& compression = {})
+      : gradient_{AbsDistMatType::Instantiate(dist_data)},
+        compressor_{make_gradient_compressor<TensorDataType>(compression)}
     {
       El::Zeros(*gradient_, height, width);
     }
@@ -246,6 +336,21 @@ protected:
     void start_allreduce(lbann_comm& comm) override {
       switch (this->get_status()) {
       case optimizer_gradient_status::allreduce_needed:
+        if (compressor_ && gradient_->RedundantSize() > 1) {
+          // GPU gradients are compressed in host memory
+          if (gradient_->GetLocalDevice() != El::Device::CPU) {
+            El::Copy(gradient_->LockedMatrix(), host_gradient_);
+#ifdef LBANN_HAS_GPU
+            hydrogen::gpu::SynchronizeDevice();
+#endif // LBANN_HAS_GPU
+          }
+          compressor_->start_allreduce(compression_buffer(),
+                                       comm,
+                                       gradient_->RedundantComm());
+          compression_started_ = true;
+          this->set_status(optimizer_gradient_status::allreduce_started);
+          break;
+        }
         comm.nb_allreduce(*gradient_,
                           gradient_->RedundantComm(),
                           allreduce_req_);
@@ -262,7 +367,18 @@ protected:
     void complete_allreduce(lbann_comm& comm) override {
       switch (this->get_status()) {
       case optimizer_gradient_status::allreduce_started:
-        comm.wait(allreduce_req_);
+        if (compression_started_) {
+          compression_started_ = false;
+          compressor_->finish_allreduce(compression_buffer(),
+                                        comm,
+                                        gradient_->RedundantComm());
+          if (gradient_->GetLocalDevice() != El::Device::CPU) {
+            El::Copy(host_gradient_, gradient_->Matrix());
+          }
+        }
+        else {
+          comm.wait(allreduce_req_);
+        }
         this->set_status(optimizer_gradient_status::ready);
         break;
       case optimizer_gradient_status::ready:
@@ -280,9 +396,53 @@ protected:
     void clear() override {
       this->set_status(optimizer_gradient_status::cleared);
     }
+    AbsDistMatType const&
+    reduce_scatter(lbann_comm& comm, El::DistData const& shard_dist) override {
+      if (!shard_ || !(shard_->DistData() == shard_dist)) {
+        shard_.reset(AbsDistMatType::Instantiate(shard_dist));
+      }
+      const El::Int size = gradient_->Height() * gradient_->Width();
+      switch (this->get_status()) {
+      case optimizer_gradient_status::allreduce_started:
+        this->complete_allreduce(comm);
+        El::Copy(*make_flat_view(*gradient_), *shard_);
+        break;
+      case optimizer_gradient_status::ready:
+        El::Copy(*make_flat_view(*gradient_), *shard_);
+        break;
+      case optimizer_gradient_status::allreduce_needed:
+        El::Contract(*make_flat_view(*gradient_), *shard_);
+        break;
+      case optimizer_gradient_status::cleared:
+        El::Zeros(*shard_, size, 1);
+        break;
+      default:
+        LBANN_ERROR("unexpected gradient status "
+                    "(" + to_string(this->get_status()) + ")");
+      }
+      return *shard_;
+    }
+    const gradient_compressor_base* compressor() const noexcept override {
+      return compressor_.get();
+    }
+  private:
+    /** @brief Local gradient in host memory, for the compressor. */
+    El::AbstractMatrix<TensorDataType>& compression_buffer() {
+      if (gradient_->GetLocalDevice() == El::Device::CPU) {
+        return gradient_->Matrix();
+      }
+      return host_gradient_;
+    }
   private:
     std::unique_ptr<AbsDistMatType> gradient_;
+    /** @brief Workspace for the reduce-scattered gradient. */
+    std::unique_ptr<AbsDistMatType> shard_;
     Al::request allreduce_req_;
+    std::unique_ptr<gradient_compressor<TensorDataType>> compressor_;
+    /** @brief Whether the pending allreduce is compressed. */
+    bool compression_started_ = false;
+    /** @brief Host copy of a GPU gradient during compression. */
+    El::Matrix<TensorDataType, El::Device::CPU> host_gradient_;
   };// class GradientHelperImpl
 
   /** @brief Copy construct/copy assign */
@@ -311,6 +471,24 @@ protected:
   void accumulate_all_gradient_contributions(
     El::AbstractDistMatrix<TensorDataType>& gradient);
 
+  /** @brief Reduce-scatter all gradient contributions into a shard.
+   *
+   *  Used instead of the gradient allreduce when optimizer state is
+   *  sharded. @c shard is a column vector with one entry per weights
+   *  entry, distributed over the trainer (e.g. VC,STAR).
+   */
+  template <typename TensorDataType>
+  void reduce_scatter_all_gradient_contributions(
+    El::AbstractDistMatrix<TensorDataType>& shard);
+
+  /** @brief View a replicated matrix as a column vector.
+   *
+   *  The matrix must be STAR,STAR with a contiguous local buffer.
+   */
+  template <typename TensorDataType>
+  static std::unique_ptr<El::AbstractDistMatrix<TensorDataType>>
+  make_flat_view(El::AbstractDistMatrix<TensorDataType>& mat);
+
   /** @brief Launch non-blocking allreduce on the gradient, if needed.
    *
    *  Does nothing if an allreduce is not needed or has already been
@@ -355,6 +533,15 @@ private:
   /** @brief Time spent in optimization step. */
   EvalType m_step_time = 0;
 
+  /** @brief Compression of the gradient allreduce. */
+  gradient_compression_params m_gradient_compression;
+
+  /** @brief Whether optimizer state is partitioned over the trainer. */
+  bool m_sharded_state = false;
+
+  /** @brief Whether gradient contributions skip the allreduce. */
+  bool m_skip_gradient_allreduce = false;
+
   /** @brief Map from data types to gradient contributions.
    *  @todo Refactor this out. It's a hack.
    */
@@ -374,6 +561,8 @@ El::AbstractDistMatrix<TensorDataType>& optimizer::get_gradient_buffer(
   enum { HEIGHT=0, WIDTH, DISTDATA };
   using GradMgrType = GradientHelperImpl<TensorDataType>;
 
+  allreduce_needed = allreduce_needed && !m_skip_gradient_allreduce;
+
   auto& grad_mgr_ptr = gradients_[std::type_index(typeid(TensorDataType))];
   // If the manager hasn't been created, let's make it.
   if (!grad_mgr_ptr) {
@@ -381,7 +570,8 @@ El::AbstractDistMatrix<TensorDataType>& optimizer::get_gradient_buffer(
     grad_mgr_ptr = make_unique<GradMgrType>(
       std::get<HEIGHT>(mat_info),
       std::get<WIDTH>(mat_info),
-      std::get<DISTDATA>(mat_info));
+      std::get<DISTDATA>(mat_info),
+      m_gradient_compression);
     grad_mgr_ptr->set_status(optimizer_gradient_status::cleared);
   }
   // Get the underlying matrix back out.
@@ -502,6 +692,52 @@ void optimizer::accumulate_all_gradient_contributions(
   }
 }
 
+template <typename TensorDataType>
+void optimizer::reduce_scatter_all_gradient_contributions(
+  El::AbstractDistMatrix<TensorDataType>& shard)
+{
+  using AbsDistMatType = El::AbstractDistMatrix<TensorDataType>;
+  static const TensorDataType one = TensorDataType(1.f);
+
+  auto const this_type_idx = std::type_index(typeid(TensorDataType));
+  El::Zero(shard);
+  std::unique_ptr<AbsDistMatType> tmp;
+  for (auto& grad_mgr_v : this->gradients_) {
+    auto const& contrib =
+      grad_mgr_v.second->reduce_scatter(*m_comm, shard.DistData());
+    if (grad_mgr_v.first == this_type_idx) {
+      El::Axpy(one, dynamic_cast<AbsDistMatType const&>(contrib), shard);
+    }
+    else {
+      // Need a temporary matrix for the type-casted copy.
+      if (!tmp) {
+        tmp.reset(shard.Construct(shard.Grid(), shard.Root()));
+      }
+      El::Copy(contrib, *tmp);
+      El::Axpy(one, *tmp, shard);
+    }
+  }
+}
+
+template <typename TensorDataType>
+std::unique_ptr<El::AbstractDistMatrix<TensorDataType>>
+optimizer::make_flat_view(El::AbstractDistMatrix<TensorDataType>& mat) {
+  const auto dist = mat.DistData();
+  if (dist.colDist != El::STAR || dist.rowDist != El::STAR) {
+    LBANN_ERROR("attempted to flatten a matrix that is not replicated");
+  }
+  if (mat.Width() > 1 && mat.LDim() != mat.Height()) {
+    LBANN_ERROR("attempted to flatten a non-contiguous matrix");
+  }
+  const El::Int size = mat.Height() * mat.Width();
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>> view{
+    mat.Construct(mat.Grid(), mat.Root())};
+  dynamic_cast<El::ElementalMatrix<TensorDataType>&>(*view).Attach(
+    size, 1, mat.Grid(), 0, 0, mat.Buffer(), std::max(size, El::Int(1)),
+    mat.Root());
+  return view;
+}
+
 } // namespace lbann
 
 #endif // LBANN_OPTIMIZERS_OPTIMIZER_HPP_INCLUDED
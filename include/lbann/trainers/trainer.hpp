@@ -260,6 +260,10 @@ public:
 private:
   void delete_execution_context(execution_context_key_pair_t key);
 
+  /** @brief The context to restore when restarting a model that is
+   *         running with context @c c. */
+  execution_context& get_restart_context(model& m, execution_context& c);
+
   void for_each_execution_context(
     std::function<void(observer_ptr<execution_context>)> fn);
 
@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_ASYNC_WRITER_HPP_INCLUDED
+#define LBANN_UTILS_ASYNC_WRITER_HPP_INCLUDED
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lbann {
+
+/** @class async_writer
+ *  @brief Writes files from a background thread.
+ *
+ *  Callbacks that dump tensors copy them into a host staging buffer
+ *  and hand the buffer to the writer together with a function that
+ *  writes it to file. The function runs on a background thread, in
+ *  submission order, so formatting and file system latency are
+ *  taken off the training loop.
+ *
+ *  The staging buffers come from a bounded pool. Acquiring a buffer
+ *  only waits when every buffer is queued or being written, so the
+ *  training loop is slowed down to the speed of the file system only
+ *  when it produces data faster than it can be written. Buffers keep
+ *  their capacity when they are returned to the pool.
+ *
+ *  An exception thrown by a write function is reported by the next
+ *  call to acquire() or flush().
+ */
+class async_writer
+{
+public:
+  using buffer_type = std::vector<unsigned char>;
+  using write_function = std::function<void(buffer_type const&)>;
+
+  /** @param num_buffers Number of staging buffers in the pool. */
+  explicit async_writer(size_t num_buffers);
+  /** @brief Finish pending writes and join the background thread. */
+  ~async_writer();
+
+  async_writer(async_writer const&) = delete;
+  async_writer& operator=(async_writer const&) = delete;
+
+  /** @brief Get a staging buffer from the pool.
+   *
+   *  Waits for a buffer to be written if the pool is empty.
+   */
+  buffer_type acquire();
+
+  /** @brief Queue a staging buffer to be written.
+   *
+   *  @param buffer Buffer obtained from acquire(). It goes back to the
+   *                pool once @c write has returned.
+   *  @param write  Called on the background thread with the buffer.
+   */
+  void submit(buffer_type buffer, write_function write);
+
+  /** @brief Queue a function that needs no staging buffer.
+   *
+   *  It runs after every previously submitted write, e.g. to update a
+   *  file that points to the written data.
+   */
+  void submit(std::function<void()> func);
+
+  /** @brief Wait until every submitted write has finished. */
+  void flush();
+
+  /** @brief Number of staging buffers in the pool. */
+  size_t get_num_buffers() const noexcept { return m_num_buffers; }
+
+  /** @brief Number of times acquire() had to wait for a buffer. */
+  size_t get_num_stalls() const;
+
+private:
+  struct job
+  {
+    buffer_type buffer;
+    write_function write;
+    bool uses_buffer;
+  };
+
+  /** @brief Background thread main loop. */
+  void run();
+
+  /** @brief Throw if a write function has failed.
+   *  @note Must be called with the lock held.
+   */
+  void check_error();
+
+  size_t m_num_buffers;
+  mutable std::mutex m_mutex;
+  /** @brief Signals new jobs and shutdown to the background thread. */
+  std::condition_variable m_job_cv;
+  /** @brief Signals returned buffers and finished jobs. */
+  std::condition_variable m_done_cv;
+  std::deque<job> m_jobs;
+  std::vector<buffer_type> m_free_buffers;
+  /** @brief Number of jobs queued or being written. */
+  size_t m_num_pending = 0;
+  size_t m_num_stalls = 0;
+  bool m_shutdown = false;
+  std::exception_ptr m_error;
+  std::thread m_thread;
+
+}; // class async_writer
+
+/** @brief Writer shared by the callbacks that dump tensors. */
+async_writer& get_async_writer();
+
+/** @brief Open a file for writing.
+ *
+ *  If @c compress is true, the file is gzip-compressed and ".gz" is
+ *  appended to its name.
+ *
+ *  @throws lbann::exception If the file could not be opened.
+ */
+std::unique_ptr<std::ostream> open_output_file(std::string const& file_name,
+                                               bool compress);
+
+/** @brief Flush a file opened with open_output_file.
+ *
+ *  @throws lbann::exception If any write to the file failed.
+ */
+void finish_output_file(std::ostream& fs, std::string const& file_name);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_ASYNC_WRITER_HPP_INCLUDED
@@ -76,4 +76,22 @@ struct ViewIfPossibleOrCopy<DataType,DataType> {
   }
 };
 
+/** @brief Bytes of host memory owned by the local part of a matrix.
+ *
+ *  Views, matrices on other devices, and null pointers own no host
+ *  memory.
+ */
+template <typename TensorDataType>
+size_t get_host_memory_bytes(El::AbstractDistMatrix<TensorDataType> const* x)
+{
+  if (x == nullptr
+      || x->Viewing()
+      || x->GetLocalDevice() != El::Device::CPU) {
+    return 0;
+  }
+  return (static_cast<size_t>(x->LocalHeight())
+          * static_cast<size_t>(x->LocalWidth())
+          * sizeof(TensorDataType));
+}
+
 }
@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_INT8_QUANTIZATION_HPP_INCLUDED
+#define LBANN_UTILS_INT8_QUANTIZATION_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Matrix quantized to int8 with per-channel scaling factors.
+ *
+ *  Entries are quantized symmetrically, i.e. an entry @f$ x @f$ in
+ *  channel @f$ c @f$ is approximated by @f$ s_c q @f$ with
+ *  @f$ q \in [-127,127] @f$. Channels are either rows or columns of
+ *  the matrix. Entries are stored in column-major order with a
+ *  leading dimension equal to the matrix height.
+ */
+struct int8_quantized_matrix {
+  El::Int height = 0;
+  El::Int width = 0;
+  /** @brief Whether each column is a channel. Otherwise each row is. */
+  bool column_channels = false;
+  /** @brief Quantized entries. */
+  std::vector<std::int8_t> values;
+  /** @brief Scaling factor for each channel. */
+  std::vector<float> scales;
+
+  bool empty() const noexcept { return values.empty(); }
+  void clear() {
+    height = 0;
+    width = 0;
+    values.clear();
+    scales.clear();
+  }
+};
+
+/** @brief Quantize matrix with one scaling factor per channel.
+ *
+ *  Each channel is scaled so that its largest magnitude entry maps to
+ *  127.
+ */
+template <typename TensorDataType>
+void quantize_int8_per_channel(const CPUMatDT<TensorDataType>& mat,
+                               bool column_channels,
+                               int8_quantized_matrix& result);
+
+/** @brief Quantize matrix with a single scaling factor.
+ *
+ *  Entries are divided by @c scale, rounded, and clamped to
+ *  [-127,127]. The result is packed in column-major order with a
+ *  leading dimension equal to the matrix height.
+ */
+template <typename TensorDataType>
+void quantize_int8(const CPUMatDT<TensorDataType>& mat,
+                   float scale,
+                   std::vector<std::int8_t>& result);
+
+/** @brief Largest magnitude entry in a matrix. */
+template <typename TensorDataType>
+float max_abs(const CPUMatDT<TensorDataType>& mat);
+
+/** @brief Integer matrix-matrix product.
+ *
+ *  Computes @f$ C = op(A) op(B) @f$ with 32-bit accumulation, where
+ *  @f$ C @f$ is @f$ m \times n @f$ and @f$ op(A) @f$ is @f$ m \times
+ *  k @f$. All matrices are column-major. Uses oneDNN if available.
+ */
+void int8_gemm(El::Orientation orient_a,
+               El::Orientation orient_b,
+               El::Int m, El::Int n, El::Int k,
+               const std::int8_t* A, El::Int lda,
+               const std::int8_t* B, El::Int ldb,
+               std::int32_t* C, El::Int ldc);
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_INT8_QUANTIZATION_HPP_INCLUDED
@@ -44,6 +44,7 @@ const int lbann_default_random_seed = 42;
 #define PROCS_PER_TRAINER "Processes per trainer"
 #define TRAINER_GRID_HEIGHT "Height of 2D process grid for each trainer"
 #define SMILES_BUFFER_SIZE "SMILES Data Reader buffer size"
+#define LAYER_CONCURRENCY "Max. concurrent layers"
 
 void construct_std_options();
 
@@ -53,13 +54,16 @@ void construct_std_options();
  * @param[in] mbs The max mini-batch size
  * @param[in] input_dims The dimension of the input tensor
  * @param[in] output_dims The dimension of the output tensor
+ * @param[in] prepare Simplify the model for inference before setup
+ *            (see @c prepare_for_inference)
  * @return Model loaded from checkpoint
  */
 std::unique_ptr<model> load_inference_model(lbann_comm* lc,
                                             std::string cp_dir,
                                             int mbs,
                                             std::vector<int> input_dims,
-                                            std::vector<int> output_dims);
+                                            std::vector<int> output_dims,
+                                            bool prepare = true);
 
 /** @brief Creates execution algorithm and infers on samples using a model
  * @param[in] model A trained model
@@ -33,6 +33,7 @@
 
 #include <El.hpp>
 
+#include <istream>
 #include <optional>
 #include <string>
 
@@ -153,6 +154,7 @@ public:
       ar_(g.Rank() == root
           ? std::make_optional<archive_type>(is)
           : std::nullopt),
+      is_{&is},
       grid_{&g},
       root_{root}
   {}
@@ -185,6 +187,17 @@ public:
       ar_.value()(data);
   }
 
+  /** @brief Skip bytes of the underlying stream on the root.
+   *
+   *  Only valid for binary archives, which read directly from the
+   *  stream.
+   */
+  void skip_on_root(std::streamoff num_bytes)
+  {
+    if (this->am_root())
+      is_->seekg(num_bytes, std::ios_base::cur);
+  }
+
   template <typename T>
   void prologue_on_root(T const& data)
   {
@@ -201,6 +214,7 @@ public:
 
 private:
   std::optional<archive_type> ar_;
+  std::istream* is_;
   El::Grid const* grid_;
   El::Int root_;
 };// RootedInputArchiveAdaptor
@@ -292,6 +292,25 @@ struct grid_manager
   ~grid_manager();
 };
 
+/** @brief RAII scope for skipping distributed matrix values.
+ *
+ *  While the innermost manager has @c skip set, distributed matrices
+ *  loaded from rooted binary archives are resized, but their values
+ *  are skipped in the archive instead of being read and
+ *  distributed. Only use this if the values are restored from
+ *  elsewhere afterwards.
+ */
+struct skip_matrix_values_manager
+{
+  skip_matrix_values_manager(bool skip);
+  ~skip_matrix_values_manager();
+};
+
+/** @brief Whether distributed matrix values are currently skipped
+ *         during deserialization.
+ */
+bool skipping_matrix_values() noexcept;
+
 /** @brief Get the current grid being used for deserialization.
  *
  *  If not in a deserialization scope, this will return the default
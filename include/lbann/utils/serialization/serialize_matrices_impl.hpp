@@ -294,6 +294,20 @@ void load(lbann::RootedInputArchiveAdaptor<ArchiveT>& ar,
   LBANN_ASSERT(mat.Grid() == ar.grid());
   LBANN_ASSERT(mat.Root() == ar.root());
 
+  // Values that are restored elsewhere are skipped. This follows the
+  // CIRC,CIRC matrix format: global size, then the root's local
+  // matrix.
+  if (::lbann::utils::skipping_matrix_values()) {
+    ::El::Int height, width, local_height = 0, local_width = 0;
+    ar(::cereal::make_nvp("global_height", height),
+       ::cereal::make_nvp("global_width", width));
+    ar.load_on_root(local_height);
+    ar.load_on_root(local_width);
+    ar.skip_on_root(local_height * local_width * sizeof(T));
+    mat.Resize(height, width);
+    return;
+  }
+
   // Do the root process read.
   CircMatType circ_mat(mat.Grid(), mat.Root());
   load(ar, circ_mat);
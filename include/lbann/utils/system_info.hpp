@@ -27,6 +27,7 @@
 #ifndef LBANN_UTILS_SYSTEM_INFO_HPP_INCLUDED
 #define LBANN_UTILS_SYSTEM_INFO_HPP_INCLUDED
 
+#include <cstddef>
 #include <string>
 
 namespace lbann {
@@ -81,6 +82,19 @@ public:
    */
   virtual std::string env_variable_value(std::string const& var_name) const;
 
+  /** @brief Get the resident set size of this process in bytes.
+   *
+   *  If this cannot be determined (e.g. there is no @c /proc
+   *  filesystem), this will return 0.
+   */
+  virtual size_t resident_memory() const;
+
+  /** @brief Get the peak resident set size of this process in bytes.
+   *
+   *  If this cannot be determined, this will return 0.
+   */
+  virtual size_t peak_resident_memory() const;
+
 };
 
 }// namespace utils
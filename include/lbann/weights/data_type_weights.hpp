@@ -130,6 +130,7 @@ public:
   AbsDistMatrixType& get_values() override;
   /** Get the weight matrix. */
   const AbsDistMatrixType& get_values() const override;
+  size_t get_host_values_bytes() const override;
   using weights::set_values;
   /** Set the weight matrix. */
   void set_values(const AbsDistMatrixType& values);
@@ -141,6 +142,20 @@ public:
   /** Set an entry in the weight matrix. */
   void set_value(TensorDataType value, size_t row, size_t col);
 
+  /** @brief View an external buffer as the weight values.
+   *
+   *  The buffer holds the full weight matrix in column-major order
+   *  and must stay valid as long as @c storage is alive. The weights
+   *  keep a reference to @c storage until the values are replaced.
+   *  Updates write into the buffer, so it should be private to this
+   *  process (e.g. a copy-on-write file mapping).
+   *
+   *  @returns Whether the buffer was attached. Only replicated CPU
+   *  values (STAR,STAR distribution) can view an external buffer.
+   */
+  bool attach_values(TensorDataType* buffer,
+                     std::shared_ptr<const void> storage);
+
   /** Reconcile weight values.
    *  If weight values are duplicated across multiple processes, they
    *  are set to the average across the processes.
@@ -185,6 +200,10 @@ private:
 
   /** Weight matrix. */
   std::unique_ptr<AbsDistMatrixType> m_values;
+  /** @brief External storage viewed by the weight matrix.
+   *  @details Null unless values were attached with @c attach_values.
+   */
+  std::shared_ptr<const void> m_values_storage;
 
   /** Weights initializer.
    *  Default is nullptr, which corresponds to zero initialization.
@@ -26,6 +26,7 @@
 #ifndef LBANN_DATA_TYPE_WEIGHTS_IMPL_HPP
 #define LBANN_DATA_TYPE_WEIGHTS_IMPL_HPP
 
+#include "lbann/io/weights_bundle.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/weights/data_type_weights.hpp"
 
@@ -38,9 +39,19 @@ data_type_weights<TensorDataType>
 ::serialize(ArchiveT& ar)
 #if !(defined __CUDACC__)
 {
-  ar(cereal::base_class<weights>(this),
-     CEREAL_NVP(m_values),
-     CEREAL_NVP(m_optimizer));
+  ar(cereal::base_class<weights>(this));
+  if constexpr (utils::IsInputArchive<ArchiveT>)
+  {
+    // Values that are restored from a weights bundle are not read
+    utils::skip_matrix_values_manager skip_values(
+      weights_bundle_restore_scope::skip_values(this->get_name()));
+    ar(CEREAL_NVP(m_values));
+  }
+  else
+  {
+    ar(CEREAL_NVP(m_values));
+  }
+  ar(CEREAL_NVP(m_optimizer));
   if constexpr (utils::IsInputArchive<ArchiveT>)
   {
     if (m_optimizer)
@@ -190,6 +190,13 @@ public:
   /** @brief Access the matrix of weights values. */
   virtual El::BaseDistMatrix& get_values() = 0;
   virtual El::BaseDistMatrix const& get_values() const = 0;
+  /** @brief Bytes of host memory owned by the weights values on
+   *  this process.
+   *
+   *  Zero before setup, for device memory, and for values attached
+   *  to external storage.
+   */
+  virtual size_t get_host_values_bytes() const = 0;
   ///@}
 
   // -----------------------------------------------
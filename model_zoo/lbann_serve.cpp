@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/lbann.hpp"
+#include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/protobuf_utils.hpp"
+#include "lbann/utils/argument_parser.hpp"
+
+#include <lbann.pb.h>
+#include <model.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <thread>
+
+#include <pthread.h>
+
+using namespace lbann;
+
+#define SERVE_SOCKET "Inference server socket"
+#define SERVE_MAX_BATCH_SIZE "Inference server max mini-batch size"
+#define SERVE_MAX_LATENCY "Inference server max batching latency"
+#define SERVE_REPORT_INTERVAL "Inference server report interval"
+#define SERVE_PIN_CORES "Inference server core pinning"
+#define SERVE_MAX_REQUEST_SAMPLES "Inference server max request size"
+
+namespace {
+
+/** @brief Signals that shut the server down. */
+sigset_t shutdown_signals() {
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  return signals;
+}
+
+/** @brief Requests server shutdown when SIGINT or SIGTERM arrives.
+ *
+ *  The signals must be blocked in every thread (see
+ *  @c shutdown_signals) so that only this thread receives them.
+ */
+class signal_watcher {
+public:
+  signal_watcher(inference_server& server)
+    : m_thread([this, &server] {
+        const auto signals = shutdown_signals();
+        while (true) {
+          int sig = 0;
+          if (sigwait(&signals, &sig) != 0) { continue; }
+          if (m_done) { break; }
+          server.request_shutdown();
+        }
+      }) {}
+  ~signal_watcher() {
+    m_done = true;
+    pthread_kill(m_thread.native_handle(), SIGTERM);
+    m_thread.join();
+  }
+private:
+  std::atomic<bool> m_done{false};
+  std::thread m_thread;
+};
+
+} // namespace <anon>
+
+int main(int argc, char *argv[]) {
+  auto& arg_parser = global_argument_parser();
+  construct_std_options();
+  arg_parser.add_option(SERVE_SOCKET,
+                        {"--serve_socket"},
+                        "Path of the UNIX domain socket. Each trainer "
+                        "serves a model replica on <path>.<trainer id>.",
+                        "/tmp/lbann_serve");
+  arg_parser.add_option(SERVE_MAX_BATCH_SIZE,
+                        {"--serve_max_batch_size"},
+                        "Maximum number of samples in a mini-batch "
+                        "(defaults to the model's mini-batch size).",
+                        0);
+  arg_parser.add_option(SERVE_MAX_LATENCY,
+                        {"--serve_max_latency_us"},
+                        "Maximum time in microseconds that a request "
+                        "waits for its mini-batch to fill.",
+                        1000);
+  arg_parser.add_option(SERVE_REPORT_INTERVAL,
+                        {"--serve_report_interval"},
+                        "Seconds between latency and throughput reports "
+                        "(0 only reports at shutdown).",
+                        10.);
+  arg_parser.add_flag(SERVE_PIN_CORES,
+                      {"--serve_pin_cores"},
+                      "Pin the ranks on each node to disjoint sets of "
+                      "cores.");
+  arg_parser.add_option(SERVE_MAX_REQUEST_SAMPLES,
+                        {"--serve_max_request_samples"},
+                        "Maximum number of samples in a request "
+                        "(defaults to the max mini-batch size).",
+                        0);
+
+  try {
+    arg_parser.parse(argc, argv);
+  }
+  catch (std::exception const& e) {
+    std::cerr << "Error during argument parsing:\n\ne.what():\n\n  "
+              << e.what() << "\n\nProcess terminating."
+              << std::endl;
+    std::terminate();
+  }
+
+  // Shutdown signals are handled by a signal_watcher, so block them
+  // before any other threads are created
+  const auto signals = shutdown_signals();
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  auto comm = initialize(argc, argv);
+  const bool master = comm->am_world_master();
+
+  try {
+    // Pin replicas before any OpenMP threads are created
+    if (arg_parser.get<bool>(SERVE_PIN_CORES)) {
+      inference_server::pin_to_cores(*comm);
+    }
+
+    // Split MPI into trainers
+    allocate_trainer_resources(comm.get());
+
+    // Initialize options db (this parses the command line)
+    options *opts = options::get();
+    opts->init(argc, argv);
+    if (opts->has_string("h") or opts->has_string("help") or argc == 1) {
+      print_help(*comm);
+      return EXIT_SUCCESS;
+    }
+
+    auto pbs = protobuf_utils::load_prototext(master, argc, argv);
+    for(size_t i = 0; i < pbs.size(); i++) {
+      get_cmdline_overrides(*comm, *(pbs[i]));
+    }
+
+    lbann_data::LbannPB& pb = *(pbs[0]);
+    lbann_data::Trainer *pb_trainer = pb.mutable_trainer();
+
+    // Construct the trainer
+    auto& trainer = construct_trainer(comm.get(), pb_trainer, *(pbs[0]), opts);
+
+    thread_pool& io_thread_pool = trainer.get_io_thread_pool();
+    int training_dr_linearized_data_size = -1;
+    auto *dr = trainer.get_data_coordinator().get_data_reader(execution_mode::testing);
+    if(dr != nullptr) {
+      training_dr_linearized_data_size = dr->get_linearized_data_size();
+    } else {
+      LBANN_ERROR("No testing data reader defined");
+    }
+
+    // Model replica served by this trainer
+    auto m = build_model_from_prototext(argc, argv, pb_trainer, pb,
+                                        comm.get(), opts, io_thread_pool,
+                                        trainer.get_callbacks_with_ownership(),
+                                        training_dr_linearized_data_size);
+
+    size_t max_batch_size = arg_parser.get<int>(SERVE_MAX_BATCH_SIZE);
+    if (max_batch_size == 0) {
+      max_batch_size = trainer.get_max_mini_batch_size();
+    }
+    inference_server server(
+      arg_parser.get<std::string>(SERVE_SOCKET)
+        + "." + std::to_string(comm->get_trainer_rank()),
+      max_batch_size,
+      std::chrono::microseconds(arg_parser.get<int>(SERVE_MAX_LATENCY)),
+      arg_parser.get<double>(SERVE_REPORT_INTERVAL),
+      arg_parser.get<int>(SERVE_MAX_REQUEST_SAMPLES));
+    signal_watcher watcher(server);
+    server.serve(m.get());
+
+  } catch (std::exception& e) {
+    El::ReportException(e);
+    // It's possible that a proper subset of ranks throw some
+    // exception. But we want to tear down the whole world.
+    El::mpi::Abort(El::mpi::COMM_WORLD, EXIT_FAILURE);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,278 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+// Load generator for the LBANN inference server (lbann_serve). Sends
+// random samples over the server's UNIX domain socket and reports
+// latency percentiles and throughput.
+
+#include "lbann/execution_algorithms/inference_server.hpp"
+#include "lbann/utils/argument_parser.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace lbann;
+
+#define LOADGEN_SOCKET "Server socket"
+#define LOADGEN_SAMPLE_SIZE "Sample size"
+#define LOADGEN_SAMPLES_PER_REQUEST "Samples per request"
+#define LOADGEN_NUM_REQUESTS "Number of requests"
+#define LOADGEN_NUM_CLIENTS "Number of clients"
+#define LOADGEN_RATE "Request rate"
+#define LOADGEN_SHUTDOWN "Shutdown server"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+bool send_all(int fd, const void* buffer, size_t size) {
+  const auto* ptr = static_cast<const char*>(buffer);
+  while (size > 0) {
+    const auto n = ::send(fd, ptr, size, MSG_NOSIGNAL);
+    if (n <= 0) { return false; }
+    ptr += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool recv_all(int fd, void* buffer, size_t size) {
+  auto* ptr = static_cast<char*>(buffer);
+  while (size > 0) {
+    const auto n = ::recv(fd, ptr, size, 0);
+    if (n <= 0) { return false; }
+    ptr += n;
+    size -= n;
+  }
+  return true;
+}
+
+int connect_to_server(const std::string& path) {
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0
+      || ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+    std::cerr << "could not connect to " << path << " ("
+              << std::strerror(errno) << ")" << std::endl;
+    std::exit(EXIT_FAILURE);
+  }
+  return fd;
+}
+
+/** @brief Send requests from one client connection.
+ *
+ *  Requests are sent back-to-back (closed loop) if @c interval is
+ *  zero, otherwise at a fixed interval (open loop).
+ */
+void run_client(const std::string& path,
+                size_t sample_size,
+                size_t samples_per_request,
+                size_t num_requests,
+                std::chrono::nanoseconds interval,
+                int seed,
+                latency_statistics& stats,
+                std::mutex& stats_mutex) {
+  const int fd = connect_to_server(path);
+  std::mt19937 gen(seed);
+  std::uniform_real_distribution<float> dist(0.f, 1.f);
+  std::vector<float> samples(samples_per_request * sample_size);
+  inference_request_header header;
+  header.num_samples = samples_per_request;
+  header.sample_size = sample_size;
+
+  auto send_request = [&] {
+    for (auto& x : samples) { x = dist(gen); }
+    if (!send_all(fd, &header, sizeof(header))
+        || !send_all(fd, samples.data(), samples.size() * sizeof(float))) {
+      std::cerr << "lost connection to server" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+  };
+  auto receive_response = [&](clock_type::time_point sent) {
+    std::vector<int32_t> labels(samples_per_request);
+    if (!recv_all(fd, labels.data(), labels.size() * sizeof(int32_t))) {
+      std::cerr << "lost connection to server" << std::endl;
+      std::exit(EXIT_FAILURE);
+    }
+    const std::chrono::duration<double> latency = clock_type::now() - sent;
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    stats.record(latency.count(), samples_per_request);
+  };
+
+  // Closed loop: wait for each response before the next request
+  if (interval.count() == 0) {
+    for (size_t i = 0; i < num_requests; ++i) {
+      const auto sent = clock_type::now();
+      send_request();
+      receive_response(sent);
+    }
+    ::close(fd);
+    return;
+  }
+
+  // Open loop: responses arrive in request order, and each send
+  // time is queued before its request is sent
+  std::mutex sent_mutex;
+  std::deque<clock_type::time_point> sent_times;
+  std::thread receiver([&] {
+    std::vector<int32_t> labels(samples_per_request);
+    for (size_t i = 0; i < num_requests; ++i) {
+      if (!recv_all(fd, labels.data(), labels.size() * sizeof(int32_t))) {
+        std::cerr << "lost connection to server" << std::endl;
+        std::exit(EXIT_FAILURE);
+      }
+      const auto received = clock_type::now();
+      clock_type::time_point sent;
+      {
+        std::lock_guard<std::mutex> lock(sent_mutex);
+        sent = sent_times.front();
+        sent_times.pop_front();
+      }
+      const std::chrono::duration<double> latency = received - sent;
+      std::lock_guard<std::mutex> lock(stats_mutex);
+      stats.record(latency.count(), samples_per_request);
+    }
+  });
+  auto next_send = clock_type::now();
+  for (size_t i = 0; i < num_requests; ++i) {
+    std::this_thread::sleep_until(next_send);
+    next_send += interval;
+    {
+      std::lock_guard<std::mutex> lock(sent_mutex);
+      sent_times.push_back(clock_type::now());
+    }
+    send_request();
+  }
+  receiver.join();
+  ::close(fd);
+}
+
+} // namespace <anon>
+
+int main(int argc, char *argv[]) {
+  auto& arg_parser = global_argument_parser();
+  arg_parser.add_option(LOADGEN_SOCKET,
+                        {"--socket"},
+                        "UNIX domain socket of the server replica.",
+                        "/tmp/lbann_serve.0");
+  arg_parser.add_option(LOADGEN_SAMPLE_SIZE,
+                        {"--sample_size"},
+                        "Number of entries in each sample (must match "
+                        "the model input).",
+                        0);
+  arg_parser.add_option(LOADGEN_SAMPLES_PER_REQUEST,
+                        {"--samples_per_request"},
+                        "Number of samples in each request.",
+                        1);
+  arg_parser.add_option(LOADGEN_NUM_REQUESTS,
+                        {"--num_requests"},
+                        "Total number of requests.",
+                        1000);
+  arg_parser.add_option(LOADGEN_NUM_CLIENTS,
+                        {"--num_clients"},
+                        "Number of concurrent client connections.",
+                        1);
+  arg_parser.add_option(LOADGEN_RATE,
+                        {"--rate"},
+                        "Total requests per second. If 0, each client "
+                        "waits for a response before sending its next "
+                        "request.",
+                        0.);
+  arg_parser.add_flag(LOADGEN_SHUTDOWN,
+                      {"--shutdown"},
+                      "Shut the server down when done.");
+  try {
+    arg_parser.parse(argc, argv);
+  }
+  catch (std::exception const& e) {
+    std::cerr << "Error during argument parsing:\n\ne.what():\n\n  "
+              << e.what() << "\n\nProcess terminating."
+              << std::endl;
+    std::terminate();
+  }
+
+  const auto path = arg_parser.get<std::string>(LOADGEN_SOCKET);
+  const int sample_size = arg_parser.get<int>(LOADGEN_SAMPLE_SIZE);
+  const int samples_per_request = arg_parser.get<int>(LOADGEN_SAMPLES_PER_REQUEST);
+  const int num_requests = arg_parser.get<int>(LOADGEN_NUM_REQUESTS);
+  const int num_clients = arg_parser.get<int>(LOADGEN_NUM_CLIENTS);
+  const double rate = arg_parser.get<double>(LOADGEN_RATE);
+  if (sample_size <= 0 || samples_per_request <= 0
+      || num_requests <= 0 || num_clients <= 0 || rate < 0.) {
+    std::cerr << "invalid load generator options" << std::endl
+              << arg_parser << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Each client sends at an equal share of the total rate
+  const std::chrono::nanoseconds interval(
+    rate > 0. ? static_cast<long long>(1e9 * num_clients / rate) : 0);
+  latency_statistics stats;
+  std::mutex stats_mutex;
+  std::vector<std::thread> clients;
+  for (int i = 0; i < num_clients; ++i) {
+    const int client_requests = (num_requests / num_clients
+                                 + (i < num_requests % num_clients ? 1 : 0));
+    clients.emplace_back(run_client,
+                         path,
+                         sample_size,
+                         samples_per_request,
+                         client_requests,
+                         interval,
+                         i,
+                         std::ref(stats),
+                         std::ref(stats_mutex));
+  }
+  for (auto& t : clients) { t.join(); }
+  std::cout << "load generator: " << stats.summary() << std::endl;
+
+  if (arg_parser.get<bool>(LOADGEN_SHUTDOWN)) {
+    const int fd = connect_to_server(path + ".admin");
+    inference_request_header header;
+    header.num_samples = 0;
+    header.sample_size = sample_size;
+    send_all(fd, &header, sizeof(header));
+    ::close(fd);
+  }
+
+  return EXIT_SUCCESS;
+}
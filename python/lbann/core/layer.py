@@ -21,6 +21,10 @@ class Layer(abc.ABC):
         datatype (lbann.DataType, optional): Data type used for activations and weights.
         hint_layer (Layer, optional): Hint for output dimensions.
         parallel_strategy (dictionary, optional): Data partitioning scheme.
+        checkpoint_segment (str, optional): Activation checkpointing
+            segment. Layers in the same segment release their
+            activations after forward prop and recompute them in
+            backward prop.
 
     """
 
@@ -36,7 +40,8 @@ class Layer(abc.ABC):
                  data_layout=None,
                  datatype=None,
                  hint_layer=None,
-                 parallel_strategy={}):
+                 parallel_strategy={},
+                 checkpoint_segment=None):
         Layer.global_count += 1
         self.parents = []
         self.children = []
@@ -47,6 +52,7 @@ class Layer(abc.ABC):
         self.datatype = datatype
         self.hint_layer = hint_layer
         self.parallel_strategy = parallel_strategy if parallel_strategy else {}
+        self.checkpoint_segment = checkpoint_segment
 
         # Initialize parents, children, and weights
         for arg in args:
@@ -72,6 +78,8 @@ class Layer(abc.ABC):
             proto.hint_layer = self.hint_layer.name
         for k, v in self.parallel_strategy.items():
             setattr(proto.parallel_strategy, k, v)
+        if self.checkpoint_segment:
+            proto.checkpoint_segment = self.checkpoint_segment
         return proto
 
     def add_parent(self, parent):
@@ -107,11 +115,13 @@ if layers_pb2:
         skip_fields = set([
             'name', 'parents', 'children', 'data_layout', 'device_allocation', 'datatype',
             'weights', 'num_neurons_from_data_reader', 'freeze', 'hint_layer',
-            'parallel_strategy', 'weights_data', 'top', 'bottom', 'type', 'motif_layer']),
+            'parallel_strategy', 'weights_data', 'top', 'bottom', 'type', 'motif_layer',
+            'checkpoint_segment']),
         base_class = Layer,
         base_kwargs = set([
             'parents', 'children', 'weights',
-            'name', 'device', 'data_layout', 'datatype', 'hint_layer', 'parallel_strategy']),
+            'name', 'device', 'data_layout', 'datatype', 'hint_layer', 'parallel_strategy',
+            'checkpoint_segment']),
         base_has_export_proto = True)
     for c in classes:
         globals()[c.__name__] = c
@@ -10,11 +10,13 @@ class Model:
     def __init__(self, epochs,
                  layers=[], weights=[], objective_function=None,
                  metrics=[], callbacks=[],
-                 summary_dir=None):
+                 summary_dir=None,
+                 auto_checkpoint_activations=False):
 
         # Scalar fields
         self.epochs = epochs
         self.summary_dir = summary_dir
+        self.auto_checkpoint_activations = auto_checkpoint_activations
         # Get connected layers
         self.layers = list(lbann.core.layer.traverse_layer_graph(layers))
 
@@ -43,6 +45,7 @@ class Model:
         model.num_epochs = self.epochs
         if self.summary_dir is not None:
             model.summarizer.dir = self.summary_dir
+        model.auto_checkpoint_activations = self.auto_checkpoint_activations
         # Add model components
         model.layer.extend([l.export_proto() for l in self.layers])
         model.weights.extend([w.export_proto() for w in self.weights])
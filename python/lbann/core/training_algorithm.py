@@ -214,6 +214,10 @@ class RandomPairwiseExchange(MetaLearningStrategy):
         LOWER_IS_BETTER: int = 0
         HIGHER_IS_BETTER: int = 1
 
+    class TournamentProtocol:
+        EXCHANGE_MODELS: int = 0
+        EXCHANGE_SCORES: int = 1
+
     # This is supposed to go away. I don't want to make it any more
     # visible than this. In the same vein, I don't want more "class"
     # stuff for the different strategies.
@@ -249,14 +253,18 @@ class RandomPairwiseExchange(MetaLearningStrategy):
            the target trainers' instances of the model. While
            extremely fragile hackery could produce other cases that
            happen to work, this essentially implies that the model
-           topology should be homogenous across all trainers.
+           topology should be homogenous across all trainers. With
+           `single_message=True`, all weights and SGD/Adam state are
+           packed into one non-blocking message that overlaps with
+           the evaluation of the local model.
 
         """
 
         def __init__(self, strategy: str = "checkpoint_binary",
                      weights_names: list[str] = [],
                      exchange_hyperparameters: bool = False,
-                     checkpoint_dir: str = None):
+                     checkpoint_dir: str = None,
+                     single_message: bool = False):
             """Construct a new exchange strategy.
 
             Args:
@@ -269,11 +277,16 @@ class RandomPairwiseExchange(MetaLearningStrategy):
                   the "sendrecv_weights" strategy.
                 checkpoint_dir: A path to a directory for storing the
                   checkpoint files. Only applies to "checkpoint_file".
+                single_message:
+                  If True, exchange all weights in a single
+                  non-blocking message. Only applies to the
+                  "sendrecv_weights" strategy.
             """
             self.strategy = strategy
             self.exchange_hyperparameters = exchange_hyperparameters
             self.weights_names = make_iterable(weights_names)
             self.checkpoint_dir = checkpoint_dir
+            self.single_message = single_message
 
         def export_proto(self):
             """Get a protobuf representation of this object."""
@@ -291,13 +304,15 @@ class RandomPairwiseExchange(MetaLearningStrategy):
                     raise Exception("Must provide checkpoint dir")
             elif self.strategy == "sendrecv_weights":
                 msg.sendrecv_weights.exchange_hyperparameters = self.exchange_hyperparameters
+                msg.sendrecv_weights.single_message = self.single_message
             else:
                 raise ValueError("Unknown strategy")
             return msg
 
     def __init__(self,
                  metric_strategies: dict[str,int] = {},
-                 exchange_strategy = ExchangeStrategy()):
+                 exchange_strategy = ExchangeStrategy(),
+                 tournament_protocol: int = TournamentProtocol.EXCHANGE_MODELS):
         """Construct a new RandomPairwiseExchange metalearning strategy.
 
         Args:
@@ -306,10 +321,16 @@ class RandomPairwiseExchange(MetaLearningStrategy):
               with respect to this metric
             exchange_strategy:
               The algorithm used for exchanging models.
+            tournament_protocol:
+              EXCHANGE_MODELS (default) evaluates both models on the
+              local tournament set. EXCHANGE_SCORES evaluates only
+              the local model, exchanges scores, and transfers the
+              winning model to the loser only.
         """
 
         self.metric_strategies = metric_strategies
         self.exchange_strategy = exchange_strategy
+        self.tournament_protocol = tournament_protocol
 
     def export_proto(self):
         """Get a protobuf representation of this object."""
@@ -319,6 +340,7 @@ class RandomPairwiseExchange(MetaLearningStrategy):
             msg.metric_name_strategy_map[key] = value
 
         msg.exchange_strategy.CopyFrom(self.exchange_strategy.export_proto())
+        msg.tournament_protocol = self.tournament_protocol
         return msg
 
 class KFAC(TrainingAlgorithm):
@@ -361,3 +383,243 @@ class KFAC(TrainingAlgorithm):
         for key, value in self.kfac_args.items():
             setattr(params, key, value)
         return params
+
+class LocalSGD(TrainingAlgorithm):
+    """Local SGD with periodic model averaging.
+
+    Each trainer takes SGD steps on its own data without synchronizing
+    gradients with the other trainers. Every `sync_interval` steps, the
+    weights of all trainers (and optionally their optimizer state) are
+    averaged with a single fused allreduce. With one process per
+    trainer, this is local SGD per rank.
+
+    All trainers must take the same number of steps, e.g. by using a
+    batch-count stopping criterion.
+
+    """
+
+    def __init__(
+            self,
+            name: str,
+            first_order_optimizer: BatchedIterativeOptimizer,
+            sync_interval: int = 8,
+            max_sync_interval: int = 0,
+            sync_interval_growth_period: int = 0,
+            warmup_steps: int = 0,
+            average_optimizer_state: bool = False,
+    ):
+        """Construct a new local SGD algorithm.
+
+        Args:
+            name:
+              A user-defined name to identify this object in logs.
+            first_order_optimizer:
+              The SGD-like algorithm used for local steps. Its
+              stopping criteria apply to the whole run.
+            sync_interval:
+              Local steps between model averages.
+            max_sync_interval:
+              Largest sync interval reached by doubling (default:
+              sync_interval).
+            sync_interval_growth_period:
+              Double the sync interval after this many model averages
+              (default: 0, fixed interval).
+            warmup_steps:
+              Average after every step for this many initial steps.
+            average_optimizer_state:
+              If True, also average SGD velocity or Adam moments.
+
+        """
+        self.name = name
+        self.first_order_optimizer = first_order_optimizer
+        self.sync_interval = sync_interval
+        self.max_sync_interval = max_sync_interval
+        self.sync_interval_growth_period = sync_interval_growth_period
+        self.warmup_steps = warmup_steps
+        self.average_optimizer_state = average_optimizer_state
+
+    def do_export_proto(self):
+        """Get a protobuf representation of this object."""
+        params = AlgoProto.LocalSGD()
+        first_order_optimizer_proto = self.first_order_optimizer.export_proto()
+        first_order_optimizer_proto.parameters.Unpack(params.sgd)
+        params.sync_interval = self.sync_interval
+        params.max_sync_interval = self.max_sync_interval
+        params.sync_interval_growth_period = self.sync_interval_growth_period
+        params.warmup_steps = self.warmup_steps
+        params.average_optimizer_state = self.average_optimizer_state
+        return params
+
+class PipelineParallel(TrainingAlgorithm):
+    """Pipeline-parallel SGD with a 1F1B micro-batch schedule.
+
+    The model's layers are split into stages of roughly equal
+    estimated cost and each trainer runs one stage. All trainers must
+    have the same number of processes. The trainer mini-batch size is
+    the micro-batch size; gradients of `num_micro_batches`
+    micro-batches are accumulated before each weight update.
+
+    Layers outside the last stage must be able to recompute their
+    forward prop, e.g. no dropout.
+
+    """
+
+    def __init__(
+            self,
+            name: str,
+            first_order_optimizer: BatchedIterativeOptimizer,
+            num_micro_batches: int = 4,
+    ):
+        """Construct a new pipeline-parallel algorithm.
+
+        Args:
+            name:
+              A user-defined name to identify this object in logs.
+            first_order_optimizer:
+              The SGD-like algorithm whose stopping criteria apply to
+              the whole run.
+            num_micro_batches:
+              Micro-batches per weight update.
+
+        """
+        self.name = name
+        self.first_order_optimizer = first_order_optimizer
+        self.num_micro_batches = num_micro_batches
+
+    def do_export_proto(self):
+        """Get a protobuf representation of this object."""
+        params = AlgoProto.PipelineParallel()
+        first_order_optimizer_proto = self.first_order_optimizer.export_proto()
+        first_order_optimizer_proto.parameters.Unpack(params.sgd)
+        params.num_micro_batches = self.num_micro_batches
+        return params
+
+class BottleneckAnalysis(TrainingAlgorithm):
+    """Diagnostic that finds the stage limiting training speed.
+
+    Times regular training steps, then the data pipeline alone,
+    forward/backward prop on a cached synthetic mini-batch without
+    I/O or gradient allreduces, and the gradient allreduces alone. The
+    trainer master prints each stage's rate, which is a ceiling on the
+    training rate, next to the real rate.
+
+    The synthetic steps update the weights with meaningless gradients,
+    so the resulting model should not be used.
+
+    """
+
+    def __init__(
+            self,
+            name: str,
+            num_steps: int = 20,
+            num_warmup_steps: int = 5,
+    ):
+        """Construct a new bottleneck analysis.
+
+        Args:
+            name:
+              A user-defined name to identify this object in logs.
+            num_steps:
+              Timed steps of each kind.
+            num_warmup_steps:
+              Untimed steps before each timed run.
+
+        """
+        self.name = name
+        self.num_steps = num_steps
+        self.num_warmup_steps = num_warmup_steps
+
+    def do_export_proto(self):
+        """Get a protobuf representation of this object."""
+        params = AlgoProto.BottleneckAnalysis()
+        params.num_steps = self.num_steps
+        params.num_warmup_steps = self.num_warmup_steps
+        return params
+
+class ReplayBenchmark(TrainingAlgorithm):
+    """Reproducible benchmark of the training step time.
+
+    Replays the training sample order from a file, or records it there
+    if the file does not exist, with shuffling disabled. A fixed number
+    of untimed warmup steps is followed by a fixed window of timed
+    training steps, with no validation or testing. The trainer master
+    prints the median step time with a 95% confidence interval, so runs
+    can be compared reliably.
+
+    """
+
+    def __init__(
+            self,
+            name: str,
+            index_file: str,
+            num_steps: int = 50,
+            num_warmup_steps: int = 10,
+    ):
+        """Construct a new replay benchmark.
+
+        Args:
+            name:
+              A user-defined name to identify this object in logs.
+            index_file:
+              Training sample order to replay or record.
+            num_steps:
+              Timed steps.
+            num_warmup_steps:
+              Untimed steps before the timed steps.
+
+        """
+        self.name = name
+        self.index_file = index_file
+        self.num_steps = num_steps
+        self.num_warmup_steps = num_warmup_steps
+
+    def do_export_proto(self):
+        """Get a protobuf representation of this object."""
+        params = AlgoProto.ReplayBenchmark()
+        params.index_file = self.index_file
+        params.num_steps = self.num_steps
+        params.num_warmup_steps = self.num_warmup_steps
+        return params
+
+class AsyncValidation(TrainingAlgorithm):
+    """SGD with validation overlapped with training.
+
+    The trainers are split in two halves. Trainers in the first half
+    train, and at the end of each epoch send their weights to a
+    partner trainer in the second half, which evaluates them on the
+    validation set. Training continues while the evaluation runs. The
+    objective function, metrics and early stopping decision come back
+    at most `max_lag` epochs late. With an odd number of trainers, the
+    last trainer trains with synchronous validation. All weights must
+    have the default data type.
+
+    """
+
+    def __init__(
+            self,
+            name: str,
+            first_order_optimizer: BatchedIterativeOptimizer,
+            max_lag: int = 1,
+    ):
+        """Construct a new asynchronous validation algorithm.
+
+        Args:
+            name:
+              A user-defined name to identify this object in logs.
+            first_order_optimizer:
+              The SGD-like algorithm run by the training trainers.
+            max_lag:
+              Largest number of outstanding evaluations.
+
+        """
+        self.name = name
+        self.first_order_optimizer = first_order_optimizer
+        self.max_lag = max_lag
+
+    def do_export_proto(self):
+        """Get a protobuf representation of this object."""
+        params = AlgoProto.AsyncValidation()
+        first_order_optimizer_proto = self.first_order_optimizer.export_proto()
+        first_order_optimizer_proto.parameters.Unpack(params.sgd)
+        params.max_lag = self.max_lag
+        return params
@@ -27,12 +27,14 @@ class Weights:
 
     global_count = 0  # Static counter, used for default names
 
-    def __init__(self, initializer=None, optimizer=None, name=None, datatype=None):
+    def __init__(self, initializer=None, optimizer=None, name=None, datatype=None,
+                 sharded_optimizer_state=False):
         Weights.global_count += 1
         self.name = name if name else 'weights{0}'.format(Weights.global_count)
         self.initializer = initializer
         self.optimizer = optimizer
         self.datatype = datatype
+        self.sharded_optimizer_state = sharded_optimizer_state
 
     def export_proto(self):
         """Construct and return a protobuf message."""
@@ -53,4 +55,8 @@ class Weights:
         if self.datatype:
             proto.datatype = self.datatype
 
+        # Partition optimizer state over the trainer if needed
+        if self.sharded_optimizer_state:
+            proto.sharded_optimizer_state = True
+
         return proto
@@ -26,6 +26,7 @@
 
 #include "lbann/callbacks/dump_outputs.hpp"
 #include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/async_writer.hpp"
 #include "lbann/utils/file_utils.hpp"
 #include "lbann/utils/trainer_file_utils.hpp"
 #include "lbann/layers/data_type_layer.hpp"
@@ -49,24 +50,24 @@ namespace {
  */
 void save_text(const std::string& file_name,
                std::string delimiter,
-               const CPUMat& data) {
-  std::ofstream fs(file_name.c_str());
-  if (!fs.is_open()) {
-    LBANN_ERROR("failed to open output file (" + file_name + ")");
-  }
+               const CPUMat& data,
+               bool compress) {
+  auto fs = open_output_file(file_name, compress);
   for (El::Int col = 0; col < data.Width(); ++col) {
     for (El::Int row = 0; row < data.Height(); ++row) {
-      fs << (row > 0 ? delimiter : "") << data(row, col);
+      *fs << (row > 0 ? delimiter : "") << data(row, col);
     }
-    fs << "\n";
+    *fs << "\n";
   }
+  finish_output_file(*fs, file_name);
 }
 
 
 /** Save NumPy binary file. */
 void save_npy(const std::string& file_name,
               const std::vector<int>& dims,
-              const CPUMat& data) {
+              const CPUMat& data,
+              bool compress) {
 #ifndef LBANN_HAS_CNPY
   LBANN_ERROR("CNPY not detected");
 #else
@@ -76,7 +77,16 @@ void save_npy(const std::string& file_name,
   std::vector<size_t> shape;
   shape.push_back(data.Width());
   for (const auto& d : dims) { shape.push_back(d); }
-  cnpy::npy_save(file_name, data.LockedBuffer(), shape);
+  if (!compress) {
+    cnpy::npy_save(file_name, data.LockedBuffer(), shape);
+    return;
+  }
+  const auto header = cnpy::create_npy_header<DataType>(shape);
+  auto fs = open_output_file(file_name, compress);
+  fs->write(header.data(), header.size());
+  fs->write(reinterpret_cast<const char*>(data.LockedBuffer()),
+            sizeof(DataType) * data.Height() * data.Width());
+  finish_output_file(*fs, file_name);
 #endif // LBANN_HAS_CNPY
 }
 
@@ -98,18 +108,40 @@ void save_npz(const std::string& file_name,
 #endif // LBANN_HAS_CNPY
 }
 
+/** Save a tensor in one of the supported file formats. */
+void save_output(const std::string& file_name,
+                 const std::string& file_format,
+                 const std::string& tensor_name,
+                 const std::vector<int>& dims,
+                 const CPUMat& data,
+                 bool compress) {
+  if (file_format == "csv") {
+    save_text(file_name, ",", data, compress);
+  } else if (file_format == "tsv") {
+    save_text(file_name, "\t", data, compress);
+  } else if (file_format == "npy") {
+    save_npy(file_name, dims, data, compress);
+  } else if (file_format == "npz") {
+    save_npz(file_name, tensor_name, dims, data);
+  }
+}
+
 } // namespace
 
 dump_outputs::dump_outputs(std::set<std::string> layer_names,
                            std::set<execution_mode> modes,
                            El::Int batch_interval,
                            std::string directory,
-                           std::string file_format)
+                           std::string file_format,
+                           bool asynchronous,
+                           bool compress)
   : callback_base(std::max(batch_interval, El::Int(1))),
     m_layer_names(std::move(layer_names)),
     m_modes(std::move(modes)),
     m_directory(std::move(directory)),
-    m_file_format(std::move(file_format)) {
+    m_file_format(std::move(file_format)),
+    m_asynchronous(asynchronous),
+    m_compress(compress) {
   std::stringstream err;
 
   // Initialize directory for output files
@@ -134,6 +166,11 @@ dump_outputs::dump_outputs(std::set<std::string> layer_names,
         << "to use invalid file format (" << m_file_format << ")";
     LBANN_ERROR(err.str());
   }
+  if (m_compress && m_file_format == "npz") {
+    err << "callback \"" << this->name() << "\" attempted "
+        << "to compress npz files, which are already zip archives";
+    LBANN_ERROR(err.str());
+  }
 
 }
 
@@ -149,7 +186,9 @@ void dump_outputs::serialize(Archive & ar) {
      CEREAL_NVP(m_layer_names),
      CEREAL_NVP(m_modes),
      CEREAL_NVP(m_directory),
-     CEREAL_NVP(m_file_format));
+     CEREAL_NVP(m_file_format),
+     CEREAL_NVP(m_asynchronous),
+     CEREAL_NVP(m_compress));
 }
 
 void dump_outputs::do_dump_outputs(const model& m, const Layer& l) {
@@ -178,23 +217,75 @@ void dump_outputs::do_dump_outputs(const model& m, const Layer& l) {
                                      + l.get_name()
                                      + "_output" + std::to_string(i)
                                      + "." + m_file_format);
-      if (m_file_format == "csv") {
-        save_text(file_name, ",", data);
-      } else if (m_file_format == "tsv") {
-        save_text(file_name, "\t", data);
-      } else if (m_file_format == "npy") {
-        save_npy(file_name, dtl.get_output_dims(i), data);
-      } else if (m_file_format == "npz") {
-        save_npz(file_name,
-                 l.get_name() + "_output" + std::to_string(i),
-                 dtl.get_output_dims(i),
-                 data);
+      const std::string tensor_name = l.get_name() + "_output" + std::to_string(i);
+      const auto dims = dtl.get_output_dims(i);
+      if (!m_asynchronous) {
+        save_output(file_name, m_file_format, tensor_name, dims, data, m_compress);
+        continue;
+      }
+
+      // Copy to a staging buffer and write in the background
+      // Note: Errors are reported collectively when the writes are
+      // flushed, so that the trainer does not deadlock if only the
+      // root process fails.
+      if (!m_write_error.empty()) { continue; }
+      try {
+        auto& writer = get_async_writer();
+        auto buffer = writer.acquire();
+        const El::Int height = data.Height();
+        const El::Int width = data.Width();
+        buffer.resize(sizeof(DataType) * height * width);
+        CPUMat staged;
+        staged.Attach(height, width,
+                      reinterpret_cast<DataType*>(buffer.data()), height);
+        El::Copy(data, staged);
+        writer.submit(
+          std::move(buffer),
+          [file_name, file_format = m_file_format, tensor_name, dims,
+           height, width, compress = m_compress]
+          (const async_writer::buffer_type& b) {
+            CPUMat staged;
+            staged.LockedAttach(height, width,
+                                reinterpret_cast<const DataType*>(b.data()),
+                                height);
+            save_output(file_name, file_format, tensor_name, dims, staged,
+                        compress);
+          });
+      }
+      catch (std::exception const& e) {
+        m_write_error = e.what();
       }
     }
   }
 
 }
 
+void dump_outputs::flush(const lbann_comm& comm) {
+  if (!m_asynchronous) { return; }
+  auto error = std::move(m_write_error);
+  m_write_error.clear();
+  if (error.empty()) {
+    try {
+      get_async_writer().flush();
+    }
+    catch (std::exception const& e) {
+      error = e.what();
+    }
+  }
+
+  // Every process throws if any of them failed to write its files
+  const int failed = comm.trainer_allreduce(int(!error.empty()),
+                                            El::mpi::MAX);
+  if (failed) {
+    LBANN_ERROR("callback \"", this->name(), "\" failed to dump outputs to ",
+                m_directory, " (",
+                (error.empty()
+                 ? std::string("write failed on another process")
+                 : error),
+                ")");
+  }
+}
+
 std::unique_ptr<callback_base>
 build_dump_outputs_callback_from_pbuf(
   const google::protobuf::Message& proto_msg, const std::shared_ptr<lbann_summary>&) {
@@ -207,7 +298,9 @@ build_dump_outputs_callback_from_pbuf(
                                                   modes,
                                                   params.batch_interval(),
                                                   params.directory(),
-                                                  params.format());
+                                                  params.format(),
+                                                  params.asynchronous(),
+                                                  params.compress());
 }
 
 } // namespace callback
@@ -26,6 +26,8 @@
 
 #include "lbann/callbacks/dump_weights.hpp"
 #include "lbann/callbacks/checkpoint.hpp" // Reuse the checkpoint naming scheme
+#include "lbann/io/weights_bundle.hpp"
+#include "lbann/utils/async_writer.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/weights/data_type_weights.hpp"
 #include "lbann/utils/cloneable.hpp"
@@ -35,6 +37,7 @@
 
 #include <callbacks.pb.h>
 
+#include <exception>
 #include <string>
 
 namespace lbann {
@@ -54,10 +57,66 @@ public:
 
   /** @brief Write weight values to file. */
   virtual void write(const weights& w, const std::string& file) const = 0;
+
+  /** @brief Write all weights in a model to a directory.
+   *
+   *  By default, each weights object is written to a file named
+   *  after it.
+   */
+  virtual void write_all(const model& m, const std::string& dir) const {
+    for (auto* w : m.get_weights()) {
+      write(*w, El::BuildString(dir, w->get_name()));
+    }
+  }
+
+  /** @brief Whether files are written from a background thread. */
+  virtual bool is_asynchronous() const { return false; }
 };
 
 namespace {
 
+/** @brief Write a local matrix in Elemental's BINARY format.
+ *
+ *  The file has the same layout as with El::Write: the height and
+ *  width, then the column-major entries. The matrix is copied to a
+ *  host staging buffer, which is written by the shared background
+ *  writer if @c asynchronous is true.
+ */
+template <typename TensorDataType>
+void write_binary(const El::AbstractMatrix<TensorDataType>& mat,
+                  const std::string& file,
+                  bool asynchronous,
+                  bool compress) {
+  const El::Int height = mat.Height();
+  const El::Int width = mat.Width();
+  auto write = [file, height, width, compress](
+                 const async_writer::buffer_type& buffer) {
+    auto fs = open_output_file(El::BuildString(file, ".bin"), compress);
+    fs->write(reinterpret_cast<const char*>(&height), sizeof(El::Int));
+    fs->write(reinterpret_cast<const char*>(&width), sizeof(El::Int));
+    fs->write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    finish_output_file(*fs, El::BuildString(file, ".bin"));
+  };
+
+  // Copy to a host staging buffer
+  auto buffer = (asynchronous
+                 ? get_async_writer().acquire()
+                 : async_writer::buffer_type{});
+  buffer.resize(sizeof(TensorDataType) * height * width);
+  El::Matrix<TensorDataType, El::Device::CPU> staged;
+  staged.Attach(height, width,
+                reinterpret_cast<TensorDataType*>(buffer.data()),
+                height);
+  El::Copy(mat, staged);
+
+  if (asynchronous) {
+    get_async_writer().submit(std::move(buffer), std::move(write));
+  }
+  else {
+    write(buffer);
+  }
+}
+
 class TextFileFormat final
   : public Cloneable<TextFileFormat, FileFormat>
 {
@@ -110,7 +169,11 @@ class BinaryFileFormat final
   : public Cloneable<BinaryFileFormat, FileFormat>
 {
 public:
-  BinaryFileFormat() = default;
+  BinaryFileFormat(bool asynchronous = false, bool compress = false)
+    : m_asynchronous{asynchronous}, m_compress{compress}
+  {}
+
+  bool is_asynchronous() const final { return m_asynchronous; }
 
   void write(const weights& w, const std::string& file) const final {
 
@@ -146,19 +209,36 @@ private:
     if (typed_w == nullptr) {
       return false;
     }
-    else {
+    else if (!m_asynchronous && !m_compress) {
       El::Write(typed_w->get_values(), file, El::BINARY);
       return true;
     }
+    else {
+      El::DistMatrix<TensorDataType, El::CIRC, El::CIRC, El::ELEMENT,
+                     El::Device::CPU> circ_values(typed_w->get_values());
+      if (circ_values.CrossRank() == circ_values.Root()) {
+        write_binary(circ_values.LockedMatrix(), file,
+                     m_asynchronous, m_compress);
+      }
+      return true;
+    }
   }
 
+  bool m_asynchronous;
+  bool m_compress;
+
 };
 
 class DistributedBinaryFileFormat final
   : public Cloneable<DistributedBinaryFileFormat, FileFormat>
 {
 public:
-  DistributedBinaryFileFormat() = default;
+  DistributedBinaryFileFormat(bool asynchronous = false,
+                              bool compress = false)
+    : m_asynchronous{asynchronous}, m_compress{compress}
+  {}
+
+  bool is_asynchronous() const final { return m_asynchronous; }
 
   void write(const weights& w, const std::string& file) const final {
 
@@ -197,16 +277,48 @@ private:
     }
     else {
       const auto& mat = typed_w->get_values();
-      if (mat.RedundantRank() == 0) {
-        El::Write(
-          mat.LockedMatrix(),
-          El::BuildString(file, "_rank", mat.DistRank()),
-          El::BINARY);
+      if (mat.RedundantRank() != 0) {
+        return true;
+      }
+      const auto rank_file = El::BuildString(file, "_rank", mat.DistRank());
+      if (!m_asynchronous && !m_compress) {
+        El::Write(mat.LockedMatrix(), rank_file, El::BINARY);
+      }
+      else {
+        write_binary(mat.LockedMatrix(), rank_file,
+                     m_asynchronous, m_compress);
       }
       return true;
     }
   }
 
+  bool m_asynchronous;
+  bool m_compress;
+
+};
+
+class BundleFileFormat final
+  : public Cloneable<BundleFileFormat, FileFormat>
+{
+public:
+  BundleFileFormat() = default;
+
+  void write(const weights& w, const std::string& file) const final {
+    LBANN_ERROR(
+      "could not write weights \"",w.get_name(),"\" ",
+      "to ",file,", since weights bundles contain every weights ",
+      "in a model");
+  }
+
+  /** @brief Write all weights to a single bundle file.
+   *
+   *  See @c weights_bundle. The load_model callback reads the bundle
+   *  back without copying replicated weights.
+   */
+  void write_all(const model& m, const std::string& dir) const final {
+    write_weights_bundle(m, El::BuildString(dir, weights_bundle::file_name));
+  }
+
 };
 
 } // namespace <anon>
@@ -256,6 +368,18 @@ void dump_weights::on_train_begin(model *m) {
   do_dump_weights(*m, visitor_hook::execution_mode_begin);
 }
 
+void dump_weights::on_train_end(model *m) {
+  finish_dump(*m->get_comm());
+}
+
+void dump_weights::on_validation_end(model *m) {
+  finish_dump(*m->get_comm());
+}
+
+void dump_weights::on_test_end(model *m) {
+  finish_dump(*m->get_comm());
+}
+
 void dump_weights::on_epoch_end(model *m) {
   const auto& context = static_cast<const sgd_execution_context&>(m->get_execution_context());
   if (context.get_epoch() % m_epoch_interval == 0) {
@@ -279,27 +403,66 @@ void dump_weights::do_dump_weights(const model& m, visitor_hook hook) {
       context.get_epoch(),
       context.get_step()),
     m.get_name(), '/');
-  file::trainer_master_make_directory(dir, m.get_comm());
+
+  // Confirm the previous asynchronous dump before starting a new one
+  auto& comm = *m.get_comm();
+  finish_dump(comm);
+  file::trainer_master_make_directory(dir, &comm);
 
   // Save weights
-  for (auto* w : m.get_weights()) {
-    m_file_format->write(*w, El::BuildString(dir, w->get_name()));
+  // Note: Errors are reported collectively, so that the trainer does
+  // not deadlock if only some processes fail.
+  m_pending_dump = make_unique<pending_dump>();
+  m_pending_dump->dir = dir;
+  m_pending_dump->latest_file = get_last_shared_checkpoint_filename(
+    t.get_name(),
+    context.get_type(),
+    m_directory.c_str());
+  m_pending_dump->hook = hook;
+  m_pending_dump->mode = context.get_execution_mode();
+  m_pending_dump->epoch = context.get_epoch();
+  m_pending_dump->step = context.get_step();
+  try {
+    m_file_format->write_all(m, dir);
+  }
+  catch (std::exception const& e) {
+    m_pending_dump->error = e.what();
   }
 
-  // Update checkpoint file
-  if (m.get_comm()->am_trainer_master()) {
-    auto latest_file = get_last_shared_checkpoint_filename(
-      t.get_name(),
-      context.get_type(),
-      m_directory.c_str());
-    write_latest(
-      latest_file,
-      hook,
-      context.get_execution_mode(),
-      context.get_epoch(),
-      context.get_step());
+  // Asynchronous dumps are finished by the next dump or at the end
+  // of training, validation or testing
+  if (!m_file_format->is_asynchronous()) {
+    finish_dump(comm);
+  }
+
+}
+
+void dump_weights::finish_dump(const lbann_comm& comm) {
+  if (m_pending_dump == nullptr) { return; }
+  auto dump = std::move(m_pending_dump);
+  if (dump->error.empty() && m_file_format->is_asynchronous()) {
+    try {
+      get_async_writer().flush();
+    }
+    catch (std::exception const& e) {
+      dump->error = e.what();
+    }
   }
 
+  // Only point to the dump once every process has written its files
+  const int failed = comm.trainer_allreduce(int(!dump->error.empty()),
+                                            El::mpi::MAX);
+  if (failed) {
+    LBANN_ERROR("failed to dump weights to ", dump->dir, " (",
+                (dump->error.empty()
+                 ? std::string("write failed on another process")
+                 : dump->error),
+                ")");
+  }
+  if (comm.am_trainer_master()) {
+    write_latest(dump->latest_file, dump->hook, dump->mode,
+                 dump->epoch, dump->step);
+  }
 }
 
 std::unique_ptr<callback_base>
@@ -315,14 +478,25 @@ build_dump_weights_callback_from_pbuf(
     file_format = make_unique<dump_weights_internal::TextFileFormat>();
   }
   if (params.format() == "binary") {
-    file_format = make_unique<dump_weights_internal::BinaryFileFormat>();
+    file_format = make_unique<dump_weights_internal::BinaryFileFormat>(
+      params.asynchronous(), params.compress());
   }
   if (params.format() == "distributed_binary") {
-    file_format = make_unique<dump_weights_internal::DistributedBinaryFileFormat>();
+    file_format = make_unique<dump_weights_internal::DistributedBinaryFileFormat>(
+      params.asynchronous(), params.compress());
+  }
+  if (params.format() == "bundle") {
+    file_format = make_unique<dump_weights_internal::BundleFileFormat>();
   }
   if (file_format == nullptr) {
     LBANN_ERROR("unrecognized file format \"",params.format(),"\"");
   }
+  if ((params.asynchronous() || params.compress())
+      && params.format() != "binary"
+      && params.format() != "distributed_binary") {
+    LBANN_ERROR("asynchronous and compressed weight dumps require the ",
+                "binary or distributed_binary format");
+  }
 
   // Construct callback
   return make_unique<dump_weights>(
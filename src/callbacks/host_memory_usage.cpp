@@ -0,0 +1,282 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/callbacks/host_memory_usage.hpp"
+#include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include "lbann/layers/layer.hpp"
+#include "lbann/optimizers/optimizer.hpp"
+#include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/file_utils.hpp"
+#include "lbann/utils/serialize.hpp"
+#include "lbann/utils/system_info.hpp"
+#include "lbann/weights/weights.hpp"
+
+#include <callbacks.pb.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace lbann {
+namespace callback {
+namespace {
+
+/** Number of per-process entries at the end of a measurement. */
+constexpr size_t num_process_entries = 5;
+
+/** Min, mean, and max of one measurement across processes. */
+struct statistics {
+  size_t min = 0;
+  double mean = 0;
+  size_t max = 0;
+};
+
+/** @param values Measurements from all processes, in rank-major order.
+ *  @param count  Number of measurements per process.
+ *  @param index  Which measurement to summarize.
+ */
+statistics get_statistics(const std::vector<size_t>& values,
+                          size_t count,
+                          size_t index) {
+  statistics stats;
+  const size_t num_procs = values.size() / count;
+  stats.min = values[index];
+  for (size_t p = 0; p < num_procs; ++p) {
+    const auto& val = values[p * count + index];
+    stats.min = std::min(stats.min, val);
+    stats.max = std::max(stats.max, val);
+    stats.mean += static_cast<double>(val);
+  }
+  stats.mean /= num_procs;
+  return stats;
+}
+
+/** Statistics of the sum of several measurements on each process. */
+statistics get_sum_statistics(const std::vector<size_t>& values,
+                              size_t count,
+                              const std::vector<size_t>& indices) {
+  const size_t num_procs = values.size() / count;
+  std::vector<size_t> sums(num_procs, 0);
+  for (size_t p = 0; p < num_procs; ++p) {
+    for (const auto& i : indices) {
+      sums[p] += values[p * count + i];
+    }
+  }
+  return get_statistics(sums, 1, 0);
+}
+
+std::string to_json(const statistics& stats) {
+  std::ostringstream ss;
+  ss << "{\"min\":" << stats.min
+     << ",\"mean\":" << std::fixed << std::setprecision(1) << stats.mean
+     << ",\"max\":" << stats.max << "}";
+  return ss.str();
+}
+
+std::string to_json(const std::string& str) {
+  std::ostringstream ss;
+  ss << '"';
+  for (const auto& c : str) {
+    switch (c) {
+    case '"':  ss << "\\\""; break;
+    case '\\': ss << "\\\\"; break;
+    case '\n': ss << "\\n"; break;
+    case '\t': ss << "\\t"; break;
+    default:   ss << c;
+    }
+  }
+  ss << '"';
+  return ss.str();
+}
+
+std::string to_mib(const statistics& stats) {
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(1)
+     << stats.mean / 1024.0 / 1024.0 << " MiB mean, "
+     << stats.max / 1024.0 / 1024.0 << " MiB max, "
+     << stats.min / 1024.0 / 1024.0 << " MiB min";
+  return ss.str();
+}
+
+} // namespace
+
+host_memory_usage::host_memory_usage(std::string directory)
+  : callback_base(), m_directory(std::move(directory)) {}
+
+template <class Archive>
+void host_memory_usage::serialize(Archive & ar) {
+  ar(::cereal::make_nvp(
+       "BaseCallback",
+       ::cereal::base_class<callback_base>(this)),
+     CEREAL_NVP(m_directory));
+}
+
+std::vector<size_t> host_memory_usage::measure(model& m) {
+  std::vector<size_t> bytes;
+  size_t attributed = 0;
+  const auto record = [&bytes, &attributed](size_t b) {
+    bytes.push_back(b);
+    attributed += b;
+  };
+  for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+    const auto& l = m.get_layer(i);
+    record(l.get_host_activations_bytes());
+    record(l.get_host_error_signals_bytes());
+    record(l.get_host_workspace_bytes());
+  }
+  for (const auto* w : m.get_weights()) {
+    const auto* opt = w->get_optimizer();
+    record(w->get_host_values_bytes());
+    record(opt != nullptr ? opt->get_host_state_bytes() : 0);
+  }
+  const auto& dc = get_trainer().get_data_coordinator();
+  record(dc.get_data_store_bytes());
+  record(dc.get_host_io_buffer_bytes());
+  const utils::SystemInfo system_info;
+  const size_t rss = system_info.resident_memory();
+  bytes.push_back(rss > attributed ? rss - attributed : 0);
+  bytes.push_back(rss);
+  bytes.push_back(system_info.peak_resident_memory());
+  return bytes;
+}
+
+void host_memory_usage::on_epoch_begin(model *m) {
+  const auto local_bytes = measure(*m);
+  const size_t count = local_bytes.size();
+  auto* comm = m->get_comm();
+  if (!comm->am_trainer_master()) {
+    comm->trainer_gather(local_bytes.data(), static_cast<int>(count),
+                         comm->get_trainer_master());
+    return;
+  }
+  const size_t num_procs = comm->get_procs_per_trainer();
+  std::vector<size_t> bytes(num_procs * count);
+  comm->trainer_gather(local_bytes.data(), static_cast<int>(count),
+                       bytes.data());
+
+  // Indices of each category in a measurement
+  const size_t num_layers = m->get_num_layers();
+  const auto weights_list = m->get_weights();
+  const size_t weights_offset = 3 * num_layers;
+  const size_t process_offset = weights_offset + 2 * weights_list.size();
+  std::vector<size_t> activations, error_signals, workspace;
+  for (size_t i = 0; i < num_layers; ++i) {
+    activations.push_back(3 * i);
+    error_signals.push_back(3 * i + 1);
+    workspace.push_back(3 * i + 2);
+  }
+  std::vector<size_t> values, optimizer_state;
+  for (size_t i = 0; i < weights_list.size(); ++i) {
+    values.push_back(weights_offset + 2 * i);
+    optimizer_state.push_back(weights_offset + 2 * i + 1);
+  }
+  const size_t data_store = process_offset;
+  const size_t io_buffers = process_offset + 1;
+  const size_t unattributed = process_offset + 2;
+  const size_t rss = process_offset + 3;
+  const size_t peak_rss = process_offset + 4;
+
+  // Print summary
+  const auto& c = static_cast<const sgd_execution_context&>(m->get_execution_context());
+  std::ostringstream msg;
+  msg << "Model " << comm->get_trainer_rank()
+      << " host memory usage statistics (epoch " << c.get_epoch() << ") :\n"
+      << "  resident       : " << to_mib(get_statistics(bytes, count, rss)) << "\n"
+      << "  peak resident  : " << to_mib(get_statistics(bytes, count, peak_rss)) << "\n"
+      << "  activations    : " << to_mib(get_sum_statistics(bytes, count, activations)) << "\n"
+      << "  error signals  : " << to_mib(get_sum_statistics(bytes, count, error_signals)) << "\n"
+      << "  workspace      : " << to_mib(get_sum_statistics(bytes, count, workspace)) << "\n"
+      << "  weights        : " << to_mib(get_sum_statistics(bytes, count, values)) << "\n"
+      << "  optimizer      : " << to_mib(get_sum_statistics(bytes, count, optimizer_state)) << "\n"
+      << "  data store     : " << to_mib(get_statistics(bytes, count, data_store)) << "\n"
+      << "  input buffers  : " << to_mib(get_statistics(bytes, count, io_buffers)) << "\n"
+      << "  unattributed   : " << to_mib(get_statistics(bytes, count, unattributed)) << "\n";
+  std::cout << msg.str() << std::flush;
+
+  if (m_directory.empty()) { return; }
+
+  // Write one JSON object per epoch
+  std::ostringstream json;
+  json << "{\"model\":" << to_json(m->get_name())
+       << ",\"trainer\":" << comm->get_trainer_rank()
+       << ",\"epoch\":" << c.get_epoch()
+       << ",\"step\":" << c.get_step()
+       << ",\"num_procs\":" << num_procs
+       << ",\"process\":{"
+       << "\"resident\":" << to_json(get_statistics(bytes, count, rss))
+       << ",\"peak_resident\":" << to_json(get_statistics(bytes, count, peak_rss))
+       << ",\"data_store\":" << to_json(get_statistics(bytes, count, data_store))
+       << ",\"input_buffers\":" << to_json(get_statistics(bytes, count, io_buffers))
+       << ",\"unattributed\":" << to_json(get_statistics(bytes, count, unattributed))
+       << "},\"layers\":[";
+  for (size_t i = 0; i < num_layers; ++i) {
+    const auto& l = m->get_layer(i);
+    json << (i > 0 ? "," : "")
+         << "{\"name\":" << to_json(l.get_name())
+         << ",\"type\":" << to_json(l.get_type())
+         << ",\"activations\":" << to_json(get_statistics(bytes, count, activations[i]))
+         << ",\"error_signals\":" << to_json(get_statistics(bytes, count, error_signals[i]))
+         << ",\"workspace\":" << to_json(get_statistics(bytes, count, workspace[i]))
+         << "}";
+  }
+  json << "],\"weights\":[";
+  for (size_t i = 0; i < weights_list.size(); ++i) {
+    json << (i > 0 ? "," : "")
+         << "{\"name\":" << to_json(weights_list[i]->get_name())
+         << ",\"values\":" << to_json(get_statistics(bytes, count, values[i]))
+         << ",\"optimizer\":" << to_json(get_statistics(bytes, count, optimizer_state[i]))
+         << "}";
+  }
+  json << "]}\n";
+
+  file::make_directory(m_directory);
+  const auto file_name = El::BuildString(m_directory, "/host_memory_usage-trainer",
+                                         comm->get_trainer_rank(), ".jsonl");
+  std::ofstream fs(file_name, std::ios::app);
+  if (!fs) {
+    LBANN_ERROR("failed to open host memory usage report (", file_name, ")");
+  }
+  fs << json.str();
+}
+
+std::unique_ptr<callback_base>
+build_host_memory_usage_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg, const std::shared_ptr<lbann_summary>&) {
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackHostMemoryUsage&>(proto_msg);
+  return make_unique<host_memory_usage>(params.directory());
+}
+
+} // namespace callback
+} // namespace lbann
+
+#define LBANN_CLASS_NAME callback::host_memory_usage
+#include <lbann/macros/register_class_with_cereal.hpp>
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/int8_calibration.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/layers/learning/int8_inference.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/serialize.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+namespace callback {
+
+template <class Archive>
+void int8_calibration::serialize(Archive & ar) {
+  ar(::cereal::make_nvp(
+       "BaseCallback",
+       ::cereal::base_class<callback_base>(this)));
+}
+
+void int8_calibration::on_epoch_begin(model *m) {
+  for (auto* l : m->get_layers()) {
+    if (auto* ql = dynamic_cast<int8_inference_layer*>(l)) {
+      ql->disable_int8_inference();
+    }
+  }
+  reset();
+}
+
+void int8_calibration::on_evaluate_forward_prop_end(model *m, Layer *l) {
+  const auto& c = m->get_execution_context();
+  if (c.get_execution_mode() == execution_mode::validation) {
+    record_input_range(*l);
+  }
+}
+
+void int8_calibration::on_validation_end(model *m) {
+  const auto num_quantized = apply(*m);
+  if (num_quantized > 0 && m->get_comm()->am_trainer_master()) {
+    std::cout << name() << ": "
+              << num_quantized << " layer(s) in model \"" << m->get_name()
+              << "\" use int8 inference" << std::endl;
+  }
+}
+
+void int8_calibration::record_input_range(Layer& l) {
+  auto* ql = dynamic_cast<int8_inference_layer*>(&l);
+  if (ql == nullptr || ql->using_int8_inference()) { return; }
+  auto& range = m_input_ranges[l.get_name()];
+  range = std::max(range, ql->get_local_input_range());
+}
+
+void int8_calibration::record_input_ranges(model& m) {
+  for (auto* l : m.get_layers()) {
+    record_input_range(*l);
+  }
+}
+
+size_t int8_calibration::apply(model& m) {
+  auto& comm = *m.get_comm();
+  size_t num_quantized = 0;
+  for (auto* l : m.get_layers()) {
+    auto* ql = dynamic_cast<int8_inference_layer*>(l);
+    if (ql == nullptr) { continue; }
+    if (ql->using_int8_inference()) {
+      ++num_quantized;
+      continue;
+    }
+    auto it = m_input_ranges.find(l->get_name());
+    if (it == m_input_ranges.end()) { continue; }
+    const auto range = comm.trainer_allreduce(it->second, El::mpi::MAX);
+    if (ql->enable_int8_inference(range)) {
+      ++num_quantized;
+    }
+  }
+  reset();
+  return num_quantized;
+}
+
+} // namespace callback
+} // namespace lbann
+
+#define LBANN_CLASS_NAME callback::int8_calibration
+#include <lbann/macros/register_class_with_cereal.hpp>
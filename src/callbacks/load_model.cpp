@@ -100,6 +100,24 @@ void load_weights_from_checkpoint(model& m,
   }
 }
 
+void load_weights_from_bundle(model& m,
+                              std::string const& bundle_file,
+                              weights_bundle_access access)
+{
+  auto comm = m.get_comm();
+  // TODO: Logging API
+  if (comm->am_trainer_master()) {
+    std::cout << "Restoring from " << bundle_file << std::endl;
+  }
+  auto const num_restored = read_weights_bundle(m, bundle_file, access);
+  // TODO: Replace with logging API
+  if (comm->am_trainer_master()) {
+    std::cout << "Restored " << num_restored << " of "
+              << m.get_weights().size() << " weights "
+              << "from weights bundle." << std::endl;
+  }
+}
+
 void load_weights_from_files(model& m,
                              std::string const& ckpt_dir)
 {
@@ -149,8 +167,12 @@ void load_weights_from_files(model& m,
 // directory with a checkpoint, the weights will be pulled from the
 // checkpoint. (In the future, it might be faster to prefer the
 // standalone weights objects, but testing for `model.bin` is
-// faster/easier than checking each `<weights_name>.bin`.)
-bool load_model_weights(const std::string& ckpt_dir, model& m)
+// faster/easier than checking each `<weights_name>.bin`.) A weights
+// bundle takes precedence over both, since replicated weights can
+// view it without copies.
+bool load_model_weights(const std::string& ckpt_dir,
+                        model& m,
+                        weights_bundle_access bundle_access)
 {
   std::string const active_ckpt_dir = add_delimiter(ckpt_dir);
   LBANN_ASSERT(file::directory_exists(active_ckpt_dir));
@@ -160,8 +182,12 @@ bool load_model_weights(const std::string& ckpt_dir, model& m)
     std::cout << "Loading model weights from " << active_ckpt_dir << std::endl;
   }
 
+  auto const bundle_file = file::join_path(active_ckpt_dir,
+                                          weights_bundle::file_name);
   auto const checkpoint_file = file::join_path(active_ckpt_dir, "model.bin");
-  if (file::file_exists(checkpoint_file))
+  if (file::file_exists(bundle_file))
+    load_weights_from_bundle(m, bundle_file, bundle_access);
+  else if (file::file_exists(checkpoint_file))
     load_weights_from_checkpoint(m, checkpoint_file);
   else
     load_weights_from_files(m, active_ckpt_dir);
@@ -176,13 +202,14 @@ void load_model::serialize(Archive & ar) {
   ar(cereal::base_class<callback_base>(this),
      CEREAL_NVP(m_dirs),
      CEREAL_NVP(m_extension),
+     CEREAL_NVP(m_bundle_access),
      CEREAL_NVP(m_loaded));
 }
 
 void load_model::on_train_begin(model *m) {
   if(!m_loaded) {
     for (const auto& d : m_dirs) {
-      m_loaded = load_model_weights(d, *m);
+      m_loaded = load_model_weights(d, *m, m_bundle_access);
       if(!m_loaded)
         LBANN_ERROR("Unable to reload model on train begin");
     }
@@ -192,7 +219,7 @@ void load_model::on_train_begin(model *m) {
 void load_model::on_test_begin(model *m) {
   if(!m_loaded) {
     for (const auto& d : m_dirs) {
-      m_loaded = load_model_weights(d, *m);
+      m_loaded = load_model_weights(d, *m, m_bundle_access);
       if(!m_loaded)
         LBANN_ERROR("Unable to reload model on test begin");
     }
@@ -205,14 +232,20 @@ build_load_model_callback_from_pbuf(
   const google::protobuf::Message& proto_msg, const std::shared_ptr<lbann_summary>&) {
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackLoadModel&>(proto_msg);
+  const auto bundle_access = (params.broadcast_bundle()
+                              ? weights_bundle_access::broadcast
+                              : weights_bundle_access::map);
   if(params.extension().size() != 0) {
     return make_unique<load_model>(
       parse_list<std::string>(params.dirs()),
-      params.extension());
+      params.extension(),
+      bundle_access);
   }
   else {
     return make_unique<load_model>(
-      parse_list<std::string>(params.dirs()));
+      parse_list<std::string>(params.dirs()),
+      "prototext",
+      bundle_access);
   }
 }
 
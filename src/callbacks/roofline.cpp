@@ -0,0 +1,267 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/callbacks/roofline.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include "lbann/layers/layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/serialize.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <callbacks.pb.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+namespace {
+
+/** Make sure asynchronous GPU work is included in a layer's time. */
+void synchronize_device(const Layer& l) {
+#ifdef LBANN_HAS_GPU
+  if (l.get_device_allocation() == El::Device::GPU) {
+    hydrogen::gpu::SynchronizeDevice();
+  }
+#endif // LBANN_HAS_GPU
+}
+
+/** One line of the roofline report. */
+struct report_row {
+  std::string name;
+  std::string type;
+  std::string pass;
+  double time = 0;
+  double gflops = 0;
+  double gbps = 0;
+  double intensity = 0;
+  bool compute_bound = false;
+  double efficiency = 0;
+  bool flagged = false;
+};
+
+} // namespace
+
+roofline::roofline(double peak_gflops, double peak_gbps, double flag_threshold)
+  : callback_base(),
+    m_peak_gflops(peak_gflops),
+    m_peak_gbps(peak_gbps),
+    m_flag_threshold(flag_threshold) {
+  if (m_peak_gflops <= 0 || m_peak_gbps <= 0) {
+    LBANN_ERROR("roofline callback requires positive peak compute rate "
+                "and memory bandwidth (got peak_gflops=", m_peak_gflops,
+                ", peak_gbps=", m_peak_gbps, ")");
+  }
+}
+
+roofline::roofline() : roofline(1.0, 1.0, 0.1) {}
+
+template <class Archive>
+void roofline::serialize(Archive & ar) {
+  ar(::cereal::make_nvp(
+       "BaseCallback",
+       ::cereal::base_class<callback_base>(this)),
+     CEREAL_NVP(m_peak_gflops),
+     CEREAL_NVP(m_peak_gbps),
+     CEREAL_NVP(m_flag_threshold));
+}
+
+void roofline::on_epoch_begin(model *m) {
+  m_fp_stats.clear();
+  m_bp_stats.clear();
+}
+
+void roofline::pass_begin(pass_stats& stats, const Layer& l) {
+  synchronize_device(l);
+  stats.start = get_time();
+}
+
+void roofline::pass_end(pass_stats& stats,
+                        const Layer& l,
+                        double flops,
+                        double bytes) {
+  synchronize_device(l);
+  stats.time += get_time() - stats.start;
+  stats.flops += flops;
+  stats.bytes += bytes;
+}
+
+void roofline::on_forward_prop_begin(model *m, Layer *l) {
+  pass_begin(m_fp_stats[l->get_name()], *l);
+}
+
+void roofline::on_forward_prop_end(model *m, Layer *l) {
+  const auto& c = static_cast<const sgd_execution_context&>(m->get_execution_context());
+  const El::Int mini_batch_size = c.get_current_mini_batch_size();
+  pass_end(m_fp_stats[l->get_name()], *l,
+           l->get_fp_flops(mini_batch_size),
+           l->get_fp_bytes(mini_batch_size));
+}
+
+void roofline::on_backward_prop_begin(model *m, Layer *l) {
+  pass_begin(m_bp_stats[l->get_name()], *l);
+}
+
+void roofline::on_backward_prop_end(model *m, Layer *l) {
+  const auto& c = static_cast<const sgd_execution_context&>(m->get_execution_context());
+  const El::Int mini_batch_size = c.get_current_mini_batch_size();
+  pass_end(m_bp_stats[l->get_name()], *l,
+           l->get_bp_flops(mini_batch_size),
+           l->get_bp_bytes(mini_batch_size));
+}
+
+void roofline::on_epoch_end(model *m) {
+  const auto& c = static_cast<const sgd_execution_context&>(m->get_execution_context());
+  auto& comm = *m->get_comm();
+  const El::Int num_layers = m->get_num_layers();
+
+  // The slowest process determines each time
+  std::vector<double> local_times(2 * num_layers, 0.0);
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& name = m->get_layer(i).get_name();
+    local_times[2 * i] = m_fp_stats[name].time;
+    local_times[2 * i + 1] = m_bp_stats[name].time;
+  }
+  std::vector<double> times(local_times.size());
+  comm.trainer_allreduce(local_times.data(),
+                         static_cast<int>(local_times.size()),
+                         times.data(),
+                         El::mpi::MAX);
+  if (!comm.am_trainer_master()) { return; }
+
+  // Place each pass on the roofline
+  const double num_procs = comm.get_procs_per_trainer();
+  std::vector<report_row> rows;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = m->get_layer(i);
+    for (int j = 0; j < 2; ++j) {
+      const auto& stats = (j == 0 ? m_fp_stats : m_bp_stats)[l.get_name()];
+      const double time = times[2 * i + j];
+      if (time <= 0) { continue; }
+      report_row row;
+      row.name = l.get_name();
+      row.type = l.get_type();
+      row.pass = (j == 0 ? "fp" : "bp");
+      row.time = time;
+      row.gflops = stats.flops / num_procs / time / 1e9;
+      row.gbps = stats.bytes / num_procs / time / 1e9;
+      if (stats.flops > 0) {
+        row.intensity = (stats.bytes > 0
+                         ? stats.flops / stats.bytes
+                         : std::numeric_limits<double>::infinity());
+        const double memory_bound = row.intensity * m_peak_gbps;
+        row.compute_bound = (memory_bound >= m_peak_gflops);
+        row.efficiency = row.gflops / std::min(m_peak_gflops, memory_bound);
+      }
+      else {
+        // Pure data movement is bounded by bandwidth alone
+        row.efficiency = row.gbps / m_peak_gbps;
+      }
+      row.flagged = row.efficiency < m_flag_threshold;
+      rows.push_back(std::move(row));
+    }
+  }
+
+  // Print per-layer table
+  std::ostringstream msg;
+  msg << "Model " << comm.get_trainer_rank()
+      << " roofline (training epoch " << c.get_epoch() - 1 << ", "
+      << "peak " << m_peak_gflops << " GFLOP/s and "
+      << m_peak_gbps << " GB/s per process) :\n";
+  msg << "  " << std::left
+      << std::setw(24) << "layer"
+      << std::setw(20) << "type"
+      << std::setw(5) << "pass"
+      << std::right
+      << std::setw(11) << "time (s)"
+      << std::setw(11) << "GFLOP/s"
+      << std::setw(10) << "GB/s"
+      << std::setw(11) << "FLOP/byte"
+      << std::setw(9) << "bound"
+      << std::setw(10) << "% bound"
+      << "\n";
+  for (const auto& row : rows) {
+    msg << "  " << std::left
+        << std::setw(24) << row.name
+        << std::setw(20) << row.type
+        << std::setw(5) << row.pass
+        << std::right << std::fixed
+        << std::setw(11) << std::setprecision(4) << row.time
+        << std::setw(11) << std::setprecision(1) << row.gflops
+        << std::setw(10) << std::setprecision(1) << row.gbps
+        << std::setw(11) << std::setprecision(2) << row.intensity
+        << std::setw(9) << (row.compute_bound ? "compute" : "memory")
+        << std::setw(9) << std::setprecision(1) << 100 * row.efficiency << "%"
+        << (row.flagged ? " *" : "")
+        << "\n";
+  }
+
+  // List flagged passes, most time first
+  std::vector<report_row> flagged;
+  std::copy_if(rows.begin(), rows.end(), std::back_inserter(flagged),
+               [](const report_row& row) { return row.flagged; });
+  std::sort(flagged.begin(), flagged.end(),
+            [](const report_row& a, const report_row& b) {
+              return a.time > b.time;
+            });
+  if (!flagged.empty()) {
+    msg << "  passes below " << 100 * m_flag_threshold
+        << "% of their bound (*), by time :\n";
+    for (const auto& row : flagged) {
+      msg << "    " << row.name << " (" << row.pass << ") : "
+          << std::setprecision(4) << row.time << "s, could save up to "
+          << row.time * (1 - row.efficiency) << "s\n";
+    }
+  }
+  std::cout << msg.str() << std::flush;
+
+}
+
+std::unique_ptr<callback_base>
+build_roofline_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg, const std::shared_ptr<lbann_summary>&) {
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackRoofline&>(proto_msg);
+  const double flag_threshold = (params.flag_threshold() > 0
+                                 ? params.flag_threshold()
+                                 : 0.1);
+  return make_unique<roofline>(params.peak_gflops(),
+                               params.peak_gbps(),
+                               flag_threshold);
+}
+
+} // namespace callback
+} // namespace lbann
+
+#define LBANN_CLASS_NAME callback::roofline
+#include <lbann/macros/register_class_with_cereal.hpp>
@@ -225,6 +225,22 @@ void timer::timing_end(model& m) {
 
       std::cout << report.str() << std::flush;
     }
+
+    // Report activation checkpointing overhead
+    if (mode == execution_mode::training
+        && m.get_num_checkpoint_segments() > 0) {
+      std::cout << m.get_name() << " (instance " << comm.get_trainer_rank() << ") "
+                << mode_string << " "
+                << "activation checkpointing : "
+                << m.get_checkpoint_bytes_released() / (1024.0 * 1024.0)
+                << " MiB released per step, "
+                << m.get_checkpoint_num_recomputes() << " recomputes, "
+                << m.get_checkpoint_recompute_time() << "s recompute time"
+                << std::endl;
+    }
+  }
+  if (mode == execution_mode::training) {
+    m.reset_checkpoint_counters();
   }
 
 }
@@ -34,8 +34,13 @@
 #include "lbann/utils/timer.hpp"
 #include "mpi.h"
 #include "omp.h"
+#include <cstdlib>
+#include <limits>
+#include <memory>
 #include <sstream>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
 namespace lbann {
 
@@ -60,8 +65,10 @@ namespace lbann {
 
 lbann_comm::lbann_comm(int ppm, El::mpi::Comm world)
   : m_world_comm(std::move(world)), m_procs_per_trainer(ppm),
-    m_num_trainer_barriers(0), m_num_intertrainer_barriers(0),
-    m_num_global_barriers(0), m_bytes_sent(0), m_bytes_received(0)
+    m_hierarchical_allreduce_threshold(256 * 1024),
+    m_hierarchical_blocking_allreduce(false), m_num_trainer_barriers(0),
+    m_num_intertrainer_barriers(0), m_num_global_barriers(0), m_bytes_sent(0),
+    m_bytes_received(0)
 {
 #ifdef LBANN_HAS_ALUMINUM
   // Don't have argc/argv here, but MPI should already be init'd.
@@ -79,6 +86,14 @@ lbann_comm::lbann_comm(int ppm, El::mpi::Comm world)
 
   // Setup threads
   setup_threads();
+
+  // Message size for switching to the hierarchical allreduce
+  if (const char* env = getenv("LBANN_HIERARCHICAL_ALLREDUCE_THRESHOLD")) {
+    m_hierarchical_allreduce_threshold = std::strtoull(env, nullptr, 10);
+  }
+  if (const char* env = getenv("LBANN_HIERARCHICAL_BLOCKING_ALLREDUCE")) {
+    m_hierarchical_blocking_allreduce = (std::atoi(env) != 0);
+  }
 }
 
 lbann_comm::~lbann_comm()
@@ -353,8 +368,481 @@ void nb_allreduce_impl(El::Matrix<T, El::Device::GPU>& m,
 }
 
 #endif // defined(LBANN_HAS_GPU) && defined(LBANN_HAS_ALUMINUM)
+
+// Node-aware hierarchical allreduce. The sub-communicators are
+// cached as an MPI attribute on the parent communicator, so they are
+// freed together with it.
+
+/** @brief Sub-communicators of a communicator split by compute node. */
+struct node_aware_comms
+{
+  /** @brief Processes of the parent comm on this node. */
+  MPI_Comm intra = MPI_COMM_NULL;
+  /** @brief Processes of the parent comm with the same rank in
+   *         their node. */
+  MPI_Comm inter = MPI_COMM_NULL;
+  int intra_rank = 0;
+  int intra_size = 1;
+  /** @brief Whether the hierarchical algorithm applies: several
+   *         nodes, each with the same number of processes (>1). */
+  bool enabled = false;
+};
+
+int free_node_aware_comms(MPI_Comm, int, void* attr, void*)
+{
+  auto* comms = static_cast<node_aware_comms*>(attr);
+  if (comms->intra != MPI_COMM_NULL)
+    MPI_Comm_free(&comms->intra);
+  if (comms->inter != MPI_COMM_NULL)
+    MPI_Comm_free(&comms->inter);
+  delete comms;
+  return MPI_SUCCESS;
+}
+
+/** @brief Get (and build on first use) the node-aware
+ *         sub-communicators of @c c. Collective over @c c on first use.
+ */
+node_aware_comms const& get_node_aware_comms(const El::mpi::Comm& c)
+{
+  static int keyval = [] {
+    int kv = MPI_KEYVAL_INVALID;
+    checkMPI(MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN,
+                                    free_node_aware_comms,
+                                    &kv,
+                                    nullptr));
+    return kv;
+  }();
+
+  MPI_Comm const mpi_comm = c.GetMPIComm();
+  void* attr = nullptr;
+  int found = 0;
+  checkMPI(MPI_Comm_get_attr(mpi_comm, keyval, &attr, &found));
+  if (found)
+    return *static_cast<node_aware_comms*>(attr);
+
+  auto* comms = new node_aware_comms;
+  int rank = 0, size = 1;
+  checkMPI(MPI_Comm_rank(mpi_comm, &rank));
+  checkMPI(MPI_Comm_size(mpi_comm, &size));
+  checkMPI(MPI_Comm_split_type(mpi_comm,
+                               MPI_COMM_TYPE_SHARED,
+                               rank,
+                               MPI_INFO_NULL,
+                               &comms->intra));
+  checkMPI(MPI_Comm_rank(comms->intra, &comms->intra_rank));
+  checkMPI(MPI_Comm_size(comms->intra, &comms->intra_size));
+  checkMPI(MPI_Comm_split(mpi_comm, comms->intra_rank, rank, &comms->inter));
+
+  // The slices only line up if every node has the same process count
+  int node_sizes[2] = {comms->intra_size, -comms->intra_size};
+  checkMPI(MPI_Allreduce(MPI_IN_PLACE,
+                         node_sizes,
+                         2,
+                         MPI_INT,
+                         MPI_MAX,
+                         mpi_comm));
+  comms->enabled = (node_sizes[0] == -node_sizes[1] &&
+                    comms->intra_size > 1 && comms->intra_size < size);
+
+  checkMPI(MPI_Comm_set_attr(mpi_comm, keyval, comms));
+  return *comms;
+}
+
+template <typename T>
+constexpr bool is_hierarchical_allreduce_type()
+{
+  return std::is_same<T, float>::value || std::is_same<T, double>::value;
+}
+
+template <typename T>
+MPI_Datatype get_hierarchical_allreduce_mpi_type()
+{
+  return (std::is_same<T, float>::value ? MPI_FLOAT : MPI_DOUBLE);
+}
+
+/** @brief Single non-blocking MPI allgather. */
+class all_gather_request final : public Al::multistage_request
+{
+public:
+  all_gather_request(const void* src,
+                     int src_count,
+                     void* rcv,
+                     int rcv_count,
+                     MPI_Datatype type,
+                     MPI_Comm comm)
+  {
+    checkMPI(MPI_Iallgather(src,
+                            src_count,
+                            type,
+                            rcv,
+                            rcv_count,
+                            type,
+                            comm,
+                            &m_request));
+  }
+
+  all_gather_request(all_gather_request const&) = delete;
+  all_gather_request& operator=(all_gather_request const&) = delete;
+
+  ~all_gather_request() override
+  {
+    // MPI may still be writing to the receive buffer
+    try {
+      progress(true);
+    }
+    catch (...) {
+    }
+  }
+
+  bool progress(bool block) override
+  {
+    if (m_done) {
+      return true;
+    }
+    int flag = 1;
+    if (block) {
+      checkMPI(MPI_Wait(&m_request, MPI_STATUS_IGNORE));
+    }
+    else {
+      checkMPI(MPI_Test(&m_request, &flag, MPI_STATUS_IGNORE));
+    }
+    m_done = (flag != 0);
+    return m_done;
+  }
+
+private:
+  MPI_Request m_request = MPI_REQUEST_NULL;
+  bool m_done = false;
+};
+
+template <typename T>
+MPI_Datatype get_all_gather_mpi_type();
+template <>
+MPI_Datatype get_all_gather_mpi_type<int>()
+{
+  return MPI_INT;
+}
+template <>
+MPI_Datatype get_all_gather_mpi_type<float>()
+{
+  return MPI_FLOAT;
+}
+template <>
+MPI_Datatype get_all_gather_mpi_type<double>()
+{
+  return MPI_DOUBLE;
+}
+
+/** @brief In-place hierarchical allreduce of a contiguous buffer. */
+template <typename T>
+void hierarchical_allreduce_buffer(T* buffer,
+                                   int count,
+                                   node_aware_comms const& comms,
+                                   MPI_Op op)
+{
+  auto const type = get_hierarchical_allreduce_mpi_type<T>();
+
+  // Block partition of the buffer among the processes on the node
+  std::vector<int> counts(comms.intra_size), displs(comms.intra_size);
+  for (int i = 0; i < comms.intra_size; ++i) {
+    const int begin = static_cast<int>(
+      (static_cast<long long>(count) * i) / comms.intra_size);
+    const int end = static_cast<int>(
+      (static_cast<long long>(count) * (i + 1)) / comms.intra_size);
+    counts[i] = end - begin;
+    displs[i] = begin;
+  }
+  const int my_count = counts[comms.intra_rank];
+  T* my_slice = buffer + displs[comms.intra_rank];
+
+  // Intra-node reduce-scatter into this process's slice
+  std::vector<T> slice(my_count);
+  checkMPI(MPI_Reduce_scatter(buffer,
+                              slice.data(),
+                              counts.data(),
+                              type,
+                              op,
+                              comms.intra));
+
+  // Inter-node allreduce on 1/ppn of the data
+  checkMPI(MPI_Allreduce(slice.data(),
+                         my_slice,
+                         my_count,
+                         type,
+                         op,
+                         comms.inter));
+
+  // Intra-node allgather of the reduced slices
+  checkMPI(MPI_Allgatherv(MPI_IN_PLACE,
+                          0,
+                          type,
+                          buffer,
+                          counts.data(),
+                          displs.data(),
+                          type,
+                          comms.intra));
+}
+
+/** @brief Non-blocking in-place hierarchical allreduce of a CPU
+ *         matrix.
+ *
+ *  Runs the steps of hierarchical_allreduce_buffer as non-blocking
+ *  MPI collectives. The next step is started when progress finds the
+ *  current one complete.
+ */
+template <typename T>
+class hierarchical_allreduce_request final : public Al::multistage_request
+{
+public:
+  hierarchical_allreduce_request(El::Matrix<T, El::Device::CPU>& m,
+                                 node_aware_comms const& comms,
+                                 MPI_Op op)
+    : m_matrix{m},
+      m_comms{comms},
+      m_op{op},
+      m_type{get_hierarchical_allreduce_mpi_type<T>()},
+      m_counts(comms.intra_size),
+      m_displs(comms.intra_size)
+  {
+    // MPI needs a contiguous buffer
+    if (m.Height() == m.LDim() || m.Width() == 1) {
+      m_buffer = m.Buffer();
+    }
+    else {
+      m_contiguous = m;
+      m_buffer = m_contiguous.Buffer();
+    }
+
+    // Block partition of the buffer among the processes on the node
+    const El::Int count = m.Height() * m.Width();
+    for (int i = 0; i < comms.intra_size; ++i) {
+      const int begin = static_cast<int>((count * i) / comms.intra_size);
+      const int end = static_cast<int>((count * (i + 1)) / comms.intra_size);
+      m_counts[i] = end - begin;
+      m_displs[i] = begin;
+    }
+    m_slice.resize(m_counts[comms.intra_rank]);
+
+    // Intra-node reduce-scatter into this process's slice
+    checkMPI(MPI_Ireduce_scatter(m_buffer,
+                                 m_slice.data(),
+                                 m_counts.data(),
+                                 m_type,
+                                 m_op,
+                                 m_comms.intra,
+                                 &m_request));
+  }
+
+  hierarchical_allreduce_request(hierarchical_allreduce_request const&) =
+    delete;
+  hierarchical_allreduce_request&
+  operator=(hierarchical_allreduce_request const&) = delete;
+
+  ~hierarchical_allreduce_request() override
+  {
+    // MPI may still be writing to the buffers
+    try {
+      progress(true);
+    }
+    catch (...) {
+    }
+  }
+
+  bool progress(bool block) override
+  {
+    while (m_stage != stage::done) {
+      int flag = 1;
+      if (block) {
+        checkMPI(MPI_Wait(&m_request, MPI_STATUS_IGNORE));
+      }
+      else {
+        checkMPI(MPI_Test(&m_request, &flag, MPI_STATUS_IGNORE));
+      }
+      if (!flag) {
+        return false;
+      }
+      start_next_stage();
+    }
+    return true;
+  }
+
+private:
+  enum class stage
+  {
+    reduce_scatter,
+    allreduce,
+    allgather,
+    done
+  };
+
+  void start_next_stage()
+  {
+    const int rank = m_comms.intra_rank;
+    switch (m_stage) {
+    case stage::reduce_scatter:
+      // Inter-node allreduce on 1/ppn of the data
+      checkMPI(MPI_Iallreduce(m_slice.data(),
+                              m_buffer + m_displs[rank],
+                              m_counts[rank],
+                              m_type,
+                              m_op,
+                              m_comms.inter,
+                              &m_request));
+      m_stage = stage::allreduce;
+      break;
+    case stage::allreduce:
+      // Intra-node allgather of the reduced slices
+      checkMPI(MPI_Iallgatherv(MPI_IN_PLACE,
+                               0,
+                               m_type,
+                               m_buffer,
+                               m_counts.data(),
+                               m_displs.data(),
+                               m_type,
+                               m_comms.intra,
+                               &m_request));
+      m_stage = stage::allgather;
+      break;
+    case stage::allgather:
+      if (m_buffer != m_matrix.Buffer()) {
+        El::Copy(m_contiguous, m_matrix);
+      }
+      m_stage = stage::done;
+      break;
+    case stage::done:
+      break;
+    }
+  }
+
+  El::Matrix<T, El::Device::CPU>& m_matrix;
+  El::Matrix<T, El::Device::CPU> m_contiguous;
+  T* m_buffer = nullptr;
+  node_aware_comms const& m_comms;
+  MPI_Op m_op;
+  MPI_Datatype m_type;
+  std::vector<int> m_counts;
+  std::vector<int> m_displs;
+  std::vector<T> m_slice;
+  MPI_Request m_request = MPI_REQUEST_NULL;
+  stage m_stage = stage::reduce_scatter;
+};
+
+/** @brief Start a non-blocking hierarchical allreduce of a CPU
+ *         matrix.
+ *  @returns false if the hierarchical algorithm does not apply.
+ */
+template <typename T>
+bool try_nb_hierarchical_allreduce(El::Matrix<T, El::Device::CPU>& m,
+                                   const El::mpi::Comm& c,
+                                   Al::request& req,
+                                   El::mpi::Op const& op)
+{
+  if constexpr (!is_hierarchical_allreduce_type<T>()) {
+    return false;
+  }
+  else {
+    if (m.Height() * m.Width() > std::numeric_limits<int>::max()) {
+      return false;
+    }
+    auto const& comms = get_node_aware_comms(c);
+    if (!comms.enabled) {
+      return false;
+    }
+    req.multistage_req =
+      std::make_shared<hierarchical_allreduce_request<T>>(m, comms, op.op);
+    return true;
+  }
+}
+
+/** @brief Hierarchical allreduce of a CPU matrix.
+ *  @returns false if the hierarchical algorithm does not apply.
+ */
+template <typename T>
+bool try_hierarchical_allreduce(El::Matrix<T, El::Device::CPU>& m,
+                                const El::mpi::Comm& c,
+                                El::mpi::Op const& op)
+{
+  if constexpr (!is_hierarchical_allreduce_type<T>()) {
+    return false;
+  }
+  else {
+    const El::Int size = m.Height() * m.Width();
+    if (size > std::numeric_limits<int>::max()) {
+      return false;
+    }
+    auto const& comms = get_node_aware_comms(c);
+    if (!comms.enabled) {
+      return false;
+    }
+    if (m.Height() == m.LDim() || m.Width() == 1) {
+      hierarchical_allreduce_buffer(m.Buffer(), size, comms, op.op);
+    }
+    else {
+      El::Matrix<T, El::Device::CPU> contiguous_m(m);
+      hierarchical_allreduce_buffer(contiguous_m.Buffer(), size, comms, op.op);
+      El::Copy(contiguous_m, m);
+    }
+    return true;
+  }
+}
+
 } // namespace
 
+template <typename TensorDataType>
+void lbann_comm::hierarchical_allreduce(El::AbstractMatrix<TensorDataType>& m,
+                                        const El::mpi::Comm& c,
+                                        El::mpi::Op op) const
+{
+  if (m.GetDevice() != El::Device::CPU) {
+    LBANN_ERROR("hierarchical allreduce only supports CPU matrices");
+  }
+  if (El::mpi::Size(c) == 1 || m.Height() < 1 || m.Width() < 1) {
+    return;
+  }
+  auto& cpu_m = static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(m);
+  if (!try_hierarchical_allreduce(cpu_m, c, op)) {
+    allreduce_impl(cpu_m, c, op);
+  }
+}
+
+template <typename TensorDataType>
+void lbann_comm::nb_hierarchical_allreduce(
+  El::AbstractMatrix<TensorDataType>& m,
+  const El::mpi::Comm& c,
+  Al::request& req,
+  El::mpi::Op op) const
+{
+  if (m.GetDevice() != El::Device::CPU) {
+    LBANN_ERROR("hierarchical allreduce only supports CPU matrices");
+  }
+  if (El::mpi::Size(c) == 1 || m.Height() < 1 || m.Width() < 1) {
+    return;
+  }
+  auto& cpu_m = static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(m);
+  if (!try_nb_hierarchical_allreduce(cpu_m, c, req, op)) {
+    nb_allreduce_impl(cpu_m, c, req, op);
+  }
+}
+
+template <typename T>
+void lbann_comm::nb_all_gather(const T* src,
+                               int src_count,
+                               T* rcv,
+                               int rcv_count,
+                               const El::mpi::Comm& c,
+                               Al::request& req) const
+{
+  m_bytes_sent += sizeof(T) * src_count;
+  m_bytes_received += sizeof(T) * rcv_count * (El::mpi::Size(c) - 1);
+  req.multistage_req = std::make_shared<all_gather_request>(
+    src,
+    src_count,
+    rcv,
+    rcv_count,
+    get_all_gather_mpi_type<T>(),
+    c.GetMPIComm());
+}
+
 template <typename TensorDataType>
 void lbann_comm::allreduce(El::AbstractMatrix<TensorDataType>& m,
                            const El::mpi::Comm& c,
@@ -370,6 +858,11 @@ void lbann_comm::allreduce(El::AbstractMatrix<TensorDataType>& m,
 
   switch (m.GetDevice()) {
   case El::Device::CPU:
+    if (m_hierarchical_blocking_allreduce &&
+        sizeof(TensorDataType) * local_size >=
+          m_hierarchical_allreduce_threshold) {
+      return hierarchical_allreduce(m, c, op);
+    }
     return allreduce_impl(
       static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(m),
       c,
@@ -408,6 +901,10 @@ void lbann_comm::nb_allreduce(El::AbstractMatrix<TensorDataType>& m,
 
   switch (m.GetDevice()) {
   case El::Device::CPU:
+    if (sizeof(TensorDataType) * local_size >=
+        m_hierarchical_allreduce_threshold) {
+      return nb_hierarchical_allreduce(m, c, req, op);
+    }
     return nb_allreduce_impl(
       static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(m),
       c,
@@ -435,6 +932,10 @@ void lbann_comm::nb_allreduce(El::AbstractDistMatrix<TensorDataType>& m,
 
 void lbann_comm::wait(Al::request& req) const
 {
+  if (req.multistage_req != nullptr) {
+    req.multistage_req->progress(true);
+    req.multistage_req.reset();
+  }
 #ifdef LBANN_HAS_ALUMINUM
   if (req.mpi_req != Al::mpi_null_req) {
     ::Al::Wait<::Al::MPIBackend>(req.mpi_req);
@@ -457,6 +958,14 @@ void lbann_comm::wait(Al::request& req) const
 bool lbann_comm::test(Al::request& req) const
 {
   bool req_test = true;
+  if (req.multistage_req != nullptr) {
+    if (req.multistage_req->progress(false)) {
+      req.multistage_req.reset();
+    }
+    else {
+      req_test = false;
+    }
+  }
 #ifdef LBANN_HAS_ALUMINUM
   if (req.mpi_req != Al::mpi_null_req) {
     req_test = req_test && ::Al::Test<::Al::MPIBackend>(req.mpi_req);
@@ -728,6 +1237,14 @@ int get_rank_in_world()
 }
 
 #define PROTO(T)                                                               \
+  template void lbann_comm::hierarchical_allreduce(El::AbstractMatrix<T>& m,   \
+                                                   const El::mpi::Comm& c,     \
+                                                   El::mpi::Op op) const;      \
+  template void lbann_comm::nb_hierarchical_allreduce(                         \
+    El::AbstractMatrix<T>& m,                                                  \
+    const El::mpi::Comm& c,                                                    \
+    Al::request& req,                                                          \
+    El::mpi::Op op) const;                                                     \
   template void lbann_comm::allreduce(El::AbstractMatrix<T>& m,                \
                                       const El::mpi::Comm& c,                  \
                                       El::mpi::Op op) const;                   \
@@ -746,5 +1263,18 @@ int get_rank_in_world()
 #define LBANN_INSTANTIATE_CPU_HALF
 #define LBANN_INSTANTIATE_GPU_HALF
 #include "lbann/macros/instantiate.hpp"
+#undef PROTO
+
+#define PROTO(T)                                                               \
+  template void lbann_comm::nb_all_gather(const T* src,                        \
+                                          int src_count,                       \
+                                          T* rcv,                              \
+                                          int rcv_count,                       \
+                                          const El::mpi::Comm& c,              \
+                                          Al::request& req) const
+PROTO(int);
+PROTO(float);
+PROTO(double);
+#undef PROTO
 
 } // namespace lbann
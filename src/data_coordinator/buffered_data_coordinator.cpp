@@ -31,6 +31,7 @@
 #include "lbann/data_readers/utils/input_data_type.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/hydrogen_utils.hpp"
 #include "lbann/utils/profiling.hpp"
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/serialize.hpp"
@@ -209,6 +210,20 @@ bool buffered_data_coordinator<TensorDataType>::epoch_complete(execution_mode mo
   return m_data_set_processed;
 }
 
+template <typename TensorDataType>
+size_t buffered_data_coordinator<TensorDataType>::get_host_io_buffer_bytes() const {
+  size_t bytes = 0;
+  for (const auto& buffer_map : m_data_buffers) {
+    for (const auto& buffer : buffer_map) {
+      if (buffer.second == nullptr) { continue; }
+      for (const auto& input_buffer : buffer.second->m_input_buffers) {
+        bytes += get_host_memory_bytes(input_buffer.second.get());
+      }
+    }
+  }
+  return bytes;
+}
+
 template <typename TensorDataType>
 auto buffered_data_coordinator<TensorDataType>::get_active_buffer_map(execution_mode mode) const -> const data_buffer_map_t& {
   return m_data_buffers.at(get_active_buffer_idx(mode) % m_data_buffers.size());
@@ -26,10 +26,13 @@
 
 #include "lbann/comm_impl.hpp"
 #include <lbann/data_coordinator/data_coordinator.hpp>
+#include <lbann/data_store/data_store_conduit.hpp>
 #include <lbann/trainers/trainer.hpp>
 #include <lbann/utils/distconv.hpp>
 #include <lbann/utils/serialize.hpp>
 
+#include <set>
+
 namespace lbann {
 
 template <class Archive>
@@ -235,6 +238,20 @@ int data_coordinator::get_current_world_master_mini_batch_adjustment(execution_m
   return (data_reader != nullptr) ? data_reader->get_current_world_master_mini_batch_adjustment(model_rank) : 0;
 }
 
+size_t data_coordinator::get_data_store_bytes() const {
+  // Data readers may be shared between execution modes
+  std::set<const data_store_conduit*> data_stores;
+  size_t bytes = 0;
+  for (const auto& dr : m_data_readers) {
+    if (dr.second == nullptr) { continue; }
+    auto* data_store = dr.second->get_data_store_ptr();
+    if (data_store != nullptr && data_stores.insert(data_store).second) {
+      bytes += data_store->get_mem_usage();
+    }
+  }
+  return bytes;
+}
+
 // save state of IO to a checkpoint
 bool data_coordinator::save_to_checkpoint_shared(persist& p) const {
   // save state of data readers from input layer
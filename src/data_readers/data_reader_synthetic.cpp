@@ -88,6 +88,28 @@ bool data_reader_synthetic::fetch_response(CPUMat& Y, int data_id, int mb_idx) {
   return true;
 }
 
+void data_reader_synthetic::generate_mini_batch(CPUMat& X,
+                                                CPUMat& Y,
+                                                int mini_batch_size) {
+  X.Resize(get_linearized_data_size(), mini_batch_size);
+  if (m_num_labels > 0) {
+    El::Zeros(Y, m_num_labels, mini_batch_size);
+  }
+  else if (!m_response_dimensions.empty()) {
+    Y.Resize(get_linearized_response_size(), mini_batch_size);
+  }
+  auto io_rng = set_io_generators_local_index(0);
+  for (int mb_idx = 0; mb_idx < mini_batch_size; ++mb_idx) {
+    fetch_datum(X, mb_idx, mb_idx);
+    if (m_num_labels > 0) {
+      Y.Set(fast_rand_int(get_fast_io_generator(), m_num_labels), mb_idx, 1);
+    }
+    else if (!m_response_dimensions.empty()) {
+      fetch_response(Y, mb_idx, mb_idx);
+    }
+  }
+}
+
 void data_reader_synthetic::load() {
   m_shuffled_indices.clear();
   m_shuffled_indices.resize(m_num_samples);
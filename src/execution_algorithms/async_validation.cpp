@@ -0,0 +1,453 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/execution_algorithms/async_validation.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/metrics/metric.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <training_algorithm.pb.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using TensorDataType = lbann::DataType;
+using WeightsType = lbann::data_type_weights<TensorDataType>;
+
+/** @brief Weights whose values are sent in a snapshot. */
+std::vector<WeightsType*> get_snapshot_weights(lbann::model const& m)
+{
+  std::vector<WeightsType*> snapshot_weights;
+  for (auto&& w_ptr : m.get_weights()) {
+    auto* w = dynamic_cast<WeightsType*>(w_ptr);
+    if (w == nullptr) {
+      LBANN_ERROR("asynchronous validation only supports weights with the "
+                  "default data type, but weights \"",
+                  w_ptr->get_name(),
+                  "\" have a different one");
+    }
+    snapshot_weights.push_back(w);
+  }
+  return snapshot_weights;
+}
+
+/** @brief Number of local weights entries in a snapshot. */
+size_t get_snapshot_size(lbann::model const& m)
+{
+  size_t size = 0;
+  for (auto const* w : get_snapshot_weights(m)) {
+    auto const& values = w->get_values();
+    size += values.LocalHeight() * values.LocalWidth();
+  }
+  return size;
+}
+
+/** @brief Copy local weights values into a host buffer. */
+void pack_snapshot(lbann::model const& m, std::vector<TensorDataType>& buffer)
+{
+  buffer.resize(get_snapshot_size(m));
+  size_t offset = 0;
+  for (auto const* w : get_snapshot_weights(m)) {
+    auto const& local_mat = w->get_values().LockedMatrix();
+    El::Matrix<TensorDataType, El::Device::CPU> buffer_view;
+    buffer_view.Attach(local_mat.Height(),
+                       local_mat.Width(),
+                       buffer.data() + offset,
+                       local_mat.Height());
+    El::Copy(local_mat, buffer_view);
+    offset += local_mat.Height() * local_mat.Width();
+  }
+}
+
+/** @brief Copy a host buffer into the local weights values. */
+void unpack_snapshot(std::vector<TensorDataType> const& buffer,
+                     lbann::model& m)
+{
+  size_t offset = 0;
+  for (auto* w : get_snapshot_weights(m)) {
+    auto& local_mat = w->get_values().Matrix();
+    El::Matrix<TensorDataType, El::Device::CPU> buffer_view;
+    buffer_view.LockedAttach(local_mat.Height(),
+                             local_mat.Width(),
+                             buffer.data() + offset,
+                             local_mat.Height());
+    El::Copy(buffer_view, local_mat);
+    offset += local_mat.Height() * local_mat.Width();
+  }
+}
+
+/** @brief Messages are only split if they exceed the maximum MPI
+ *  count. */
+constexpr size_t max_count = std::numeric_limits<int>::max();
+
+/** @brief Snapshot sent to the evaluating trainer, along with the
+ *  reply that is expected for it.
+ *
+ *  The header holds the epoch (or -1 for the final weights) and the
+ *  size of the buffer. The results hold the early stop flag, the
+ *  objective function, and the metrics.
+ */
+struct snapshot
+{
+  size_t epoch = 0;
+  std::vector<El::Int> header;
+  std::vector<TensorDataType> buffer;
+  std::vector<lbann::EvalType> results;
+  El::mpi::Request<El::Int> header_request;
+  std::vector<El::mpi::Request<TensorDataType>> buffer_requests;
+  El::mpi::Request<lbann::EvalType> results_request;
+};
+
+/** @brief Pack the weights and post the messages of a snapshot. */
+void send_snapshot(lbann::lbann_comm const& comm,
+                   lbann::model const& m,
+                   El::Int evaluator,
+                   El::Int epoch,
+                   snapshot& s)
+{
+  pack_snapshot(m, s.buffer);
+  s.header = {epoch, static_cast<El::Int>(s.buffer.size())};
+  comm.nb_send(s.header.data(), s.header.size(), evaluator, s.header_request);
+  for (size_t pos = 0; pos < s.buffer.size(); pos += max_count) {
+    int const count = static_cast<int>(std::min(max_count,
+                                                s.buffer.size() - pos));
+    s.buffer_requests.emplace_back();
+    comm.nb_send(s.buffer.data() + pos,
+                 count,
+                 evaluator,
+                 s.buffer_requests.back());
+  }
+  if (epoch >= 0) {
+    s.results.resize(2 + m.get_metrics().size());
+    comm.nb_recv(s.results.data(),
+                 s.results.size(),
+                 evaluator,
+                 s.results_request);
+  }
+}
+
+/** @brief Report the results of the oldest snapshots.
+ *
+ *  Results that have arrived on every process of the trainer are
+ *  reported, as well as the oldest ones beyond @c max_outstanding,
+ *  which are waited for. Every process reports the same snapshots, so
+ *  they agree on early stopping.
+ */
+void collect_results(lbann::lbann_comm const& comm,
+                     lbann::sgd_execution_context& c,
+                     lbann::model const& m,
+                     std::deque<snapshot>& snapshots,
+                     size_t max_outstanding)
+{
+  int num_ready = 0;
+  for (auto& s : snapshots) {
+    if (!comm.test(s.results_request)) {
+      break;
+    }
+    ++num_ready;
+  }
+  num_ready = comm.trainer_allreduce(num_ready, El::mpi::MIN);
+  size_t num_collected = num_ready;
+  if (snapshots.size() > max_outstanding) {
+    num_collected =
+      std::max(num_collected, snapshots.size() - max_outstanding);
+  }
+
+  for (size_t i = 0; i < num_collected; ++i) {
+    auto& s = snapshots.front();
+    comm.wait(s.results_request);
+    comm.wait(s.header_request);
+    comm.wait_all(s.buffer_requests);
+    const bool early_stop = (s.results[0] != lbann::EvalType(0));
+    if (comm.am_trainer_master()) {
+      const auto metrics = m.get_metrics();
+      std::ostringstream msg;
+      msg << m.get_name() << " (trainer " << comm.get_trainer_rank()
+          << ") asynchronous validation after " << s.epoch << " epochs ("
+          << c.get_epoch() - s.epoch << " epochs behind training)\n"
+          << "  objective function : " << s.results[1] << "\n";
+      for (size_t j = 0; j < metrics.size(); ++j) {
+        msg << "  " << metrics[j]->name() << " : " << s.results[2 + j]
+            << metrics[j]->get_unit() << "\n";
+      }
+      if (early_stop) {
+        msg << "  early stopping requested\n";
+      }
+      std::cout << msg.str() << std::flush;
+    }
+    if (early_stop) {
+      c.set_early_stop(true);
+    }
+    snapshots.pop_front();
+  }
+}
+
+} // namespace
+
+namespace lbann {
+
+AsyncValidation::AsyncValidation(
+  std::string name,
+  std::unique_ptr<sgd_termination_criteria> stop,
+  size_t max_lag)
+  : BaseType(std::move(name), std::move(stop)),
+    m_max_lag{max_lag}
+{
+  if (m_max_lag == 0) {
+    LBANN_ERROR("asynchronous validation lag must be positive");
+  }
+}
+
+std::string AsyncValidation::get_type() const { return "AsyncValidation"; }
+
+// =============================================
+// Evaluation and training
+// =============================================
+
+void AsyncValidation::apply(execution_context& context,
+                            model& model,
+                            data_coordinator& dc,
+                            execution_mode mode)
+{
+  if (mode != execution_mode::training) {
+    sgd_training_algorithm::apply(context, model, dc, mode);
+    return;
+  }
+  auto& c = dynamic_cast<sgd_execution_context&>(context);
+  auto const& comm = *model.get_comm();
+  const El::Int num_trainers = comm.get_num_trainers();
+  const El::Int num_pairs = num_trainers / 2;
+  const El::Int trainer = comm.get_trainer_rank();
+  if (num_trainers % 2 != 0 && comm.am_world_master()) {
+    LBANN_WARNING("asynchronous validation pairs up trainers, but there "
+                  "are ",
+                  num_trainers,
+                  " trainers; trainer ",
+                  num_trainers - 1,
+                  " will validate synchronously");
+  }
+  if (trainer < num_pairs) {
+    train_with_snapshots(c, model, dc, trainer + num_pairs);
+  }
+  else if (trainer < 2 * num_pairs) {
+    evaluate_snapshots(c, model, dc, trainer - num_pairs);
+  }
+  else {
+    sgd_training_algorithm::apply(context, model, dc, mode);
+  }
+}
+
+void AsyncValidation::train_with_snapshots(sgd_execution_context& c,
+                                           model& model,
+                                           data_coordinator& dc,
+                                           El::Int evaluator)
+{
+  auto const& comm = *model.get_comm();
+  auto const& term = get_stopping_criteria();
+
+  // Initialize some state so it knows we're training now.
+  c.set_execution_mode(execution_mode::training);
+  model.reset_mode(c, execution_mode::training);
+  dc.reset_mode(c);
+
+  // Run callbacks.
+  do_train_begin_cbs(model);
+
+  // Start iterating
+  std::deque<snapshot> snapshots;
+  bool is_start_of_epoch = true;
+  c.start_timer();
+  while (!term(c)) {
+
+    if (is_start_of_epoch) {
+      // Initialize epoch
+      model.reset_mode(c, execution_mode::training);
+      model.reset_epoch_statistics(execution_mode::training);
+      dc.reset_mode(c);
+      do_epoch_begin_cbs(model);
+      is_start_of_epoch = false;
+    }
+
+    // Train a mini batch. Returns "true" if the data_coordinator
+    // detects the end of an epoch.
+    if (train_mini_batch(c, model, dc)) {
+      // Finalize epoch
+      c.inc_epoch();
+      model.reconcile_weight_values();
+      do_epoch_end_cbs(model);
+
+      // Hand the weights to the evaluator and keep training
+      if (dc.is_execution_mode_valid(execution_mode::validation)) {
+        snapshots.emplace_back();
+        snapshots.back().epoch = c.get_epoch();
+        send_snapshot(comm,
+                      model,
+                      evaluator,
+                      static_cast<El::Int>(c.get_epoch()),
+                      snapshots.back());
+        collect_results(comm, c, model, snapshots, m_max_lag);
+      }
+
+      // Trigger new epoch stuff next iteration (if there is one).
+      is_start_of_epoch = true;
+    }
+  }
+  c.stop_timer();
+
+  // Report the remaining evaluations and leave the evaluator with
+  // the final weights
+  collect_results(comm, c, model, snapshots, 0);
+  snapshot final_weights;
+  send_snapshot(comm, model, evaluator, -1, final_weights);
+  comm.wait(final_weights.header_request);
+  comm.wait_all(final_weights.buffer_requests);
+
+  // Reset the model back to the training execution context prior to
+  // end of training callbacks
+  model.reset_mode(c, execution_mode::training);
+  do_train_end_cbs(model);
+}
+
+void AsyncValidation::evaluate_snapshots(sgd_execution_context& c,
+                                         model& model,
+                                         data_coordinator& dc,
+                                         El::Int trainer)
+{
+  auto const& comm = *model.get_comm();
+  const execution_mode mode = execution_mode::validation;
+  std::vector<El::Int> header(2);
+  std::vector<TensorDataType> buffer(get_snapshot_size(model));
+  std::vector<EvalType> results(2 + model.get_metrics().size());
+  while (true) {
+
+    // Receive the weights
+    comm.recv(header.data(), header.size(), trainer);
+    if (header[1] != static_cast<El::Int>(buffer.size())) {
+      LBANN_ERROR("asynchronous validation snapshot from trainer ",
+                  trainer,
+                  " has ",
+                  header[1],
+                  " local weights entries, but ",
+                  buffer.size(),
+                  " were expected");
+    }
+    for (size_t pos = 0; pos < buffer.size(); pos += max_count) {
+      int const count = static_cast<int>(std::min(max_count,
+                                                  buffer.size() - pos));
+      comm.recv(buffer.data() + pos, count, trainer);
+    }
+    unpack_snapshot(buffer, model);
+    if (header[0] < 0) {
+      break;
+    }
+
+    // Evaluate on validation set
+    //
+    // Note: Copied from sgd_training_algorithm.cpp.
+    sgd_execution_context evaluation_context(mode,
+                                             dc.get_mini_batch_size(mode));
+    size_t num_validation_epochs = 1UL;
+    if (header[0] > 1) {
+      evaluation_context.inc_epoch();
+      ++num_validation_epochs;
+    }
+    evaluate(evaluation_context,
+             model,
+             dc,
+             mode,
+             epoch_termination_criteria(num_validation_epochs));
+
+    // Reply with the results
+    const auto metrics = model.get_metrics();
+    results[0] = evaluation_context.get_early_stop() ? 1 : 0;
+    results[1] = model.get_objective_function()->get_mean_value(mode);
+    for (size_t i = 0; i < metrics.size(); ++i) {
+      results[2 + i] = metrics[i]->get_mean_value(mode);
+    }
+    comm.send(results.data(),
+              results.size(),
+              trainer,
+              comm.get_rank_in_trainer());
+  }
+
+  // Leave the model with this algorithm's execution context
+  model.reset_mode(c, execution_mode::training);
+}
+
+} // namespace lbann
+
+template <>
+std::unique_ptr<lbann::AsyncValidation>
+lbann::make<lbann::AsyncValidation>(google::protobuf::Message const& msg_in)
+{
+  auto const& params =
+    dynamic_cast<lbann_data::TrainingAlgorithm const&>(msg_in);
+
+  lbann_data::AsyncValidation async_params;
+  LBANN_ASSERT(params.parameters().UnpackTo(&async_params));
+
+  // SGD parameters
+  auto const& stopping_criteria = async_params.sgd().stopping_criteria();
+  std::unique_ptr<lbann::sgd_termination_criteria> stopping;
+  switch (stopping_criteria.criterion_case()) {
+  case lbann_data::SGD::TerminationCriteria::kMaxBatches:
+    stopping = lbann::make_unique<lbann::batch_termination_criteria>(
+      stopping_criteria.max_batches());
+    break;
+  case lbann_data::SGD::TerminationCriteria::kMaxEpochs:
+    stopping = lbann::make_unique<lbann::epoch_termination_criteria>(
+      stopping_criteria.max_epochs());
+    break;
+  case lbann_data::SGD::TerminationCriteria::kMaxSeconds:
+    stopping = lbann::make_unique<lbann::seconds_termination_criteria>(
+      stopping_criteria.max_seconds());
+    break;
+  default:
+    LBANN_ERROR("No stopping criteria specified.");
+  }
+
+  const size_t max_lag =
+    (async_params.max_lag() > 0 ? async_params.max_lag() : 1UL);
+  return make_unique<AsyncValidation>(params.name(),
+                                      std::move(stopping),
+                                      max_lag);
+}
@@ -0,0 +1,410 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/execution_algorithms/bottleneck_analysis.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/data_readers/data_reader_synthetic.hpp"
+#include "lbann/layers/io/input_layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/optimizers/optimizer.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/timer.hpp"
+#include "lbann/weights/weights.hpp"
+
+#include <training_algorithm.pb.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+bool is_input_layer(lbann::Layer const& l) { return l.get_type() == "input"; }
+
+/** @brief Feed an input layer a synthetic mini-batch.
+ *
+ *  The input layer keeps the mini-batch until @c clear_samples is
+ *  called.
+ *  @returns Whether the layer is an input layer on device @c Dev.
+ */
+template <El::Device Dev>
+bool load_synthetic_mini_batch(lbann::Layer& l, int mini_batch_size)
+{
+  using InputLayerType =
+    lbann::input_layer<lbann::DataType, lbann::data_layout::DATA_PARALLEL, Dev>;
+  auto* input = dynamic_cast<InputLayerType*>(&l);
+  if (input == nullptr) {
+    return false;
+  }
+  const bool has_targets = (l.get_num_children() > 1);
+  const std::vector<int> dims = {l.get_output_size(0)};
+  std::unique_ptr<lbann::data_reader_synthetic> reader;
+  if (has_targets && input->is_for_regression()) {
+    reader = lbann::make_unique<lbann::data_reader_synthetic>(
+      mini_batch_size,
+      dims,
+      std::vector<int>{l.get_output_size(1)},
+      false);
+  }
+  else {
+    reader = lbann::make_unique<lbann::data_reader_synthetic>(
+      mini_batch_size,
+      dims,
+      has_targets ? l.get_output_size(1) : 0,
+      false);
+  }
+
+  // Each process generates the whole mini-batch, so no communication
+  // is needed to distribute it
+  auto const& grid = l.get_comm()->get_trainer_grid();
+  El::DistMatrix<lbann::DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+    samples(l.get_output_size(0), mini_batch_size, grid),
+    targets(has_targets ? l.get_output_size(1) : 0, mini_batch_size, grid);
+  reader->generate_mini_batch(samples.Matrix(),
+                              targets.Matrix(),
+                              mini_batch_size);
+  input->set_samples(samples);
+  if (has_targets) {
+    input->set_targets(targets);
+  }
+  return true;
+}
+
+/** @brief Copy of a weights object's values and optimizer state. */
+struct weights_snapshot
+{
+  lbann::weights* target;
+  std::unique_ptr<lbann::weights> values;
+  std::unique_ptr<lbann::optimizer> opt;
+};
+
+std::vector<weights_snapshot> snapshot_weights(lbann::model& m)
+{
+  std::vector<weights_snapshot> snapshots;
+  for (auto* w : m.get_weights()) {
+    auto* opt = w->get_optimizer();
+    snapshots.push_back({w, w->clone(), opt ? opt->clone() : nullptr});
+  }
+  return snapshots;
+}
+
+void restore_weights(std::vector<weights_snapshot>& snapshots)
+{
+  for (auto& s : snapshots) {
+    s.target->set_values(s.values->get_values());
+    if (s.opt != nullptr) {
+      s.target->set_optimizer(std::move(s.opt));
+    }
+  }
+}
+
+void set_skip_gradient_allreduce(lbann::model& m, bool skip)
+{
+  for (auto* w : m.get_weights()) {
+    if (auto* opt = w->get_optimizer()) {
+      opt->set_skip_gradient_allreduce(skip);
+    }
+  }
+}
+
+} // namespace
+
+namespace lbann {
+
+BottleneckAnalysis::BottleneckAnalysis(std::string name,
+                                       size_t num_steps,
+                                       size_t num_warmup_steps)
+  : BaseType(std::move(name),
+             make_unique<batch_termination_criteria>(num_steps
+                                                     + num_warmup_steps)),
+    m_num_steps{std::max(num_steps, size_t{1})},
+    m_num_warmup_steps{num_warmup_steps}
+{}
+
+std::string BottleneckAnalysis::get_type() const
+{
+  return "BottleneckAnalysis";
+}
+
+// =============================================
+// Analysis
+// =============================================
+
+void BottleneckAnalysis::apply(execution_context& context,
+                               model& model,
+                               data_coordinator& dc,
+                               execution_mode mode)
+{
+  if (mode != execution_mode::training) {
+    sgd_training_algorithm::apply(context, model, dc, mode);
+    return;
+  }
+  auto& c = dynamic_cast<sgd_execution_context&>(context);
+  c.set_execution_mode(execution_mode::training);
+  model.reset_mode(c, execution_mode::training);
+  dc.reset_mode(c);
+  do_train_begin_cbs(model);
+
+  // Real training runs first so the other runs start from a warm
+  // model and data pipeline
+  c.start_timer();
+  const double training_time = time_training(c, model, dc);
+  const double io_time = time_data_pipeline(c, model, dc);
+  const double compute_time = time_compute(c, model, dc);
+  const double comm_time = time_gradient_allreduce(model);
+  c.stop_timer();
+
+  model.reset_mode(c, execution_mode::training);
+  do_train_end_cbs(model);
+
+  // Report rates in samples per second
+  auto const& comm = *model.get_comm();
+  if (!comm.am_trainer_master()) {
+    return;
+  }
+  const double samples_per_step =
+    dc.get_mini_batch_size(execution_mode::training);
+  const std::vector<std::pair<std::string, double>> ceilings = {
+    {"data pipeline only", io_time},
+    {"compute only", compute_time},
+    {"gradient allreduce only", comm_time}};
+  auto binding = ceilings.front();
+  for (auto const& stage : ceilings) {
+    if (stage.second > binding.second) {
+      binding = stage;
+    }
+  }
+  auto print_row = [&](std::string const& stage, double time) {
+    std::cout << "  " << std::left << std::setw(26) << stage << std::right
+              << std::setw(12) << 1e3 * time << " ms"
+              << std::setw(14) << samples_per_step / time << " samples/s"
+              << std::setw(11) << training_time / time << "x" << std::endl;
+  };
+  std::ostringstream header;
+  header << "BottleneckAnalysis: model \"" << model.get_name() << "\", "
+         << "trainer " << comm.get_trainer_rank() << ", "
+         << m_num_steps << " steps of " << samples_per_step << " samples";
+  std::cout << std::string(80, '-') << "\n"
+            << header.str() << "\n"
+            << "  " << std::left << std::setw(26) << "stage" << std::right
+            << std::setw(15) << "step time"
+            << std::setw(24) << "rate"
+            << std::setw(12) << "vs. training" << "\n"
+            << std::fixed << std::setprecision(3);
+  print_row("training", training_time);
+  for (auto const& stage : ceilings) {
+    print_row(stage.first, stage.second);
+  }
+  std::cout << "Binding stage: " << binding.first << " (training runs at "
+            << std::setprecision(1) << 100 * binding.second / training_time
+            << "% of its ceiling)\n"
+            << std::string(80, '-') << std::defaultfloat << std::endl;
+}
+
+double BottleneckAnalysis::time_steps(lbann_comm& comm,
+                                      std::function<void()> const& step) const
+{
+  for (size_t i = 0; i < m_num_warmup_steps; ++i) {
+    step();
+  }
+  comm.trainer_barrier();
+  const double start = get_time();
+  for (size_t i = 0; i < m_num_steps; ++i) {
+    step();
+  }
+  const double elapsed = get_time() - start;
+  return comm.trainer_allreduce(elapsed, El::mpi::MAX) / m_num_steps;
+}
+
+double BottleneckAnalysis::time_training(sgd_execution_context& c,
+                                         model& model,
+                                         data_coordinator& dc)
+{
+  bool is_start_of_epoch = true;
+  return time_steps(*model.get_comm(), [&]() {
+    if (is_start_of_epoch) {
+      model.reset_mode(c, execution_mode::training);
+      model.reset_epoch_statistics(execution_mode::training);
+      dc.reset_mode(c);
+      do_epoch_begin_cbs(model);
+      is_start_of_epoch = false;
+    }
+    if (train_mini_batch(c, model, dc)) {
+      c.inc_epoch();
+      model.reconcile_weight_values();
+      do_epoch_end_cbs(model);
+      is_start_of_epoch = true;
+    }
+  });
+}
+
+double BottleneckAnalysis::time_data_pipeline(sgd_execution_context& c,
+                                              model& model,
+                                              data_coordinator& dc) const
+{
+  std::vector<Layer*> input_layers;
+  for (El::Int i = 0; i < model.get_num_layers(); ++i) {
+    if (is_input_layer(model.get_layer(i))) {
+      input_layers.push_back(&model.get_layer(i));
+    }
+  }
+  return time_steps(*model.get_comm(), [&]() {
+    model.reset_mode(c, execution_mode::training);
+    dc.reset_mode(c);
+    dc.fetch_data(execution_mode::training);
+    for (auto* l : input_layers) {
+      l->forward_prop();
+    }
+    if (dc.epoch_complete(execution_mode::training)) {
+      c.inc_epoch();
+    }
+  });
+}
+
+double BottleneckAnalysis::time_compute(sgd_execution_context& c,
+                                        model& model,
+                                        data_coordinator& dc) const
+{
+  // Cache a synthetic mini-batch in the input layers
+  const int mini_batch_size = dc.get_mini_batch_size(execution_mode::training);
+  std::vector<Layer*> input_layers;
+  for (El::Int i = 0; i < model.get_num_layers(); ++i) {
+    auto& l = model.get_layer(i);
+    if (!is_input_layer(l)) {
+      continue;
+    }
+    bool loaded = load_synthetic_mini_batch<El::Device::CPU>(l, mini_batch_size);
+#ifdef LBANN_HAS_GPU
+    loaded = loaded
+      || load_synthetic_mini_batch<El::Device::GPU>(l, mini_batch_size);
+#endif // LBANN_HAS_GPU
+    if (!loaded) {
+      LBANN_ERROR("BottleneckAnalysis only supports data-parallel input "
+                  "layers with the default data type, but input layer \"",
+                  l.get_name(), "\" is not one");
+    }
+    input_layers.push_back(&l);
+  }
+
+  // Gradients are not allreduced, so the steps would leave the
+  // weights inconsistent across ranks
+  model.clear_gradients();
+  auto snapshots = snapshot_weights(model);
+  set_skip_gradient_allreduce(model, true);
+  const double time = time_steps(*model.get_comm(), [&]() {
+    model.reset_mode(c, execution_mode::training);
+    model.clear_gradients();
+    model.forward_prop(execution_mode::training);
+    model.get_objective_function()->differentiate();
+    model.backward_prop();
+    model.get_objective_function()->compute_weight_regularization();
+    model.update_weights();
+  });
+  model.clear_gradients();
+  set_skip_gradient_allreduce(model, false);
+  restore_weights(snapshots);
+
+  // Resume reading from the data coordinator
+  for (auto* l : input_layers) {
+    if (auto* input = dynamic_cast<input_layer<DataType>*>(l)) {
+      input->clear_samples();
+    }
+#ifdef LBANN_HAS_GPU
+    using GPUInputLayerType =
+      input_layer<DataType, data_layout::DATA_PARALLEL, El::Device::GPU>;
+    if (auto* input = dynamic_cast<GPUInputLayerType*>(l)) {
+      input->clear_samples();
+    }
+#endif // LBANN_HAS_GPU
+  }
+  return time;
+}
+
+double BottleneckAnalysis::time_gradient_allreduce(model& model) const
+{
+  // Gradient contributions with the distribution of each weights
+  std::vector<optimizer*> optimizers;
+  std::vector<std::unique_ptr<El::AbstractDistMatrix<DataType>>> contribs;
+  for (auto* w : model.get_weights()) {
+    auto* opt = w->get_optimizer();
+    if (opt == nullptr || w->is_frozen()) {
+      continue;
+    }
+    optimizers.push_back(opt);
+    contribs.emplace_back(
+      El::AbstractDistMatrix<DataType>::Instantiate(
+        w->get_matrix_distribution()));
+    El::Zeros(*contribs.back(), w->get_matrix_height(), w->get_matrix_width());
+  }
+
+  // As in backward prop, each allreduce is launched once its
+  // contribution is added and they are all completed afterward
+  model.clear_gradients();
+  return time_steps(*model.get_comm(), [&]() {
+    for (size_t i = 0; i < optimizers.size(); ++i) {
+      auto& opt = *optimizers[i];
+      opt.add_gradient_source(contribs[i].get());
+      opt.add_to_gradient(*contribs[i], DataType(1), true);
+      opt.remove_gradient_source(contribs[i].get());
+    }
+    for (auto* opt : optimizers) {
+      opt->synchronize_gradient();
+    }
+    for (auto* opt : optimizers) {
+      opt->clear_gradient();
+    }
+  });
+}
+
+} // namespace lbann
+
+template <>
+std::unique_ptr<lbann::BottleneckAnalysis>
+lbann::make<lbann::BottleneckAnalysis>(google::protobuf::Message const& msg_in)
+{
+  auto const& params =
+    dynamic_cast<lbann_data::TrainingAlgorithm const&>(msg_in);
+
+  lbann_data::BottleneckAnalysis analysis_params;
+  LBANN_ASSERT(params.parameters().UnpackTo(&analysis_params));
+
+  return make_unique<BottleneckAnalysis>(
+    params.name(),
+    (analysis_params.num_steps() > 0 ? analysis_params.num_steps() : 20UL),
+    (analysis_params.num_warmup_steps() > 0
+       ? analysis_params.num_warmup_steps()
+       : 5UL));
+}
@@ -24,8 +24,13 @@
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
 #include "lbann/execution_algorithms/factory.hpp"
+#include "lbann/execution_algorithms/async_validation.hpp"
+#include "lbann/execution_algorithms/bottleneck_analysis.hpp"
 #include "lbann/execution_algorithms/kfac.hpp"
+#include "lbann/execution_algorithms/local_sgd.hpp"
 #include "lbann/execution_algorithms/ltfb.hpp"
+#include "lbann/execution_algorithms/pipeline_parallel.hpp"
+#include "lbann/execution_algorithms/replay_benchmark.hpp"
 #include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
 #include "lbann/proto/helpers.hpp"
 #include "lbann/utils/make_abstract.hpp"
@@ -42,6 +47,15 @@ lbann::TrainingAlgorithmFactory build_default_factory()
   fact.register_builder("SGD", lbann::make<lbann::sgd_training_algorithm>);
   fact.register_builder("LTFB", lbann::make<lbann::LTFB>);
   fact.register_builder("KFAC", lbann::make<lbann::KFAC>);
+  fact.register_builder("LocalSGD", lbann::make<lbann::LocalSGD>);
+  fact.register_builder("PipelineParallel",
+                        lbann::make<lbann::PipelineParallel>);
+  fact.register_builder("BottleneckAnalysis",
+                        lbann::make<lbann::BottleneckAnalysis>);
+  fact.register_builder("ReplayBenchmark",
+                        lbann::make<lbann::ReplayBenchmark>);
+  fact.register_builder("AsyncValidation",
+                        lbann::make<lbann::AsyncValidation>);
   return fact;
 }
 
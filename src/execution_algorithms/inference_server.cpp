@@ -0,0 +1,546 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/execution_algorithms/inference_server.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif // __linux__
+
+namespace lbann {
+
+namespace {
+
+/** @brief Read exactly @c size bytes. Returns false on EOF or error. */
+bool read_all(int fd, void* buffer, size_t size) {
+  auto* ptr = static_cast<char*>(buffer);
+  while (size > 0) {
+    const auto n = ::recv(fd, ptr, size, 0);
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n <= 0) { return false; }
+    ptr += n;
+    size -= n;
+  }
+  return true;
+}
+
+/** @brief Write exactly @c size bytes. Returns false on error. */
+bool write_all(int fd, const void* buffer, size_t size) {
+  const auto* ptr = static_cast<const char*>(buffer);
+  while (size > 0) {
+    // Do not raise SIGPIPE if the client has disconnected
+    const auto n = ::send(fd, ptr, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) { continue; }
+    if (n <= 0) { return false; }
+    ptr += n;
+    size -= n;
+  }
+  return true;
+}
+
+/** @brief Open a listening UNIX domain socket.
+ *
+ *  If @c owner_only is set, the socket file is restricted to the
+ *  owner before the socket accepts connections.
+ */
+int listen_on_socket(const std::string& path, bool owner_only) {
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+    LBANN_ERROR("invalid inference server socket path (\"", path, "\")");
+  }
+  std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path)-1);
+
+  const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    LBANN_ERROR("could not create inference server socket "
+                "(", std::strerror(errno), ")");
+  }
+  ::unlink(path.c_str());
+  if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+      || (owner_only && ::chmod(path.c_str(), S_IRUSR | S_IWUSR) != 0)
+      || ::listen(fd, SOMAXCONN) != 0) {
+    const std::string err = std::strerror(errno);
+    ::close(fd);
+    ::unlink(path.c_str());
+    LBANN_ERROR("could not listen on \"", path, "\" (", err, ")");
+  }
+  return fd;
+}
+
+} // namespace <anon>
+
+// ---------------------------------------------
+// Client connections
+// ---------------------------------------------
+
+inference_connection::~inference_connection() {
+  if (m_fd >= 0) { ::close(m_fd); }
+}
+
+void inference_connection::shutdown() {
+  ::shutdown(m_fd, SHUT_RDWR);
+}
+
+// ---------------------------------------------
+// Dynamic batcher
+// ---------------------------------------------
+
+dynamic_batcher::dynamic_batcher(size_t max_batch_size,
+                                 std::chrono::microseconds max_latency)
+  : m_max_batch_size(max_batch_size),
+    m_max_latency(max_latency) {
+  if (m_max_batch_size == 0) {
+    LBANN_ERROR("mini-batch size must be larger than 0");
+  }
+}
+
+void dynamic_batcher::push(inference_request req) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_shutdown) { return; }
+    m_num_queued_samples += req.num_samples;
+    m_queue.emplace_back(std::move(req));
+  }
+  m_cv.notify_one();
+}
+
+std::vector<inference_request> dynamic_batcher::next_batch() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  // Wait until the batch is full or the oldest request is due
+  while (true) {
+    if (m_queue.empty()) {
+      if (m_shutdown) { return {}; }
+      m_cv.wait(lock);
+      continue;
+    }
+    const auto deadline = m_queue.front().arrival_time + m_max_latency;
+    if (m_shutdown
+        || m_num_queued_samples >= m_max_batch_size
+        || std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    m_cv.wait_until(lock, deadline);
+  }
+
+  // Take requests in arrival order
+  std::vector<inference_request> batch;
+  size_t batch_size = 0;
+  while (!m_queue.empty()) {
+    const auto num_samples = m_queue.front().num_samples;
+    if (!batch.empty() && batch_size + num_samples > m_max_batch_size) {
+      break;
+    }
+    batch_size += num_samples;
+    m_num_queued_samples -= num_samples;
+    batch.emplace_back(std::move(m_queue.front()));
+    m_queue.pop_front();
+  }
+  return batch;
+}
+
+void dynamic_batcher::shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shutdown = true;
+  }
+  m_cv.notify_all();
+}
+
+size_t dynamic_batcher::get_num_queued_samples() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_num_queued_samples;
+}
+
+// ---------------------------------------------
+// Latency statistics
+// ---------------------------------------------
+
+void latency_statistics::record(double latency, size_t num_samples) {
+  m_latencies.push_back(latency);
+  m_num_samples += num_samples;
+}
+
+double latency_statistics::get_percentile(double p) const {
+  if (m_latencies.empty()) { return 0.; }
+  // Nearest-rank percentile
+  auto latencies = m_latencies;
+  const auto n = latencies.size();
+  const auto rank = static_cast<size_t>(std::ceil(p / 100. * n));
+  const auto idx = std::min(std::max(rank, size_t{1}), n) - 1;
+  std::nth_element(latencies.begin(), latencies.begin() + idx, latencies.end());
+  return latencies[idx];
+}
+
+double latency_statistics::get_throughput() const {
+  const std::chrono::duration<double> elapsed
+    = std::chrono::steady_clock::now() - m_start_time;
+  return (elapsed.count() > 0.
+          ? m_num_samples / elapsed.count()
+          : 0.);
+}
+
+std::string latency_statistics::summary() const {
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(3)
+     << get_num_requests() << " requests, "
+     << get_num_samples() << " samples, "
+     << get_num_batches() << " mini-batches, "
+     << "p50 latency " << get_percentile(50) * 1e3 << " ms, "
+     << "p99 latency " << get_percentile(99) * 1e3 << " ms, "
+     << "throughput " << get_throughput() << " samples/s";
+  return ss.str();
+}
+
+void latency_statistics::reset() {
+  m_latencies.clear();
+  m_num_samples = 0;
+  m_num_batches = 0;
+  m_start_time = std::chrono::steady_clock::now();
+}
+
+// ---------------------------------------------
+// Inference server
+// ---------------------------------------------
+
+inference_server::inference_server(std::string socket_path,
+                                   size_t max_batch_size,
+                                   std::chrono::microseconds max_latency,
+                                   double report_interval,
+                                   size_t max_request_samples)
+  : m_socket_path(std::move(socket_path)),
+    m_max_batch_size(max_batch_size),
+    m_max_request_samples(max_request_samples > 0
+                          ? max_request_samples
+                          : max_batch_size),
+    m_report_interval(report_interval),
+    m_batcher(max_batch_size, max_latency) {}
+
+inference_server::~inference_server() {
+  try {
+    stop_listening();
+  }
+  catch (...) {}
+}
+
+void inference_server::serve(observer_ptr<model> m) {
+  auto& comm = *m->get_comm();
+  const bool master = comm.am_trainer_master();
+
+  // Get input sample size
+  El::Int sample_size = 0;
+  for (const auto* l : m->get_layers()) {
+    if (l->get_type() == "input") {
+      sample_size = l->get_output_size();
+    }
+  }
+  if (sample_size <= 0) {
+    LBANN_ERROR("inference server requires a model with an input layer");
+  }
+
+  if (master) {
+    start_listening(sample_size);
+    std::cout << "inference server: listening on " << m_socket_path
+              << " (trainer " << comm.get_trainer_rank() << ", "
+              << "admin socket " << get_admin_socket_path() << ")"
+              << std::endl;
+  }
+  m_statistics.reset();
+  auto last_report = std::chrono::steady_clock::now();
+
+  while (true) {
+
+    // Assemble mini-batch on trainer master
+    std::vector<inference_request> batch;
+    El::Int num_samples = 0;
+    int done = 0;
+    if (master) {
+      batch = m_batcher.next_batch();
+      done = batch.empty();
+      for (const auto& req : batch) {
+        num_samples += req.num_samples;
+      }
+    }
+    comm.trainer_broadcast(0, done);
+    if (done) { break; }
+    comm.trainer_broadcast(0, num_samples);
+
+    // Distribute samples within trainer
+    El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+      samples(num_samples, sample_size, comm.get_trainer_grid());
+    if (master) {
+      auto& local_samples = samples.Matrix();
+      El::Int row = 0;
+      for (const auto& req : batch) {
+        for (size_t i = 0; i < req.num_samples; ++i, ++row) {
+          for (El::Int j = 0; j < sample_size; ++j) {
+            local_samples(row, j) = req.samples[i*sample_size+j];
+          }
+        }
+      }
+    }
+    comm.trainer_broadcast(0,
+                           samples.Buffer(),
+                           static_cast<int>(samples.LDim() * sample_size));
+
+    // Run inference and respond
+    const auto labels = m_algorithm.infer(m, samples, m_max_batch_size);
+    if (master) {
+      respond(batch, labels);
+      m_statistics.add_batch();
+      const std::chrono::duration<double> since_report
+        = std::chrono::steady_clock::now() - last_report;
+      if (m_report_interval > 0. && since_report.count() >= m_report_interval) {
+        std::cout << "inference server: " << m_statistics.summary()
+                  << std::endl;
+        last_report = std::chrono::steady_clock::now();
+      }
+    }
+
+  }
+
+  if (master) {
+    stop_listening();
+    std::cout << "inference server: " << m_statistics.summary() << std::endl;
+  }
+}
+
+void inference_server::respond(
+  const std::vector<inference_request>& batch,
+  const El::Matrix<int, El::Device::CPU>& labels) {
+  const auto now = std::chrono::steady_clock::now();
+  El::Int row = 0;
+  std::vector<int32_t> response;
+  for (const auto& req : batch) {
+    response.resize(req.num_samples);
+    for (auto& label : response) {
+      label = labels(row++);
+    }
+    if (req.connection != nullptr) {
+      // Clients that have disconnected are ignored
+      write_all(req.connection->get_fd(),
+                response.data(),
+                response.size() * sizeof(int32_t));
+    }
+    const std::chrono::duration<double> latency = now - req.arrival_time;
+    m_statistics.record(latency.count(), req.num_samples);
+  }
+}
+
+void inference_server::request_shutdown() {
+  m_batcher.shutdown();
+}
+
+void inference_server::start_listening(size_t sample_size) {
+  m_admin_fd = listen_on_socket(get_admin_socket_path(), true);
+  try {
+    m_listen_fd = listen_on_socket(m_socket_path, false);
+  }
+  catch (...) {
+    ::close(m_admin_fd);
+    m_admin_fd = -1;
+    ::unlink(get_admin_socket_path().c_str());
+    throw;
+  }
+  m_admin_thread = std::thread(&inference_server::accept_admin_connections,
+                               this);
+  m_accept_thread = std::thread(&inference_server::accept_connections,
+                                this,
+                                sample_size);
+}
+
+void inference_server::stop_listening() {
+  if (m_listen_fd < 0) { return; }
+
+  // Stop accepting connections
+  ::shutdown(m_listen_fd, SHUT_RDWR);
+  ::close(m_listen_fd);
+  m_listen_fd = -1;
+  if (m_accept_thread.joinable()) { m_accept_thread.join(); }
+  ::shutdown(m_admin_fd, SHUT_RDWR);
+  ::close(m_admin_fd);
+  m_admin_fd = -1;
+  if (m_admin_thread.joinable()) { m_admin_thread.join(); }
+
+  // Disconnect clients
+  std::vector<std::thread> reader_threads;
+  {
+    std::lock_guard<std::mutex> lock(m_connections_mutex);
+    for (auto& weak_connection : m_connections) {
+      if (auto connection = weak_connection.lock()) {
+        connection->shutdown();
+      }
+    }
+    m_connections.clear();
+    m_finished_readers.clear();
+    reader_threads.swap(m_reader_threads);
+  }
+  for (auto& t : reader_threads) { t.join(); }
+  m_batcher.shutdown();
+  ::unlink(m_socket_path.c_str());
+  ::unlink(get_admin_socket_path().c_str());
+}
+
+void inference_server::accept_connections(size_t sample_size) {
+  const int listen_fd = m_listen_fd;
+  while (true) {
+    const int fd = ::accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR) { continue; }
+      break;
+    }
+    auto connection = std::make_shared<inference_connection>(fd);
+    std::lock_guard<std::mutex> lock(m_connections_mutex);
+    reap_reader_threads();
+    m_connections.emplace_back(connection);
+    m_reader_threads.emplace_back(&inference_server::read_requests,
+                                  this,
+                                  std::move(connection),
+                                  sample_size);
+  }
+}
+
+void inference_server::accept_admin_connections() {
+  const int admin_fd = m_admin_fd;
+  while (true) {
+    const int fd = ::accept(admin_fd, nullptr, nullptr);
+    if (fd < 0) {
+      if (errno == EINTR) { continue; }
+      break;
+    }
+
+    // Do not let an idle client block shutdown requests
+    timeval timeout;
+    timeout.tv_sec = 1;
+    timeout.tv_usec = 0;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    inference_request_header header;
+    if (read_all(fd, &header, sizeof(header)) && header.num_samples == 0) {
+      request_shutdown();
+    }
+    ::close(fd);
+  }
+}
+
+void inference_server::read_requests(
+  std::shared_ptr<inference_connection> connection,
+  size_t sample_size) {
+  const int fd = connection->get_fd();
+  while (true) {
+    inference_request_header header;
+    if (!read_all(fd, &header, sizeof(header))) { break; }
+    if (header.num_samples == 0
+        || header.num_samples > m_max_request_samples) {
+      LBANN_WARNING("inference server accepts requests with 1 to ",
+                    m_max_request_samples, " samples, but got ",
+                    header.num_samples, " (closing connection)");
+      break;
+    }
+    if (header.sample_size != sample_size) {
+      LBANN_WARNING("inference server expected samples of size ",
+                    sample_size, ", but got ", header.sample_size,
+                    " (closing connection)");
+      break;
+    }
+    inference_request req;
+    req.connection = connection;
+    req.num_samples = header.num_samples;
+    req.samples.resize(req.num_samples * sample_size);
+    if (!read_all(fd, req.samples.data(), req.samples.size() * sizeof(float))) {
+      break;
+    }
+    req.arrival_time = std::chrono::steady_clock::now();
+    m_batcher.push(std::move(req));
+  }
+
+  // Let the accept thread join this thread
+  std::lock_guard<std::mutex> lock(m_connections_mutex);
+  m_finished_readers.push_back(std::this_thread::get_id());
+}
+
+void inference_server::reap_reader_threads() {
+  for (const auto& id : m_finished_readers) {
+    auto it = std::find_if(m_reader_threads.begin(),
+                           m_reader_threads.end(),
+                           [&id](const std::thread& t) {
+                             return t.get_id() == id;
+                           });
+    if (it != m_reader_threads.end()) {
+      it->join();
+      m_reader_threads.erase(it);
+    }
+  }
+  m_finished_readers.clear();
+  m_connections.erase(
+    std::remove_if(m_connections.begin(),
+                   m_connections.end(),
+                   [](const std::weak_ptr<inference_connection>& c) {
+                     return c.expired();
+                   }),
+    m_connections.end());
+}
+
+void inference_server::pin_to_cores(const lbann_comm& comm) {
+#ifdef __linux__
+  const int num_cores = std::thread::hardware_concurrency();
+  const int procs_per_node = comm.get_procs_per_node();
+  const int cores_per_proc = num_cores / std::max(procs_per_node, 1);
+  if (cores_per_proc < 1) {
+    LBANN_WARNING("not enough cores to pin ", procs_per_node,
+                  " processes per node to disjoint cores");
+    return;
+  }
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  const int offset = comm.get_rank_in_node() * cores_per_proc;
+  for (int core = offset; core < offset + cores_per_proc; ++core) {
+    CPU_SET(core, &cpu_set);
+  }
+  if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+    LBANN_WARNING("could not set CPU affinity (", std::strerror(errno), ")");
+  }
+#endif // __linux__
+}
+
+}  // namespace lbann
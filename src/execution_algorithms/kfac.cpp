@@ -30,6 +30,7 @@
 
 #include "lbann/base.hpp"
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/comm_impl.hpp"
 #include "lbann/execution_algorithms/kfac/kfac_block.hpp"
 #include "lbann/execution_algorithms/kfac/kfac_block_bn.hpp"
 #include "lbann/execution_algorithms/kfac/kfac_block_fc_conv.hpp"
@@ -42,11 +43,14 @@
 #include "lbann/models/model.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/profiling.hpp"
+#include "lbann/utils/timer.hpp"
 
 #include <training_algorithm.pb.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <limits>
+#include <memory>
 
 namespace lbann {
 
@@ -71,9 +75,12 @@ KFAC::KFAC(
   std::vector<size_t> update_intervals,
   size_t update_interval_steps,
   kfac::kfac_inverse_strategy inverse_strategy,
+  size_t inverse_rebalance_updates,
   std::vector<std::string> disable_layers,
   double learning_rate_factor,
-  double learning_rate_factor_gru)
+  double learning_rate_factor_gru,
+  size_t eigen_refresh_interval,
+  bool overlap_factor_reduction)
   : BaseType{std::move(name)},
     m_stopping_criteria{std::move(stop)},
     m_damping_act_params{std::move(damping_act_params)},
@@ -89,9 +96,12 @@ KFAC::KFAC(
     m_update_intervals{std::move(update_intervals)},
     m_update_interval_steps{update_interval_steps},
     m_inverse_strategy{inverse_strategy},
+    m_inverse_rebalance_updates{inverse_rebalance_updates},
     m_disable_layers{std::move(disable_layers)},
     m_learning_rate_factor{learning_rate_factor},
-    m_learning_rate_factor_gru{learning_rate_factor_gru}
+    m_learning_rate_factor_gru{learning_rate_factor_gru},
+    m_eigen_refresh_interval{eigen_refresh_interval},
+    m_overlap_factor_reduction{overlap_factor_reduction}
 {}
 
 KFAC::KFAC(KFAC const& other)
@@ -110,8 +120,12 @@ KFAC::KFAC(KFAC const& other)
     m_update_intervals{other.m_update_intervals},
     m_update_interval_steps{other.m_update_interval_steps},
     m_inverse_strategy{other.m_inverse_strategy},
+    m_inverse_rebalance_updates{other.m_inverse_rebalance_updates},
     m_disable_layers{other.m_disable_layers},
-    m_learning_rate_factor{other.m_learning_rate_factor}
+    m_learning_rate_factor{other.m_learning_rate_factor},
+    m_learning_rate_factor_gru{other.m_learning_rate_factor_gru},
+    m_eigen_refresh_interval{other.m_eigen_refresh_interval},
+    m_overlap_factor_reduction{other.m_overlap_factor_reduction}
 {}
 
 KFAC& KFAC::operator=(KFAC const& other) {
@@ -130,11 +144,61 @@ KFAC& KFAC::operator=(KFAC const& other) {
   m_update_intervals = other.m_update_intervals;
   m_update_interval_steps = other.m_update_interval_steps;
   m_inverse_strategy = other.m_inverse_strategy;
+  m_inverse_rebalance_updates = other.m_inverse_rebalance_updates;
   m_disable_layers = other.m_disable_layers;
   m_learning_rate_factor = other.m_learning_rate_factor;
+  m_learning_rate_factor_gru = other.m_learning_rate_factor_gru;
+  m_eigen_refresh_interval = other.m_eigen_refresh_interval;
+  m_overlap_factor_reduction = other.m_overlap_factor_reduction;
   return *this;
 }
 
+class KFAC::factor_reduction_callback final : public callback_base {
+public:
+  factor_reduction_callback(KFAC& algo, ExeContextType& context)
+    : m_algo{algo}, m_context{context} {}
+  factor_reduction_callback* copy() const override {
+    return new factor_reduction_callback(*this);
+  }
+  std::string name() const override { return "kfac_factor_reduction"; }
+  using callback_base::on_backward_prop_end;
+  void on_backward_prop_end(model *m, Layer *l) override {
+    m_algo.on_layer_backward_prop_end(m_context, *m, *l);
+  }
+private:
+  KFAC& m_algo;
+  ExeContextType& m_context;
+};
+
+namespace {
+
+/** @brief Registers a callback with a model for the lifetime of the
+ *         object.
+ *
+ *  The callback is removed even if training throws, so the model
+ *  never keeps a callback that refers to a finished algorithm.
+ */
+class scoped_callback {
+public:
+  scoped_callback(model& m, std::shared_ptr<callback_base> cb)
+    : m_model{m}, m_callback{std::move(cb)} {
+    if (m_callback != nullptr) { m_model.add_callback(m_callback); }
+  }
+  ~scoped_callback() {
+    if (m_callback != nullptr) {
+      auto& cbs = m_model.get_callbacks_with_ownership();
+      cbs.erase(std::remove(cbs.begin(), cbs.end(), m_callback), cbs.end());
+    }
+  }
+  scoped_callback(const scoped_callback&) = delete;
+  scoped_callback& operator=(const scoped_callback&) = delete;
+private:
+  model& m_model;
+  std::shared_ptr<callback_base> m_callback;
+};
+
+} // namespace <anon>
+
 std::string KFAC::get_type() const { return "KFAC"; }
 
 kfac::ExecutionContext* KFAC::do_get_new_execution_context() const
@@ -188,6 +252,14 @@ void KFAC::train(
   kfac_context.m_damping_bn_act = m_damping_bn_act_params[0];
   kfac_context.m_damping_bn_err = m_damping_bn_err_params[0];
 
+  // Start Kronecker factor reductions during backprop
+  std::shared_ptr<callback_base> reduction_cb;
+  if (m_overlap_factor_reduction) {
+    reduction_cb = std::make_shared<factor_reduction_callback>(
+      *this, kfac_context);
+  }
+  scoped_callback reduction_cb_registration(model, reduction_cb);
+
   // Run callbacks.
   do_train_begin_cbs(model);
 
@@ -255,6 +327,20 @@ void KFAC::train(
   // end of training callbacks
   model.reset_mode(sgd_context, execution_mode::training);
   do_train_end_cbs(model);
+
+  if (reduction_cb != nullptr) {
+    const auto num_updates = kfac_context.m_num_overlapped_factor_updates;
+    if (num_updates > 0 && model.get_comm()->am_trainer_master()) {
+      const double overlap = kfac_context.m_factor_reduction_overlap_time;
+      const double wait = kfac_context.m_factor_reduction_wait_time;
+      std::cout << "K-FAC: factor reductions overlapped with backprop for "
+                << 1e3 * overlap / num_updates << " ms per update, "
+                << "exposed for " << 1e3 * wait / num_updates
+                << " ms per update (at most "
+                << (overlap + wait > 0 ? 100 * overlap / (overlap + wait) : 0)
+                << "% hidden)" << std::endl;
+    }
+  }
 }
 
 // =============================================
@@ -457,6 +543,31 @@ void KFAC::on_forward_prop_end(
       prof_region_end(("kfac-setup/" + l->get_name()).c_str(), prof_sync);
     }
 
+    // Stagger eigendecompositions so that roughly
+    // 1/m_eigen_refresh_interval of the blocks refresh at each update
+    if(m_eigen_refresh_interval > 0) {
+      size_t num_eigen_blocks = 0;
+      for(auto& block : context.m_blocks) {
+        auto* fc_conv_block =
+            dynamic_cast<kfac_block_fc_conv<Device>*>(block.get());
+        if(fc_conv_block != nullptr)
+          fc_conv_block->set_eigen_decomposition(
+              m_eigen_refresh_interval, num_eigen_blocks++);
+      }
+    }
+
+    // Replace the round-robin assignment with a cost-balanced one
+    if(m_inverse_strategy == kfac::kfac_inverse_strategy::BALANCED) {
+      std::vector<double> costs;
+      for(const auto& block : context.m_blocks)
+        costs.push_back(block->get_inverse_cost());
+      const auto ranks = kfac::get_balanced_proc_ranks(costs, num_procs);
+      for(size_t i = 0; i < context.m_blocks.size(); i++)
+        context.m_blocks[i]->set_inverse_proc_rank(ranks[i]);
+    }
+    context.m_inverse_times.assign(context.m_blocks.size(), 0.0);
+    context.m_num_inverse_updates = 0;
+
     if(comm.am_trainer_master()) {
       for(const auto& block : context.m_blocks)
         std::cout << "K-FAC setup: "
@@ -469,6 +580,63 @@ void KFAC::on_forward_prop_end(
   for(auto& block : context.m_blocks)
     block->on_forward_prop_end();
 
+  // Update the udpate interval
+  const size_t num_steps = context.get_sgd_execution_context().get_step();
+  if(m_update_intervals.size() == 1)
+    context.m_update_interval = m_update_intervals[0];
+  else {
+    context.m_update_interval = m_update_intervals[0]
+        + ((double) m_update_intervals[1]-m_update_intervals[0])
+        * std::min((double) num_steps/ m_update_interval_steps, 1.0);
+  }
+  context.m_is_kronecker_update_required =
+      ((num_steps%context.m_update_interval) == 0 || !m_has_kronecker_inverse);
+
+  // Prepare to reduce Kronecker factors during backprop
+  context.m_local_factors_ready.assign(context.m_blocks.size(), false);
+  context.m_num_factor_reductions_started = 0;
+  context.m_factor_reduction_requests.clear();
+
+}
+
+void KFAC::on_layer_backward_prop_end(
+  ExeContextType& context,
+  model& model,
+  Layer& layer) {
+  if(!context.m_is_kronecker_update_required)
+    return;
+  auto& comm = *model.get_comm();
+  for(size_t i = 0; i < context.m_blocks.size(); i++) {
+    auto& block = context.m_blocks[i];
+    if(block->get_layer() != &layer)
+      continue;
+    prof_region_begin(("kfac-update/local/" + block->get_name()).c_str(), prof_color, prof_sync);
+    block->compute_local_kronecker_factors(
+      &comm, m_print_matrix, m_print_matrix_summary);
+    prof_region_end(("kfac-update/local/" + block->get_name()).c_str(), prof_sync);
+    context.m_local_factors_ready[i] = true;
+  }
+  start_factor_reductions(context, comm);
+}
+
+void KFAC::start_factor_reductions(
+  ExeContextType& context,
+  lbann_comm& comm) {
+  const size_t num_blocks = context.m_blocks.size();
+  auto& num_started = context.m_num_factor_reductions_started;
+  while(num_started < num_blocks
+        && context.m_local_factors_ready[num_blocks-num_started-1]) {
+    if(num_started == 0)
+      context.m_factor_reduction_start_time = get_time();
+    auto& block = context.m_blocks[num_blocks-num_started-1];
+    for(auto L : block->get_local_kronecker_buffers()) {
+      context.m_factor_reduction_requests.emplace_back();
+      comm.nb_allreduce(
+        *L, comm.get_trainer_comm(),
+        context.m_factor_reduction_requests.back());
+    }
+    num_started++;
+  }
 }
 
 void KFAC::on_backward_prop_end(
@@ -477,8 +645,6 @@ void KFAC::on_backward_prop_end(
 
   // Get some configs
   auto& comm = *model.get_comm();
-  const auto& sgd_context = context.get_sgd_execution_context();
-  const size_t num_steps = sgd_context.get_step();
   const auto layers = model.get_layers();
 
   // Update the damping value
@@ -502,15 +668,6 @@ void KFAC::on_backward_prop_end(
   context.m_damping_bn_err = get_next_damping(
     context.m_damping_bn_err, m_damping_bn_err_params, m_damping_warmup_steps);
 
-  // Update the udpate interval
-  if(m_update_intervals.size() == 1)
-    context.m_update_interval = m_update_intervals[0];
-  else {
-    context.m_update_interval = m_update_intervals[0]
-        + ((double) m_update_intervals[1]-m_update_intervals[0])
-        * std::min((double) num_steps/ m_update_interval_steps, 1.0);
-  }
-
   // List up layers to be updated
   if(context.m_blocks.size() == 0){
     LBANN_ERROR("K-FAC blocks have not been setup");
@@ -522,55 +679,86 @@ void KFAC::on_backward_prop_end(
   // for the model-parallel part.
   const bool is_first_step = (!m_has_kronecker_inverse);
   const bool is_kronecker_update_required =
-      ((num_steps%context.m_update_interval) == 0 || !m_has_kronecker_inverse);
+      context.m_is_kronecker_update_required;
   if(is_kronecker_update_required) {
     prof_region_begin("kfac-update", prof_color, prof_sync);
 
-    prof_region_begin("kfac-update/local", prof_color, prof_sync);
-    for(auto& block : context.m_blocks) {
-      prof_region_begin(("kfac-update/local/" + block->get_name()).c_str(), prof_color, prof_sync);
-      block->compute_local_kronecker_factors(
-        &comm, m_print_matrix, m_print_matrix_summary);
-      prof_region_end(("kfac-update/local/" + block->get_name()).c_str(), prof_sync);
+    if(m_overlap_factor_reduction) {
+      // Blocks whose layers did not report backprop are handled now
+      for(size_t i = 0; i < context.m_blocks.size(); i++) {
+        if(!context.m_local_factors_ready[i]) {
+          context.m_blocks[i]->compute_local_kronecker_factors(
+            &comm, m_print_matrix, m_print_matrix_summary);
+          context.m_local_factors_ready[i] = true;
+        }
+      }
+      start_factor_reductions(context, comm);
+
+      // Finish the reductions started during backprop
+      prof_region_begin("kfac-update/wait", prof_color, prof_sync);
+      const double t_wait_start = get_time();
+      for(auto& req : context.m_factor_reduction_requests)
+        comm.wait(req);
+      context.m_factor_reduction_requests.clear();
+      const double t_wait_end = get_time();
+      context.m_factor_reduction_overlap_time +=
+          t_wait_start - context.m_factor_reduction_start_time;
+      context.m_factor_reduction_wait_time += t_wait_end - t_wait_start;
+      context.m_num_overlapped_factor_updates++;
+      prof_region_end("kfac-update/wait", prof_sync);
+      if(m_print_time && comm.am_trainer_master())
+        std::cout << "K-FAC: factor reductions overlapped for "
+                  << t_wait_start - context.m_factor_reduction_start_time
+                  << "s, exposed for " << t_wait_end - t_wait_start
+                  << "s" << std::endl;
     }
-    prof_region_end("kfac-update/local", prof_sync);
+    else {
+      prof_region_begin("kfac-update/local", prof_color, prof_sync);
+      for(auto& block : context.m_blocks) {
+        prof_region_begin(("kfac-update/local/" + block->get_name()).c_str(), prof_color, prof_sync);
+        block->compute_local_kronecker_factors(
+          &comm, m_print_matrix, m_print_matrix_summary);
+        prof_region_end(("kfac-update/local/" + block->get_name()).c_str(), prof_sync);
+      }
+      prof_region_end("kfac-update/local", prof_sync);
 
 #ifdef LBANN_NVPROF
-    prof_region_begin("kfac-update/local-barrier", prof_color, prof_sync);
-    CHECK_CUDA(cudaDeviceSynchronize());
-    comm.trainer_barrier();
-    prof_region_end("kfac-update/local-barrier", prof_sync);
+      prof_region_begin("kfac-update/local-barrier", prof_color, prof_sync);
+      CHECK_CUDA(cudaDeviceSynchronize());
+      comm.trainer_barrier();
+      prof_region_end("kfac-update/local-barrier", prof_sync);
 #endif // LBANN_NVPROF
 
-    // List-up buffers to synchronize.
-    std::vector<std::pair<size_t, El::AbstractMatrix<DataType>*>> buffers;
-    size_t global_buffer_size = 0;
-    for(auto& block : context.m_blocks)
-      for(auto L : block->get_local_kronecker_buffers()) {
-        const size_t rank = block->get_inverse_proc_rank();
-        buffers.emplace_back(rank, L);
-        assert(L->Width() == 1);
-        global_buffer_size += L->Height();
-      }
+      // List-up buffers to synchronize.
+      std::vector<std::pair<size_t, El::AbstractMatrix<DataType>*>> buffers;
+      size_t global_buffer_size = 0;
+      for(auto& block : context.m_blocks)
+        for(auto L : block->get_local_kronecker_buffers()) {
+          const size_t rank = block->get_inverse_proc_rank();
+          buffers.emplace_back(rank, L);
+          assert(L->Width() == 1);
+          global_buffer_size += L->Height();
+        }
 
-    // Perform reduce-scatter.
-    prof_region_begin("kfac-update/reduce-scatter", prof_color, prof_sync);
-    const auto reduce_scatter_mode = kfac::kfac_reduce_scatter_mode::ALLREDUCE;
-    El::Matrix<DataType, Device>& global_buffer =
-      context.get_workspace_matrix(
-        "reduce_scatter_send_buffer",
-        kfac::is_reduce_scatter_buffer_required(reduce_scatter_mode) ? global_buffer_size : 0,
-        1);
-    kfac::reduce_scatter_blocks(
-        buffers, global_buffer, &comm, reduce_scatter_mode);
-    prof_region_end("kfac-update/reduce-scatter", prof_sync);
+      // Perform reduce-scatter.
+      prof_region_begin("kfac-update/reduce-scatter", prof_color, prof_sync);
+      const auto reduce_scatter_mode = kfac::kfac_reduce_scatter_mode::ALLREDUCE;
+      El::Matrix<DataType, Device>& global_buffer =
+        context.get_workspace_matrix(
+          "reduce_scatter_send_buffer",
+          kfac::is_reduce_scatter_buffer_required(reduce_scatter_mode) ? global_buffer_size : 0,
+          1);
+      kfac::reduce_scatter_blocks(
+          buffers, global_buffer, &comm, reduce_scatter_mode);
+      prof_region_end("kfac-update/reduce-scatter", prof_sync);
 
 #ifdef LBANN_NVPROF
-    prof_region_begin("kfac-update/reduce-scatter-barrier", prof_color, prof_sync);
-    CHECK_CUDA(cudaDeviceSynchronize());
-    comm.trainer_barrier();
-    prof_region_end("kfac-update/reduce-scatter-barrier", prof_sync);
+      prof_region_begin("kfac-update/reduce-scatter-barrier", prof_color, prof_sync);
+      CHECK_CUDA(cudaDeviceSynchronize());
+      comm.trainer_barrier();
+      prof_region_end("kfac-update/reduce-scatter-barrier", prof_sync);
 #endif // LBANN_NVPROF
+    }
 
     prof_region_begin("kfac-update/average", prof_color, prof_sync);
     for(auto& block : context.m_blocks) {
@@ -587,11 +775,20 @@ void KFAC::on_backward_prop_end(
   }
 
   // Step 2: Model-parallel inverse computation
+  // The first inverse update includes allocations, so the following
+  // m_inverse_rebalance_updates updates are timed instead.
+  const bool is_inverse_timed =
+      is_kronecker_update_required
+      && m_inverse_strategy == kfac::kfac_inverse_strategy::BALANCED
+      && context.m_num_inverse_updates > 0
+      && context.m_num_inverse_updates <= m_inverse_rebalance_updates;
   prof_region_begin("kfac-inverse", prof_color, prof_sync);
-  for(auto& block : context.m_blocks) {
+  for(size_t i = 0; i < context.m_blocks.size(); i++) {
+    auto& block = context.m_blocks[i];
     if(!is_kronecker_update_required || (size_t) comm.get_rank_in_trainer() != block->get_inverse_proc_rank())
       continue;
 
+    const double t_start = get_time();
     prof_region_begin(("kfac-inverse/" + block->get_name()).c_str(), prof_color, prof_sync);
     // TODO: Add kfac_block::is_bn?
     const bool is_bn = dynamic_cast<kfac_block_bn<Device>*>(block.get()) != nullptr;
@@ -604,6 +801,12 @@ void KFAC::on_backward_prop_end(
         m_print_matrix, m_print_matrix_summary,
         m_print_time);
     prof_region_end(("kfac-inverse/" + block->get_name()).c_str(), prof_sync);
+    if(is_inverse_timed) {
+#ifdef LBANN_HAS_GPU
+      hydrogen::gpu::SynchronizeDevice();
+#endif // LBANN_HAS_GPU
+      context.m_inverse_times[i] += get_time() - t_start;
+    }
   }
   m_has_kronecker_inverse = true;
   prof_region_end("kfac-inverse", prof_sync);
@@ -658,6 +861,16 @@ void KFAC::on_backward_prop_end(
 
   prof_region_end("kfac-step", prof_sync);
 
+  // Reassign blocks once enough inverse updates have been timed. The
+  // new owners restart their factor averages and inverses at the
+  // next Kronecker update.
+  if(is_kronecker_update_required) {
+    context.m_num_inverse_updates++;
+    if(is_inverse_timed
+       && context.m_num_inverse_updates == m_inverse_rebalance_updates+1)
+      rebalance_inverse_proc_ranks(context, comm);
+  }
+
   if(is_first_step) {
     for(auto& block : context.m_blocks) {
       for(auto& info : block->get_internal_matrix_info()) {
@@ -676,6 +889,40 @@ void KFAC::on_backward_prop_end(
 
 }
 
+void KFAC::rebalance_inverse_proc_ranks(
+  ExeContextType& context,
+  lbann_comm& comm) {
+
+  // Each block is timed only by its owner
+  auto& times = context.m_inverse_times;
+  std::vector<double> global_times(times.size(), 0.0);
+  comm.trainer_allreduce(times.data(), times.size(), global_times.data());
+  const auto ranks = kfac::get_balanced_proc_ranks(
+      global_times, comm.get_procs_per_trainer());
+
+  // Report the expected improvement
+  std::vector<double> old_loads(comm.get_procs_per_trainer(), 0.0);
+  std::vector<double> new_loads(comm.get_procs_per_trainer(), 0.0);
+  for(size_t i = 0; i < context.m_blocks.size(); i++) {
+    old_loads[context.m_blocks[i]->get_inverse_proc_rank()] += global_times[i];
+    new_loads[ranks[i]] += global_times[i];
+    context.m_blocks[i]->set_inverse_proc_rank(ranks[i]);
+  }
+  if(comm.am_trainer_master()) {
+    std::cout << "K-FAC: rebalanced inverse assignment using measured times"
+              << " (max inverse time per process: "
+              << *std::max_element(old_loads.begin(), old_loads.end())
+              << "s -> "
+              << *std::max_element(new_loads.begin(), new_loads.end())
+              << "s over " << m_inverse_rebalance_updates << " updates)"
+              << std::endl;
+    for(const auto& block : context.m_blocks)
+      std::cout << "K-FAC setup: " << block->get_info() << std::endl;
+  }
+  std::fill(times.begin(), times.end(), 0.0);
+
+}
+
 } // namespace lbann
 
 template <>
@@ -759,12 +1006,16 @@ std::unique_ptr<lbann::KFAC> lbann::make<lbann::KFAC>(
     inverse_strategy = kfac::kfac_inverse_strategy::EACH;
   else if(inverse_strategy_str == "root")
     inverse_strategy = kfac::kfac_inverse_strategy::ROOT;
+  else if(inverse_strategy_str == "balanced")
+    inverse_strategy = kfac::kfac_inverse_strategy::BALANCED;
   else {
     std::stringstream err;
     err << "Invalid inverse strategy type: "
         << inverse_strategy_str;
     LBANN_ERROR(err.str());
   }
+  const size_t inverse_rebalance_updates =
+      kfac_params.inverse_rebalance_updates();
 
   const std::vector<std::string> disable_layers =
       parse_list<std::string>(kfac_params.disable_layers());
@@ -776,6 +1027,13 @@ std::unique_ptr<lbann::KFAC> lbann::make<lbann::KFAC>(
   if(learning_rate_factor_gru == 0.0)
     learning_rate_factor_gru = learning_rate_factor;
 
+  size_t eigen_refresh_interval = 0;
+  if(kfac_params.use_eigen_decomposition()) {
+    eigen_refresh_interval = kfac_params.eigen_refresh_interval();
+    if(eigen_refresh_interval == 0)
+      eigen_refresh_interval = 1;
+  }
+
   return make_unique<AlgoType>(
     params.name(),
     std::move(stopping),
@@ -792,8 +1050,11 @@ std::unique_ptr<lbann::KFAC> lbann::make<lbann::KFAC>(
     std::move(update_intervals),
     update_interval_steps,
     inverse_strategy,
+    inverse_rebalance_updates,
     std::move(disable_layers),
     learning_rate_factor,
-    learning_rate_factor_gru);
+    learning_rate_factor_gru,
+    eigen_refresh_interval,
+    kfac_params.overlap_factor_reduction());
 
 }
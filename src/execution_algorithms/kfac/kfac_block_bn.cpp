@@ -256,6 +256,12 @@ kfac_block_bn<Device>::get_preconditioned_grad_buffers() {
   return ret;
 }
 
+template <El::Device Device>
+double kfac_block_bn<Device>::get_inverse_cost() const {
+  // The Fisher block couples the scales and biases of all channels.
+  return kfac::get_matrix_inverse_cost(m_num_channels*2);
+}
+
 template <El::Device Device>
 std::vector<std::tuple<std::string, size_t, size_t>>
 kfac_block_bn<Device>::get_internal_matrix_info() const {
@@ -228,26 +228,49 @@ void kfac_block_fc_conv<Device>::update_kronecker_inverse(
     LBANN_WARNING(err.str());
   }
 
+  const bool use_eigen = (m_eigen_refresh_interval > 0);
   if(!this->m_has_kronecker_inverse) {
     this->m_has_kronecker_inverse = true;
-    m_kronecker_inverse_A.Resize(Aave.Height(), Aave.Width());
-    m_kronecker_inverse_G.Resize(Gave.Height(), Gave.Width());
+    if(!use_eigen) {
+      m_kronecker_inverse_A.Resize(Aave.Height(), Aave.Width());
+      m_kronecker_inverse_G.Resize(Gave.Height(), Gave.Width());
+    }
   }
   // TODO: Refactoring
   auto& Ainv = m_kronecker_inverse_A;
   auto& Ginv = m_kronecker_inverse_G;
-  auto& ALinv = this->get_workspace_matrix(
-      "ALinv", Aave.Height(), Aave.Height());
-  auto& GLinv = this->get_workspace_matrix(
-      "GLinv", Gave.Height(), Gave.Height());
-  kfac::get_matrix_inverse(
-      Ainv, ALinv, Aave, comm->am_trainer_master() && print_time,
-      DataType(damping_act*pi), 0,
-      false, sync_info);
-  kfac::get_matrix_inverse(
-      Ginv, GLinv, Gave, comm->am_trainer_master() && print_time,
-      DataType(damping_err/pi), 0,
-      false, sync_info);
+  if(use_eigen) {
+    // Damping is applied when preconditioning, so the eigenbases
+    // only need to track the factors. Refreshes are staggered across
+    // blocks to spread the decompositions over several updates.
+    const bool is_refresh_required =
+        m_eigenvalues_A.Height() != Aave.Height()
+        || m_eigenvalues_G.Height() != Gave.Height()
+        || ((m_num_inverse_updates + m_eigen_refresh_offset)
+            % m_eigen_refresh_interval) == 0;
+    if(is_refresh_required) {
+      kfac::get_matrix_eigen(
+          m_eigenvectors_A, m_eigenvalues_A, Aave,
+          comm->am_trainer_master() && print_time);
+      kfac::get_matrix_eigen(
+          m_eigenvectors_G, m_eigenvalues_G, Gave,
+          comm->am_trainer_master() && print_time);
+    }
+  } else {
+    auto& ALinv = this->get_workspace_matrix(
+        "ALinv", Aave.Height(), Aave.Height());
+    auto& GLinv = this->get_workspace_matrix(
+        "GLinv", Gave.Height(), Gave.Height());
+    kfac::get_matrix_inverse(
+        Ainv, ALinv, Aave, comm->am_trainer_master() && print_time,
+        DataType(damping_act*pi), 0,
+        false, sync_info);
+    kfac::get_matrix_inverse(
+        Ginv, GLinv, Gave, comm->am_trainer_master() && print_time,
+        DataType(damping_err/pi), 0,
+        false, sync_info);
+  }
+  m_num_inverse_updates++;
 
   if(print_matrix_summary) {
     std::ostringstream oss;
@@ -296,19 +319,46 @@ void kfac_block_fc_conv<Device>::update_kronecker_inverse(
   // Compute preconditioned gradients
   auto& Gg = this->get_workspace_matrix(
       "Gg",
-      Ginv.Height(),
+      Gave.Height(),
       m_is_conv ? w_gradients.Height() : w_gradients.Width());
-
-  El::Gemm(
-      El::NORMAL, m_is_conv ? El::TRANSPOSE : El::NORMAL,
-      El::TypeTraits<DataType>::One(), Ginv, w_gradients,
-      El::TypeTraits<DataType>::Zero(), Gg);
   auto& Fgrad = this->get_workspace_matrix(
-      "Fgrad", Ginv.Height(), Ainv.Width());
-  El::Gemm(
-      El::NORMAL, El::NORMAL,
-      learning_rate_factor, Gg, Ainv,
-      El::TypeTraits<DataType>::Zero(), Fgrad);
+      "Fgrad", Gave.Height(), Aave.Width());
+  if(use_eigen) {
+    // Fgrad = QG ((QG^T grad QA) ./ ((lG+dG) (lA+dA)^T)) QA^T
+    const auto& QA = m_eigenvectors_A;
+    const auto& QG = m_eigenvectors_G;
+    El::Gemm(
+        El::TRANSPOSE, m_is_conv ? El::TRANSPOSE : El::NORMAL,
+        El::TypeTraits<DataType>::One(), QG, w_gradients,
+        El::TypeTraits<DataType>::Zero(), Gg);
+    auto& GgQ = this->get_workspace_matrix(
+        "GgQ", Gg.Height(), QA.Width());
+    El::Gemm(
+        El::NORMAL, El::NORMAL,
+        El::TypeTraits<DataType>::One(), Gg, QA,
+        El::TypeTraits<DataType>::Zero(), GgQ);
+    kfac::scale_by_damped_eigenvalues(
+        GgQ, m_eigenvalues_G, m_eigenvalues_A,
+        DataType(damping_err/pi), DataType(damping_act*pi),
+        sync_info);
+    El::Gemm(
+        El::NORMAL, El::NORMAL,
+        El::TypeTraits<DataType>::One(), QG, GgQ,
+        El::TypeTraits<DataType>::Zero(), Gg);
+    El::Gemm(
+        El::NORMAL, El::TRANSPOSE,
+        learning_rate_factor, Gg, QA,
+        El::TypeTraits<DataType>::Zero(), Fgrad);
+  } else {
+    El::Gemm(
+        El::NORMAL, m_is_conv ? El::TRANSPOSE : El::NORMAL,
+        El::TypeTraits<DataType>::One(), Ginv, w_gradients,
+        El::TypeTraits<DataType>::Zero(), Gg);
+    El::Gemm(
+        El::NORMAL, El::NORMAL,
+        learning_rate_factor, Gg, Ainv,
+        El::TypeTraits<DataType>::Zero(), Fgrad);
+  }
 
   // Update gradients in the buffer
   DataType dst_scale = El::TypeTraits<DataType>::Zero(),
@@ -346,8 +396,13 @@ void kfac_block_fc_conv<Device>::update_kronecker_inverse(
 
   // Dump matrices for debugging
   if(print_matrix) {
-    std::cout << std::endl; El::Print(Ainv, "Ainv");
-    std::cout << std::endl; El::Print(Ginv, "Ginv");
+    if(use_eigen) {
+      std::cout << std::endl; El::Print(m_eigenvalues_A, "lambda_A");
+      std::cout << std::endl; El::Print(m_eigenvalues_G, "lambda_G");
+    } else {
+      std::cout << std::endl; El::Print(Ainv, "Ainv");
+      std::cout << std::endl; El::Print(Ginv, "Ginv");
+    }
     std::cout << std::endl; El::Print(w_gradients, "w_grad");
     std::cout << std::endl; El::Print(Fgrad, "Fgrad");
     std::cout << std::endl;
@@ -360,8 +415,12 @@ void kfac_block_fc_conv<Device>::update_kronecker_inverse(
     std::ostringstream oss;
     oss << "K-FAC: L2 norm @ "<< this->m_layer->get_name() << ": "
         << kfac::get_matrix_stat((const El::Matrix<DataType, Device>&) w_values.LockedMatrix(), "W")
-        << ", " << kfac::get_matrix_stat(Ainv, "Ainv")
-        << ", " << kfac::get_matrix_stat(Ginv, "Ginv")
+        << ", " << (use_eigen
+                    ? kfac::get_matrix_stat(m_eigenvalues_A, "lambda_A")
+                    : kfac::get_matrix_stat(Ainv, "Ainv"))
+        << ", " << (use_eigen
+                    ? kfac::get_matrix_stat(m_eigenvalues_G, "lambda_G")
+                    : kfac::get_matrix_stat(Ginv, "Ginv"))
         << ", " << kfac::get_matrix_stat(w_gradients, "grad")
         << ", " << kfac::get_matrix_stat(Fgrad, "Finvgrad")
         << std::endl;
@@ -492,6 +551,35 @@ double kfac_block_fc_conv<Device>::compute_pi(
   return sqrt((get_trace(A, ws, sync_info)/A.Height())/(get_trace(G, ws, sync_info)/G.Height()));
 }
 
+template <El::Device Device>
+double kfac_block_fc_conv<Device>::get_inverse_cost() const {
+  // Heights of the Kronecker factors, as in
+  // compute_local_kronecker_factors
+  size_t height_A = this->m_layer->get_input_size();
+  size_t height_G = this->m_layer->get_output_size();
+  if(m_is_conv) {
+    const auto* l_conv = dynamic_cast<const convolution_layer<DataType, data_layout::DATA_PARALLEL, Device>*>(this->m_layer);
+    const auto conv_dims = l_conv->get_conv_dims();
+    height_A = this->m_layer->get_input_dims()[0]
+        *std::accumulate(conv_dims.begin(), conv_dims.end(),
+                         1, std::multiplies<int>());
+    height_G = this->m_layer->get_output_dims()[0];
+  }
+  if(m_has_bias)
+    height_A++;
+  if(m_eigen_refresh_interval > 0) {
+    // Decompositions are amortized over the refresh interval, but
+    // preconditioning takes twice as many products.
+    return (kfac::get_matrix_eigen_cost(height_A)
+            + kfac::get_matrix_eigen_cost(height_G))
+        / m_eigen_refresh_interval
+        + 2 * kfac::get_precondition_cost(height_G, height_A);
+  }
+  return kfac::get_matrix_inverse_cost(height_A)
+      + kfac::get_matrix_inverse_cost(height_G)
+      + kfac::get_precondition_cost(height_G, height_A);
+}
+
 template <El::Device Device>
 std::vector<std::tuple<std::string, size_t, size_t>>
 kfac_block_fc_conv<Device>::get_internal_matrix_info() const {
@@ -507,6 +595,10 @@ kfac_block_fc_conv<Device>::get_internal_matrix_info() const {
   emplace("average_G", m_kronecker_average_G);
   emplace("inverse_A", m_kronecker_inverse_A);
   emplace("inverse_G", m_kronecker_inverse_G);
+  emplace("eigenvectors_A", m_eigenvectors_A);
+  emplace("eigenvectors_G", m_eigenvectors_G);
+  emplace("eigenvalues_A", m_eigenvalues_A);
+  emplace("eigenvalues_G", m_eigenvalues_G);
   emplace("grad_buffer_v", m_grad_buffer_v);
   return list;
 }
@@ -476,6 +476,24 @@ kfac_block_gru<Device>::get_preconditioned_grad_buffers() {
   return ret;
 }
 
+template <El::Device Device>
+double kfac_block_gru<Device>::get_inverse_cost() const {
+  const size_t hidden_size = get_hidden_size();
+  const size_t input_size = get_input_size();
+  double cost = kfac::get_matrix_inverse_cost(hidden_size)
+      + kfac::get_matrix_inverse_cost(input_size);
+  for(auto& matrix_type : kfac_gru_util::LEARNABLE_MATRICES) {
+    const bool is_recurrent =
+        (matrix_type == kfac_gru_util::weight_type::Rr
+         || matrix_type == kfac_gru_util::weight_type::Ri
+         || matrix_type == kfac_gru_util::weight_type::Rh);
+    cost += kfac::get_matrix_inverse_cost(hidden_size)
+        + kfac::get_precondition_cost(
+            hidden_size, is_recurrent ? hidden_size : input_size);
+  }
+  return cost;
+}
+
 template <El::Device Device>
 std::vector<std::tuple<std::string, size_t, size_t>>
 kfac_block_gru<Device>::get_internal_matrix_info() const {
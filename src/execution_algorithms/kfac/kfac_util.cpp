@@ -29,14 +29,42 @@
 #include "lbann/base.hpp"
 #include "lbann/utils/timer.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <core/imports/mpi.hpp>
 #include <iomanip>
 #include <iterator>
+#include <numeric>
+
+// LAPACK symmetric eigensolver (divide and conquer)
+extern "C" {
+void ssyevd_(const char* jobz, const char* uplo, const int* n,
+             float* a, const int* lda, float* w,
+             float* work, const int* lwork,
+             int* iwork, const int* liwork, int* info);
+void dsyevd_(const char* jobz, const char* uplo, const int* n,
+             double* a, const int* lda, double* w,
+             double* work, const int* lwork,
+             int* iwork, const int* liwork, int* info);
+} // extern "C"
 
 namespace lbann {
 namespace kfac {
 namespace {
+
+void syevd(const char* jobz, const char* uplo, const int* n,
+           float* a, const int* lda, float* w,
+           float* work, const int* lwork,
+           int* iwork, const int* liwork, int* info) {
+  ssyevd_(jobz, uplo, n, a, lda, w, work, lwork, iwork, liwork, info);
+}
+void syevd(const char* jobz, const char* uplo, const int* n,
+           double* a, const int* lda, double* w,
+           double* work, const int* lwork,
+           int* iwork, const int* liwork, int* info) {
+  dsyevd_(jobz, uplo, n, a, lda, w, work, lwork, iwork, liwork, info);
+}
+
 std::vector<int> intify_size_t_vector(std::vector<size_t> const& in_sizes)
 {
   std::vector<int> out;
@@ -225,6 +253,56 @@ void get_matrix_inverse(
   El::Synchronize(sync_info);
 }
 
+template <El::Device Device>
+void get_matrix_eigen(
+    El::Matrix<DataType, Device>& Q,
+    El::Matrix<DataType, Device>& lambda,
+    const El::Matrix<DataType, Device>& A,
+    const bool report_time) {
+  assert(A.Height() == A.Width());
+  const int n = A.Height();
+
+  const double t_start = get_time();
+
+  // LAPACK overwrites the input with the eigenvectors
+  El::Matrix<DataType, El::Device::CPU> Q_host, lambda_host(n, 1);
+  El::Copy(A, Q_host);
+  const int lda = Q_host.LDim();
+  const char jobz = 'V', uplo = 'L';
+  int info = 0, lwork = -1, liwork = -1, iwork_query = 0;
+  DataType work_query = 0;
+  syevd(&jobz, &uplo, &n, Q_host.Buffer(), &lda, lambda_host.Buffer(),
+        &work_query, &lwork, &iwork_query, &liwork, &info);
+  lwork = static_cast<int>(work_query);
+  liwork = iwork_query;
+  std::vector<DataType> work(std::max(lwork, 1));
+  std::vector<int> iwork(std::max(liwork, 1));
+  syevd(&jobz, &uplo, &n, Q_host.Buffer(), &lda, lambda_host.Buffer(),
+        work.data(), &lwork, iwork.data(), &liwork, &info);
+  if(info != 0) {
+    std::stringstream err;
+    err << "K-FAC: eigendecomposition of a "
+        << n << "x" << n << " matrix failed (info=" << info << ")";
+    LBANN_ERROR(err.str());
+  }
+  for(int i = 0; i < n; i++)
+    lambda_host(i, 0) = std::max(lambda_host(i, 0), DataType(0));
+
+  const double t_eigen = get_time();
+
+  El::Copy(Q_host, Q);
+  El::Copy(lambda_host, lambda);
+
+  if(report_time) {
+    std::cout << "K-FAC: get_matrix_eigen of"
+              << " " << A.Height() << "x" << A.Width()
+              << " using LAPACK: "
+              << " t_syevd=" << (t_eigen-t_start)
+              << ", t_copy=" << (get_time()-t_eigen)
+              << std::endl;
+  }
+}
+
 template <El::Device Device>
 std::string get_matrix_stat(const El::Matrix<DataType, Device>& X,
                             const char *name) {
@@ -256,6 +334,49 @@ void allreduce_lower_tri(El::AbstractMatrix<DataType>& A,
   unpack_lower_tri<Device>(A, AL, sync_info);
 }
 
+double get_matrix_inverse_cost(const size_t n) {
+  const double dn = n;
+  // Cholesky, Trsm against the identity, and L^T L take about 2n^3
+  // flops together.
+  return 2.0 * dn * dn * dn;
+}
+
+double get_precondition_cost(const size_t g, const size_t a) {
+  const double dg = g, da = a;
+  return 2.0 * (dg * dg * da + dg * da * da);
+}
+
+double get_matrix_eigen_cost(const size_t n) {
+  const double dn = n;
+  // Tridiagonal reduction, divide and conquer, and back-transformation
+  // take roughly 9n^3 flops together.
+  return 9.0 * dn * dn * dn;
+}
+
+std::vector<size_t> get_balanced_proc_ranks(
+    const std::vector<double>& costs,
+    const size_t num_procs) {
+  if(num_procs == 0)
+    LBANN_ERROR("K-FAC requires at least one process.");
+  std::vector<size_t> order(costs.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(
+      order.begin(), order.end(),
+      [&costs](const size_t i, const size_t j) {
+        return costs[i] > costs[j];
+      });
+  std::vector<double> loads(num_procs, 0.0);
+  std::vector<size_t> ranks(costs.size(), 0);
+  for(const auto& i : order) {
+    const auto rank = std::distance(
+        loads.begin(),
+        std::min_element(loads.begin(), loads.end()));
+    ranks[i] = rank;
+    loads[rank] += costs[i];
+  }
+  return ranks;
+}
+
 bool is_reduce_scatter_buffer_required(const kfac_reduce_scatter_mode mode) {
   if(mode == kfac_reduce_scatter_mode::ALLREDUCE)
     return true;
@@ -443,6 +564,24 @@ void add_to_diagonal(
     A(i, i) += (is_bn && i >= A.Height()/2 ? damping_bn_err : damping);
 }
 
+template <>
+void scale_by_damped_eigenvalues(
+    El::Matrix<DataType, El::Device::CPU>& X,
+    const El::Matrix<DataType, El::Device::CPU>& lambda_rows,
+    const El::Matrix<DataType, El::Device::CPU>& lambda_cols,
+    const DataType damping_rows,
+    const DataType damping_cols,
+    const El::SyncInfo<El::Device::CPU>& sync_info) {
+  const auto height = X.Height();
+  const auto width = X.Width();
+#pragma omp parallel for
+  for(int col = 0; col < width; col++) {
+    const DataType col_scale = lambda_cols(col, 0) + damping_cols;
+    for(int row = 0; row < height; row++)
+      X(row, col) /= (lambda_rows(row, 0) + damping_rows) * col_scale;
+  }
+}
+
 template <>
 void fill_upper_tri(
     El::Matrix<DataType, El::Device::CPU>& A,
@@ -515,6 +654,11 @@ void unpack_lower_tri(
       T damping_bn_err,                         \
       bool is_bn,                               \
       const El::SyncInfo<Device>& sync_info);   \
+  template void get_matrix_eigen(               \
+      El::Matrix<T, Device>& Q,                 \
+      El::Matrix<T, Device>& lambda,            \
+      const El::Matrix<T, Device>& A,           \
+      bool report_time);                        \
   template std::string get_matrix_stat(         \
       const El::Matrix<T, Device>& X,           \
       const char *name);                        \
@@ -45,6 +45,24 @@ __global__ void kfac_add_to_diagonal_kernel(
   }
 }
 
+template <typename TensorDataType>
+__global__ void kfac_scale_by_damped_eigenvalues_kernel(
+    TensorDataType * __restrict__ X,
+    const TensorDataType * __restrict__ lambda_rows,
+    const TensorDataType * __restrict__ lambda_cols,
+    const size_t height,
+    const size_t width,
+    const size_t ldim,
+    const TensorDataType damping_rows,
+    const TensorDataType damping_cols) {
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t row = gid%height, col = gid/height;
+  if(col < width) {
+    X[row+col*ldim] /= (lambda_rows[row]+damping_rows)
+        *(lambda_cols[col]+damping_cols);
+  }
+}
+
 template <typename TensorDataType>
 __global__ void kfac_fill_upper_tri_kernel(
     TensorDataType * __restrict__ A,
@@ -145,6 +163,28 @@ void add_to_diagonal(
   }
 }
 
+template <>
+void scale_by_damped_eigenvalues(
+    El::Matrix<DataType, El::Device::GPU>& X,
+    const El::Matrix<DataType, El::Device::GPU>& lambda_rows,
+    const El::Matrix<DataType, El::Device::GPU>& lambda_cols,
+    const DataType damping_rows,
+    const DataType damping_cols,
+    const El::SyncInfo<El::Device::GPU>& sync_info) {
+  const size_t height = X.Height();
+  const size_t width = X.Width();
+  constexpr size_t block_size = 256;
+  const size_t grid_size = (height*width + block_size - 1) / block_size;
+  if (grid_size > 0) {
+    hydrogen::gpu::LaunchKernel(
+      kfac_scale_by_damped_eigenvalues_kernel<DataType>,
+      grid_size, block_size, 0, sync_info,
+      X.Buffer(), lambda_rows.LockedBuffer(), lambda_cols.LockedBuffer(),
+      height, width, (size_t) X.LDim(),
+      damping_rows, damping_cols);
+  }
+}
+
 template <>
 void fill_upper_tri(
     El::Matrix<DataType, El::Device::GPU>& A,
@@ -0,0 +1,508 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/execution_algorithms/local_sgd.hpp"
+#include "lbann/execution_algorithms/local_sgd/execution_context.hpp"
+#include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/callbacks/callback.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/optimizers/adam.hpp"
+#include "lbann/optimizers/sgd.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/timer.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <training_algorithm.pb.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+/** @brief Matrices that are averaged for a weights object.
+ *
+ *  The weights values always come first, followed by the SGD
+ *  velocity or the Adam moments if requested.
+ */
+template <typename TensorDataType>
+std::vector<El::AbstractDistMatrix<TensorDataType>*>
+get_averaged_matrices(lbann::data_type_weights<TensorDataType>& w,
+                      bool include_optimizer_state)
+{
+  std::vector<El::AbstractDistMatrix<TensorDataType>*> mats = {
+    &w.get_values()};
+  if (!include_optimizer_state)
+    return mats;
+  auto* opt = w.get_optimizer();
+  if (auto* sgd_opt = dynamic_cast<lbann::sgd<TensorDataType>*>(opt)) {
+    if (sgd_opt->get_momentum() != TensorDataType(0))
+      mats.push_back(&sgd_opt->get_velocity());
+  }
+  else if (auto* adam_opt = dynamic_cast<lbann::adam<TensorDataType>*>(opt)) {
+    mats.push_back(&adam_opt->get_moment1());
+    mats.push_back(&adam_opt->get_moment2());
+  }
+  return mats;
+}
+
+} // namespace
+
+namespace lbann {
+
+LocalSGD::LocalSGD(
+  std::string name,
+  std::unique_ptr<TermCriteriaType> stop,
+  size_t sync_interval,
+  size_t max_sync_interval,
+  size_t sync_interval_growth_period,
+  size_t warmup_steps,
+  bool average_optimizer_state)
+  : BaseType{std::move(name)},
+    m_stopping_criteria{std::move(stop)},
+    m_sync_interval{sync_interval},
+    m_max_sync_interval{std::max(sync_interval, max_sync_interval)},
+    m_sync_interval_growth_period{sync_interval_growth_period},
+    m_warmup_steps{warmup_steps},
+    m_average_optimizer_state{average_optimizer_state}
+{
+  if (m_sync_interval == 0) {
+    LBANN_ERROR("local SGD sync interval must be positive");
+  }
+}
+
+LocalSGD::LocalSGD(LocalSGD const& other)
+  : BaseType(other.get_name()),
+    m_stopping_criteria{other.m_stopping_criteria->clone()},
+    m_sync_interval{other.m_sync_interval},
+    m_max_sync_interval{other.m_max_sync_interval},
+    m_sync_interval_growth_period{other.m_sync_interval_growth_period},
+    m_warmup_steps{other.m_warmup_steps},
+    m_average_optimizer_state{other.m_average_optimizer_state}
+{}
+
+LocalSGD& LocalSGD::operator=(LocalSGD const& other) {
+  BaseType::operator=(other);
+  m_stopping_criteria = other.m_stopping_criteria->clone();
+  m_sync_interval = other.m_sync_interval;
+  m_max_sync_interval = other.m_max_sync_interval;
+  m_sync_interval_growth_period = other.m_sync_interval_growth_period;
+  m_warmup_steps = other.m_warmup_steps;
+  m_average_optimizer_state = other.m_average_optimizer_state;
+  return *this;
+}
+
+std::string LocalSGD::get_type() const { return "LocalSGD"; }
+
+local_sgd::ExecutionContext* LocalSGD::do_get_new_execution_context() const
+{
+  return new local_sgd::ExecutionContext(0UL);
+}
+
+// =============================================
+// Evaluation and training
+// =============================================
+
+void LocalSGD::apply(
+  execution_context& context_,
+  model& model,
+  data_coordinator& dc,
+  execution_mode mode)
+{
+  ExeContextType& context = dynamic_cast<ExeContextType&>(context_);
+  if (mode == execution_mode::training) {
+    train(context, model, dc, *m_stopping_criteria);
+  }
+  else {
+    sgd_training_algorithm eval_algo(
+      this->get_name()+"_eval",
+      m_stopping_criteria->clone());
+    auto& eval_context = context.get_sgd_execution_context();
+    eval_algo.apply(eval_context, model, dc, mode);
+  }
+}
+
+void LocalSGD::train(
+  ExeContextType& context,
+  model& model,
+  data_coordinator& dc,
+  TermCriteriaType const& term)
+{
+  // Initialize some state so it knows we're training now.
+  auto& sgd_context = context.get_sgd_execution_context();
+  sgd_context.set_execution_mode(execution_mode::training);
+  model.reset_mode(sgd_context, execution_mode::training);
+  dc.reset_mode(sgd_context);
+
+  // Sync trainers (Assumption: all trainers in this lbann_comm are
+  // participating in this training algorithm)
+  model.get_comm()->intertrainer_barrier();
+
+  // Run callbacks. This may restore the context from a checkpoint.
+  do_train_begin_cbs(model);
+  update_sync_interval(context);
+
+  // Start iterating
+  bool is_start_of_epoch = true;
+  sgd_context.start_timer();
+  while (!term(sgd_context)) {
+
+    if (is_start_of_epoch) {
+      // Initialize epoch
+      model.reset_mode(sgd_context, execution_mode::training);
+      model.reset_epoch_statistics(execution_mode::training);
+      dc.reset_mode(sgd_context);
+      do_epoch_begin_cbs(model);
+      is_start_of_epoch = false;
+    }
+
+    // Train a mini batch. Returns "true" if the data_coordinator
+    // detects the end of an epoch.
+    if (train_mini_batch(context, model, dc)) {
+      // Finalize epoch
+      sgd_context.inc_epoch();
+      model.reconcile_weight_values();
+      do_epoch_end_cbs(model);
+
+      // Evaluate on validation set
+      //
+      // Note: Copied from sgd_training_algorithm.cpp. Each trainer
+      // validates the model it currently holds.
+      if (dc.is_execution_mode_valid(execution_mode::validation)) {
+        const execution_mode eval_mode = execution_mode::validation;
+        sgd_execution_context eval_context(
+          eval_mode,
+          dc.get_mini_batch_size(eval_mode));
+        size_t num_validation_epochs = 1UL;
+        if (sgd_context.get_epoch() > 1UL) {
+          eval_context.inc_epoch();
+          ++num_validation_epochs;
+        }
+        sgd_training_algorithm eval_algo(
+          this->get_name()+"_eval",
+          make_unique<epoch_termination_criteria>(num_validation_epochs));
+        eval_algo.apply(eval_context, model, dc, eval_mode);
+        sgd_context.set_early_stop(eval_context.get_early_stop());
+      }
+
+      // Trigger new epoch stuff next iteration (if there is one).
+      is_start_of_epoch = true;
+    }
+  }
+  sgd_context.stop_timer();
+
+  // Leave all trainers with the same model
+  if (context.m_steps_since_average > 0) {
+    average_models(context, model);
+  }
+
+  // Reset the model back to the training execution context prior to
+  // end of training callbacks
+  model.reset_mode(sgd_context, execution_mode::training);
+  do_train_end_cbs(model);
+
+  auto const& comm = *model.get_comm();
+  if (comm.am_world_master() && context.get_step() > 0) {
+    std::cout << "LocalSGD: " << context.get_step() << " model averages in "
+              << sgd_context.get_step() << " steps ("
+              << 1e3 * context.m_average_time / context.get_step()
+              << " ms per average)" << std::endl;
+  }
+}
+
+// =============================================
+// Mini-batch step
+// =============================================
+
+// Returns "true" if the data_coordinator detects the end of an epoch.
+bool LocalSGD::train_mini_batch(
+  ExeContextType& context,
+  model& model,
+  data_coordinator& dc)
+{
+  auto& sgd_context = context.get_sgd_execution_context();
+
+  model.reset_mode(sgd_context, execution_mode::training);
+  dc.reset_mode(sgd_context);
+  do_batch_begin_cbs(model);
+
+  bool finished = false;
+
+  dc.fetch_data(execution_mode::training);
+
+#if defined(LBANN_HAVE_OMP_TASKLOOP)
+  LBANN_OMP_PARALLEL
+  {
+#pragma omp single
+    {
+#endif
+      // Forward prop step
+      model.clear_gradients();
+      model.forward_prop(execution_mode::training);
+      // check if the data coordinator has finished the epoch and kickoff
+      // background I/O
+      finished = dc.epoch_complete(execution_mode::training);
+
+      // Result is not needed until the end of the mini-batch.
+      model.get_objective_function()->start_evaluation(
+        execution_mode::training,
+        sgd_context.get_current_mini_batch_size());
+
+      // Backward prop step
+      model.get_objective_function()->differentiate();
+      model.backward_prop();
+      model.get_objective_function()->compute_weight_regularization();
+
+      // Finish evaluation.
+      model.get_objective_function()->finish_evaluation(
+        execution_mode::training,
+        sgd_context.get_current_mini_batch_size());
+      model.evaluate_metrics(execution_mode::training,
+                             sgd_context.get_current_mini_batch_size());
+
+      // Update step
+      model.update_weights();
+      model.update_layers();
+#if defined(LBANN_HAVE_OMP_TASKLOOP)
+    }
+  }
+#endif
+
+  // Average models once enough local steps have been taken
+  if (count_local_step(context)) {
+    average_models(context, model);
+  }
+
+  do_batch_end_cbs(model);
+  return finished;
+}
+
+// =============================================
+// Model averaging
+// =============================================
+
+void LocalSGD::average_models(ExeContextType& context, model& model) const
+{
+  auto& comm = *model.get_comm();
+  const double start = get_time();
+  const auto num_trainers = comm.get_num_trainers();
+
+  if (num_trainers > 1) {
+    using TensorDataType = DataType;
+    using WeightsType = data_type_weights<TensorDataType>;
+    using LocalMatType = El::Matrix<TensorDataType, local_sgd::Device>;
+
+    // Matrices are packed in the same order on all trainers
+    std::vector<El::AbstractDistMatrix<TensorDataType>*> mats;
+    El::Int buffer_size = 0;
+    for (auto* w_ptr : model.get_weights()) {
+      auto* w = dynamic_cast<WeightsType*>(w_ptr);
+      if (w == nullptr) {
+        LBANN_ERROR("local SGD only supports weights with the default "
+                    "data type, but weights \"",
+                    w_ptr->get_name(),
+                    "\" have a different one");
+      }
+      for (auto* mat : get_averaged_matrices(*w, m_average_optimizer_state)) {
+        mats.push_back(mat);
+        buffer_size += mat->LocalHeight() * mat->LocalWidth();
+      }
+    }
+
+    // Pack, allreduce once, and unpack
+    auto& buffer = context.m_average_buffer;
+    buffer.Resize(buffer_size, 1);
+    El::Int offset = 0;
+    for (auto const* mat : mats) {
+      auto const& local_mat = mat->LockedMatrix();
+      LocalMatType buffer_view;
+      buffer_view.Attach(local_mat.Height(),
+                         local_mat.Width(),
+                         buffer.Buffer(offset, 0),
+                         local_mat.Height());
+      El::Copy(local_mat, buffer_view);
+      offset += local_mat.Height() * local_mat.Width();
+    }
+    comm.allreduce(static_cast<El::AbstractMatrix<TensorDataType>&>(buffer),
+                   comm.get_intertrainer_comm());
+    El::Scale(El::TypeTraits<TensorDataType>::One() / num_trainers, buffer);
+    offset = 0;
+    for (auto* mat : mats) {
+      auto& local_mat = mat->Matrix();
+      LocalMatType buffer_view;
+      buffer_view.LockedAttach(local_mat.Height(),
+                               local_mat.Width(),
+                               buffer.LockedBuffer(offset, 0),
+                               local_mat.Height());
+      El::Copy(buffer_view, local_mat);
+      offset += local_mat.Height() * local_mat.Width();
+    }
+  }
+
+  context.m_average_time += get_time() - start;
+  finish_average(context);
+}
+
+// =============================================
+// Averaging schedule
+// =============================================
+
+bool LocalSGD::count_local_step(ExeContextType& context) const
+{
+  context.get_sgd_execution_context().inc_step();
+  return ++context.m_steps_since_average >= context.m_sync_interval;
+}
+
+void LocalSGD::finish_average(ExeContextType& context) const
+{
+  context.inc_step();
+  context.m_steps_since_average = 0;
+  if (context.get_sgd_execution_context().get_step() > m_warmup_steps) {
+    ++context.m_num_local_rounds;
+  }
+  update_sync_interval(context);
+}
+
+void LocalSGD::update_sync_interval(ExeContextType& context) const
+{
+  if (context.get_sgd_execution_context().get_step() < m_warmup_steps) {
+    context.m_sync_interval = 1;
+    return;
+  }
+  size_t interval = m_sync_interval;
+  if (m_sync_interval_growth_period > 0) {
+    const size_t num_doublings =
+      context.m_num_local_rounds / m_sync_interval_growth_period;
+    for (size_t i = 0; i < num_doublings && interval < m_max_sync_interval;
+         ++i) {
+      interval *= 2;
+    }
+  }
+  context.m_sync_interval = std::min(interval, m_max_sync_interval);
+}
+
+// =============================================
+// Callbacks
+// =============================================
+
+void LocalSGD::do_train_begin_cbs(model& model)
+{
+  for (const auto& cb : model.get_callbacks()) {
+    cb->on_train_begin(&model);
+  }
+}
+
+void LocalSGD::do_train_end_cbs(model& model)
+{
+  for (const auto& cb : model.get_callbacks()) {
+    cb->on_train_end(&model);
+  }
+}
+
+void LocalSGD::do_epoch_begin_cbs(model& model)
+{
+  for (const auto& cb : model.get_callbacks()) {
+    cb->on_epoch_begin(&model);
+  }
+}
+
+void LocalSGD::do_epoch_end_cbs(model& model)
+{
+  for (const auto& cb : model.get_callbacks()) {
+    cb->on_epoch_end(&model);
+  }
+}
+
+void LocalSGD::do_batch_begin_cbs(model& model)
+{
+  sgd_execution_context& c =
+    static_cast<sgd_execution_context&>(model.get_execution_context());
+  for (const auto& cb : model.get_callbacks()) {
+    if (c.get_step() % cb->get_batch_interval() == 0) {
+      cb->on_batch_begin(&model);
+    }
+  }
+}
+
+void LocalSGD::do_batch_end_cbs(model& model)
+{
+  sgd_execution_context& c =
+    static_cast<sgd_execution_context&>(model.get_execution_context());
+  for (const auto& cb : model.get_callbacks()) {
+    if (c.get_step() % cb->get_batch_interval() == 0) {
+      cb->on_batch_end(&model);
+    }
+  }
+}
+
+} // namespace lbann
+
+template <>
+std::unique_ptr<lbann::LocalSGD> lbann::make<lbann::LocalSGD>(
+  google::protobuf::Message const& msg_in)
+{
+  auto const& params =
+    dynamic_cast<lbann_data::TrainingAlgorithm const&>(msg_in);
+
+  lbann_data::LocalSGD local_sgd_params;
+  LBANN_ASSERT(params.parameters().UnpackTo(&local_sgd_params));
+
+  // SGD parameters
+  auto const& sgd_params = local_sgd_params.sgd();
+  auto const& stopping_criteria = sgd_params.stopping_criteria();
+  std::unique_ptr<lbann::sgd_termination_criteria> stopping;
+  switch (stopping_criteria.criterion_case()) {
+  case lbann_data::SGD::TerminationCriteria::kMaxBatches:
+    stopping = lbann::make_unique<lbann::batch_termination_criteria>(
+      stopping_criteria.max_batches());
+    break;
+  case lbann_data::SGD::TerminationCriteria::kMaxEpochs:
+    stopping = lbann::make_unique<lbann::epoch_termination_criteria>(
+      stopping_criteria.max_epochs());
+    break;
+  case lbann_data::SGD::TerminationCriteria::kMaxSeconds:
+    stopping = lbann::make_unique<lbann::seconds_termination_criteria>(
+      stopping_criteria.max_seconds());
+    break;
+  default:
+    LBANN_ERROR("No stopping criteria specified.");
+  }
+
+  const size_t sync_interval =
+    (local_sgd_params.sync_interval() > 0 ? local_sgd_params.sync_interval()
+                                          : 8UL);
+  return make_unique<LocalSGD>(params.name(),
+                               std::move(stopping),
+                               sync_interval,
+                               local_sgd_params.max_sync_interval(),
+                               local_sgd_params.sync_interval_growth_period(),
+                               local_sgd_params.warmup_steps(),
+                               local_sgd_params.average_optimizer_state());
+}
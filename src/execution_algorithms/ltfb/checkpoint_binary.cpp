@@ -74,5 +74,41 @@ CheckpointBinary::get_partner_model(model const& m,
   return partner_model_ptr;
 }
 
+std::unique_ptr<model>
+CheckpointBinary::transfer_model(model const& m,
+                                 El::Int partner_trainer,
+                                 size_t /*step*/,
+                                 bool send)
+{
+  auto const& comm = *m.get_comm();
+
+  // The sender serializes its model directly; no copy is needed.
+  if (send) {
+    send_object(comm, m, partner_trainer);
+    return nullptr;
+  }
+
+  auto partner_model_ptr = m.copy_model();
+  auto& partner_model = *partner_model_ptr;
+
+  // Keep track of weights that shouldn't be exchanged
+  std::unordered_map<std::string, std::unique_ptr<weights>> restore_weights;
+  auto const& weights_names = this->weights_names();
+  if (!weights_names.empty()) {
+    for (auto w : partner_model.get_weights()) {
+      if (weights_names.find(w->get_name()) == weights_names.cend()) {
+        using TensorDataType = DataType;
+        using WeightsType = data_type_weights<TensorDataType>;
+        restore_weights[w->get_name()] =
+          make_unique<WeightsType>(dynamic_cast<WeightsType&>(*w));
+      }
+    }
+  }
+  receive_object(comm, partner_model, partner_trainer);
+  restore_model_weights(partner_model, restore_weights);
+
+  return partner_model_ptr;
+}
+
 } // namespace ltfb
 } // namespace lbann
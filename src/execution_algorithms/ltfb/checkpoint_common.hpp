@@ -29,6 +29,9 @@
 #include "lbann/models/model.hpp"
 #include "lbann/weights/data_type_weights_impl.hpp"
 
+#include <limits>
+#include <sstream>
+#include <string>
 #include <unordered_set>
 
 namespace lbann {
@@ -109,6 +112,93 @@ inline static std::string sendrecv_string(lbann_comm const& c,
   return tgt;
 }
 
+/** @brief Send a string to the partner trainer's master process.
+ *
+ *  One-way counterpart of sendrecv_string. Only the trainer master
+ *  communicates.
+ */
+inline static void send_string(lbann_comm const& c,
+                               std::string const& src,
+                               El::Int partner_trainer)
+{
+  if (!c.am_trainer_master())
+    return;
+
+  size_t size = src.size();
+  c.send(&size, 1, partner_trainer, 0, El::SyncInfo<El::Device::CPU>{});
+
+  auto const* send_buf = reinterpret_cast<El::byte const*>(src.data());
+  std::size_t constexpr max_blk_size = std::numeric_limits<int>::max();
+  while (size) {
+    int const this_blk_size = (size > max_blk_size ? max_blk_size : size);
+    c.send(send_buf,
+           this_blk_size,
+           partner_trainer,
+           0,
+           El::SyncInfo<El::Device::CPU>{});
+    send_buf += this_blk_size;
+    size -= this_blk_size;
+  }
+}
+
+/** @brief Receive a string sent with send_string.
+ *
+ *  Returns an empty string on processes other than the trainer
+ *  master.
+ */
+inline static std::string recv_string(lbann_comm const& c,
+                                      El::Int partner_trainer)
+{
+  if (!c.am_trainer_master())
+    return "";
+
+  size_t size = 0;
+  c.recv(&size, 1, partner_trainer, 0, El::SyncInfo<El::Device::CPU>{});
+
+  std::string tgt(size, '\0');
+  auto* recv_buf = reinterpret_cast<El::byte*>(tgt.data());
+  std::size_t constexpr max_blk_size = std::numeric_limits<int>::max();
+  while (size) {
+    int const this_blk_size = (size > max_blk_size ? max_blk_size : size);
+    c.recv(recv_buf,
+           this_blk_size,
+           partner_trainer,
+           0,
+           El::SyncInfo<El::Device::CPU>{});
+    recv_buf += this_blk_size;
+    size -= this_blk_size;
+  }
+  return tgt;
+}
+
+/** @brief Serialize an object and send it to the partner trainer. */
+template <typename T>
+static void
+send_object(lbann_comm const& c, T const& object, El::Int partner_trainer)
+{
+  std::ostringstream oss;
+  {
+    RootedBinaryOutputArchive ar(oss, c.get_trainer_grid());
+    c.trainer_barrier();
+    ar(object);
+  }
+  send_string(c, oss.str(), partner_trainer);
+  c.trainer_barrier();
+}
+
+/** @brief Receive an object sent with send_object. */
+template <typename T>
+static void
+receive_object(lbann_comm const& c, T& object, El::Int partner_trainer)
+{
+  {
+    std::istringstream iss{recv_string(c, partner_trainer)};
+    RootedBinaryInputArchive ar(iss, c.get_trainer_grid());
+    ar(object);
+  }
+  c.trainer_barrier();
+}
+
 template <typename T>
 static void exchange(lbann_comm const& c, T& object, El::Int partner_trainer)
 {
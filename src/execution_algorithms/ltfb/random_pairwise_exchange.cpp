@@ -40,6 +40,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
@@ -134,8 +135,11 @@ bool local_wins(EvalType local,
 
 RandomPairwiseExchange::RandomPairwiseExchange(
   std::unordered_map<std::string, metric_strategy> metrics,
-  std::unique_ptr<ExchangeStrategy> comm_algo)
-  : m_metrics{std::move(metrics)}, m_comm_algo{std::move(comm_algo)}
+  std::unique_ptr<ExchangeStrategy> comm_algo,
+  tournament_protocol protocol)
+  : m_metrics{std::move(metrics)},
+    m_comm_algo{std::move(comm_algo)},
+    m_protocol{protocol}
 {
   LBANN_ASSERT(m_metrics.size());
 }
@@ -143,14 +147,18 @@ RandomPairwiseExchange::RandomPairwiseExchange(
 RandomPairwiseExchange::RandomPairwiseExchange(
   std::string metric_name,
   metric_strategy winner_strategy,
-  std::unique_ptr<ExchangeStrategy> comm_algo)
+  std::unique_ptr<ExchangeStrategy> comm_algo,
+  tournament_protocol protocol)
   : RandomPairwiseExchange({{metric_name, winner_strategy}},
-                           std::move(comm_algo))
+                           std::move(comm_algo),
+                           protocol)
 {}
 
 RandomPairwiseExchange::RandomPairwiseExchange(
   RandomPairwiseExchange const& other)
-  : m_metrics{other.m_metrics}, m_comm_algo{other.m_comm_algo->clone()}
+  : m_metrics{other.m_metrics},
+    m_comm_algo{other.m_comm_algo->clone()},
+    m_protocol{other.m_protocol}
 {}
 
 std::unordered_map<std::string, EvalType>
@@ -260,6 +268,56 @@ bool RandomPairwiseExchange::local_is_better(
                      });
 }
 
+std::unordered_map<std::string, EvalType>
+RandomPairwiseExchange::exchange_scores(
+  lbann_comm const& comm,
+  std::unordered_map<std::string, EvalType> const& local_scores,
+  El::Int partner_trainer) const
+{
+  // Metric values are identical on all ranks in a trainer, so each
+  // rank swaps them with its counterpart in the partner trainer.
+  // Scores are packed in metric-name order.
+  std::map<std::string, EvalType> sorted_scores(std::cbegin(local_scores),
+                                                std::cend(local_scores));
+  std::vector<EvalType> send_scores, recv_scores;
+  for (auto const& [name, value] : sorted_scores)
+    send_scores.push_back(value);
+  recv_scores.resize(send_scores.size());
+  const El::Int rank_in_trainer = comm.get_rank_in_trainer();
+  comm.sendrecv(send_scores.data(),
+                send_scores.size(),
+                partner_trainer,
+                rank_in_trainer,
+                recv_scores.data(),
+                recv_scores.size(),
+                partner_trainer,
+                rank_in_trainer,
+                El::SyncInfo<El::Device::CPU>{});
+
+  std::unordered_map<std::string, EvalType> partner_scores;
+  size_t i = 0;
+  for (auto const& [name, value] : sorted_scores)
+    partner_scores[name] = recv_scores[i++];
+  return partner_scores;
+}
+
+void RandomPairwiseExchange::adopt_partner_model(model& m,
+                                                 model& partner_model) const
+{
+  // FIXME (trb 03/18/21): This is ... not great. We need to
+  // unravel the "fake" polymorphism in the model non-hierarchy
+  // soon.
+  using DAGModel = directed_acyclic_graph_model;
+  auto& local_model = dynamic_cast<DAGModel&>(m);
+  auto& partner_dag_model = dynamic_cast<DAGModel&>(partner_model);
+  local_model = std::move(partner_dag_model);
+  auto& trainer = get_trainer();
+  auto&& metadata = trainer.get_data_coordinator().get_dr_metadata();
+  m.setup(trainer.get_max_mini_batch_size(),
+          metadata,
+          /*force=*/true);
+}
+
 void RandomPairwiseExchange::select_next(model& m,
                                          ltfb::ExecutionContext& ctxt,
                                          data_coordinator& dc) const
@@ -281,41 +339,82 @@ void RandomPairwiseExchange::select_next(model& m,
   El::Int const local_trainer = comm.get_trainer_rank();
   El::Int const partner_trainer = get_partner_trainer(comm);
 
-  LBANN_LOG_WORLD_MASTER(comm, message_prefix, "evaluating local model...");
-
-  auto const local_scores = evaluate_model(m, ctxt, dc);
-
-  LBANN_LOG_WORLD_MASTER(comm, message_prefix, "exchanging model data...");
-
-  // The "local_model" is passed in here to accommodate the
-  // "sendrecv_weights" strategy; other than that, I don't think it
-  // should be necessary.
-  auto partner_model =
-    m_comm_algo->get_partner_model(m, partner_trainer, ctxt.get_step());
-
-  LBANN_LOG_WORLD_MASTER(comm, message_prefix, "evaluating partner model...");
-
-  auto const partner_scores = evaluate_model(*partner_model, ctxt, dc);
-
-  // If we win, we do nothing. The input model is the winner, so no
-  // further action is required. Otherwise, swap models.
-  El::Int const tournament_winner =
-    (local_is_better(local_scores, partner_scores) ? local_trainer
-                                                   : partner_trainer);
-
-  if (tournament_winner == partner_trainer) {
-    // FIXME (trb 03/18/21): This is ... not great. We need to
-    // unravel the "fake" polymorphism in the model non-hierarchy
-    // soon.
-    using DAGModel = directed_acyclic_graph_model;
-    auto& local_model = dynamic_cast<DAGModel&>(m);
-    auto& partner_dag_model = dynamic_cast<DAGModel&>(*partner_model);
-    local_model = std::move(partner_dag_model);
-    auto& trainer = get_trainer();
-    auto&& metadata = trainer.get_data_coordinator().get_dr_metadata();
-    m.setup(trainer.get_max_mini_batch_size(),
-            metadata,
-            /*force=*/true);
+  std::unordered_map<std::string, EvalType> local_scores, partner_scores;
+  El::Int tournament_winner = local_trainer;
+  switch (m_protocol) {
+  case tournament_protocol::EXCHANGE_MODELS: {
+    // Strategies that communicate in the background overlap the
+    // exchange with the local evaluation.
+    m_comm_algo->start_exchange(m, partner_trainer, ctxt.get_step());
+
+    LBANN_LOG_WORLD_MASTER(comm, message_prefix, "evaluating local model...");
+
+    local_scores = evaluate_model(m, ctxt, dc);
+
+    LBANN_LOG_WORLD_MASTER(comm, message_prefix, "exchanging model data...");
+
+    // The "local_model" is passed in here to accommodate the
+    // "sendrecv_weights" strategy; other than that, I don't think it
+    // should be necessary.
+    auto partner_model =
+      m_comm_algo->finish_exchange(m, partner_trainer, ctxt.get_step());
+
+    LBANN_LOG_WORLD_MASTER(comm,
+                           message_prefix,
+                           "evaluating partner model...");
+
+    partner_scores = evaluate_model(*partner_model, ctxt, dc);
+
+    // If we win, we do nothing. The input model is the winner, so no
+    // further action is required. Otherwise, swap models.
+    tournament_winner =
+      (local_is_better(local_scores, partner_scores) ? local_trainer
+                                                     : partner_trainer);
+    if (tournament_winner == partner_trainer)
+      adopt_partner_model(m, *partner_model);
+    break;
+  }
+  case tournament_protocol::EXCHANGE_SCORES: {
+    LBANN_LOG_WORLD_MASTER(comm, message_prefix, "evaluating local model...");
+
+    local_scores = evaluate_model(m, ctxt, dc);
+
+    LBANN_LOG_WORLD_MASTER(comm, message_prefix, "exchanging scores...");
+
+    partner_scores = exchange_scores(comm, local_scores, partner_trainer);
+
+    // Each trainer applies the usual rule from its own point of
+    // view, and also works out its partner's decision, so only a
+    // loser's model is ever replaced. With ties, both trainers keep
+    // their own models and nothing is transferred.
+    bool local_keeps = local_is_better(local_scores, partner_scores);
+    bool partner_keeps = local_is_better(partner_scores, local_scores);
+    if (!local_keeps && !partner_keeps) {
+      // Only possible with NaN scores; neither model is better.
+      local_keeps = partner_keeps = true;
+    }
+    if (!local_keeps) {
+      LBANN_LOG_WORLD_MASTER(comm,
+                             message_prefix,
+                             "receiving partner model...");
+      auto partner_model = m_comm_algo->transfer_model(m,
+                                                       partner_trainer,
+                                                       ctxt.get_step(),
+                                                       /*send=*/false);
+      adopt_partner_model(m, *partner_model);
+      tournament_winner = partner_trainer;
+    }
+    else if (!partner_keeps) {
+      LBANN_LOG_WORLD_MASTER(comm, message_prefix, "sending local model...");
+      m_comm_algo->transfer_model(m,
+                                  partner_trainer,
+                                  ctxt.get_step(),
+                                  /*send=*/true);
+    }
+    break;
+  }
+  default:
+    LBANN_ERROR("Invalid tournament protocol!");
   }
 
   LBANN_LOG_TRAINER_MASTER(comm,
@@ -379,7 +478,8 @@ make_sendrecv_weights(std::set<std::string> weights_names,
   auto const& params = dynamic_cast<SendRecvWeights const&>(msg);
   return std::make_unique<lbann::ltfb::SendRecvWeights>(
     std::move(weights_names),
-    params.exchange_hyperparameters());
+    params.exchange_hyperparameters(),
+    params.single_message());
 }
 
 lbann::ltfb::RandomPairwiseExchange::metric_strategy
@@ -398,6 +498,23 @@ to_lbann(lbann_data::RandomPairwiseExchange::MetricStrategy strategy)
   return LBANNEnumType::LOWER_IS_BETTER;
 }
 
+lbann::ltfb::RandomPairwiseExchange::tournament_protocol
+to_lbann(lbann_data::RandomPairwiseExchange::TournamentProtocol protocol)
+{
+  using LBANNEnumType =
+    lbann::ltfb::RandomPairwiseExchange::tournament_protocol;
+  using ProtoEnumType = lbann_data::RandomPairwiseExchange::TournamentProtocol;
+  switch (protocol) {
+  case ProtoEnumType::RandomPairwiseExchange_TournamentProtocol_EXCHANGE_MODELS:
+    return LBANNEnumType::EXCHANGE_MODELS;
+  case ProtoEnumType::RandomPairwiseExchange_TournamentProtocol_EXCHANGE_SCORES:
+    return LBANNEnumType::EXCHANGE_SCORES;
+  default:
+    LBANN_ERROR("Unknown enum value: ", static_cast<int>(protocol));
+  }
+  return LBANNEnumType::EXCHANGE_MODELS;
+}
+
 ExchangeStrategyFactory build_default_exchange_factory()
 {
   ExchangeStrategyFactory factory;
@@ -461,5 +578,6 @@ lbann::make<lbann::ltfb::RandomPairwiseExchange>(
     lbann::ltfb::RandomPairwiseExchange::ExchangeStrategy;
   return make_unique<lbann::ltfb::RandomPairwiseExchange>(
     std::move(metric_map),
-    make_abstract<ExchangeStrategyType>(msg.exchange_strategy()));
+    make_abstract<ExchangeStrategyType>(msg.exchange_strategy()),
+    to_lbann(msg.tournament_protocol()));
 }
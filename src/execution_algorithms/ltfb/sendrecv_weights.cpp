@@ -36,6 +36,10 @@
 
 #include "checkpoint_common.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 namespace {
 bool have_same_optimizer_type(lbann::lbann_comm const& c,
                               lbann::optimizer const& opt,
@@ -54,26 +58,331 @@ bool have_same_optimizer_type(lbann::lbann_comm const& c,
              El::SyncInfo<El::Device::CPU>{});
   return my_type_hash == other_type_hash;
 }
+
+/** @brief Matrices whose local data is packed for a weights object.
+ *
+ *  The weights values always come first, followed by the SGD
+ *  velocity or the Adam moments if requested.
+ */
+template <typename TensorDataType>
+std::vector<El::AbstractDistMatrix<TensorDataType>*>
+get_packed_matrices(lbann::data_type_weights<TensorDataType>& w,
+                    bool include_optimizer_state)
+{
+  std::vector<El::AbstractDistMatrix<TensorDataType>*> mats = {
+    &w.get_values()};
+  if (!include_optimizer_state)
+    return mats;
+  auto* opt = w.get_optimizer();
+  if (auto* sgd_opt = dynamic_cast<lbann::sgd<TensorDataType>*>(opt)) {
+    mats.push_back(&sgd_opt->get_velocity());
+  }
+  else if (auto* adam_opt = dynamic_cast<lbann::adam<TensorDataType>*>(opt)) {
+    mats.push_back(&adam_opt->get_moment1());
+    mats.push_back(&adam_opt->get_moment2());
+  }
+  return mats;
+}
+
+/** @brief Whether the optimizer state can be packed into a buffer. */
+bool is_packable_optimizer(lbann::optimizer const& opt)
+{
+  using TensorDataType = lbann::DataType;
+  return (dynamic_cast<lbann::sgd<TensorDataType> const*>(&opt) != nullptr ||
+          dynamic_cast<lbann::adam<TensorDataType> const*>(&opt) != nullptr);
+}
+
 } // namespace
 
 namespace lbann {
 namespace ltfb {
 
 SendRecvWeights::SendRecvWeights(std::set<std::string> const& weights_names,
-                                 bool exchange_hyperparameters)
-  : BaseType(weights_names), exchange_hyperparams_{exchange_hyperparameters}
+                                 bool exchange_hyperparameters,
+                                 bool single_message)
+  : BaseType(weights_names),
+    exchange_hyperparams_{exchange_hyperparameters},
+    single_message_{single_message}
 {}
 
 SendRecvWeights::SendRecvWeights(std::set<std::string>&& weights_names,
-                                 bool exchange_hyperparameters)
-  : BaseType(std::move(weights_names)), exchange_hyperparams_{
-                                          exchange_hyperparameters}
+                                 bool exchange_hyperparameters,
+                                 bool single_message)
+  : BaseType(std::move(weights_names)),
+    exchange_hyperparams_{exchange_hyperparameters},
+    single_message_{single_message}
 {}
 
+bool SendRecvWeights::is_selected(weights const& w) const
+{
+  auto const& weights_names = this->weights_names();
+  return (weights_names.empty() ||
+          weights_names.find(w.get_name()) != weights_names.cend());
+}
+
 std::unique_ptr<model>
 SendRecvWeights::get_partner_model(model const& m,
                                    El::Int partner_trainer,
-                                   size_t /*step*/)
+                                   size_t step)
+{
+  if (!single_message_)
+    return exchange_per_weights(m, partner_trainer);
+  start_exchange(m, partner_trainer, step);
+  return finish_exchange(m, partner_trainer, step);
+}
+
+size_t SendRecvWeights::setup_packed_exchange(model const& m,
+                                              El::Int partner_trainer)
+{
+  auto& comm = *m.get_comm();
+  const El::Int rank_in_trainer = comm.get_rank_in_trainer();
+
+  using TensorDataType = DataType;
+  using WeightsType = data_type_weights<TensorDataType>;
+  std::vector<WeightsType*> selected_weights;
+  for (auto&& w_ptr : m.get_weights()) {
+    if (is_selected(*w_ptr))
+      selected_weights.push_back(&dynamic_cast<WeightsType&>(*w_ptr));
+  }
+
+  // Exchange optimizer types for all weights in one message
+  std::vector<std::size_t> my_type_hashes, other_type_hashes;
+  for (auto const* w : selected_weights) {
+    auto const* opt = w->get_optimizer();
+    my_type_hashes.push_back(opt ? typeid(*opt).hash_code() : 0);
+  }
+  other_type_hashes.resize(my_type_hashes.size());
+  comm.sendrecv(my_type_hashes.data(),
+                my_type_hashes.size(),
+                partner_trainer,
+                rank_in_trainer,
+                other_type_hashes.data(),
+                other_type_hashes.size(),
+                partner_trainer,
+                rank_in_trainer,
+                El::SyncInfo<El::Device::CPU>{});
+
+  // Decide how each optimizer is exchanged. Both partners reach the
+  // same decisions, so their buffers have matching layouts.
+  optimizer_exchange_.clear();
+  size_t buffer_size = 0;
+  for (size_t i = 0; i < selected_weights.size(); ++i) {
+    auto const* opt = selected_weights[i]->get_optimizer();
+    if (opt == nullptr) {
+      optimizer_exchange_.push_back(optimizer_exchange::NONE);
+    }
+    else if (exchange_hyperparams_ ||
+             my_type_hashes[i] != other_type_hashes[i]) {
+      optimizer_exchange_.push_back(optimizer_exchange::ARCHIVE);
+    }
+    else if (is_packable_optimizer(*opt)) {
+      optimizer_exchange_.push_back(optimizer_exchange::PACKED);
+    }
+    else {
+      LBANN_WARNING("Unknown optimizer type. NO EXCHANGE.");
+      optimizer_exchange_.push_back(optimizer_exchange::NONE);
+    }
+    auto const pack_opt =
+      (optimizer_exchange_.back() == optimizer_exchange::PACKED);
+    for (auto const* mat : get_packed_matrices(*selected_weights[i], pack_opt))
+      buffer_size += mat->LocalHeight() * mat->LocalWidth();
+  }
+  return buffer_size;
+}
+
+void SendRecvWeights::pack_weights(model const& m)
+{
+  using TensorDataType = DataType;
+  using WeightsType = data_type_weights<TensorDataType>;
+  size_t offset = 0;
+  size_t weights_index = 0;
+  for (auto&& w_ptr : m.get_weights()) {
+    if (!is_selected(*w_ptr))
+      continue;
+    auto& w = dynamic_cast<WeightsType&>(*w_ptr);
+    auto const pack_opt = (optimizer_exchange_.at(weights_index++) ==
+                           optimizer_exchange::PACKED);
+    for (auto const* mat : get_packed_matrices(w, pack_opt)) {
+      auto const& local_mat = mat->LockedMatrix();
+      El::Matrix<TensorDataType, El::Device::CPU> buffer_view;
+      buffer_view.Attach(local_mat.Height(),
+                         local_mat.Width(),
+                         send_buffer_.data() + offset,
+                         local_mat.Height());
+      El::Copy(local_mat, buffer_view);
+      offset += local_mat.Height() * local_mat.Width();
+    }
+  }
+}
+
+void SendRecvWeights::unpack_weights(model& partner_model,
+                                     El::Int partner_trainer,
+                                     bool symmetric)
+{
+  auto& comm = *partner_model.get_comm();
+  using TensorDataType = DataType;
+  using WeightsType = data_type_weights<TensorDataType>;
+  size_t offset = 0;
+  size_t weights_index = 0;
+  for (auto&& w_ptr : partner_model.get_weights()) {
+    if (!is_selected(*w_ptr))
+      continue;
+    auto& recv_weights = dynamic_cast<WeightsType&>(*w_ptr);
+    auto const opt_exchange = optimizer_exchange_.at(weights_index++);
+    auto const pack_opt = (opt_exchange == optimizer_exchange::PACKED);
+    for (auto* mat : get_packed_matrices(recv_weights, pack_opt)) {
+      auto& local_mat = mat->Matrix();
+      El::Matrix<TensorDataType, El::Device::CPU> buffer_view;
+      buffer_view.LockedAttach(local_mat.Height(),
+                               local_mat.Width(),
+                               recv_buffer_.data() + offset,
+                               local_mat.Height());
+      El::Copy(buffer_view, local_mat);
+      offset += local_mat.Height() * local_mat.Width();
+    }
+
+    // Optimizers that cannot be packed are exchanged as before
+    if (opt_exchange == optimizer_exchange::ARCHIVE) {
+      optimizer* recv_opt = recv_weights.get_optimizer();
+      auto opt_up = recv_opt->clone();
+      if (symmetric)
+        exchange(comm, opt_up, partner_trainer);
+      else
+        receive_object(comm, opt_up, partner_trainer);
+      opt_up->setup(&recv_weights);
+      recv_weights.set_optimizer(std::move(opt_up));
+    }
+  }
+  if (offset != recv_buffer_.size()) {
+    LBANN_ERROR("LTFB weights exchange unpacked ",
+                offset,
+                " entries, but received ",
+                recv_buffer_.size());
+  }
+}
+
+void SendRecvWeights::start_exchange(model const& m,
+                                     El::Int partner_trainer,
+                                     size_t /*step*/)
+{
+  if (!single_message_)
+    return;
+  if (exchange_started_) {
+    LBANN_ERROR("attempted to start an LTFB weights exchange "
+                "while another is in progress");
+  }
+  auto& comm = *m.get_comm();
+
+  // Pack local data into a contiguous host buffer
+  auto const buffer_size = setup_packed_exchange(m, partner_trainer);
+  send_buffer_.resize(buffer_size);
+  recv_buffer_.resize(buffer_size);
+  pack_weights(m);
+
+  // Post the exchange. Messages are only split if they exceed the
+  // maximum MPI count.
+  requests_.clear();
+  size_t constexpr max_count = std::numeric_limits<int>::max();
+  requests_.reserve(2 * (buffer_size / max_count + 1));
+  for (size_t pos = 0; pos < buffer_size; pos += max_count) {
+    int const count = static_cast<int>(std::min(max_count, buffer_size - pos));
+    requests_.emplace_back();
+    comm.nb_recv(recv_buffer_.data() + pos,
+                 count,
+                 partner_trainer,
+                 requests_.back());
+    requests_.emplace_back();
+    comm.nb_send(send_buffer_.data() + pos,
+                 count,
+                 partner_trainer,
+                 requests_.back());
+  }
+  exchange_partner_ = partner_trainer;
+  exchange_started_ = true;
+}
+
+std::unique_ptr<model>
+SendRecvWeights::finish_exchange(model const& m,
+                                 El::Int partner_trainer,
+                                 size_t step)
+{
+  if (!single_message_)
+    return exchange_per_weights(m, partner_trainer);
+  if (!exchange_started_)
+    start_exchange(m, partner_trainer, step);
+  if (partner_trainer != exchange_partner_) {
+    LBANN_ERROR("LTFB weights exchange was started with trainer ",
+                exchange_partner_,
+                " but finished with trainer ",
+                partner_trainer);
+  }
+  auto& comm = *m.get_comm();
+
+  // Copy this model while the exchange is in flight
+  auto partner_model_ptr = m.copy_model();
+
+  comm.wait_all(requests_);
+  requests_.clear();
+  exchange_started_ = false;
+
+  unpack_weights(*partner_model_ptr, partner_trainer, /*symmetric=*/true);
+  return partner_model_ptr;
+}
+
+std::unique_ptr<model>
+SendRecvWeights::transfer_model(model const& m,
+                                El::Int partner_trainer,
+                                size_t /*step*/,
+                                bool send)
+{
+  auto& comm = *m.get_comm();
+
+  // One-way transfers always use the packed buffer
+  auto const buffer_size = setup_packed_exchange(m, partner_trainer);
+  size_t constexpr max_count = std::numeric_limits<int>::max();
+  if (send) {
+    send_buffer_.resize(buffer_size);
+    pack_weights(m);
+    for (size_t pos = 0; pos < buffer_size; pos += max_count) {
+      int const count =
+        static_cast<int>(std::min(max_count, buffer_size - pos));
+      comm.send(send_buffer_.data() + pos,
+                count,
+                partner_trainer,
+                comm.get_rank_in_trainer());
+    }
+    using TensorDataType = DataType;
+    using WeightsType = data_type_weights<TensorDataType>;
+    size_t weights_index = 0;
+    for (auto&& w_ptr : m.get_weights()) {
+      if (!is_selected(*w_ptr))
+        continue;
+      if (optimizer_exchange_.at(weights_index++) ==
+          optimizer_exchange::ARCHIVE) {
+        auto& w = dynamic_cast<WeightsType&>(*w_ptr);
+        optimizer* send_opt = w.get_optimizer();
+        auto opt_up = send_opt->clone();
+        send_object(comm, opt_up, partner_trainer);
+      }
+    }
+    return nullptr;
+  }
+
+  recv_buffer_.resize(buffer_size);
+  for (size_t pos = 0; pos < buffer_size; pos += max_count) {
+    int const count = static_cast<int>(std::min(max_count, buffer_size - pos));
+    comm.recv(recv_buffer_.data() + pos,
+              count,
+              partner_trainer,
+              comm.get_rank_in_trainer());
+  }
+  auto partner_model_ptr = m.copy_model();
+  unpack_weights(*partner_model_ptr, partner_trainer, /*symmetric=*/false);
+  return partner_model_ptr;
+}
+
+std::unique_ptr<model>
+SendRecvWeights::exchange_per_weights(model const& m, El::Int partner_trainer)
 {
   auto& comm = *m.get_comm();
 
@@ -90,9 +399,7 @@ SendRecvWeights::get_partner_model(model const& m,
   // Exchange weights with partner
   for (auto&& w_ptr : partner_model.get_weights()) {
     // Skip weights if name isn't in list
-    auto const& weights_names = this->weights_names();
-    if (!weights_names.empty() &&
-        (weights_names.find(w_ptr->get_name()) == weights_names.cend())) {
+    if (!is_selected(*w_ptr)) {
       continue;
     }
 
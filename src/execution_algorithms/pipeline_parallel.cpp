@@ -0,0 +1,923 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/execution_algorithms/pipeline_parallel.hpp"
+#include "lbann/execution_algorithms/pipeline_parallel/execution_context.hpp"
+#include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/callbacks/callback.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/layers/data_type_layer.hpp"
+#include "lbann/layers/transform/evaluation.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/timer.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <training_algorithm.pb.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using lbann::pipeline_parallel::BufferType;
+using lbann::pipeline_parallel::Edge;
+using LayerType = lbann::data_type_layer<lbann::DataType>;
+using DistMatType = El::AbstractDistMatrix<lbann::DataType>;
+
+LayerType& as_data_type_layer(lbann::Layer& l)
+{
+  auto* ptr = dynamic_cast<LayerType*>(&l);
+  if (ptr == nullptr) {
+    LBANN_ERROR("pipeline stage boundaries only support layers with the "
+                "default data type, but ",
+                l.get_type(),
+                " layer \"",
+                l.get_name(),
+                "\" has a different one");
+  }
+  return *ptr;
+}
+
+bool is_input_layer(lbann::Layer const& l) { return l.get_type() == "input"; }
+
+/** @brief Rough cost of a layer's forward and backward prop.
+ *
+ *  Output entries approximate entry-wise work. Each weights entry is
+ *  used once per output position, e.g. once per pixel for a
+ *  convolution kernel and once for a fully-connected matrix.
+ */
+double estimate_cost(lbann::Layer const& l)
+{
+  double cost = 0.0;
+  double positions = 1.0;
+  for (int i = 0; i < l.get_num_children(); ++i) {
+    cost += l.get_output_size(i);
+  }
+  if (l.get_num_children() > 0) {
+    const auto dims = l.get_output_dims(0);
+    positions = std::accumulate(dims.begin() + std::min<size_t>(1, dims.size()),
+                                dims.end(),
+                                1.0,
+                                std::multiplies<double>());
+  }
+  for (auto const& w_ptr : l.get_weights_pointers()) {
+    if (auto w = w_ptr.lock()) {
+      cost += positions * w->get_size();
+    }
+  }
+  return cost;
+}
+
+/** @brief Split a sequence into contiguous parts with the smallest
+ *         maximum part cost.
+ *
+ *  Binary search over the maximum cost, checking each candidate by
+ *  filling parts greedily. Every part gets at least one item.
+ */
+std::vector<int> partition_contiguous(std::vector<double> const& costs,
+                                      int num_parts)
+{
+  const int num_items = costs.size();
+  const auto assign = [&](double limit, std::vector<int>* parts) {
+    int part = 0;
+    double part_cost = 0.0;
+    for (int i = 0; i < num_items; ++i) {
+      // Leave at least one item for each remaining part
+      const bool must_cut =
+        parts != nullptr && num_items - i == num_parts - 1 - part;
+      if (i > 0 && (part_cost + costs[i] > limit || must_cut)) {
+        ++part;
+        part_cost = 0.0;
+      }
+      part_cost += costs[i];
+      if (parts != nullptr) {
+        (*parts)[i] = std::min(part, num_parts - 1);
+      }
+    }
+    return part + 1;
+  };
+  double lo = *std::max_element(costs.begin(), costs.end());
+  double hi = std::accumulate(costs.begin(), costs.end(), 0.0);
+  for (int iter = 0; iter < 64 && lo < hi; ++iter) {
+    const double mid = 0.5 * (lo + hi);
+    if (assign(mid, nullptr) <= num_parts) {
+      hi = mid;
+    }
+    else {
+      lo = mid;
+    }
+  }
+  std::vector<int> parts(num_items, 0);
+  assign(hi, &parts);
+  return parts;
+}
+
+/** @brief Copy the local part of a tensor into a host buffer. */
+void pack(DistMatType const& mat, BufferType& buffer)
+{
+  buffer.Resize(mat.LocalHeight(), mat.LocalWidth());
+  El::Copy(mat.LockedMatrix(), buffer);
+}
+
+/** @brief Copy a host buffer into the local part of a tensor. */
+void unpack(BufferType const& buffer, DistMatType& mat)
+{
+  auto& local_mat = mat.Matrix();
+  if (local_mat.Height() != buffer.Height()
+      || local_mat.Width() != buffer.Width()) {
+    LBANN_ERROR("pipeline stage received a ",
+                buffer.Height(), " x ", buffer.Width(),
+                " local tensor, but expected ",
+                local_mat.Height(), " x ", local_mat.Width(),
+                " (are the process grids of all trainers identical?)");
+  }
+  El::Copy(buffer, local_mat);
+}
+
+/** @brief Set up a parent's output tensor to receive activations. */
+DistMatType& prepare_activations(Edge const& e, El::Int mini_batch_size)
+{
+  auto& mat = as_data_type_layer(*e.parent).get_activations(e.child_index);
+  if (mat.Viewing()) {
+    mat.Empty();
+  }
+  mat.Resize(e.parent->get_output_size(e.child_index), mini_batch_size);
+  return mat;
+}
+
+/** @brief Set up a child's error signal tensor to receive error
+ *         signals.
+ */
+DistMatType& prepare_error_signals(Edge const& e, El::Int mini_batch_size)
+{
+  auto& mat = as_data_type_layer(*e.child).get_error_signals(e.parent_index);
+  mat.Empty(false);
+  mat.Resize(e.child->get_input_size(e.parent_index), mini_batch_size);
+  return mat;
+}
+
+} // namespace
+
+namespace lbann {
+
+PipelineParallel::PipelineParallel(
+  std::string name,
+  std::unique_ptr<TermCriteriaType> stop,
+  size_t num_micro_batches)
+  : BaseType{std::move(name)},
+    m_stopping_criteria{std::move(stop)},
+    m_num_micro_batches{num_micro_batches}
+{
+  if (m_num_micro_batches == 0) {
+    LBANN_ERROR("pipeline-parallel training needs at least one "
+                "micro-batch per step");
+  }
+}
+
+PipelineParallel::PipelineParallel(PipelineParallel const& other)
+  : BaseType(other.get_name()),
+    m_stopping_criteria{other.m_stopping_criteria->clone()},
+    m_num_micro_batches{other.m_num_micro_batches}
+{}
+
+PipelineParallel& PipelineParallel::operator=(PipelineParallel const& other)
+{
+  BaseType::operator=(other);
+  m_stopping_criteria = other.m_stopping_criteria->clone();
+  m_num_micro_batches = other.m_num_micro_batches;
+  return *this;
+}
+
+std::string PipelineParallel::get_type() const { return "PipelineParallel"; }
+
+pipeline_parallel::ExecutionContext*
+PipelineParallel::do_get_new_execution_context() const
+{
+  return new pipeline_parallel::ExecutionContext(0UL);
+}
+
+// =============================================
+// Evaluation and training
+// =============================================
+
+void PipelineParallel::apply(
+  execution_context& context_,
+  model& model,
+  data_coordinator& dc,
+  execution_mode mode)
+{
+  ExeContextType& context = dynamic_cast<ExeContextType&>(context_);
+  if (mode == execution_mode::training) {
+    train(context, model, dc, *m_stopping_criteria);
+  }
+  else {
+    sgd_training_algorithm eval_algo(
+      this->get_name()+"_eval",
+      m_stopping_criteria->clone());
+    auto& eval_context = context.get_sgd_execution_context();
+    eval_algo.apply(eval_context, model, dc, mode);
+  }
+}
+
+void PipelineParallel::train(
+  ExeContextType& context,
+  model& model,
+  data_coordinator& dc,
+  TermCriteriaType const& term)
+{
+  auto& comm = *model.get_comm();
+
+  // Initialize some state so it knows we're training now.
+  auto& sgd_context = context.get_sgd_execution_context();
+  sgd_context.set_execution_mode(execution_mode::training);
+  model.reset_mode(sgd_context, execution_mode::training);
+  dc.reset_mode(sgd_context);
+  partition_model(context, model);
+  context.m_effective_mini_batch_size =
+    m_num_micro_batches * dc.get_mini_batch_size(execution_mode::training);
+
+  // Sync trainers (Assumption: all trainers in this lbann_comm are
+  // participating in this training algorithm)
+  comm.intertrainer_barrier();
+
+  // Run callbacks. This may restore the context from a checkpoint.
+  do_train_begin_cbs(model);
+
+  // Start iterating
+  // Note: The first stage decides when to stop so that all stages
+  // take the same number of steps.
+  bool is_start_of_epoch = true;
+  sgd_context.start_timer();
+  while (true) {
+    int stop = term(sgd_context) ? 1 : 0;
+    comm.intertrainer_broadcast(0, stop);
+    if (stop != 0) {
+      break;
+    }
+
+    if (is_start_of_epoch) {
+      // Initialize epoch
+      model.reset_mode(sgd_context, execution_mode::training);
+      model.reset_epoch_statistics(execution_mode::training);
+      dc.reset_mode(sgd_context);
+      do_epoch_begin_cbs(model);
+      is_start_of_epoch = false;
+    }
+
+    // Train a mini batch. Returns "true" if the data_coordinator
+    // detects the end of an epoch.
+    if (train_mini_batch(context, model, dc)) {
+      // Finalize epoch
+      sgd_context.inc_epoch();
+      synchronize_weights(context, model);
+      model.reconcile_weight_values();
+      do_epoch_end_cbs(model);
+
+      // Evaluate on validation set
+      //
+      // Note: Copied from sgd_training_algorithm.cpp. Every trainer
+      // holds the whole model after the weights are synchronized.
+      if (dc.is_execution_mode_valid(execution_mode::validation)) {
+        const execution_mode eval_mode = execution_mode::validation;
+        sgd_execution_context eval_context(
+          eval_mode,
+          dc.get_mini_batch_size(eval_mode));
+        size_t num_validation_epochs = 1UL;
+        if (sgd_context.get_epoch() > 1UL) {
+          eval_context.inc_epoch();
+          ++num_validation_epochs;
+        }
+        sgd_training_algorithm eval_algo(
+          this->get_name()+"_eval",
+          make_unique<epoch_termination_criteria>(num_validation_epochs));
+        eval_algo.apply(eval_context, model, dc, eval_mode);
+        sgd_context.set_early_stop(eval_context.get_early_stop());
+      }
+
+      // Trigger new epoch stuff next iteration (if there is one).
+      is_start_of_epoch = true;
+    }
+  }
+  sgd_context.stop_timer();
+
+  // Leave all trainers with the same model
+  synchronize_weights(context, model);
+
+  // Reset the model back to the training execution context prior to
+  // end of training callbacks
+  model.reset_mode(sgd_context, execution_mode::training);
+  do_train_end_cbs(model);
+
+  // Report per-stage statistics from the world master
+  if (comm.am_trainer_master() && sgd_context.get_step() > 0) {
+    const double num_steps = sgd_context.get_step();
+    const std::vector<double> stats{
+      static_cast<double>(context.m_layers.size()),
+      1e3 * context.m_wait_time / num_steps,
+      1e3 * context.m_recompute_time / num_steps};
+    if (comm.am_world_master()) {
+      std::vector<double> all_stats(stats.size() * context.m_num_stages);
+      comm.intertrainer_gather(stats.data(), stats.size(), all_stats.data());
+      for (int stage = 0; stage < context.m_num_stages; ++stage) {
+        const auto* s = &all_stats[stage * stats.size()];
+        std::cout << "PipelineParallel: stage " << stage << " of "
+                  << context.m_num_stages << " (" << s[0]
+                  << " layers) waited " << s[1] << " ms and recomputed "
+                  << s[2] << " ms per step" << std::endl;
+      }
+    }
+    else {
+      comm.intertrainer_gather(stats.data(),
+                               stats.size(),
+                               comm.get_world_master());
+    }
+  }
+}
+
+// =============================================
+// Mini-batch step
+// =============================================
+
+// Returns "true" if the data_coordinator detects the end of an epoch.
+bool PipelineParallel::train_mini_batch(
+  ExeContextType& context,
+  model& model,
+  data_coordinator& dc)
+{
+  auto& comm = *model.get_comm();
+  auto& sgd_context = context.get_sgd_execution_context();
+
+  model.reset_mode(sgd_context, execution_mode::training);
+  dc.reset_mode(sgd_context);
+  do_batch_begin_cbs(model);
+
+  // Hold back the gradient allreduces until the last micro-batch
+  model.clear_gradients();
+  for (auto* w : context.m_weights) {
+    if (auto* opt = w->get_optimizer()) {
+      opt->add_gradient_source(&context);
+    }
+  }
+
+  // 1F1B schedule
+  // Note: Stage s keeps at most S-s micro-batches in flight, so
+  // later stages start their backward passes first and the last
+  // stage alternates between forward and backward passes.
+  const El::Int max_in_flight = context.m_num_stages - context.m_stage;
+  El::Int num_forward = 0;
+  bool last = false, finished = false;
+  while (!last || !context.m_in_flight.empty()) {
+    if (!last && static_cast<El::Int>(context.m_in_flight.size()) < max_in_flight) {
+      std::tie(last, finished) =
+        forward_micro_batch(context, model, dc, num_forward++);
+    }
+    else {
+      backward_micro_batch(context, model);
+    }
+  }
+
+  // Update step
+  model.get_objective_function()->compute_weight_regularization();
+  for (auto* w : context.m_weights) {
+    if (auto* opt = w->get_optimizer()) {
+      opt->remove_gradient_source(&context);
+    }
+  }
+  for (auto rit = context.m_weights.rbegin(); rit != context.m_weights.rend();
+       ++rit) {
+    if (auto* opt = (*rit)->get_optimizer()) {
+      opt->step();
+    }
+  }
+  model.update_layers();
+
+  // Outgoing messages must complete before their buffers are freed
+  comm.wait_all(context.m_send_requests);
+  comm.wait_all(context.m_header_requests);
+  context.m_send_requests.clear();
+  context.m_send_buffers.clear();
+  context.m_header_requests.clear();
+  context.m_header_buffers.clear();
+  context.m_resident_micro_batch = -1;
+
+  sgd_context.inc_step();
+  do_batch_end_cbs(model);
+  return finished;
+}
+
+std::pair<bool, bool> PipelineParallel::forward_micro_batch(
+  ExeContextType& context,
+  model& model,
+  data_coordinator& dc,
+  El::Int index) const
+{
+  auto& comm = *model.get_comm();
+  auto& sgd_context = context.get_sgd_execution_context();
+  const bool is_first_stage = (context.m_stage == 0);
+  const bool is_last_stage = (context.m_stage == context.m_num_stages - 1);
+  const auto num_recvs = context.m_recv_activations.size();
+
+  pipeline_parallel::MicroBatch micro_batch;
+  micro_batch.index = index;
+  micro_batch.inputs.resize(num_recvs + context.m_stage_inputs.size());
+  bool last = false, finished = false;
+
+  if (is_first_stage) {
+    dc.fetch_data(execution_mode::training);
+  }
+  else {
+    // Micro-batch size and schedule flags come from the first stage
+    std::vector<El::Int> header(3);
+    El::mpi::Request<El::Int> header_req;
+    comm.nb_recv(header.data(), header.size(), 0, header_req);
+    const double start = get_time();
+    comm.wait(header_req);
+    micro_batch.size = header[0];
+    last = (header[1] != 0);
+    finished = (header[2] != 0);
+    sgd_context.set_current_mini_batch_size(micro_batch.size);
+
+    // Receive activations from earlier stages
+    std::vector<El::mpi::Request<DataType>> reqs(num_recvs);
+    for (size_t i = 0; i < num_recvs; ++i) {
+      auto const& e = context.m_recv_activations[i];
+      auto& mat = prepare_activations(e, micro_batch.size);
+      auto& buffer = micro_batch.inputs[i];
+      buffer.Resize(mat.LocalHeight(), mat.LocalWidth());
+      comm.nb_recv(buffer.Buffer(),
+                   buffer.Height() * buffer.Width(),
+                   e.remote_stage,
+                   reqs[i]);
+    }
+    comm.wait_all(reqs);
+    context.m_wait_time += get_time() - start;
+    for (size_t i = 0; i < num_recvs; ++i) {
+      unpack(micro_batch.inputs[i],
+             as_data_type_layer(*context.m_recv_activations[i].parent)
+               .get_activations(context.m_recv_activations[i].child_index));
+    }
+  }
+
+  // Forward prop through this stage
+  // Note: Outgoing activations are copied right after they are
+  // computed since children may overwrite them in-place.
+  std::vector<BufferType*> outgoing;
+  outgoing.reserve(context.m_send_activations.size());
+  size_t next_send = 0, next_input = 0;
+  for (auto* l : context.m_layers) {
+    l->forward_prop();
+    for (; next_send < context.m_send_activations.size()
+           && context.m_send_activations[next_send].parent == l;
+         ++next_send) {
+      auto const& e = context.m_send_activations[next_send];
+      context.m_send_buffers.emplace_back();
+      outgoing.push_back(&context.m_send_buffers.back());
+      pack(as_data_type_layer(*l).get_activations(e.child_index),
+           *outgoing.back());
+    }
+    for (; !is_last_stage && next_input < context.m_stage_inputs.size()
+           && context.m_stage_inputs[next_input].parent == l;
+         ++next_input) {
+      auto const& e = context.m_stage_inputs[next_input];
+      pack(as_data_type_layer(*l).get_activations(e.child_index),
+           micro_batch.inputs[num_recvs + next_input]);
+    }
+  }
+
+  if (is_first_stage) {
+    // check if the data coordinator has finished the epoch and kickoff
+    // background I/O
+    micro_batch.size = sgd_context.get_current_mini_batch_size();
+    finished = dc.epoch_complete(execution_mode::training);
+    last = finished || index + 1 >= static_cast<El::Int>(m_num_micro_batches);
+    for (int stage = 1; stage < context.m_num_stages; ++stage) {
+      context.m_header_buffers.emplace_back(
+        std::vector<El::Int>{micro_batch.size, last ? 1 : 0, finished ? 1 : 0});
+      context.m_header_requests.emplace_back();
+      auto& header = context.m_header_buffers.back();
+      comm.nb_send(header.data(),
+                   header.size(),
+                   stage,
+                   context.m_header_requests.back());
+    }
+  }
+
+  // Send activations to later stages
+  for (size_t i = 0; i < outgoing.size(); ++i) {
+    context.m_send_requests.emplace_back();
+    comm.nb_send(outgoing[i]->LockedBuffer(),
+                 outgoing[i]->Height() * outgoing[i]->Width(),
+                 context.m_send_activations[i].remote_stage,
+                 context.m_send_requests.back());
+  }
+
+  context.m_resident_micro_batch = index;
+  context.m_in_flight.push_back(std::move(micro_batch));
+  context.inc_step();
+  return {last, finished};
+}
+
+void PipelineParallel::backward_micro_batch(
+  ExeContextType& context,
+  model& model) const
+{
+  auto& comm = *model.get_comm();
+  auto& sgd_context = context.get_sgd_execution_context();
+  auto& objective = *model.get_objective_function();
+  const bool is_last_stage = (context.m_stage == context.m_num_stages - 1);
+  auto const& micro_batch = context.m_in_flight.front();
+
+  // Restore the activations of this micro-batch
+  if (context.m_resident_micro_batch != micro_batch.index) {
+    recompute_micro_batch(context, model);
+  }
+  sgd_context.set_current_mini_batch_size(micro_batch.size);
+  sgd_context.set_effective_mini_batch_size(
+    context.m_effective_mini_batch_size);
+
+  // The last stage holds the evaluation layers
+  if (is_last_stage) {
+    objective.start_evaluation(execution_mode::training, micro_batch.size);
+    objective.differentiate();
+  }
+
+  // Receive error signals from later stages
+  const auto num_recvs = context.m_recv_error_signals.size();
+  std::vector<BufferType> incoming(num_recvs);
+  std::vector<El::mpi::Request<DataType>> reqs(num_recvs);
+  for (size_t i = 0; i < num_recvs; ++i) {
+    auto const& e = context.m_recv_error_signals[i];
+    auto& mat = prepare_error_signals(e, micro_batch.size);
+    incoming[i].Resize(mat.LocalHeight(), mat.LocalWidth());
+    comm.nb_recv(incoming[i].Buffer(),
+                 incoming[i].Height() * incoming[i].Width(),
+                 e.remote_stage,
+                 reqs[i]);
+  }
+  const double start = get_time();
+  comm.wait_all(reqs);
+  context.m_wait_time += get_time() - start;
+  for (size_t i = 0; i < num_recvs; ++i) {
+    auto const& e = context.m_recv_error_signals[i];
+    auto& mat = as_data_type_layer(*e.child).get_error_signals(e.parent_index);
+    unpack(incoming[i], mat);
+    deep_copy_error_signal(*e.parent, *e.child, mat);
+  }
+
+  // Backward prop through this stage
+  std::vector<BufferType*> outgoing;
+  outgoing.reserve(context.m_send_error_signals.size());
+  size_t next_send = 0;
+  for (auto rit = context.m_layers.rbegin(); rit != context.m_layers.rend();
+       ++rit) {
+    auto* l = *rit;
+    l->back_prop();
+    for (; next_send < context.m_send_error_signals.size()
+           && context.m_send_error_signals[next_send].child == l;
+         ++next_send) {
+      auto const& e = context.m_send_error_signals[next_send];
+      context.m_send_buffers.emplace_back();
+      outgoing.push_back(&context.m_send_buffers.back());
+      pack(as_data_type_layer(*l).get_error_signals(e.parent_index),
+           *outgoing.back());
+    }
+  }
+
+  // Send error signals to earlier stages
+  for (size_t i = 0; i < outgoing.size(); ++i) {
+    context.m_send_requests.emplace_back();
+    comm.nb_send(outgoing[i]->LockedBuffer(),
+                 outgoing[i]->Height() * outgoing[i]->Width(),
+                 context.m_send_error_signals[i].remote_stage,
+                 context.m_send_requests.back());
+  }
+
+  if (is_last_stage) {
+    objective.finish_evaluation(execution_mode::training, micro_batch.size);
+    model.evaluate_metrics(execution_mode::training, micro_batch.size);
+  }
+  context.m_in_flight.pop_front();
+}
+
+void PipelineParallel::recompute_micro_batch(
+  ExeContextType& context,
+  model& model) const
+{
+  const double start = get_time();
+  auto& sgd_context = context.get_sgd_execution_context();
+  auto const& micro_batch = context.m_in_flight.front();
+  sgd_context.set_current_mini_batch_size(micro_batch.size);
+
+  // Restore the tensors entering this stage
+  const auto num_recvs = context.m_recv_activations.size();
+  for (size_t i = 0; i < num_recvs; ++i) {
+    auto const& e = context.m_recv_activations[i];
+    unpack(micro_batch.inputs[i], prepare_activations(e, micro_batch.size));
+  }
+  for (size_t i = 0; i < context.m_stage_inputs.size(); ++i) {
+    auto const& e = context.m_stage_inputs[i];
+    unpack(micro_batch.inputs[num_recvs + i],
+           prepare_activations(e, micro_batch.size));
+  }
+
+  // Rerun everything else
+  for (auto* l : context.m_layers) {
+    if (!is_input_layer(*l)) {
+      l->forward_prop();
+    }
+  }
+  context.m_resident_micro_batch = micro_batch.index;
+  context.m_recompute_time += get_time() - start;
+}
+
+// =============================================
+// Stage assignment
+// =============================================
+
+void PipelineParallel::partition_model(ExeContextType& context,
+                                       model& model) const
+{
+  auto const& comm = *model.get_comm();
+  const int num_stages = comm.get_num_trainers();
+  const int stage = comm.get_trainer_rank();
+  const auto layers = model.get_layers();
+  const int num_layers = layers.size();
+  if (num_layers < num_stages) {
+    LBANN_ERROR("model \"", model.get_name(), "\" has ", num_layers,
+                " layers, which is fewer than the ", num_stages,
+                " pipeline stages (one per trainer)");
+  }
+
+  // Balance estimated cost over contiguous stages
+  std::vector<double> costs(num_layers);
+  std::unordered_map<Layer const*, int> positions;
+  for (int i = 0; i < num_layers; ++i) {
+    costs[i] = estimate_cost(*layers[i]);
+    positions[layers[i]] = i;
+  }
+  auto layer_stages = partition_contiguous(costs, num_stages);
+
+  // Data is only fetched by the first stage and the objective
+  // function is only evaluated by the last
+  for (int i = 0; i < num_layers; ++i) {
+    auto const& l = *layers[i];
+    if (is_input_layer(l)) {
+      layer_stages[i] = 0;
+    }
+    else if (dynamic_cast<abstract_evaluation_layer<DataType> const*>(&l)) {
+      layer_stages[i] = num_stages - 1;
+    }
+  }
+
+  // Check the assignment
+  for (int i = 0; i < num_layers; ++i) {
+    auto const& l = *layers[i];
+    for (auto const* child : l.get_child_layers()) {
+      if (layer_stages[positions.at(child)] < layer_stages[i]) {
+        LBANN_ERROR("layer \"", child->get_name(), "\" is in pipeline stage ",
+                    layer_stages[positions.at(child)],
+                    ", but its parent \"", l.get_name(), "\" is in stage ",
+                    layer_stages[i]);
+      }
+    }
+    if (layer_stages[i] < num_stages - 1 && !l.can_recompute_forward_prop()) {
+      LBANN_ERROR(l.get_type(), " layer \"", l.get_name(), "\" ",
+                  "is in pipeline stage ", layer_stages[i], " of ", num_stages,
+                  ", but it cannot recompute its forward prop");
+    }
+  }
+
+  // Each weights object is updated by the stage that uses it
+  context.m_weights_stage.clear();
+  for (int i = 0; i < num_layers; ++i) {
+    for (auto const& w_ptr : layers[i]->get_weights_pointers()) {
+      auto const* w = w_ptr.lock().get();
+      auto iter = context.m_weights_stage.find(w);
+      if (iter == context.m_weights_stage.end()) {
+        context.m_weights_stage[w] = layer_stages[i];
+      }
+      else if (iter->second != layer_stages[i]) {
+        LBANN_ERROR("weights \"", w->get_name(), "\" are used in pipeline "
+                    "stages ", iter->second, " and ", layer_stages[i],
+                    ", but weights may not be shared between stages");
+      }
+    }
+  }
+  context.m_weights.clear();
+  for (auto* w : model.get_weights()) {
+    auto iter = context.m_weights_stage.find(w);
+    if (iter == context.m_weights_stage.end()) {
+      context.m_weights_stage[w] = 0;
+    }
+    if (context.m_weights_stage[w] == stage) {
+      context.m_weights.push_back(w);
+    }
+  }
+
+  // Find the tensors that cross stage boundaries
+  // Note: Messages between two stages are matched in posting order,
+  // so both stages must list them in the same order. Activations are
+  // sent in forward order and error signals in backward order.
+  context.m_stage = stage;
+  context.m_num_stages = num_stages;
+  context.m_layers.clear();
+  context.m_stage_inputs.clear();
+  context.m_recv_activations.clear();
+  context.m_send_activations.clear();
+  context.m_recv_error_signals.clear();
+  context.m_send_error_signals.clear();
+  context.m_in_flight.clear();
+  context.m_resident_micro_batch = -1;
+  for (int i = 0; i < num_layers; ++i) {
+    auto* parent = layers[i];
+    const int parent_stage = layer_stages[i];
+    if (parent_stage == stage) {
+      context.m_layers.push_back(parent);
+    }
+    for (int j = 0; j < parent->get_num_children(); ++j) {
+      auto* child = const_cast<Layer*>(&parent->get_child_layer(j));
+      const int child_stage = layer_stages[positions.at(child)];
+      const int parent_index = child->find_parent_layer_index(*parent);
+      if (parent_stage == stage && is_input_layer(*parent)) {
+        context.m_stage_inputs.push_back(
+          {parent, child, j, parent_index, stage});
+      }
+      if (parent_stage == child_stage
+          || (parent_stage != stage && child_stage != stage)) {
+        continue;
+      }
+
+      // Error signals must outlive the child's backward pass
+      child->set_keep_error_signals(true);
+      if (parent_stage == stage) {
+        Edge e{parent, child, j, parent_index, child_stage};
+        context.m_send_activations.push_back(e);
+        context.m_recv_error_signals.push_back(e);
+      }
+      else {
+        Edge e{parent, child, j, parent_index, parent_stage};
+        context.m_recv_activations.push_back(e);
+        context.m_send_error_signals.push_back(e);
+      }
+    }
+  }
+  const auto backward_order = [&positions](Edge const& a, Edge const& b) {
+    const auto pos_a = positions.at(a.child), pos_b = positions.at(b.child);
+    return (pos_a > pos_b
+            || (pos_a == pos_b && a.parent_index < b.parent_index));
+  };
+  std::stable_sort(context.m_recv_error_signals.begin(),
+                   context.m_recv_error_signals.end(),
+                   backward_order);
+  std::stable_sort(context.m_send_error_signals.begin(),
+                   context.m_send_error_signals.end(),
+                   backward_order);
+}
+
+void PipelineParallel::synchronize_weights(ExeContextType& context,
+                                           model& model) const
+{
+  auto const& comm = *model.get_comm();
+  if (context.m_num_stages < 2) {
+    return;
+  }
+  for (auto* w_ptr : model.get_weights()) {
+    auto* w = dynamic_cast<data_type_weights<DataType>*>(w_ptr);
+    if (w == nullptr) {
+      LBANN_ERROR("pipeline-parallel training only supports weights with "
+                  "the default data type, but weights \"",
+                  w_ptr->get_name(),
+                  "\" have a different one");
+    }
+    comm.intertrainer_broadcast_matrix(w->get_values(),
+                                       context.m_weights_stage.at(w_ptr));
+  }
+}
+
+// =============================================
+// Callbacks
+// =============================================
+
+void PipelineParallel::do_train_begin_cbs(model& model)
+{
+  for (const auto& cb : model.get_callbacks()) {
+    cb->on_train_begin(&model);
+  }
+}
+
+void PipelineParallel::do_train_end_cbs(model& model)
+{
+  for (const auto& cb : model.get_callbacks()) {
+    cb->on_train_end(&model);
+  }
+}
+
+void PipelineParallel::do_epoch_begin_cbs(model& model)
+{
+  for (const auto& cb : model.get_callbacks()) {
+    cb->on_epoch_begin(&model);
+  }
+}
+
+void PipelineParallel::do_epoch_end_cbs(model& model)
+{
+  for (const auto& cb : model.get_callbacks()) {
+    cb->on_epoch_end(&model);
+  }
+}
+
+void PipelineParallel::do_batch_begin_cbs(model& model)
+{
+  sgd_execution_context& c =
+    static_cast<sgd_execution_context&>(model.get_execution_context());
+  for (const auto& cb : model.get_callbacks()) {
+    if (c.get_step() % cb->get_batch_interval() == 0) {
+      cb->on_batch_begin(&model);
+    }
+  }
+}
+
+void PipelineParallel::do_batch_end_cbs(model& model)
+{
+  sgd_execution_context& c =
+    static_cast<sgd_execution_context&>(model.get_execution_context());
+  for (const auto& cb : model.get_callbacks()) {
+    if (c.get_step() % cb->get_batch_interval() == 0) {
+      cb->on_batch_end(&model);
+    }
+  }
+}
+
+} // namespace lbann
+
+template <>
+std::unique_ptr<lbann::PipelineParallel> lbann::make<lbann::PipelineParallel>(
+  google::protobuf::Message const& msg_in)
+{
+  auto const& params =
+    dynamic_cast<lbann_data::TrainingAlgorithm const&>(msg_in);
+
+  lbann_data::PipelineParallel pipeline_params;
+  LBANN_ASSERT(params.parameters().UnpackTo(&pipeline_params));
+
+  // SGD parameters
+  auto const& sgd_params = pipeline_params.sgd();
+  auto const& stopping_criteria = sgd_params.stopping_criteria();
+  std::unique_ptr<lbann::sgd_termination_criteria> stopping;
+  switch (stopping_criteria.criterion_case()) {
+  case lbann_data::SGD::TerminationCriteria::kMaxBatches:
+    stopping = lbann::make_unique<lbann::batch_termination_criteria>(
+      stopping_criteria.max_batches());
+    break;
+  case lbann_data::SGD::TerminationCriteria::kMaxEpochs:
+    stopping = lbann::make_unique<lbann::epoch_termination_criteria>(
+      stopping_criteria.max_epochs());
+    break;
+  case lbann_data::SGD::TerminationCriteria::kMaxSeconds:
+    stopping = lbann::make_unique<lbann::seconds_termination_criteria>(
+      stopping_criteria.max_seconds());
+    break;
+  default:
+    LBANN_ERROR("No stopping criteria specified.");
+  }
+
+  const size_t num_micro_batches =
+    (pipeline_params.num_micro_batches() > 0
+       ? pipeline_params.num_micro_batches()
+       : 4UL);
+  return make_unique<PipelineParallel>(params.name(),
+                                       std::move(stopping),
+                                       num_micro_batches);
+}
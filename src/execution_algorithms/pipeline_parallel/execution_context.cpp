@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/execution_algorithms/pipeline_parallel/execution_context.hpp"
+#include "lbann/io/persist_impl.hpp"
+#include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/serialize.hpp"
+
+namespace lbann {
+namespace pipeline_parallel {
+
+// =============================================
+// Life cycle
+// =============================================
+
+ExecutionContext::ExecutionContext(size_t mini_batch_size)
+  : m_sgd_execution_context(execution_mode::training, mini_batch_size)
+{}
+
+std::unique_ptr<lbann::execution_context> ExecutionContext::get_new() const
+{
+  return std::make_unique<ExecutionContext>(0UL);
+}
+
+// =============================================
+// Accessors
+// =============================================
+
+std::string ExecutionContext::get_type() const
+{
+  return "PipelineParallel";
+}
+
+std::string ExecutionContext::get_state_string() const noexcept
+{
+  return build_string(this->get_type(),
+                      ".step.",
+                      m_sgd_execution_context.get_step(),
+                      ".stage.",
+                      m_stage);
+}
+
+// =============================================
+// Checkpointing and serialization
+// =============================================
+
+template <class Archive> void ExecutionContext::serialize(Archive& ar)
+{
+  ar(cereal::base_class<lbann::execution_context>(this));
+}
+
+void ExecutionContext::save_to_checkpoint_shared(persist& p)
+{
+  m_sgd_execution_context.save_to_checkpoint_shared(p);
+  if (get_trainer().get_comm()->am_trainer_master()) {
+    write_cereal_archive<ExecutionContext>(*this,
+                                           p,
+                                           get_execution_mode(),
+#ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
+                                           "_pipeline_parallel.xml"
+#else  // defined LBANN_HAS_CEREAL_BINARY_ARCHIVES
+                                           "_pipeline_parallel.bin"
+#endif // LBANN_HAS_CEREAL_XML_ARCHIVES
+    );
+  }
+}
+
+void ExecutionContext::load_from_checkpoint_shared(persist& p)
+{
+  m_sgd_execution_context.load_from_checkpoint_shared(p);
+  load_from_shared_cereal_archive<ExecutionContext>(
+    *this,
+    p,
+    get_execution_mode(),
+    *(get_trainer().get_comm()),
+#ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
+    "_pipeline_parallel.xml"
+#else  // defined LBANN_HAS_CEREAL_BINARY_ARCHIVES
+    "_pipeline_parallel.bin"
+#endif // LBANN_HAS_CEREAL_XML_ARCHIVES
+  );
+}
+
+void ExecutionContext::save_to_checkpoint_distributed(persist& p)
+{
+  m_sgd_execution_context.save_to_checkpoint_distributed(p);
+  write_cereal_archive<ExecutionContext>(*this,
+                                         p,
+                                         get_execution_mode(),
+#ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
+                                         "_pipeline_parallel.xml"
+#else  // defined LBANN_HAS_CEREAL_BINARY_ARCHIVES
+                                         "_pipeline_parallel.bin"
+#endif // LBANN_HAS_CEREAL_XML_ARCHIVES
+  );
+}
+
+void ExecutionContext::load_from_checkpoint_distributed(persist& p)
+{
+  m_sgd_execution_context.load_from_checkpoint_distributed(p);
+  read_cereal_archive<ExecutionContext>(*this,
+                                        p,
+                                        get_execution_mode(),
+#ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
+                                        "_pipeline_parallel.xml"
+#else  // defined LBANN_HAS_CEREAL_BINARY_ARCHIVES
+                                        "_pipeline_parallel.bin"
+#endif // LBANN_HAS_CEREAL_XML_ARCHIVES
+  );
+}
+
+} // namespace pipeline_parallel
+} // namespace lbann
+
+#define LBANN_SKIP_CEREAL_REGISTRATION
+#define LBANN_CLASS_NAME pipeline_parallel::ExecutionContext
+#include <lbann/macros/register_class_with_cereal.hpp>
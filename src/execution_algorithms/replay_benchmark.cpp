@@ -0,0 +1,303 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/execution_algorithms/replay_benchmark.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/data_readers/data_reader.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+#include "lbann/utils/threads/thread_pool.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <training_algorithm.pb.h>
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lbann {
+
+ReplayBenchmark::ReplayBenchmark(std::string name,
+                                 std::string index_file,
+                                 size_t num_steps,
+                                 size_t num_warmup_steps)
+  : BaseType(std::move(name),
+             make_unique<batch_termination_criteria>(num_steps
+                                                     + num_warmup_steps)),
+    m_index_file{std::move(index_file)},
+    m_num_steps{std::max(num_steps, size_t{1})},
+    m_num_warmup_steps{num_warmup_steps}
+{
+  if (m_index_file.empty()) {
+    LBANN_ERROR("ReplayBenchmark requires an index file");
+  }
+}
+
+std::string ReplayBenchmark::get_type() const { return "ReplayBenchmark"; }
+
+// =============================================
+// Benchmark
+// =============================================
+
+void ReplayBenchmark::apply(execution_context& context,
+                            model& model,
+                            data_coordinator& dc,
+                            execution_mode mode)
+{
+  if (mode != execution_mode::training) {
+    sgd_training_algorithm::apply(context, model, dc, mode);
+    return;
+  }
+  auto& c = dynamic_cast<sgd_execution_context&>(context);
+  auto& comm = *model.get_comm();
+  check_threads(comm);
+  setup_sample_order(comm, dc);
+  c.set_execution_mode(execution_mode::training);
+  model.reset_mode(c, execution_mode::training);
+  dc.reset_mode(c);
+  do_train_begin_cbs(model);
+
+  // Regular SGD steps, without evaluation at the end of epochs
+  bool is_start_of_epoch = true;
+  auto step = [&]() {
+    if (is_start_of_epoch) {
+      model.reset_mode(c, execution_mode::training);
+      model.reset_epoch_statistics(execution_mode::training);
+      dc.reset_mode(c);
+      do_epoch_begin_cbs(model);
+      is_start_of_epoch = false;
+    }
+    if (train_mini_batch(c, model, dc)) {
+      c.inc_epoch();
+      model.reconcile_weight_values();
+      do_epoch_end_cbs(model);
+      is_start_of_epoch = true;
+    }
+  };
+
+  c.start_timer();
+  for (size_t i = 0; i < m_num_warmup_steps; ++i) {
+    step();
+  }
+  std::vector<double> times;
+  times.reserve(m_num_steps);
+  for (size_t i = 0; i < m_num_steps; ++i) {
+    comm.trainer_barrier();
+    const double start = get_time();
+    step();
+#ifdef LBANN_HAS_GPU
+    hydrogen::gpu::SynchronizeDevice();
+#endif // LBANN_HAS_GPU
+    times.push_back(comm.trainer_allreduce(get_time() - start, El::mpi::MAX));
+  }
+  c.stop_timer();
+
+  model.reset_mode(c, execution_mode::training);
+  do_train_end_cbs(model);
+
+  // Report step time statistics
+  if (!comm.am_trainer_master()) {
+    return;
+  }
+  const auto stats = get_statistics(times);
+  const double samples_per_step =
+    dc.get_mini_batch_size(execution_mode::training);
+  std::ostringstream msg;
+  msg << std::string(80, '-') << "\n"
+      << "ReplayBenchmark: model \"" << model.get_name() << "\", "
+      << "trainer " << comm.get_trainer_rank() << ", "
+      << m_num_steps << " timed steps after " << m_num_warmup_steps
+      << " warmup steps, " << samples_per_step << " samples per step\n"
+      << std::fixed << std::setprecision(3)
+      << "  median step time : " << 1e3 * stats.median << " ms "
+      << "(95% CI " << 1e3 * stats.median_lower << " - "
+      << 1e3 * stats.median_upper << " ms)\n"
+      << "  mean step time   : " << 1e3 * stats.mean << " ms "
+      << "(stdev " << 1e3 * stats.stdev << " ms)\n"
+      << "  min / max        : " << 1e3 * stats.min << " / "
+      << 1e3 * stats.max << " ms\n"
+      << std::setprecision(1)
+      << "  median rate      : " << samples_per_step / stats.median
+      << " samples/s (95% CI " << samples_per_step / stats.median_upper
+      << " - " << samples_per_step / stats.median_lower << " samples/s)\n"
+      << std::string(80, '-') << "\n";
+  std::cout << msg.str() << std::flush;
+}
+
+// =============================================
+// Setup
+// =============================================
+
+void ReplayBenchmark::setup_sample_order(lbann_comm& comm,
+                                         data_coordinator& dc) const
+{
+  auto* reader = dc.get_data_reader(execution_mode::training);
+  if (reader == nullptr) {
+    LBANN_ERROR("ReplayBenchmark requires a training data reader");
+  }
+  std::string file_name = m_index_file;
+  if (comm.get_num_trainers() > 1) {
+    file_name += ".trainer" + std::to_string(comm.get_trainer_rank());
+  }
+
+  // Make sure no process sees the file while it is being recorded
+  const bool file_exists = std::ifstream(file_name).good();
+  const bool replay =
+    comm.trainer_allreduce<int>(file_exists ? 1 : 0, El::mpi::MIN) != 0;
+
+  if (replay) {
+    std::ifstream fs(file_name);
+    std::vector<int> indices;
+    int index;
+    while (fs >> index) {
+      indices.push_back(index);
+    }
+    auto recorded = indices;
+    auto expected = reader->get_shuffled_indices();
+    std::sort(recorded.begin(), recorded.end());
+    std::sort(expected.begin(), expected.end());
+    if (recorded != expected) {
+      LBANN_ERROR("training sample order in ", file_name, " (",
+                  indices.size(), " indices) does not match the ",
+                  expected.size(), " samples of the training data reader");
+    }
+    reader->set_shuffled_indices(indices);
+  }
+  else if (comm.am_trainer_master()) {
+    std::ofstream fs(file_name);
+    if (!fs) {
+      LBANN_ERROR("failed to open training sample order file (",
+                  file_name, ")");
+    }
+    for (auto const& index : reader->get_shuffled_indices()) {
+      fs << index << "\n";
+    }
+  }
+  reader->set_shuffle(false);
+
+  if (comm.am_trainer_master()) {
+    std::cout << "ReplayBenchmark: "
+              << (replay ? "replaying training sample order from "
+                         : "recorded training sample order in ")
+              << file_name << std::endl;
+  }
+}
+
+void ReplayBenchmark::check_threads(lbann_comm& comm) const
+{
+  if (!comm.am_trainer_master()) {
+    return;
+  }
+  const auto num_io_threads = get_trainer().get_io_thread_pool().get_num_threads();
+  std::cout << "ReplayBenchmark: " << num_io_threads << " I/O threads and "
+            << omp_get_max_threads() << " OpenMP threads per process"
+            << std::endl;
+#ifndef LBANN_TOPO_AWARE
+  LBANN_WARNING("I/O threads are not pinned to cores since LBANN was "
+                "built without hwloc, so step times may vary between runs");
+#endif // LBANN_TOPO_AWARE
+  if (omp_get_proc_bind() == omp_proc_bind_false) {
+    LBANN_WARNING("OpenMP threads are not pinned to cores, so step times "
+                  "may vary between runs (set OMP_PROC_BIND and OMP_PLACES)");
+  }
+}
+
+// =============================================
+// Statistics
+// =============================================
+
+auto ReplayBenchmark::get_statistics(std::vector<double> times) -> statistics
+{
+  statistics stats;
+  const size_t n = times.size();
+  if (n == 0) {
+    return stats;
+  }
+  std::sort(times.begin(), times.end());
+  stats.min = times.front();
+  stats.max = times.back();
+  stats.median = (n % 2 == 1
+                  ? times[n / 2]
+                  : (times[n / 2 - 1] + times[n / 2]) / 2);
+
+  // Ranks of the order statistics bounding the median with 95%
+  // confidence, from the normal approximation to the binomial
+  const double half_width = 1.96 * std::sqrt(static_cast<double>(n)) / 2;
+  const double lower_rank = std::round(n / 2.0 - half_width);
+  const double upper_rank = std::round(n / 2.0 + half_width + 1);
+  const auto clamp_index = [n](double rank) {
+    return static_cast<size_t>(
+      std::min(std::max(rank - 1, 0.0), static_cast<double>(n - 1)));
+  };
+  stats.median_lower = times[clamp_index(lower_rank)];
+  stats.median_upper = times[clamp_index(upper_rank)];
+
+  stats.mean = std::accumulate(times.begin(), times.end(), 0.0) / n;
+  if (n > 1) {
+    double sqsum = 0;
+    for (auto const& t : times) {
+      sqsum += (t - stats.mean) * (t - stats.mean);
+    }
+    stats.stdev = std::sqrt(sqsum / (n - 1));
+  }
+  return stats;
+}
+
+} // namespace lbann
+
+template <>
+std::unique_ptr<lbann::ReplayBenchmark>
+lbann::make<lbann::ReplayBenchmark>(google::protobuf::Message const& msg_in)
+{
+  auto const& params =
+    dynamic_cast<lbann_data::TrainingAlgorithm const&>(msg_in);
+
+  lbann_data::ReplayBenchmark benchmark_params;
+  LBANN_ASSERT(params.parameters().UnpackTo(&benchmark_params));
+
+  return make_unique<ReplayBenchmark>(
+    params.name(),
+    benchmark_params.index_file(),
+    (benchmark_params.num_steps() > 0 ? benchmark_params.num_steps() : 50UL),
+    (benchmark_params.num_warmup_steps() > 0
+       ? benchmark_params.num_warmup_steps()
+       : 10UL));
+}
@@ -0,0 +1,107 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include <catch2/catch.hpp>
+
+#include "lbann/execution_algorithms/inference_server.hpp"
+
+#include <chrono>
+
+using namespace lbann;
+
+namespace {
+
+inference_request make_request(size_t num_samples) {
+  inference_request req;
+  req.num_samples = num_samples;
+  req.arrival_time = std::chrono::steady_clock::now();
+  return req;
+}
+
+} // namespace <anon>
+
+TEST_CASE("Dynamic batching of inference requests", "[inference][server]")
+{
+  SECTION("Full batches are released in arrival order")
+  {
+    dynamic_batcher batcher(4, std::chrono::seconds(60));
+    batcher.push(make_request(1));
+    batcher.push(make_request(3));
+    batcher.push(make_request(2));
+    auto batch = batcher.next_batch();
+    REQUIRE(batch.size() == 2);
+    CHECK(batch[0].num_samples == 1);
+    CHECK(batch[1].num_samples == 3);
+    CHECK(batcher.get_num_queued_samples() == 2);
+  }
+
+  SECTION("Partial batch is released at the deadline")
+  {
+    const auto max_latency = std::chrono::milliseconds(20);
+    dynamic_batcher batcher(64, max_latency);
+    const auto start = std::chrono::steady_clock::now();
+    batcher.push(make_request(2));
+    auto batch = batcher.next_batch();
+    REQUIRE(batch.size() == 1);
+    CHECK(std::chrono::steady_clock::now() - start >= max_latency);
+  }
+
+  SECTION("Oversized request is batched alone")
+  {
+    dynamic_batcher batcher(4, std::chrono::seconds(60));
+    batcher.push(make_request(8));
+    batcher.push(make_request(1));
+    auto batch = batcher.next_batch();
+    REQUIRE(batch.size() == 1);
+    CHECK(batch[0].num_samples == 8);
+  }
+
+  SECTION("Shutdown drains queued requests")
+  {
+    dynamic_batcher batcher(4, std::chrono::seconds(60));
+    batcher.push(make_request(1));
+    batcher.shutdown();
+    CHECK(batcher.next_batch().size() == 1);
+    CHECK(batcher.next_batch().empty());
+  }
+}
+
+TEST_CASE("Inference latency statistics", "[inference][server]")
+{
+  latency_statistics stats;
+  for (int i = 1; i <= 100; ++i) {
+    stats.record(i * 1e-3, 2);
+  }
+  CHECK(stats.get_num_requests() == 100);
+  CHECK(stats.get_num_samples() == 200);
+  CHECK(stats.get_percentile(50) == Approx(50e-3));
+  CHECK(stats.get_percentile(99) == Approx(99e-3));
+  CHECK(stats.get_percentile(100) == Approx(100e-3));
+  stats.reset();
+  CHECK(stats.get_num_requests() == 0);
+  CHECK(stats.get_percentile(50) == 0.);
+}
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "lbann/execution_algorithms/kfac/kfac_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace lbann;
+
+TEST_CASE("Balancing K-FAC inverse assignment", "[kfac][algorithm]")
+{
+  SECTION("Large blocks are spread across processes")
+  {
+    // Round-robin would give rank 0 both large blocks
+    std::vector<double> costs = {100., 1., 100., 1., 1., 1.};
+    const auto ranks = kfac::get_balanced_proc_ranks(costs, 2);
+    REQUIRE(ranks.size() == costs.size());
+    CHECK(ranks[0] != ranks[2]);
+    std::vector<double> loads(2, 0.);
+    for (size_t i = 0; i < costs.size(); ++i) {
+      REQUIRE(ranks[i] < 2);
+      loads[ranks[i]] += costs[i];
+    }
+    CHECK(loads[0] == loads[1]);
+  }
+
+  SECTION("More processes than blocks")
+  {
+    std::vector<double> costs = {3., 2., 1.};
+    const auto ranks = kfac::get_balanced_proc_ranks(costs, 8);
+    CHECK(ranks == std::vector<size_t>({0, 1, 2}));
+  }
+
+  SECTION("Inverse cost grows cubically")
+  {
+    CHECK(kfac::get_matrix_inverse_cost(20)
+          == 8 * kfac::get_matrix_inverse_cost(10));
+  }
+}
+
+TEST_CASE("K-FAC eigendecomposition", "[kfac][algorithm]")
+{
+  using MatType = El::Matrix<DataType, El::Device::CPU>;
+  const El::Int n = 4;
+  MatType A(n, n);
+  for (El::Int j = 0; j < n; ++j) {
+    for (El::Int i = 0; i < n; ++i) {
+      A(i, j) = (i == j ? DataType(n + i) : DataType(1) / (1 + i + j));
+    }
+  }
+
+  MatType Q, lambda;
+  kfac::get_matrix_eigen(Q, lambda, A, false);
+  REQUIRE(Q.Height() == n);
+  REQUIRE(Q.Width() == n);
+  REQUIRE(lambda.Height() == n);
+
+  SECTION("Eigenpairs reconstruct the matrix")
+  {
+    for (El::Int j = 0; j < n; ++j) {
+      for (El::Int i = 0; i < n; ++i) {
+        DataType sum = 0;
+        for (El::Int k = 0; k < n; ++k) {
+          sum += Q(i, k) * lambda(k, 0) * Q(j, k);
+        }
+        CHECK(sum == Approx(A(i, j)).margin(1e-4));
+      }
+    }
+  }
+
+  SECTION("Scaling in the eigenbasis applies the damped inverse")
+  {
+    // (A + dI)^{-1} x = Q ((Q^T x) ./ (lambda + d))
+    const DataType damping = 0.5;
+    MatType x(n, 1), zero(1, 1), y(n, 1), z(n, 1);
+    for (El::Int i = 0; i < n; ++i) {
+      x(i, 0) = DataType(i + 1);
+    }
+    El::Fill(zero, DataType(0));
+    El::Gemm(El::TRANSPOSE, El::NORMAL, DataType(1), Q, x, DataType(0), y);
+    kfac::scale_by_damped_eigenvalues(
+      y, lambda, zero, damping, DataType(1),
+      El::SyncInfo<El::Device::CPU>{});
+    El::Gemm(El::NORMAL, El::NORMAL, DataType(1), Q, y, DataType(0), z);
+    // Check (A + dI) z = x
+    for (El::Int i = 0; i < n; ++i) {
+      DataType sum = damping * z(i, 0);
+      for (El::Int j = 0; j < n; ++j) {
+        sum += A(i, j) * z(j, 0);
+      }
+      CHECK(sum == Approx(x(i, 0)).margin(1e-4));
+    }
+  }
+}
@@ -0,0 +1,113 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+
+#include <catch2/catch.hpp>
+
+#include "lbann/execution_algorithms/local_sgd.hpp"
+#include "lbann/execution_contexts/sgd_execution_context.hpp"
+#include "lbann/utils/memory.hpp"
+
+#include <vector>
+
+using lbann::LocalSGD;
+
+namespace {
+
+/** @brief Local steps after which the models are averaged, along
+ *         with the sync interval that follows each average.
+ */
+struct schedule
+{
+  std::vector<size_t> average_steps;
+  std::vector<size_t> sync_intervals;
+};
+
+schedule run_schedule(LocalSGD const& algo,
+                      lbann::local_sgd::ExecutionContext& context,
+                      size_t num_steps)
+{
+  schedule s;
+  algo.update_sync_interval(context);
+  for (size_t i = 0; i < num_steps; ++i) {
+    if (algo.count_local_step(context)) {
+      algo.finish_average(context);
+      s.average_steps.push_back(
+        context.get_sgd_execution_context().get_step());
+      s.sync_intervals.push_back(context.get_sync_interval());
+    }
+  }
+  return s;
+}
+
+LocalSGD make_local_sgd(size_t sync_interval,
+                        size_t max_sync_interval,
+                        size_t sync_interval_growth_period,
+                        size_t warmup_steps)
+{
+  return LocalSGD("local sgd",
+                  lbann::make_unique<lbann::batch_termination_criteria>(100),
+                  sync_interval,
+                  max_sync_interval,
+                  sync_interval_growth_period,
+                  warmup_steps,
+                  false);
+}
+
+} // namespace
+
+TEST_CASE("Local SGD averaging schedule", "[seq][training_algorithm]")
+{
+  lbann::local_sgd::ExecutionContext context(1UL);
+
+  SECTION("Fixed interval")
+  {
+    auto const algo = make_local_sgd(3, 0, 0, 0);
+    auto const s = run_schedule(algo, context, 13);
+    CHECK(s.average_steps == std::vector<size_t>{3, 6, 9, 12});
+    CHECK(s.sync_intervals == std::vector<size_t>{3, 3, 3, 3});
+    CHECK(context.get_step() == 4);
+    CHECK(context.get_steps_since_average() == 1);
+  }
+
+  SECTION("Warmup followed by doubling up to the maximum")
+  {
+    auto const algo = make_local_sgd(2, 8, 2, 3);
+    auto const s = run_schedule(algo, context, 31);
+    CHECK(s.average_steps
+          == std::vector<size_t>{1, 2, 3, 5, 7, 11, 15, 23, 31});
+    CHECK(s.sync_intervals
+          == std::vector<size_t>{1, 1, 2, 2, 4, 4, 8, 8, 8});
+    CHECK(context.get_step() == 9);
+    CHECK(context.get_steps_since_average() == 0);
+  }
+
+  SECTION("Maximum interval below the initial interval")
+  {
+    auto const algo = make_local_sgd(4, 2, 1, 0);
+    auto const s = run_schedule(algo, context, 12);
+    CHECK(s.average_steps == std::vector<size_t>{4, 8, 12});
+    CHECK(s.sync_intervals == std::vector<size_t>{4, 4, 4});
+  }
+}
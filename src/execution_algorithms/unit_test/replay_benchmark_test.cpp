@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include <catch2/catch.hpp>
+
+#include "lbann/execution_algorithms/replay_benchmark.hpp"
+
+#include <cmath>
+#include <vector>
+
+using lbann::ReplayBenchmark;
+
+TEST_CASE("Replay benchmark step time statistics", "[seq][training_algorithm]")
+{
+  SECTION("Odd number of steps")
+  {
+    auto const stats =
+      ReplayBenchmark::get_statistics({7., 3., 9., 1., 5., 2., 8., 4., 6.});
+    CHECK(stats.median == 5.);
+    CHECK(stats.median_lower == 2.);
+    CHECK(stats.median_upper == 8.);
+    CHECK(stats.mean == Approx(5.));
+    CHECK(stats.stdev == Approx(std::sqrt(7.5)));
+    CHECK(stats.min == 1.);
+    CHECK(stats.max == 9.);
+  }
+
+  SECTION("Even number of steps")
+  {
+    auto const stats = ReplayBenchmark::get_statistics({4., 1., 3., 2.});
+    CHECK(stats.median == 2.5);
+    CHECK(stats.median_lower <= stats.median);
+    CHECK(stats.median_upper >= stats.median);
+    CHECK(stats.min == 1.);
+    CHECK(stats.max == 4.);
+  }
+
+  SECTION("Confidence interval narrows with more steps")
+  {
+    std::vector<double> times;
+    for (int i = 1; i <= 50; ++i) {
+      times.push_back(i);
+    }
+    auto const stats = ReplayBenchmark::get_statistics(times);
+    CHECK(stats.median == 25.5);
+    CHECK(stats.median_lower == 18.);
+    CHECK(stats.median_upper == 33.);
+  }
+
+  SECTION("Single step")
+  {
+    auto const stats = ReplayBenchmark::get_statistics({3.});
+    CHECK(stats.median == 3.);
+    CHECK(stats.median_lower == 3.);
+    CHECK(stats.median_upper == 3.);
+    CHECK(stats.stdev == 0.);
+  }
+}
@@ -23,6 +23,11 @@
 // implied. See the License for the specific language governing
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
+#include "lbann/execution_algorithms/async_validation.hpp"
+#include "lbann/execution_algorithms/bottleneck_analysis.hpp"
+#include "lbann/execution_algorithms/local_sgd.hpp"
+#include "lbann/execution_algorithms/pipeline_parallel.hpp"
+#include "lbann/execution_algorithms/replay_benchmark.hpp"
 #include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
 #include "lbann/execution_algorithms/training_algorithm.hpp"
 #include "lbann/utils/exception.hpp"
@@ -147,6 +152,139 @@ TEST_CASE("Building training algorithm from the factory",
     REQUIRE(sgd2->get_name() == "my sgd algo");
   }
 
+  SECTION("Building local SGD works fine.")
+  {
+    lbann_data::LocalSGD local_sgd_msg;
+    local_sgd_msg.mutable_sgd()->mutable_stopping_criteria()->set_max_batches(
+      100);
+    local_sgd_msg.set_sync_interval(4);
+    local_sgd_msg.set_max_sync_interval(32);
+    local_sgd_msg.set_sync_interval_growth_period(10);
+
+    lbann_data::TrainingAlgorithm algo_msg;
+    algo_msg.set_name("my local sgd algo");
+    algo_msg.mutable_parameters()->PackFrom(local_sgd_msg);
+
+    auto algo = lbann::make_abstract<lbann::training_algorithm>(algo_msg);
+
+    REQUIRE_NOTHROW(dynamic_cast<lbann::LocalSGD const&>(*algo));
+    REQUIRE(algo->get_type() == "LocalSGD");
+    REQUIRE(algo->get_name() == "my local sgd algo");
+
+    auto ctxt = algo->get_new_execution_context();
+    REQUIRE(ctxt->get_type() == "LocalSGD");
+    REQUIRE(ctxt->get_step() == 0UL);
+
+    auto algo2 = algo->clone();
+    REQUIRE(algo2->get_type() == "LocalSGD");
+  }
+
+  SECTION("Building pipeline-parallel SGD works fine.")
+  {
+    lbann_data::PipelineParallel pipeline_msg;
+    pipeline_msg.mutable_sgd()->mutable_stopping_criteria()->set_max_batches(
+      100);
+    pipeline_msg.set_num_micro_batches(8);
+
+    lbann_data::TrainingAlgorithm algo_msg;
+    algo_msg.set_name("my pipeline algo");
+    algo_msg.mutable_parameters()->PackFrom(pipeline_msg);
+
+    auto algo = lbann::make_abstract<lbann::training_algorithm>(algo_msg);
+
+    REQUIRE_NOTHROW(dynamic_cast<lbann::PipelineParallel const&>(*algo));
+    REQUIRE(algo->get_type() == "PipelineParallel");
+    REQUIRE(algo->get_name() == "my pipeline algo");
+
+    auto ctxt = algo->get_new_execution_context();
+    REQUIRE(ctxt->get_type() == "PipelineParallel");
+    REQUIRE(ctxt->get_step() == 0UL);
+
+    auto algo2 = algo->clone();
+    REQUIRE(algo2->get_type() == "PipelineParallel");
+  }
+
+  SECTION("Building bottleneck analysis works fine.")
+  {
+    lbann_data::BottleneckAnalysis analysis_msg;
+    analysis_msg.set_num_steps(10);
+    analysis_msg.set_num_warmup_steps(2);
+
+    lbann_data::TrainingAlgorithm algo_msg;
+    algo_msg.set_name("my analysis");
+    algo_msg.mutable_parameters()->PackFrom(analysis_msg);
+
+    auto algo = lbann::make_abstract<lbann::training_algorithm>(algo_msg);
+
+    REQUIRE_NOTHROW(dynamic_cast<lbann::BottleneckAnalysis const&>(*algo));
+    REQUIRE(algo->get_type() == "BottleneckAnalysis");
+    REQUIRE(algo->get_name() == "my analysis");
+
+    // Evaluation runs as in SGD
+    auto ctxt = algo->get_new_execution_context();
+    REQUIRE(ctxt->get_type() == "sgd");
+
+    auto algo2 = algo->clone();
+    REQUIRE(algo2->get_type() == "BottleneckAnalysis");
+  }
+
+  SECTION("Building replay benchmark works fine.")
+  {
+    lbann_data::ReplayBenchmark benchmark_msg;
+    benchmark_msg.set_index_file("sample_order.txt");
+    benchmark_msg.set_num_steps(30);
+
+    lbann_data::TrainingAlgorithm algo_msg;
+    algo_msg.set_name("my benchmark");
+    algo_msg.mutable_parameters()->PackFrom(benchmark_msg);
+
+    auto algo = lbann::make_abstract<lbann::training_algorithm>(algo_msg);
+
+    REQUIRE_NOTHROW(dynamic_cast<lbann::ReplayBenchmark const&>(*algo));
+    REQUIRE(algo->get_type() == "ReplayBenchmark");
+    REQUIRE(algo->get_name() == "my benchmark");
+
+    auto ctxt = algo->get_new_execution_context();
+    REQUIRE(ctxt->get_type() == "sgd");
+
+    auto algo2 = algo->clone();
+    REQUIRE(algo2->get_type() == "ReplayBenchmark");
+  }
+
+  SECTION("Building replay benchmark without an index file fails")
+  {
+    lbann_data::ReplayBenchmark benchmark_msg;
+
+    lbann_data::TrainingAlgorithm algo_msg;
+    algo_msg.set_name("my bad benchmark");
+    algo_msg.mutable_parameters()->PackFrom(benchmark_msg);
+
+    REQUIRE_THROWS(lbann::make_abstract<lbann::training_algorithm>(algo_msg));
+  }
+
+  SECTION("Building asynchronous validation works fine.")
+  {
+    lbann_data::AsyncValidation async_msg;
+    async_msg.mutable_sgd()->mutable_stopping_criteria()->set_max_epochs(10);
+    async_msg.set_max_lag(2);
+
+    lbann_data::TrainingAlgorithm algo_msg;
+    algo_msg.set_name("my async validation");
+    algo_msg.mutable_parameters()->PackFrom(async_msg);
+
+    auto algo = lbann::make_abstract<lbann::training_algorithm>(algo_msg);
+
+    REQUIRE_NOTHROW(dynamic_cast<lbann::AsyncValidation const&>(*algo));
+    REQUIRE(algo->get_type() == "AsyncValidation");
+    REQUIRE(algo->get_name() == "my async validation");
+
+    auto ctxt = algo->get_new_execution_context();
+    REQUIRE(ctxt->get_type() == "sgd");
+
+    auto algo2 = algo->clone();
+    REQUIRE(algo2->get_type() == "AsyncValidation");
+  }
+
   SECTION("Building with an invalid message type fails")
   {
     lbann_data::SGD::TerminationCriteria wrong_msg_type;
@@ -0,0 +1,492 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/io/weights_bundle.hpp"
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lbann {
+
+namespace {
+
+constexpr char bundle_magic[8] = {'L', 'B', 'A', 'N', 'N', 'W', 'B', '\0'};
+constexpr uint32_t bundle_version = 1;
+
+/** Size of an index record, excluding the name. */
+constexpr size_t record_size = 2 * sizeof(uint32_t) + 3 * sizeof(uint64_t);
+
+template <typename T>
+struct bundle_type;
+template <>
+struct bundle_type<float> {
+  static constexpr auto value = weights_bundle::data_type::float32;
+};
+template <>
+struct bundle_type<double> {
+  static constexpr auto value = weights_bundle::data_type::float64;
+};
+#ifdef LBANN_HAS_HALF
+template <>
+struct bundle_type<cpu_fp16> {
+  static constexpr auto value = weights_bundle::data_type::float16;
+};
+#endif // LBANN_HAS_HALF
+
+size_t get_type_size(weights_bundle::data_type type) {
+  switch (type) {
+  case weights_bundle::data_type::float32: return 4;
+  case weights_bundle::data_type::float64: return 8;
+  case weights_bundle::data_type::float16: return 2;
+  default:
+    LBANN_ERROR("invalid data type (", static_cast<uint32_t>(type), ") "
+                "in weights bundle");
+  }
+  return 0;
+}
+
+size_t align_offset(size_t offset) {
+  const auto& alignment = weights_bundle::alignment;
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+void append_bytes(std::vector<unsigned char>& buffer, T const& val) {
+  const auto* bytes = reinterpret_cast<unsigned char const*>(&val);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T extract_bytes(unsigned char const* data, size_t size, size_t& pos) {
+  if (pos + sizeof(T) > size) {
+    LBANN_ERROR("weights bundle index is truncated");
+  }
+  T val;
+  std::memcpy(&val, data + pos, sizeof(T));
+  pos += sizeof(T);
+  return val;
+}
+
+/** Broadcast a buffer of arbitrary size over the trainer. */
+void trainer_broadcast_bytes(lbann_comm const& comm, void* data, size_t size) {
+  auto* bytes = static_cast<El::byte*>(data);
+  constexpr size_t max_count = std::numeric_limits<int>::max();
+  for (size_t pos = 0; pos < size; pos += max_count) {
+    const auto count = std::min(max_count, size - pos);
+    comm.trainer_broadcast(comm.get_trainer_master(),
+                           bytes + pos,
+                           static_cast<int>(count));
+  }
+}
+
+template <typename T>
+bool try_get_type(weights const& w, weights_bundle::data_type& type) {
+  if (dynamic_cast<data_type_weights<T> const*>(&w) == nullptr) {
+    return false;
+  }
+  type = bundle_type<T>::value;
+  return true;
+}
+
+weights_bundle::data_type get_type(weights const& w) {
+  weights_bundle::data_type type;
+  if (try_get_type<float>(w, type)) { return type; }
+  if (try_get_type<double>(w, type)) { return type; }
+#ifdef LBANN_HAS_HALF
+  if (try_get_type<cpu_fp16>(w, type)) { return type; }
+#endif // LBANN_HAS_HALF
+  LBANN_ERROR("weights \"", w.get_name(), "\" have a data type "
+              "that is not supported in weights bundles");
+  return type;
+}
+
+/** Gather weight values to the trainer master and write to file. */
+template <typename T>
+bool try_write_values(weights const& w,
+                      weights_bundle::entry const& e,
+                      std::ofstream& ofs) {
+  auto const* dtw = dynamic_cast<data_type_weights<T> const*>(&w);
+  if (dtw == nullptr) {
+    return false;
+  }
+  auto const& values = dtw->get_values();
+  El::DistMatrix<T, El::CIRC, El::CIRC, El::ELEMENT, El::Device::CPU>
+    gathered(values.Grid(), 0);
+  El::Copy(values, gathered);
+  if (ofs.is_open()) {
+    auto const& local_values = gathered.LockedMatrix();
+    ofs.seekp(e.offset);
+    for (El::Int col = 0; col < local_values.Width(); ++col) {
+      ofs.write(reinterpret_cast<char const*>(local_values.LockedBuffer(0, col)),
+                local_values.Height() * sizeof(T));
+    }
+  }
+  return true;
+}
+
+/** Restore weight values from a bundle.
+ *
+ *  With @c weights_bundle_access::map, @c bundle is the mapped file
+ *  on every process. With @c weights_bundle_access::broadcast, it is
+ *  only set on the trainer master.
+ */
+template <typename T>
+bool try_read_values(weights& w,
+                     weights_bundle::entry const& e,
+                     std::shared_ptr<weights_bundle> const& bundle,
+                     weights_bundle_access access,
+                     lbann_comm const& comm) {
+  auto* dtw = dynamic_cast<data_type_weights<T>*>(&w);
+  if (dtw == nullptr) {
+    return false;
+  }
+  auto& values = dtw->get_values();
+  if (e.type != bundle_type<T>::value
+      || e.height != values.Height()
+      || e.width != values.Width()) {
+    if (comm.am_trainer_master()) {
+      LBANN_WARNING("weights bundle entry \"", e.name, "\" "
+                    "(", e.height, " x ", e.width, ") does not match "
+                    "weights \"", w.get_name(), "\" "
+                    "(", values.Height(), " x ", values.Width(), ")");
+    }
+    return false;
+  }
+  const El::Int ldim = std::max(e.height, El::Int(1));
+
+  if (access == weights_bundle_access::map) {
+    // Replicated weights view the mapping directly
+    auto* buffer = reinterpret_cast<T*>(bundle->data() + e.offset);
+    if (!dtw->attach_values(buffer, bundle)) {
+      StarMatDT<T, El::Device::CPU> view(values.Grid(), values.Root());
+      view.LockedAttach(e.height, e.width, values.Grid(), 0, 0,
+                        buffer, ldim, values.Root());
+      El::Copy(view, values);
+    }
+  }
+  else {
+    StarMatDT<T, El::Device::CPU> replicated(values.Grid(), values.Root());
+    replicated.Resize(e.height, e.width, ldim);
+    const size_t size = e.height * e.width * sizeof(T);
+    if (comm.am_trainer_master()) {
+      std::memcpy(replicated.Buffer(), bundle->data() + e.offset, size);
+    }
+    trainer_broadcast_bytes(comm, replicated.Buffer(), size);
+    El::Copy(replicated, values);
+  }
+  return true;
+
+}
+
+} // namespace <anon>
+
+// =============================================
+// weights_bundle
+// =============================================
+
+std::shared_ptr<weights_bundle> weights_bundle::map(std::string const& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LBANN_ERROR("could not open weights bundle ", path, " "
+                "(", std::strerror(errno), ")");
+  }
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) != 0) {
+    const auto error = errno;
+    ::close(fd);
+    LBANN_ERROR("could not stat weights bundle ", path, " "
+                "(", std::strerror(error), ")");
+  }
+  const size_t size = file_stat.st_size;
+  void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  const auto error = errno;
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    LBANN_ERROR("could not map weights bundle ", path, " "
+                "(", std::strerror(error), ")");
+  }
+  return std::shared_ptr<weights_bundle>(
+    new weights_bundle(static_cast<unsigned char*>(addr), size));
+}
+
+weights_bundle::weights_bundle(unsigned char* data, size_t size)
+  : m_data(data), m_size(size) {
+  try {
+    m_entries = parse_index(data, size);
+    for (auto const& e : m_entries) {
+      const size_t tensor_size = e.height * e.width * get_type_size(e.type);
+      if (e.offset + tensor_size > size) {
+        LBANN_ERROR("weights bundle entry \"", e.name, "\" "
+                    "extends past the end of the file");
+      }
+    }
+  }
+  catch (...) {
+    ::munmap(m_data, m_size);
+    throw;
+  }
+}
+
+weights_bundle::~weights_bundle() {
+  ::munmap(m_data, m_size);
+}
+
+size_t weights_bundle::get_index_size(unsigned char const* data,
+                                      size_t size) {
+  if (size < header_size
+      || std::memcmp(data, bundle_magic, sizeof(bundle_magic)) != 0) {
+    LBANN_ERROR("invalid weights bundle header");
+  }
+  size_t pos = sizeof(bundle_magic);
+  const auto version = extract_bytes<uint32_t>(data, size, pos);
+  if (version != bundle_version) {
+    LBANN_ERROR("unsupported weights bundle version (", version, ")");
+  }
+  extract_bytes<uint32_t>(data, size, pos);
+  return extract_bytes<uint64_t>(data, size, pos);
+}
+
+auto weights_bundle::parse_index(unsigned char const* data, size_t size)
+  -> std::vector<entry> {
+  const auto index_size = get_index_size(data, size);
+  if (index_size > size) {
+    LBANN_ERROR("weights bundle index is truncated");
+  }
+  size_t pos = sizeof(bundle_magic) + sizeof(uint32_t);
+  const auto num_entries = extract_bytes<uint32_t>(data, index_size, pos);
+  pos = header_size;
+  std::vector<entry> entries(num_entries);
+  for (auto& e : entries) {
+    e.type = static_cast<data_type>(extract_bytes<uint32_t>(data, index_size, pos));
+    get_type_size(e.type);
+    const auto name_size = extract_bytes<uint32_t>(data, index_size, pos);
+    e.height = extract_bytes<uint64_t>(data, index_size, pos);
+    e.width = extract_bytes<uint64_t>(data, index_size, pos);
+    e.offset = extract_bytes<uint64_t>(data, index_size, pos);
+    if (pos + name_size > index_size) {
+      LBANN_ERROR("weights bundle index is truncated");
+    }
+    e.name.assign(reinterpret_cast<char const*>(data + pos), name_size);
+    pos += name_size;
+    if (e.offset % alignment != 0) {
+      LBANN_ERROR("weights bundle entry \"", e.name, "\" is not aligned");
+    }
+  }
+  return entries;
+}
+
+auto weights_bundle::find(std::string const& name) const -> entry const* {
+  auto it = std::find_if(m_entries.begin(), m_entries.end(),
+                         [&name](entry const& e) { return e.name == name; });
+  return it != m_entries.end() ? &(*it) : nullptr;
+}
+
+// =============================================
+// Reading and writing
+// =============================================
+
+void write_weights_bundle(model const& m, std::string const& path) {
+  auto const& comm = *m.get_comm();
+  auto const weights_list = m.get_weights();
+
+  // Lay out tensors after the index
+  std::vector<weights_bundle::entry> entries;
+  size_t index_size = weights_bundle::header_size;
+  for (auto const* w : weights_list) {
+    weights_bundle::entry e;
+    e.name = w->get_name();
+    e.type = get_type(*w);
+    e.height = w->get_matrix_height();
+    e.width = w->get_matrix_width();
+    e.offset = 0;
+    index_size += record_size + e.name.size();
+    entries.emplace_back(std::move(e));
+  }
+  size_t offset = align_offset(index_size);
+  for (auto& e : entries) {
+    e.offset = offset;
+    offset = align_offset(offset
+                          + e.height * e.width * get_type_size(e.type));
+  }
+
+  // Write header and index
+  std::ofstream ofs;
+  if (comm.am_trainer_master()) {
+    std::vector<unsigned char> index;
+    index.reserve(index_size);
+    index.insert(index.end(), bundle_magic, bundle_magic + sizeof(bundle_magic));
+    append_bytes(index, bundle_version);
+    append_bytes(index, static_cast<uint32_t>(entries.size()));
+    append_bytes(index, static_cast<uint64_t>(index_size));
+    for (auto const& e : entries) {
+      append_bytes(index, static_cast<uint32_t>(e.type));
+      append_bytes(index, static_cast<uint32_t>(e.name.size()));
+      append_bytes(index, static_cast<uint64_t>(e.height));
+      append_bytes(index, static_cast<uint64_t>(e.width));
+      append_bytes(index, static_cast<uint64_t>(e.offset));
+      index.insert(index.end(), e.name.begin(), e.name.end());
+    }
+    ofs.open(path, std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+      LBANN_ERROR("could not open ", path, " to write weights bundle");
+    }
+    ofs.write(reinterpret_cast<char const*>(index.data()), index.size());
+  }
+
+  // Write tensors
+  for (size_t i = 0; i < weights_list.size(); ++i) {
+    auto const& w = *weights_list[i];
+    if (try_write_values<float>(w, entries[i], ofs)) { continue; }
+    if (try_write_values<double>(w, entries[i], ofs)) { continue; }
+#ifdef LBANN_HAS_HALF
+    if (try_write_values<cpu_fp16>(w, entries[i], ofs)) { continue; }
+#endif // LBANN_HAS_HALF
+  }
+  if (ofs.is_open() && !ofs.flush()) {
+    LBANN_ERROR("failed to write weights bundle ", path);
+  }
+
+}
+
+namespace {
+
+/** Get the bundle index on every process.
+ *
+ *  The bundle is mapped on every process, or only on the trainer
+ *  master if the index is broadcast.
+ */
+std::vector<weights_bundle::entry>
+get_bundle_index(lbann_comm const& comm,
+                 std::string const& path,
+                 weights_bundle_access access,
+                 std::shared_ptr<weights_bundle>& bundle) {
+  if (access == weights_bundle_access::map) {
+    bundle = weights_bundle::map(path);
+    return bundle->get_entries();
+  }
+  std::vector<unsigned char> index;
+  if (comm.am_trainer_master()) {
+    bundle = weights_bundle::map(path);
+    const auto index_size = weights_bundle::get_index_size(bundle->data(),
+                                                           bundle->size());
+    index.assign(bundle->data(), bundle->data() + index_size);
+  }
+  comm.trainer_broadcast(comm.get_trainer_master(), index);
+  return weights_bundle::parse_index(index.data(), index.size());
+}
+
+/** Innermost restore scope. */
+weights_bundle_restore_scope* current_restore_scope_ = nullptr;
+
+} // namespace <anon>
+
+size_t read_weights_bundle(model& m,
+                           std::string const& path,
+                           weights_bundle_access access) {
+  auto const& comm = *m.get_comm();
+
+  // Get index on every process
+  std::shared_ptr<weights_bundle> bundle;
+  const auto entries = get_bundle_index(comm, path, access, bundle);
+  std::unordered_map<std::string, weights_bundle::entry const*> entry_map;
+  for (auto const& e : entries) {
+    entry_map[e.name] = &e;
+  }
+
+  // Restore values
+  size_t num_restored = 0;
+  for (auto* w : m.get_weights()) {
+    auto it = entry_map.find(w->get_name());
+    if (it == entry_map.end()) {
+      continue;
+    }
+    auto const& e = *it->second;
+    if (try_read_values<float>(*w, e, bundle, access, comm)
+        || try_read_values<double>(*w, e, bundle, access, comm)
+#ifdef LBANN_HAS_HALF
+        || try_read_values<cpu_fp16>(*w, e, bundle, access, comm)
+#endif // LBANN_HAS_HALF
+      ) {
+      ++num_restored;
+    }
+  }
+  return num_restored;
+
+}
+
+weights_bundle_restore_scope::weights_bundle_restore_scope(
+  lbann_comm const& comm,
+  std::string path,
+  weights_bundle_access access)
+  : m_path{std::move(path)},
+    m_access{access},
+    m_parent{current_restore_scope_} {
+  std::shared_ptr<weights_bundle> bundle;
+  for (auto const& e : get_bundle_index(comm, m_path, m_access, bundle)) {
+    m_names.insert(e.name);
+  }
+  current_restore_scope_ = this;
+}
+
+weights_bundle_restore_scope::~weights_bundle_restore_scope() {
+  current_restore_scope_ = m_parent;
+}
+
+bool weights_bundle_restore_scope::skip_values(std::string const& name) {
+  auto* scope = current_restore_scope_;
+  if (scope == nullptr || scope->m_names.count(name) == 0) {
+    return false;
+  }
+  ++scope->m_num_skipped;
+  return true;
+}
+
+size_t weights_bundle_restore_scope::restore(model& m) {
+  const auto num_restored = read_weights_bundle(m, m_path, m_access);
+  if (num_restored < m_num_skipped) {
+    LBANN_ERROR("skipped loading the values of ", m_num_skipped, " weights ",
+                "since they are in the weights bundle \"", m_path, "\", ",
+                "but only ", num_restored, " could be restored from it");
+  }
+  return num_restored;
+}
+
+} // namespace lbann
@@ -32,8 +32,10 @@
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/hydrogen_utils.hpp"
 #include "lbann/utils/summary_impl.hpp"
 #include "lbann/utils/tensor_impl.hpp"
+#include "lbann/weights/weights.hpp"
 
 namespace lbann {
 
@@ -219,6 +221,130 @@ summarize_matrices(lbann_summary& summarizer, int step) {
 
 }
 
+template <typename InputTensorDataType, typename OutputTensorDataType>
+bool data_type_layer<InputTensorDataType, OutputTensorDataType>::
+has_viewing_activations() const {
+  for (const auto& output : m_outputs) {
+    if (output && output->Viewing()) { return true; }
+  }
+  return false;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+size_t data_type_layer<InputTensorDataType, OutputTensorDataType>::
+release_activations(bool release_outputs) {
+  size_t bytes = 0;
+  for (auto& input : m_inputs) {
+    if (!input) { continue; }
+    if (!input->Viewing()) {
+      bytes += (input->LocalHeight() * input->LocalWidth()
+                * sizeof(InputTensorDataType));
+    }
+    input->Empty(true);
+  }
+  if (release_outputs) {
+    for (auto& output : m_outputs) {
+      if (!output) { continue; }
+      if (!output->Viewing()) {
+        bytes += (output->LocalHeight() * output->LocalWidth()
+                  * sizeof(OutputTensorDataType));
+      }
+      output->Empty(true);
+    }
+  }
+  return bytes;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+size_t data_type_layer<InputTensorDataType, OutputTensorDataType>::
+get_host_activations_bytes() const {
+  size_t bytes = 0;
+  for (const auto& input : m_inputs) {
+    bytes += get_host_memory_bytes(input.get());
+  }
+  for (const auto& output : m_outputs) {
+    bytes += get_host_memory_bytes(output.get());
+  }
+  return bytes;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+size_t data_type_layer<InputTensorDataType, OutputTensorDataType>::
+get_host_error_signals_bytes() const {
+  size_t bytes = 0;
+  for (const auto& grad : m_gradient_wrt_outputs) {
+    bytes += get_host_memory_bytes(grad.get());
+  }
+  for (const auto& grad : m_gradient_wrt_inputs) {
+    bytes += get_host_memory_bytes(grad.get());
+  }
+  return bytes;
+}
+
+namespace {
+
+/** Total entries per sample in a layer's input tensors. */
+double get_input_entries(const Layer& l) {
+  double entries = 0;
+  for (int i = 0; i < l.get_num_parents(); ++i) {
+    entries += l.get_input_size(i);
+  }
+  return entries;
+}
+
+/** Total entries per sample in a layer's output tensors. */
+double get_output_entries(const Layer& l) {
+  double entries = 0;
+  for (int i = 0; i < l.get_num_children(); ++i) {
+    entries += l.get_output_size(i);
+  }
+  return entries;
+}
+
+/** Total entries in a layer's weights. */
+double get_weights_entries(const Layer& l) {
+  double entries = 0;
+  for (size_t i = 0; i < l.num_weights(); ++i) {
+    if (l.has_weights(i)) {
+      entries += l.get_weights(i).get_size();
+    }
+  }
+  return entries;
+}
+
+} // namespace
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+double data_type_layer<InputTensorDataType, OutputTensorDataType>::
+get_fp_flops(El::Int mini_batch_size) const {
+  return mini_batch_size * get_output_entries(*this);
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+double data_type_layer<InputTensorDataType, OutputTensorDataType>::
+get_bp_flops(El::Int mini_batch_size) const {
+  return 2 * mini_batch_size * get_input_entries(*this);
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+double data_type_layer<InputTensorDataType, OutputTensorDataType>::
+get_fp_bytes(El::Int mini_batch_size) const {
+  // Read inputs and weights, write outputs
+  return (mini_batch_size * get_input_entries(*this) * sizeof(InputTensorDataType)
+          + mini_batch_size * get_output_entries(*this) * sizeof(OutputTensorDataType)
+          + get_weights_entries(*this) * sizeof(OutputTensorDataType));
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+double data_type_layer<InputTensorDataType, OutputTensorDataType>::
+get_bp_bytes(El::Int mini_batch_size) const {
+  // Read inputs, output gradients, and weights, write input
+  // gradients and weights gradients
+  return (2 * mini_batch_size * get_input_entries(*this) * sizeof(InputTensorDataType)
+          + mini_batch_size * get_output_entries(*this) * sizeof(OutputTensorDataType)
+          + 2 * get_weights_entries(*this) * sizeof(OutputTensorDataType));
+}
+
 // ===================================================================
 // Tensor access functions
 // ===================================================================
@@ -624,6 +750,15 @@ fp_setup_outputs(El::Int mini_batch_size) {
     auto& output = get_activations(i);
     output.Empty(false);
     if (align_outputs) { output.AlignWith(alignment_dist); }
+
+    // Write directly into child's memory if possible
+    using child_type = data_type_layer<OutputTensorDataType>;
+    const auto* child = dynamic_cast<const child_type*>(&get_child_layer(i));
+    if (child != nullptr
+        && child->view_parent_output_in_place(*this, output, mini_batch_size)) {
+      continue;
+    }
+
     output.Resize(get_output_size(i), mini_batch_size);
   }
 
@@ -666,7 +801,10 @@ view_or_copy_prev_error_signal_(
 
   // If the distributions are compatible, we can just view
   // things. Otherwise, deep-copy the data.
+  // Note: Previous error signals may still view the last step's
+  // data if they are kept after back prop.
   auto& prev_error_sig = *m_gradient_wrt_outputs[layer_idx];
+  if (prev_error_sig.Viewing()) { prev_error_sig.Empty(false); }
   view_or_copy_tensor(signal, prev_error_sig);
 }
 
@@ -708,7 +846,9 @@ move_or_copy_prev_error_signal_(
           this->get_device_allocation())->MakeEmpty(*expected_distdata.grid, 0);
     }
 
-    do_tensor_copy(signal, *m_gradient_wrt_outputs[layer_idx]);
+    auto& prev_error_sig = *m_gradient_wrt_outputs[layer_idx];
+    if (prev_error_sig.Viewing()) { prev_error_sig.Empty(false); }
+    do_tensor_copy(signal, prev_error_sig);
   }
 }
 
@@ -730,13 +870,14 @@ deep_copy_prev_error_signal_(
   // If the distributions are compatible, we can just view
   // things. Otherwise, deep-copy the data.
   auto& prev_error_sig = *m_gradient_wrt_outputs[layer_idx];
+  if (prev_error_sig.Viewing()) { prev_error_sig.Empty(false); }
   do_tensor_copy(signal, prev_error_sig);
 }
 
 template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType, OutputTensorDataType>::
 clear_prev_error_signals_() {
-  if (!m_persistent_error_signals) {
+  if (!m_persistent_error_signals && !keep_prev_error_signals()) {
     for (auto& es : m_gradient_wrt_outputs)
       es->Empty(true);
   }
@@ -772,11 +913,13 @@ propagate_error_signals_to_parents_() {
     auto& parent = const_cast<Layer&>(get_parent_layer(i));
 
     // If my error signals persist, my parent can always view them,
-    // assuming the distdata is right. Otherwise, my views and my data
-    // will be released. Views must be copied and owned data can
+    // assuming the distdata is right. The same holds for views into
+    // previous error signals that I keep. Otherwise, my views and my
+    // data will be released. Views must be copied and owned data can
     // either be copied or swapped out.
     auto& error_signal = *m_gradient_wrt_inputs[i];
-    if (m_persistent_error_signals)
+    if (m_persistent_error_signals
+        || (error_signal.Viewing() && keep_prev_error_signals()))
       attempt_view_error_signal(parent, *this, error_signal);
     else if (error_signal.Viewing())
       deep_copy_error_signal(parent, *this, error_signal);
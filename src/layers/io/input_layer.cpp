@@ -140,10 +140,27 @@ template <typename TensorDataType,
           El::Device Dev>
 void input_layer<TensorDataType, T_layout, Dev>::
 set_samples(const El::AbstractDistMatrix<TensorDataType>& samples) {
-  El::Copy(samples, this->get_activations(0));
+  // Do not write into a view of the data coordinator's buffers
+  auto& activations = this->get_activations(0);
+  if (activations.Viewing()) { activations.Empty(); }
+  El::Copy(samples, activations);
   this->m_samples_loaded = true;
 }
 
+template <typename TensorDataType,
+          data_layout T_layout,
+          El::Device Dev>
+void input_layer<TensorDataType, T_layout, Dev>::
+set_targets(const El::AbstractDistMatrix<TensorDataType>& targets) {
+  if (this->get_num_children() < 2) {
+    LBANN_ERROR(this->get_type(), " layer \"", this->get_name(), "\" ",
+                "has no output for labels or responses");
+  }
+  auto& activations = this->get_activations(1);
+  if (activations.Viewing()) { activations.Empty(); }
+  El::Copy(targets, activations);
+}
+
 template <typename TensorDataType,
           data_layout T_layout,
           El::Device Dev>
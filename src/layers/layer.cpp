@@ -77,7 +77,8 @@ Layer::Layer(const Layer& other) :
   m_child_layers(other.m_child_layers),
   m_weights(other.m_weights),
   m_output_dims_list(other.m_output_dims_list),
-  m_hint_layer(other.m_hint_layer) {
+  m_hint_layer(other.m_hint_layer),
+  m_checkpoint_segment(other.m_checkpoint_segment) {
 }
 
 Layer& Layer::operator=(const Layer& other) {
@@ -98,6 +99,7 @@ Layer& Layer::operator=(const Layer& other) {
   m_weights = other.m_weights;
   m_output_dims_list = other.m_output_dims_list;
   m_hint_layer = other.m_hint_layer;
+  m_checkpoint_segment = other.m_checkpoint_segment;
 
   return *this;
 }
@@ -206,6 +206,13 @@ base_convolution_layer<TensorDataType,Device>::get_description() const {
   return desc;
 }
 
+template <typename TensorDataType, El::Device Device>
+double
+base_convolution_layer<TensorDataType,Device>
+::get_bp_flops(El::Int mini_batch_size) const {
+  return 2 * this->get_fp_flops(mini_batch_size);
+}
+
 template <typename TensorDataType, El::Device Device>
 void
 base_convolution_layer<TensorDataType,Device>
@@ -28,10 +28,17 @@
 #include "lbann/layers/learning/base_convolution.hpp"
 #include "lbann/layers/learning/convolution.hpp"
 
+#include "lbann/models/model.hpp"
 #include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/im2col.hpp"
+#include "lbann/weights/initializer.hpp"
 
 #include <layers.pb.h>
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
 namespace lbann {
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -105,6 +112,25 @@ void convolution_layer<TensorDataType,Layout,Device>
   this->set_output_dims(output_dims);
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+double convolution_layer<TensorDataType,Layout,Device>
+::get_fp_flops(El::Int mini_batch_size) const {
+  using ScalingType =
+    typename base_convolution_layer<TensorDataType, Device>::ScalingType;
+  // Each output entry is a dot product over a kernel slice
+  const auto kernel_dims = get_kernel_dims();
+  const double kernel_slice_size = std::accumulate(kernel_dims.begin() + 1,
+                                                   kernel_dims.end(),
+                                                   1.0,
+                                                   std::multiplies<double>());
+  const double output_size = mini_batch_size * this->get_output_size();
+  double flops = 2 * output_size * kernel_slice_size;
+  if (this->m_bias_scaling_factor != El::TypeTraits<ScalingType>::Zero()) {
+    flops += output_size;
+  }
+  return flops;
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 std::vector<int> convolution_layer<TensorDataType,Layout,Device>
 ::get_kernel_dims() const {
@@ -117,9 +143,153 @@ std::vector<int> convolution_layer<TensorDataType,Layout,Device>
   return dims;
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+float convolution_layer<TensorDataType,Layout,Device>::get_local_input_range() const {
+  if constexpr (Device == El::Device::CPU) {
+    return max_abs(this->get_local_prev_activations());
+  }
+  return 0.f;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool convolution_layer<TensorDataType,Layout,Device>::enable_int8_inference(
+  float input_range) {
+  if constexpr (Device == El::Device::CPU) {
+    // Kernel is stored with one column per output channel
+    const auto& local_kernel = this->weights_values(0).LockedMatrix();
+    const El::Int num_channels = this->get_output_dims()[0];
+    const El::Int k = local_kernel.Height() * local_kernel.Width() / num_channels;
+    const CPUMatDT<TensorDataType> kernel_matrix(
+      k, num_channels, local_kernel.LockedBuffer(), k);
+    quantize_int8_per_channel(kernel_matrix, true, m_int8_kernel);
+    m_int8_input_scale = (input_range > 0.f ? input_range / 127.f : 1.f);
+    m_int8_inference = true;
+    return true;
+  }
+  return false;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool convolution_layer<TensorDataType,Layout,Device>::fold_channel_affine(
+  const std::vector<double>& scale,
+  const std::vector<double>& shift) {
+  using WeightsType = data_type_weights<TensorDataType>;
+  using ScalingType =
+    typename base_convolution_layer<TensorDataType, Device>::ScalingType;
+  if (scale.size() != static_cast<size_t>(this->m_output_channels)
+      || shift.size() != scale.size()) {
+    return false;
+  }
+
+  // Kernel is stored with one contiguous block per output channel
+  auto& kernel = dynamic_cast<WeightsType&>(this->get_weights(0));
+  apply_channel_affine(kernel.get_values(), scale, {}, false);
+
+  // Bias is scaled by the bias scaling factor in forward prop
+  const auto bias_scale = El::To<double>(this->m_bias_scaling_factor);
+  if (bias_scale != 0.0 && this->num_weights() > 1) {
+    std::vector<double> bias_shift(shift);
+    for (auto& b : bias_shift) { b /= bias_scale; }
+    auto& bias = dynamic_cast<WeightsType&>(this->get_weights(1));
+    apply_channel_affine(bias.get_values(), scale, bias_shift, false);
+  }
+  else {
+    std::vector<TensorDataType> bias_values(shift.size());
+    std::transform(shift.begin(), shift.end(), bias_values.begin(),
+                   [](double b) { return El::To<TensorDataType>(b); });
+    auto w = std::make_shared<WeightsType>(*this->get_comm());
+    w->set_name(this->get_name() + "_bias");
+    w->set_initializer(
+      make_unique<value_initializer<TensorDataType>>(std::move(bias_values)));
+    this->m_bias_scaling_factor = El::TypeTraits<ScalingType>::One();
+    this->set_num_weights(2);
+    this->set_weights(1, w);
+    this->m_model->add_weights(std::move(w));
+  }
+  return true;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void convolution_layer<TensorDataType,Layout,Device>::disable_int8_inference() {
+  m_int8_inference = false;
+  m_int8_kernel.clear();
+  m_int8_input_workspace.clear();
+  m_int8_output_workspace.clear();
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void convolution_layer<TensorDataType,Layout,Device>::fp_compute_int8() {
+  if constexpr (Device == El::Device::CPU) {
+
+    // Local matrices
+    const auto& local_input = this->get_local_prev_activations();
+    auto& local_output = this->get_local_activations();
+    const El::Int local_width = local_input.Width();
+
+    // Matrix parameters
+    const auto& input_dims = this->get_input_dims();
+    const auto& output_dims = this->get_output_dims();
+    const auto& kernel_dims = this->get_kernel_dims();
+    const El::Int n = output_dims[0];
+    const El::Int m = this->get_output_size() / n;
+    const El::Int k = m_int8_kernel.height;
+    CPUMatDT<TensorDataType> input_col;
+    CPUMatDT<TensorDataType> im2col_matrix(k, m);
+    const auto& scales = m_int8_kernel.scales;
+    auto& products = m_int8_output_workspace;
+    products.resize(m * n);
+
+    // Iterate through input columns
+    for (El::Int col = 0; col < local_width; ++col) {
+
+      // Quantize im2col matrix from current input column
+      El::LockedView(input_col, local_input, El::ALL, El::IR(col));
+      im2col<TensorDataType>(input_col,
+                             im2col_matrix,
+                             input_dims[0],
+                             input_dims.size() - 1,
+                             &input_dims[1],
+                             this->m_pads.data(),
+                             &kernel_dims[2],
+                             this->m_strides.data());
+      quantize_int8(im2col_matrix, m_int8_input_scale, m_int8_input_workspace);
+
+      // Apply quantized convolution and dequantize
+      int8_gemm(El::TRANSPOSE, El::NORMAL,
+                m, n, k,
+                m_int8_input_workspace.data(), k,
+                m_int8_kernel.values.data(), k,
+                products.data(), m);
+      auto* __restrict__ output_buffer = local_output.Buffer(0, col);
+      LBANN_OMP_PARALLEL_FOR
+      for (El::Int channel = 0; channel < n; ++channel) {
+        const float scale = scales[channel] * m_int8_input_scale;
+        for (El::Int i = channel*m; i < (channel+1)*m; ++i) {
+          output_buffer[i] = TensorDataType(static_cast<float>(products[i]) * scale);
+        }
+      }
+
+    }
+
+    this->apply_bias_cpu();
+
+  }
+  else {
+    LBANN_ERROR(this->get_type()," layer \"",this->get_name(),"\" ",
+                "does not support int8 inference");
+  }
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void convolution_layer<TensorDataType,Layout,Device>::fp_compute() {
   using BaseConvLayer = base_convolution_layer<TensorDataType, Device>;
+  if (m_int8_inference) {
+    const auto& mode = this->m_model->get_execution_context().get_execution_mode();
+    if (mode != execution_mode::training) {
+      fp_compute_int8();
+      return;
+    }
+  }
   if(this->using_gpus()) {
 #ifdef LBANN_HAS_DISTCONV
     if (this->distconv_enabled()) {
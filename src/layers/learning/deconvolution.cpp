@@ -29,6 +29,8 @@
 #include "lbann/layers/learning/deconvolution.hpp"
 #include "lbann/utils/exception.hpp"
 
+#include <functional>
+#include <numeric>
 #include <sstream>
 #include <string>
 
@@ -128,6 +130,26 @@ deconvolution_layer<TensorDataType,Layout,Device>
 
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+double
+deconvolution_layer<TensorDataType,Layout,Device>
+::get_fp_flops(El::Int mini_batch_size) const {
+  using ScalingType =
+    typename base_convolution_layer<TensorDataType, Device>::ScalingType;
+  // Each input entry is scattered through a kernel slice
+  const auto kernel_dims = get_kernel_dims();
+  const double kernel_slice_size = std::accumulate(kernel_dims.begin() + 1,
+                                                   kernel_dims.end(),
+                                                   1.0,
+                                                   std::multiplies<double>());
+  const double input_size = mini_batch_size * this->get_input_size();
+  double flops = 2 * input_size * kernel_slice_size;
+  if (this->m_bias_scaling_factor != El::TypeTraits<ScalingType>::Zero()) {
+    flops += mini_batch_size * this->get_output_size();
+  }
+  return flops;
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 std::vector<int>
 deconvolution_layer<TensorDataType,Layout,Device>
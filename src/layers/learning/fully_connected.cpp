@@ -66,7 +66,10 @@ fully_connected_layer<TensorDataType, T_layout, Dev>::fully_connected_layer(
   const fully_connected_layer& other)
   : data_type_layer<TensorDataType>(other),
   m_bias_scaling_factor(other.m_bias_scaling_factor),
-  m_transpose(other.m_transpose) {
+  m_transpose(other.m_transpose),
+  m_int8_inference(other.m_int8_inference),
+  m_int8_input_scale(other.m_int8_input_scale),
+  m_int8_linearity(other.m_int8_linearity) {
 
   // Deep matrix copies
   m_bias_gradient = other.m_bias_gradient;
@@ -81,6 +84,9 @@ auto fully_connected_layer<TensorDataType, T_layout, Dev>::operator=(
   data_type_layer<TensorDataType>::operator=(other);
   m_bias_scaling_factor = other.m_bias_scaling_factor;
   m_transpose = other.m_transpose;
+  m_int8_inference = other.m_int8_inference;
+  m_int8_input_scale = other.m_int8_input_scale;
+  m_int8_linearity = other.m_int8_linearity;
 
   // Deep matrix copies
   deallocate_matrices();
@@ -105,9 +111,159 @@ fully_connected_layer<TensorDataType, T_layout, Dev>::get_description() const {
                           ? "disabled"
                           : "enabled");
   desc.add("Bias", bias_str);
+  if (m_int8_inference) {
+    desc.add("Int8 inference", "enabled");
+  }
   return desc;
 }
 
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+double fully_connected_layer<TensorDataType, T_layout, Dev>
+::get_fp_flops(El::Int mini_batch_size) const {
+  const double output_size = mini_batch_size * this->get_output_size();
+  double flops = 2 * output_size * this->get_input_size();
+  if (m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero()) {
+    flops += output_size;
+  }
+  return flops;
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+double fully_connected_layer<TensorDataType, T_layout, Dev>
+::get_bp_flops(El::Int mini_batch_size) const {
+  // Data and linearity gradients each cost as much as forward prop
+  return 2 * get_fp_flops(mini_batch_size);
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+float fully_connected_layer<TensorDataType, T_layout, Dev>
+::get_local_input_range() const {
+  if constexpr (Dev == El::Device::CPU) {
+    return max_abs(this->get_local_prev_activations());
+  }
+  return 0.f;
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+bool fully_connected_layer<TensorDataType, T_layout, Dev>
+::enable_int8_inference(float input_range) {
+  if constexpr (Dev == El::Device::CPU
+                && T_layout == data_layout::DATA_PARALLEL) {
+    // Channels are rows of W, or columns of W^T
+    quantize_int8_per_channel(this->weights_values(0).LockedMatrix(),
+                              m_transpose,
+                              m_int8_linearity);
+    m_int8_input_scale = (input_range > 0.f ? input_range / 127.f : 1.f);
+    m_int8_inference = true;
+    return true;
+  }
+  return false;
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+bool fully_connected_layer<TensorDataType, T_layout, Dev>
+::fold_channel_affine(const std::vector<double>& scale,
+                      const std::vector<double>& shift) {
+
+  // Channels are rows of W, or columns of W^T
+  auto& linearity = dynamic_cast<WeightsType&>(this->get_weights(0));
+  auto& linearity_values = linearity.get_values();
+  const size_t output_size = (m_transpose
+                              ? linearity_values.Width()
+                              : linearity_values.Height());
+  if (scale.empty()
+      || shift.size() != scale.size()
+      || output_size % scale.size() != 0) {
+    return false;
+  }
+  apply_channel_affine(linearity_values, scale, {}, m_transpose);
+
+  // Bias is scaled by the bias scaling factor in forward prop
+  const auto bias_scale = El::To<double>(m_bias_scaling_factor);
+  if (bias_scale != 0.0 && this->num_weights() > 1) {
+    std::vector<double> bias_shift(shift);
+    for (auto& b : bias_shift) { b /= bias_scale; }
+    auto& bias = dynamic_cast<WeightsType&>(this->get_weights(1));
+    apply_channel_affine(bias.get_values(), scale, bias_shift, false);
+  }
+  else {
+    const size_t channel_size = output_size / scale.size();
+    std::vector<TensorDataType> bias_values(output_size);
+    for (size_t i = 0; i < output_size; ++i) {
+      bias_values[i] = El::To<TensorDataType>(shift[i / channel_size]);
+    }
+    auto w = std::make_shared<WeightsType>(*this->get_comm());
+    w->set_name(this->get_name() + "_bias_weights");
+    w->set_initializer(
+      make_unique<value_initializer<TensorDataType>>(std::move(bias_values)));
+    m_bias_scaling_factor = El::TypeTraits<TensorDataType>::One();
+    this->set_num_weights(2);
+    this->set_weights(1, w);
+    this->m_model->add_weights(std::move(w));
+  }
+  return true;
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void fully_connected_layer<TensorDataType, T_layout, Dev>
+::disable_int8_inference() {
+  m_int8_inference = false;
+  m_int8_linearity.clear();
+  m_int8_input_workspace.clear();
+  m_int8_output_workspace.clear();
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void fully_connected_layer<TensorDataType, T_layout, Dev>
+::fp_compute_int8() {
+  if constexpr (Dev == El::Device::CPU
+                && T_layout == data_layout::DATA_PARALLEL) {
+
+    // Matrices
+    const auto& local_input = this->get_local_prev_activations();
+    auto& local_output = this->get_local_activations();
+    const El::Int input_size = local_input.Height();
+    const El::Int output_size = local_output.Height();
+    const El::Int local_width = local_input.Width();
+
+    // Apply quantized linearity
+    quantize_int8(local_input, m_int8_input_scale, m_int8_input_workspace);
+    m_int8_output_workspace.resize(output_size * local_width);
+    int8_gemm(m_transpose ? El::TRANSPOSE : El::NORMAL,
+              El::NORMAL,
+              output_size, local_width, input_size,
+              m_int8_linearity.values.data(), m_int8_linearity.height,
+              m_int8_input_workspace.data(), input_size,
+              m_int8_output_workspace.data(), output_size);
+
+    // Dequantize and apply bias if needed
+    const bool has_bias = (m_bias_scaling_factor
+                           != El::TypeTraits<TensorDataType>::Zero());
+    const auto* local_bias = (has_bias
+                              ? &this->weights_values(1).LockedMatrix()
+                              : nullptr);
+    const auto& scales = m_int8_linearity.scales;
+    const auto& products = m_int8_output_workspace;
+    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+    for (El::Int col = 0; col < local_width; ++col) {
+      for (El::Int row = 0; row < output_size; ++row) {
+        const float z = (static_cast<float>(products[row+col*output_size])
+                         * scales[row] * m_int8_input_scale);
+        auto& y = local_output(row, col);
+        y = TensorDataType(z);
+        if (has_bias) {
+          y += m_bias_scaling_factor * (*local_bias)(row, 0);
+        }
+      }
+    }
+
+  }
+  else {
+    LBANN_ERROR(this->get_type()," layer \"",this->get_name(),"\" ",
+                "does not support int8 inference");
+  }
+}
+
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 void fully_connected_layer<TensorDataType, T_layout, Dev>
 ::setup_matrices(const El::Grid& grid) {
@@ -637,6 +793,13 @@ void bp_compute_impl(fully_connected_layer<TensorDataType, data_layout::MODEL_PA
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 void fully_connected_layer<TensorDataType, T_layout, Dev>::fp_compute() {
+  if (m_int8_inference) {
+    const auto& mode = this->m_model->get_execution_context().get_execution_mode();
+    if (mode != execution_mode::training) {
+      fp_compute_int8();
+      return;
+    }
+  }
   fp_compute_impl<TensorDataType>(*this);
 }
 
@@ -125,6 +125,32 @@ gru_layer<TensorDataType,Layout,Device>
   return desc;
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+double
+gru_layer<TensorDataType,Layout,Device>
+::get_fp_flops(El::Int mini_batch_size) const
+{
+  const double sequence_length = this->get_input_dims(0)[0];
+  const double input_size = this->get_input_size(0) / sequence_length;
+  const double hidden_size = m_hidden_size;
+  double flops_per_step = 0;
+  for (size_t i = 0; i < m_num_layers; ++i) {
+    const double cell_input_size = (i == 0 ? input_size : hidden_size);
+    flops_per_step += 2 * 3 * hidden_size * (cell_input_size + hidden_size);
+    flops_per_step += 12 * hidden_size;
+  }
+  return mini_batch_size * sequence_length * flops_per_step;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+double
+gru_layer<TensorDataType,Layout,Device>
+::get_bp_flops(El::Int mini_batch_size) const
+{
+  // Data and weights gradients each cost as much as forward prop
+  return 2 * get_fp_flops(mini_batch_size);
+}
+
 // =========================================================
 // Setup
 // =========================================================
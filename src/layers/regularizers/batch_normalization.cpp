@@ -29,8 +29,66 @@
 #include "lbann/layers/regularizers/batch_normalization.hpp"
 #include "lbann/weights/weights_helpers.hpp"
 
+#include <type_traits>
+#include <vector>
+
 namespace lbann {
 
+namespace {
+
+/** @brief Number of mini-batch samples per accumulation block.
+ *
+ *  Partial sums are accumulated per block of samples before being
+ *  added to the channel totals, which bounds the rounding error
+ *  growth compared to a single running sum.
+ */
+constexpr El::Int sample_block_size = 16;
+
+/** Whether Aluminum's host backend can reduce this type. */
+template <typename TensorDataType>
+constexpr bool supports_nb_allreduce =
+  std::is_same<TensorDataType, float>::value
+  || std::is_same<TensorDataType, double>::value;
+
+/** Range of channels in a pipeline block. */
+El::IR get_channel_block(El::Int block,
+                         El::Int num_blocks,
+                         El::Int num_channels) {
+  const El::Int start = (block * num_channels) / num_blocks;
+  const El::Int end = ((block+1) * num_channels) / num_blocks;
+  return El::IR(start, end);
+}
+
+/** @brief Start reduction of a block of rows in a fused buffer.
+ *
+ *  The fused buffers have two columns (e.g. means and variances), so
+ *  a block of rows is reduced as two contiguous ranges. Types that
+ *  Aluminum cannot reduce fall back to a blocking allreduce.
+ */
+template <typename TensorDataType>
+void start_block_allreduce(lbann_comm& comm,
+                           El::AbstractMatrix<TensorDataType>& local_buffer,
+                           const El::IR& rows,
+                           const El::mpi::Comm& c,
+                           Al::request* reqs) {
+  const El::Int count = rows.end - rows.beg;
+  if (count < 1) {
+    return;
+  }
+  if constexpr (supports_nb_allreduce<TensorDataType>) {
+    comm.nb_allreduce(local_buffer.Buffer(rows.beg, 0), count, c, reqs[0]);
+    comm.nb_allreduce(local_buffer.Buffer(rows.beg, 1), count, c, reqs[1]);
+  } else {
+    El::Matrix<TensorDataType, El::Device::CPU> block;
+    El::View(block,
+             static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(local_buffer),
+             rows, El::ALL);
+    comm.allreduce(block, c, El::mpi::SUM);
+  }
+}
+
+} // namespace
+
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute() {
   const TensorDataType zero = El::TypeTraits<TensorDataType>::Zero();
@@ -41,6 +99,8 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute() {
   const auto& input = this->get_prev_activations();
   const auto& local_input = input.LockedMatrix();
   auto& local_output = this->get_local_activations();
+  const auto& local_scale = this->weights_values(0).LockedMatrix();
+  const auto& local_bias = this->weights_values(1).LockedMatrix();
 
   // Matrix parameters
   const auto& width = input.Width();
@@ -49,113 +109,137 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute() {
   const auto& num_channels = output_dims[0];
   const auto& channel_size = this->get_output_size() / num_channels;
 
-  // Compute statistics
-  if (is_training) {
-    using ValuesGetter = weights_details::SafeWeightsAccessor<TensorDataType>;
-    // Local matrices
-    auto& local_mean = this->m_mean_v->Matrix();
-    auto& local_var = this->m_var_v->Matrix();
-    auto& local_running_mean =
-      ValuesGetter::mutable_values(this->get_weights(2)).Matrix();
-    auto& local_running_var =
-      ValuesGetter::mutable_values(this->get_weights(3)).Matrix();
-    // Compute sums and sums of squares
-    LBANN_OMP_PARALLEL_FOR
-    for (El::Int channel = 0; channel < num_channels; ++channel) {
-      TensorDataType sum = zero;
-      TensorDataType sqsum = zero;
-      const auto& row_start = channel * channel_size;
-      const auto& row_end = (channel+1) * channel_size;
+  // Apply batch normalization to a block of channels.
+  // Normalization, scaling and bias are fused into a single affine
+  // transform per channel.
+  auto apply_normalization = [&](const El::IR& channels,
+                                 const El::AbstractMatrix<TensorDataType>& local_mean,
+                                 const El::AbstractMatrix<TensorDataType>& local_var) {
+    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+    for (El::Int channel = channels.beg; channel < channels.end; ++channel) {
       for (El::Int col = 0; col < local_width; ++col) {
+        const auto& mean = local_mean(channel, 0);
+        const auto& var = local_var(channel, 0);
+        const TensorDataType inv_stdev = static_cast<TensorDataType>(1 / El::Sqrt(var + this->m_epsilon));
+        const auto a = local_scale(channel, 0) * inv_stdev;
+        const auto b = local_bias(channel, 0) - a * mean;
+        const auto& row_start = channel * channel_size;
+        const auto& row_end = (channel+1) * channel_size;
         for (El::Int row = row_start; row < row_end; ++row) {
-          const auto& x = local_input(row, col);
-          sum += x;
-          sqsum += x * x;
+          local_output(row, col) = a * local_input(row, col) + b;
         }
       }
-      local_mean(channel, 0) = sum;
-      local_var(channel, 0) = sqsum;
     }
-    El::Int num_per_sum;
-    if (this->m_statistics_group_size == 0) {
-      // Global statistics aggregation; allreduce on fused buffer.
-      this->get_comm()->allreduce(*this->m_mean_and_var, this->m_mean_and_var->RedundantComm(),
-                        El::mpi::SUM);
-      num_per_sum = channel_size * width;
-    } else if (this->m_statistics_group_size == 1) {
-      // Local aggregation, no allreduce needed.
+  };
+
+  // Inference uses running statistics
+  if (!is_training) {
+    apply_normalization(El::IR(0, num_channels),
+                        this->weights_values(2).LockedMatrix(),
+                        this->weights_values(3).LockedMatrix());
+    return;
+  }
+
+  using ValuesGetter = weights_details::SafeWeightsAccessor<TensorDataType>;
+  auto& local_mean_and_var = this->m_mean_and_var->Matrix();
+  auto& local_mean = this->m_mean_v->Matrix();
+  auto& local_var = this->m_var_v->Matrix();
+  auto& local_running_mean =
+    ValuesGetter::mutable_values(this->get_weights(2)).Matrix();
+  auto& local_running_var =
+    ValuesGetter::mutable_values(this->get_weights(3)).Matrix();
+
+  // Determine how statistics are aggregated
+  auto& comm = *this->get_comm();
+  const El::mpi::Comm* stats_comm = nullptr;
+  El::Int num_per_sum;
+  if (this->m_statistics_group_size == 0) {
+    // Global statistics aggregation
+    stats_comm = &this->m_mean_and_var->RedundantComm();
+    num_per_sum = channel_size * width;
+  } else if (this->m_statistics_group_size == 1) {
+    // Local aggregation, no allreduce needed
+    num_per_sum = channel_size * local_width;
+  } else {
+    // Grouped batchnorm
+    stats_comm = &comm.get_packed_group_comm(this->m_statistics_group_size);
+    if (this->m_num_per_sum_cache.count(width) == 0) {
       num_per_sum = channel_size * local_width;
+      num_per_sum = comm.allreduce(num_per_sum, *stats_comm);
+      this->m_num_per_sum_cache[width] = num_per_sum;
     } else {
-      // Grouped batchnorm. Allreduce on fused buffer.
-      this->get_comm()->allreduce(*this->m_mean_and_var,
-                        this->get_comm()->get_packed_group_comm(this->m_statistics_group_size),
-                        El::mpi::SUM);
-      if (this->m_num_per_sum_cache.count(width) == 0) {
-        num_per_sum = channel_size * local_width;
-        num_per_sum = this->get_comm()->allreduce(
-          num_per_sum, this->get_comm()->get_packed_group_comm(this->m_statistics_group_size));
-        this->m_num_per_sum_cache[width] = num_per_sum;
-      } else {
-        num_per_sum = this->m_num_per_sum_cache[width];
-      }
+      num_per_sum = this->m_num_per_sum_cache[width];
     }
+  }
+  const El::Int num_blocks = (stats_comm == nullptr ?
+                              1 :
+                              std::min<El::Int>(m_max_num_channel_blocks, num_channels));
+  std::vector<Al::request> reqs(2*num_blocks);
 
-    // Compute minibatch statistics
-    if (num_per_sum <= 1) {
-      El::Fill(local_var, one);
-    } else {
-      LBANN_OMP_PARALLEL_FOR
-      for (El::Int channel = 0; channel < num_channels; ++channel) {
-        auto num_per_sum_dt = El::To<TensorDataType>(num_per_sum);
-        const auto& mean = local_mean(channel, 0) / num_per_sum_dt;
-        const auto& sqmean = local_var(channel, 0) / num_per_sum_dt;
-        auto var = num_per_sum_dt * (sqmean - mean * mean)
-          / (num_per_sum_dt - El::TypeTraits<TensorDataType>::One());
-        var = std::max(var, this->m_epsilon);
-        local_mean(channel, 0) = mean;
-        local_var(channel, 0) = var;
-        auto& running_mean = local_running_mean(channel, 0);
-        auto& running_var = local_running_var(channel, 0);
-        running_mean = this->m_decay * running_mean + (one - this->m_decay) * mean;
-        running_var = this->m_decay * running_var + (one - this->m_decay) * var;
+  // Compute sums and sums of squares, shifted by the running mean.
+  // The shift is identical on every process, so shifted sums can be
+  // reduced directly and the variance does not suffer from the
+  // cancellation of the naive sum-of-squares formula.
+  for (El::Int block = 0; block < num_blocks; ++block) {
+    const auto channels = get_channel_block(block, num_blocks, num_channels);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int channel = channels.beg; channel < channels.end; ++channel) {
+      const auto& shift = local_running_mean(channel, 0);
+      const auto& row_start = channel * channel_size;
+      const auto& row_end = (channel+1) * channel_size;
+      TensorDataType sum = zero;
+      TensorDataType sqsum = zero;
+      for (El::Int col_start = 0; col_start < local_width; col_start += sample_block_size) {
+        const El::Int col_end = std::min(col_start + sample_block_size, local_width);
+        TensorDataType block_sum = zero;
+        TensorDataType block_sqsum = zero;
+        for (El::Int col = col_start; col < col_end; ++col) {
+          for (El::Int row = row_start; row < row_end; ++row) {
+            const auto& x = local_input(row, col) - shift;
+            block_sum += x;
+            block_sqsum += x * x;
+          }
+        }
+        sum += block_sum;
+        sqsum += block_sqsum;
       }
+      local_mean(channel, 0) = sum;
+      local_var(channel, 0) = sqsum;
+    }
+    if (stats_comm != nullptr) {
+      start_block_allreduce(comm, local_mean_and_var, channels,
+                            *stats_comm, &reqs[2*block]);
     }
-
   }
 
-  // Get matrices
-  const auto& local_scale = this->weights_values(0).LockedMatrix();
-  const auto& local_bias = this->weights_values(1).LockedMatrix();
-  const auto& local_mean = (is_training ?
-                            this->m_mean_v->LockedMatrix() :
-                            this->weights_values(2).LockedMatrix());
-  const auto& local_var = (is_training ?
-                           this->m_var_v->LockedMatrix() :
-                           this->weights_values(3).LockedMatrix());
-
-  // Iterate through channels
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int channel = 0; channel < num_channels; ++channel) {
-
-    // Get channel parameters
-    const auto& mean = local_mean(channel, 0);
-    const auto& var = local_var(channel, 0);
-    const TensorDataType inv_stdev = static_cast<TensorDataType>(1 / El::Sqrt(var + this->m_epsilon));
-    const auto& scale = local_scale(channel, 0);
-    const auto& bias = local_bias(channel, 0);
-
-    // Apply batch normalization to inputs in channel
-    const auto& row_start = channel * channel_size;
-    const auto& row_end = (channel+1) * channel_size;
-    for (El::Int col = 0; col < local_width; ++col) {
-      for (El::Int row = row_start; row < row_end; ++row) {
-        const auto& x = local_input(row, col);
-        const auto& xhat = (x - mean) * inv_stdev;
-        auto& y = local_output(row, col);
-        y = scale * xhat + bias;
+  // Finish statistics and normalize, one block at a time
+  const auto num_per_sum_dt = El::To<TensorDataType>(num_per_sum);
+  for (El::Int block = 0; block < num_blocks; ++block) {
+    const auto channels = get_channel_block(block, num_blocks, num_channels);
+    if (stats_comm != nullptr) {
+      comm.wait(reqs[2*block]);
+      comm.wait(reqs[2*block+1]);
+    }
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int channel = channels.beg; channel < channels.end; ++channel) {
+      const auto& shift = local_running_mean(channel, 0);
+      auto& mean = local_mean(channel, 0);
+      auto& var = local_var(channel, 0);
+      if (num_per_sum <= 1) {
+        mean = shift + mean;
+        var = one;
+        continue;
       }
+      const auto shifted_mean = mean / num_per_sum_dt;
+      const auto sqdev = var - mean * shifted_mean;
+      mean = shift + shifted_mean;
+      var = std::max(sqdev / (num_per_sum_dt - one), this->m_epsilon);
+      auto& running_mean = local_running_mean(channel, 0);
+      auto& running_var = local_running_var(channel, 0);
+      running_mean = this->m_decay * running_mean + (one - this->m_decay) * mean;
+      running_var = this->m_decay * running_var + (one - this->m_decay) * var;
     }
-
+    apply_normalization(channels, local_mean, local_var);
   }
 
 }
@@ -176,6 +260,7 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute() {
   const auto& local_input = input.LockedMatrix();
   const auto& local_gradient_wrt_output = this->get_local_prev_error_signals();
   auto& local_gradient_wrt_input = this->get_local_error_signals();
+  auto& local_mean_and_var_gradient = this->m_mean_and_var_gradient->Matrix();
   auto& local_mean_gradient = this->m_mean_gradient_v->Matrix();
   auto& local_var_gradient = this->m_var_gradient_v->Matrix();
   auto& local_scale_gradient = this->m_scale_gradient->Matrix();
@@ -188,60 +273,81 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute() {
   const auto& num_channels = output_dims[0];
   const auto& channel_size = this->get_output_size() / num_channels;
 
-  // Compute local gradients
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int channel = 0; channel < num_channels; ++channel) {
-
-    // Initialize channel parameters and gradients
-    const auto& mean = local_mean(channel, 0);
-    const auto& var = local_var(channel, 0);
-    const auto& scale = local_scale(channel, 0);
-    const TensorDataType inv_stdev = static_cast<TensorDataType>(1 / El::Sqrt(var + this->m_epsilon));
-    const auto& dvar_factor = inv_stdev * inv_stdev * inv_stdev / 2;
-    TensorDataType dmean = El::TypeTraits<TensorDataType>::Zero();
-    TensorDataType dvar = El::TypeTraits<TensorDataType>::Zero();
-    TensorDataType dscale = El::TypeTraits<TensorDataType>::Zero();
-    TensorDataType dbias = El::TypeTraits<TensorDataType>::Zero();
-
-    // Compute gradient contributions from local entries
-    const auto& row_start = channel * channel_size;
-    const auto& row_end = (channel+1) * channel_size;
-    for (El::Int col = 0; col < local_width; ++col) {
-      for (El::Int row = row_start; row < row_end; ++row) {
-        const auto& x = local_input(row, col);
-        const auto& xhat = (x - mean) * inv_stdev;
-        const auto& dy = local_gradient_wrt_output(row, col);
-        dscale += dy * xhat;
-        dbias += dy;
-        const auto& dxhat = dy * scale;
-        dmean += - dxhat * inv_stdev;
-        dvar += - dxhat * (x - mean) * dvar_factor;
-      }
+  // Determine how gradients are aggregated
+  auto& comm = *this->get_comm();
+  const El::mpi::Comm* stats_comm = nullptr;
+  El::Int num_per_sum;
+  if (this->m_statistics_group_size == 0) {
+    // Global statistics aggregation
+    if (is_training) {
+      stats_comm = &this->m_mean_and_var_gradient->RedundantComm();
     }
-    local_mean_gradient(channel, 0) = dmean;
-    local_var_gradient(channel, 0) = dvar;
-    local_scale_gradient(channel, 0) = dscale;
-    local_bias_gradient(channel, 0) = dbias;
-
+    num_per_sum = channel_size * width;
+  } else if (this->m_statistics_group_size == 1) {
+    // Local aggregation
+    num_per_sum = channel_size * local_width;
+  } else {
+    // Grouped batchnorm
+    if (is_training) {
+      stats_comm = &comm.get_packed_group_comm(this->m_statistics_group_size);
+    }
+    num_per_sum = this->m_num_per_sum_cache[width];  // This was computed in FP.
   }
+  const El::Int num_blocks = (stats_comm == nullptr ?
+                              1 :
+                              std::min<El::Int>(m_max_num_channel_blocks, num_channels));
+  std::vector<Al::request> reqs(2*num_blocks);
+
+  // Compute local gradients and start their reduction, one block of
+  // channels at a time
+  for (El::Int block = 0; block < num_blocks; ++block) {
+    const auto channels = get_channel_block(block, num_blocks, num_channels);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int channel = channels.beg; channel < channels.end; ++channel) {
+
+      // Initialize channel parameters and gradients
+      const auto& mean = local_mean(channel, 0);
+      const auto& var = local_var(channel, 0);
+      const auto& scale = local_scale(channel, 0);
+      const TensorDataType inv_stdev = static_cast<TensorDataType>(1 / El::Sqrt(var + this->m_epsilon));
+      const auto& dvar_factor = inv_stdev * inv_stdev * inv_stdev / 2;
+      TensorDataType dmean = El::TypeTraits<TensorDataType>::Zero();
+      TensorDataType dvar = El::TypeTraits<TensorDataType>::Zero();
+      TensorDataType dscale = El::TypeTraits<TensorDataType>::Zero();
+      TensorDataType dbias = El::TypeTraits<TensorDataType>::Zero();
+
+      // Compute gradient contributions from local entries
+      const auto& row_start = channel * channel_size;
+      const auto& row_end = (channel+1) * channel_size;
+      for (El::Int col = 0; col < local_width; ++col) {
+        for (El::Int row = row_start; row < row_end; ++row) {
+          const auto& x = local_input(row, col);
+          const auto& xhat = (x - mean) * inv_stdev;
+          const auto& dy = local_gradient_wrt_output(row, col);
+          dscale += dy * xhat;
+          dbias += dy;
+          const auto& dxhat = dy * scale;
+          dmean += - dxhat * inv_stdev;
+          dvar += - dxhat * (x - mean) * dvar_factor;
+        }
+      }
+      local_mean_gradient(channel, 0) = dmean;
+      local_var_gradient(channel, 0) = dvar;
+      local_scale_gradient(channel, 0) = dscale;
+      local_bias_gradient(channel, 0) = dbias;
 
-  // Accumulate gradients
-  if (is_training) {
-    if (this->m_statistics_group_size == 0) {
-      // Global aggregation; allreduce on fused buffer.
-      this->get_comm()->allreduce(*this->m_mean_and_var_gradient,
-                        this->m_mean_and_var_gradient->RedundantComm(),
-                        El::mpi::SUM);
-    } else if (this->m_statistics_group_size > 1) {
-      // Grouped batchnorm; allreduce on fused buffer.
-      this->get_comm()->allreduce(*this->m_mean_and_var_gradient,
-                        this->get_comm()->get_packed_group_comm(this->m_statistics_group_size),
-                        El::mpi::SUM);
     }
-  } else {
+    if (stats_comm != nullptr) {
+      start_block_allreduce(comm, local_mean_and_var_gradient, channels,
+                            *stats_comm, &reqs[2*block]);
+    }
+  }
+  if (!is_training) {
     // Zero fused buffer.
     El::Zero(*this->m_mean_and_var_gradient);
   }
+
+  // Send gradients to optimizers while statistics are being reduced
   auto* scale_optimizer = this->get_weights(0).get_optimizer();
   if (scale_optimizer != nullptr) {
     scale_optimizer->add_to_gradient(*this->m_scale_gradient, El::TypeTraits<TensorDataType>::One(), true);
@@ -251,23 +357,18 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute() {
     bias_optimizer->add_to_gradient(*this->m_bias_gradient, El::TypeTraits<TensorDataType>::One(), true);
   }
 
-  // Compute error signal
-  El::Int num_per_sum;
-  if (this->m_statistics_group_size == 0) {
-    // Global statistics aggregation.
-    num_per_sum = channel_size * width;
-  } else if (this->m_statistics_group_size == 1) {
-    // Local aggregation.
-    num_per_sum = channel_size * local_width;
-  } else {
-    // Grouped batchnorm.
-    num_per_sum = this->m_num_per_sum_cache[width];  // This was computed in FP.
-  }
-  if (num_per_sum <= 1) {
-    El::Zero(local_gradient_wrt_input);
-  } else {
+  // Compute error signal, one block of channels at a time
+  for (El::Int block = 0; block < num_blocks; ++block) {
+    const auto channels = get_channel_block(block, num_blocks, num_channels);
+    if (stats_comm != nullptr) {
+      comm.wait(reqs[2*block]);
+      comm.wait(reqs[2*block+1]);
+    }
+    if (num_per_sum <= 1) {
+      continue;
+    }
     LBANN_OMP_PARALLEL_FOR
-    for (El::Int channel = 0; channel < num_channels; ++channel) {
+    for (El::Int channel = channels.beg; channel < channels.end; ++channel) {
 
       // Initialize channel parameters and gradients
       const auto& mean = local_mean(channel, 0);
@@ -296,6 +397,9 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute() {
 
     }
   }
+  if (num_per_sum <= 1) {
+    El::Zero(local_gradient_wrt_input);
+  }
 
 }
 
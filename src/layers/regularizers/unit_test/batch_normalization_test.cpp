@@ -30,12 +30,103 @@
 #include "MPITestHelpers.hpp"
 
 #include <lbann/base.hpp>
+#include <lbann/execution_contexts/sgd_execution_context.hpp>
 #include <lbann/layers/regularizers/batch_normalization.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/optimizers/data_type_optimizer.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/weights/data_type_weights.hpp>
 
 #include <lbann/utils/memory.hpp>
 #include <lbann/utils/serialize.hpp>
 #include <h2/patterns/multimethods/SwitchDispatcher.hpp>
 
+#include <lbann.pb.h>
+#include <google/protobuf/text_format.h>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+
+// Batch normalization with statistics aggregated over the whole
+// trainer. The 5 channels do not divide evenly into channel blocks.
+
+std::string const batchnorm_stats_model_prototext = R"ptext(
+model {
+  disable_cuda: true
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "loss"
+    }
+  }
+  layer {
+    name: "x"
+    children: "bn"
+    weights: "x_vals"
+    weights_layer {
+      dims: "5 3"
+    }
+  }
+  layer {
+    name: "bn"
+    parents: "x"
+    children: "tanh"
+    batch_normalization {
+      decay: 0.9
+      epsilon: 1e-5
+      statistics_group_size: -1
+    }
+  }
+  layer {
+    name: "tanh"
+    parents: "bn"
+    children: "loss"
+    tanh {}
+  }
+  layer {
+    name: "loss"
+    parents: "tanh"
+    l2_norm2 {}
+  }
+  weights {
+    name: "x_vals"
+    initializer {
+      uniform_initializer {
+        min: -1
+        max: 1
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.01
+  }
+}
+trainer {
+  mini_batch_size: 4
+}
+)ptext";
+
+auto make_batchnorm_stats_model(lbann::lbann_comm& comm)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(batchnorm_stats_model_prototext,
+                                       &my_proto))
+    throw "Parsing protobuf failed.";
+  lbann::DataReaderMetaData metadata;
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model()) ;
+  my_model->setup(4UL, metadata);
+  return my_model;
+}
+
+}// namespace <anon>
+
 // Some convenience typedefs
 
 template <typename T, lbann::data_layout L, El::Device D>
@@ -146,3 +237,87 @@ TEMPLATE_LIST_TEST_CASE("Serializing batchnorm layer",
   }
 #endif // LBANN_HAS_CEREAL_XML_ARCHIVES
 }
+
+TEST_CASE("Pipelined batchnorm statistics",
+          "[mpi][layer][batchnorm]")
+{
+  using DataType = float;
+  using BNLayerType = LayerType<DataType,
+                                lbann::data_layout::DATA_PARALLEL,
+                                El::Device::CPU>;
+  using MatType = El::DistMatrix<DataType, El::STAR, El::STAR,
+                                 El::ELEMENT, El::Device::CPU>;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  // A single channel block reduces all statistics with one allreduce
+  auto const num_blocks = GENERATE(El::Int(2), El::Int(3), El::Int(4));
+  auto ref_model_ptr = make_batchnorm_stats_model(comm);
+  auto model_ptr = make_batchnorm_stats_model(comm);
+  auto get_bn_layer = [](lbann::model& m) -> BNLayerType& {
+    for (auto* l : m.get_layers()) {
+      if (l->get_name() == "bn") {
+        return dynamic_cast<BNLayerType&>(*l);
+      }
+    }
+    LBANN_ERROR("could not find batch normalization layer");
+  };
+  get_bn_layer(*ref_model_ptr).set_max_num_channel_blocks(1);
+  get_bn_layer(*model_ptr).set_max_num_channel_blocks(num_blocks);
+
+  // Both models start from the same weights
+  auto get_values = [](lbann::weights& w) -> El::AbstractDistMatrix<DataType>& {
+    return dynamic_cast<lbann::data_type_weights<DataType>&>(w).get_values();
+  };
+  auto const ref_weights = ref_model_ptr->get_weights();
+  auto const weights = model_ptr->get_weights();
+  REQUIRE(weights.size() == ref_weights.size());
+  for (size_t i = 0; i < weights.size(); ++i) {
+    REQUIRE(weights[i]->get_name() == ref_weights[i]->get_name());
+    El::Copy(get_values(*ref_weights[i]), get_values(*weights[i]));
+  }
+
+  // Run one fp/bp step and copy the batchnorm output, the gradients
+  // of the optimized weights, and every weights value (including the
+  // running statistics)
+  auto run_step = [&](lbann::model& m) {
+    lbann::sgd_execution_context ctx(lbann::execution_mode::training, 4UL);
+    m.reset_mode(ctx, lbann::execution_mode::training);
+    m.clear_gradients();
+    m.forward_prop(lbann::execution_mode::training);
+    m.get_objective_function()->start_evaluation(
+      lbann::execution_mode::training, 4UL);
+    m.get_objective_function()->differentiate();
+    m.backward_prop();
+    std::vector<MatType> results;
+    results.emplace_back(g);
+    El::Copy(get_bn_layer(m).get_activations(), results.back());
+    for (auto* w : m.get_weights()) {
+      if (auto* opt = dynamic_cast<lbann::data_type_optimizer<DataType>*>(
+            w->get_optimizer())) {
+        results.emplace_back(g);
+        El::Copy(opt->get_gradient(), results.back());
+      }
+      results.emplace_back(g);
+      El::Copy(get_values(*w), results.back());
+    }
+    return results;
+  };
+
+  auto const expected = run_step(*ref_model_ptr);
+  auto const results = run_step(*model_ptr);
+  REQUIRE(results.size() == expected.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    REQUIRE(results[i].Height() == expected[i].Height());
+    REQUIRE(results[i].Width() == expected[i].Width());
+    for (El::Int col = 0; col < results[i].LocalWidth(); ++col) {
+      for (El::Int row = 0; row < results[i].LocalHeight(); ++row) {
+        CHECK(results[i].GetLocal(row, col)
+              == Approx(expected[i].GetLocal(row, col)));
+      }
+    }
+  }
+}
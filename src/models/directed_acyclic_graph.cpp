@@ -26,6 +26,13 @@
 
 #include "lbann/models/directed_acyclic_graph.hpp"
 #include "lbann/utils/serialize.hpp"
+
+#include <omp.h>
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <set>
 #include <unordered_map>
 
 namespace lbann {
@@ -74,7 +81,351 @@ void directed_acyclic_graph_model::setup_layer_execution_order() {
   const auto& sorted_order = graph::topological_sort(nodes, edges);
   reorder_layers(sorted_order);
   model::setup_layer_execution_order();
+  setup_layer_dependencies();
+
+}
+
+void directed_acyclic_graph_model::setup_layer_dependencies() {
+  const auto& layers = this->get_layers();
+  const El::Int num_layers = layers.size();
+  std::unordered_map<const Layer*,El::Int> layer_indices;
+  for (El::Int node = 0; node < num_layers; ++node) {
+    layer_indices[layers[node]] = node;
+  }
+
+  // Dependencies from layer graph
+  std::vector<std::set<El::Int>> dependencies(num_layers);
+  for (El::Int node = 0; node < num_layers; ++node) {
+    const auto& l = layers[node];
+    for (const auto& parent : l->get_parent_layers()) {
+      dependencies[node].insert(layer_indices[parent]);
+    }
+    if (l->get_hint_layer() != nullptr) {
+      dependencies[node].insert(layer_indices[l->get_hint_layer()]);
+    }
+  }
+
+  // Layers that share weights are executed in order
+  // Note: Optimizers accumulate gradient contributions and gradient
+  // sources without synchronization.
+  std::unordered_map<const weights*,El::Int> last_user;
+  for (El::Int node = 0; node < num_layers; ++node) {
+    for (const auto& w_ptr : layers[node]->get_weights_pointers()) {
+      const auto* w = w_ptr.lock().get();
+      if (w == nullptr) { continue; }
+      auto it = last_user.find(w);
+      if (it != last_user.end() && it->second != node) {
+        dependencies[node].insert(it->second);
+      }
+      last_user[w] = node;
+    }
+  }
+
+  // Store dependency lists
+  m_layer_dependencies.assign(num_layers, {});
+  m_layer_dependents.assign(num_layers, {});
+  for (El::Int node = 0; node < num_layers; ++node) {
+    for (const auto& dep : dependencies[node]) {
+      if (dep >= node) {
+        LBANN_ERROR("layer \"", layers[node]->get_name(), "\" ",
+                    "depends on layer \"", layers[dep]->get_name(), "\", ",
+                    "which is not executed before it");
+      }
+      m_layer_dependencies[node].push_back(dep);
+      m_layer_dependents[dep].push_back(node);
+    }
+  }
+
+  // Layers that may communicate run on the calling thread
+  // Note: Layers with weights may run on worker threads, since the
+  // gradient allreduces are started from the calling thread (see
+  // backward_prop).
+  m_local_layers.assign(num_layers, false);
+  m_serial_layers.clear();
+  for (El::Int node = 0; node < num_layers; ++node) {
+    const auto& l = *layers[node];
+    bool is_local = l.has_local_compute();
+    auto matches = [&l](const Layer* neighbor) {
+      return (neighbor->get_data_layout() == l.get_data_layout()
+              && neighbor->get_device_allocation() == l.get_device_allocation());
+    };
+    for (const auto* parent : l.get_parent_layers()) {
+      is_local = is_local && matches(parent);
+    }
+    for (const auto* child : l.get_child_layers()) {
+      is_local = is_local && matches(child);
+    }
+    m_local_layers[node] = is_local;
+    if (!is_local) {
+      m_serial_layers.push_back(node);
+    }
+  }
+
+}
+
+void directed_acyclic_graph_model::set_max_layer_concurrency(size_t max_concurrency) {
+  max_concurrency = std::max(max_concurrency, size_t{1});
+  if (max_concurrency != m_max_layer_concurrency) {
+    m_compute_thread_pool.reset();
+  }
+  m_max_layer_concurrency = max_concurrency;
+}
+
+bool directed_acyclic_graph_model::use_concurrent_execution() {
+  if (m_max_layer_concurrency <= 1) {
+    return false;
+  }
+  if (static_cast<El::Int>(m_layer_dependencies.size()) != get_num_layers()
+      || static_cast<El::Int>(m_local_layers.size()) != get_num_layers()) {
+    return false;
+  }
+
+  // Activation checkpointing relies on execution order positions
+  if (get_num_checkpoint_segments() > 0) {
+    return false;
+  }
+
+  // Layers on GPU are synchronized through streams
+  for (const auto* l : get_layers()) {
+    if (l->get_device_allocation() != El::Device::CPU) {
+      return false;
+    }
+  }
+
+  if (m_compute_thread_pool == nullptr) {
+    m_compute_thread_pool = std::make_shared<thread_pool>(m_max_layer_concurrency);
+  }
+  return true;
+}
+
+void directed_acyclic_graph_model::run_layer_graph(
+  const std::vector<std::vector<El::Int>>& dependencies,
+  const std::vector<std::vector<El::Int>>& dependents,
+  const std::vector<serial_step>& serial_steps,
+  const std::function<void(Layer&)>& begin_cbs,
+  const std::function<void(Layer&)>& run_layer,
+  const std::function<void(Layer&)>& end_cbs,
+  const std::function<bool()>& done) {
+  const El::Int num_layers = dependencies.size();
+
+  // Split OpenMP threads among the workers and the calling thread
+  // Note: The calling thread's thread count is restored on exit.
+  struct omp_threads_guard {
+    int num_threads = omp_get_max_threads();
+    ~omp_threads_guard() { omp_set_num_threads(num_threads); }
+  } calling_thread_omp;
+  const int omp_threads_per_layer
+    = std::max(calling_thread_omp.num_threads
+               / static_cast<int>(m_max_layer_concurrency + 1), 1);
+  omp_set_num_threads(omp_threads_per_layer);
+
+  // Local layers with satisfied dependencies, in execution order
+  std::vector<El::Int> num_pending(num_layers);
+  std::vector<bool> finished_layers(num_layers, false);
+  std::set<El::Int> ready;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    num_pending[i] = dependencies[i].size();
+    if (num_pending[i] == 0 && m_local_layers[i]) { ready.insert(i); }
+  }
+  size_t next_serial = 0;
+  auto serial_step_ready = [&]() {
+    if (next_serial >= serial_steps.size()) { return false; }
+    const auto& step = serial_steps[next_serial];
+    if (step.layer >= 0) { return num_pending[step.layer] == 0; }
+    for (const auto& j : step.wait_for) {
+      if (!finished_layers[j]) { return false; }
+    }
+    return true;
+  };
+  auto finish_layer = [&](El::Int i) {
+    end_cbs(get_layer(i));
+    finished_layers[i] = true;
+    for (const auto& j : dependents[i]) {
+      if (--num_pending[j] == 0 && m_local_layers[j]) { ready.insert(j); }
+    }
+  };
+
+  // Completion queue, filled by worker threads
+  std::mutex completed_mutex;
+  std::condition_variable completed_cv;
+  std::vector<std::pair<El::Int,std::exception_ptr>> completed;
+
+  // Note: Errors stop the dispatch of layers, but the loop only exits
+  // once no job on the thread pool refers to its local variables.
+  size_t num_running = 0;
+  bool stop = false;
+  std::exception_ptr error;
+  auto record_error = [&](std::exception_ptr e) {
+    if (!error) { error = e; }
+    stop = true;
+  };
+  while (true) {
+
+    try {
+      while (!stop) {
+
+        // Dispatch ready local layers
+        while (!stop && !ready.empty() && num_running < m_max_layer_concurrency) {
+          const El::Int i = *ready.begin();
+          ready.erase(ready.begin());
+          begin_cbs(get_layer(i));
+          ++num_running;
+          m_compute_thread_pool->submit_job(
+            [&, i, omp_threads_per_layer]() {
+              omp_set_num_threads(omp_threads_per_layer);
+              std::exception_ptr e;
+              try {
+                run_layer(get_layer(i));
+              }
+              catch (...) {
+                e = std::current_exception();
+              }
+              {
+                std::lock_guard<std::mutex> lock(completed_mutex);
+                completed.emplace_back(i, e);
+              }
+              completed_cv.notify_one();
+              return true;
+            });
+        }
+
+        // Run the next layer that may communicate or the next action
+        if (!serial_step_ready()) { break; }
+        const auto& step = serial_steps[next_serial++];
+        if (step.layer >= 0) {
+          auto& l = get_layer(step.layer);
+          begin_cbs(l);
+          run_layer(l);
+          finish_layer(step.layer);
+        }
+        else {
+          step.action();
+        }
+        stop = done();
+
+      }
+    }
+    catch (...) {
+      record_error(std::current_exception());
+    }
+
+    // Nothing is running, so every layer has been executed or
+    // execution was stopped
+    if (num_running == 0) { break; }
+
+    // Wait for local layers to finish
+    std::vector<std::pair<El::Int,std::exception_ptr>> finished;
+    {
+      std::unique_lock<std::mutex> lock(completed_mutex);
+      completed_cv.wait(lock, [&]{ return !completed.empty(); });
+      finished.swap(completed);
+    }
+    for (const auto& f : finished) {
+      --num_running;
+      if (f.second) {
+        record_error(f.second);
+        continue;
+      }
+      try {
+        finish_layer(f.first);
+      }
+      catch (...) {
+        record_error(std::current_exception());
+      }
+    }
+
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+}
+
+void directed_acyclic_graph_model::forward_prop(execution_mode mode) {
+  if (!use_concurrent_execution()) {
+    model::forward_prop(mode);
+    return;
+  }
+  do_model_forward_prop_begin_cbs(mode);
+  std::vector<serial_step> serial_steps(m_serial_layers.size());
+  for (size_t i = 0; i < m_serial_layers.size(); ++i) {
+    serial_steps[i].layer = m_serial_layers[i];
+  }
+  run_layer_graph(
+    m_layer_dependencies,
+    m_layer_dependents,
+    serial_steps,
+    [&](Layer& l) { do_layer_forward_prop_begin_cbs(mode, &l); },
+    [](Layer& l) { l.forward_prop(); },
+    [&](Layer& l) { do_layer_forward_prop_end_cbs(mode, &l); },
+    [] { return false; });
+  do_model_forward_prop_end_cbs(mode);
+}
+
+void directed_acyclic_graph_model::backward_prop() {
+  if (!use_concurrent_execution()) {
+    model::backward_prop();
+    return;
+  }
+  do_model_backward_prop_begin_cbs();
+
+  // Layers that use each weights, in forward prop order
+  const El::Int num_layers = get_num_layers();
+  std::unordered_map<const weights*, std::vector<El::Int>> weights_users;
+  std::vector<std::vector<weights*>> first_used_weights(num_layers);
+  for (El::Int i = 0; i < num_layers; ++i) {
+    auto& l = get_layer(i);
+    for (size_t j = 0; j < l.num_weights(); ++j) {
+      auto& w = l.get_weights(j);
+      auto& users = weights_users[&w];
+      if (users.empty()) { first_used_weights[i].push_back(&w); }
+      if (users.empty() || users.back() != i) { users.push_back(i); }
+    }
+  }
+
+  // Back prop traverses the layer graph in reverse
+  // Note: The model holds an extra gradient source on each optimizer
+  // so that layers on worker threads never start an allreduce. The
+  // source is removed on this thread once every user of the weights
+  // has finished, i.e. where sequential back prop would start the
+  // allreduce.
+  std::vector<serial_step> serial_steps;
+  size_t num_pending_allreduces = 0;
+  std::vector<bool> is_serial(num_layers, false);
+  for (const auto& i : m_serial_layers) { is_serial[i] = true; }
+  for (El::Int i = num_layers - 1; i >= 0; --i) {
+    if (is_serial[i]) {
+      serial_steps.emplace_back();
+      serial_steps.back().layer = i;
+    }
+    for (auto* w : first_used_weights[i]) {
+      auto* opt = w->get_optimizer();
+      if (opt == nullptr || opt->get_num_gradient_sources() == 0) {
+        continue;
+      }
+      opt->add_gradient_source(this);
+      ++num_pending_allreduces;
+      serial_steps.emplace_back();
+      serial_steps.back().wait_for = weights_users[w];
+      serial_steps.back().action = [this, opt, &num_pending_allreduces]() {
+        --num_pending_allreduces;
+        opt->remove_gradient_source(this);
+      };
+    }
+  }
 
+  // Stop dispatching layers once all gradient allreduces have started
+  // Note: Optimizers are not queried directly since layers on worker
+  // threads may be modifying their gradient sources.
+  run_layer_graph(
+    m_layer_dependents,
+    m_layer_dependencies,
+    serial_steps,
+    [&](Layer& l) { do_layer_backward_prop_begin_cbs(&l); },
+    [](Layer& l) { l.back_prop(); },
+    [&](Layer& l) { do_layer_backward_prop_end_cbs(&l); },
+    [&num_pending_allreduces]() { return num_pending_allreduces == 0; });
+  do_model_backward_prop_end_cbs();
 }
 
 } // namespace lbann
@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/models/inference_preparation.hpp"
+
+#include "lbann/layers/learning/affine_folding.hpp"
+#include "lbann/layers/regularizers/batch_normalization.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/weights/weights.hpp"
+
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+namespace {
+
+/** Get the inference transform of a batch normalization layer. */
+template <El::Device Device>
+bool get_batch_normalization_affine(const Layer& l,
+                                    std::vector<double>& scale,
+                                    std::vector<double>& shift) {
+  using LayerType = batch_normalization_layer<DataType,
+                                              data_layout::DATA_PARALLEL,
+                                              Device>;
+  const auto* bn = dynamic_cast<const LayerType*>(&l);
+  return bn != nullptr && bn->get_inference_affine(scale, shift);
+}
+
+bool get_batch_normalization_affine(const Layer& l,
+                                    std::vector<double>& scale,
+                                    std::vector<double>& shift) {
+  if (get_batch_normalization_affine<El::Device::CPU>(l, scale, shift)) {
+    return true;
+  }
+#ifdef LBANN_HAS_GPU
+  if (get_batch_normalization_affine<El::Device::GPU>(l, scale, shift)) {
+    return true;
+  }
+#endif // LBANN_HAS_GPU
+  return false;
+}
+
+/** Fold a batch normalization layer into its parent.
+ *
+ *  The parent must have no other children, since they expect the
+ *  unnormalized output.
+ */
+bool fold_batch_normalization(Layer& l) {
+  auto parent = l.get_parent_layer_pointer(0).lock();
+  auto* foldable = dynamic_cast<affine_folding_layer*>(parent.get());
+  if (foldable == nullptr || parent->get_num_children() != 1) {
+    return false;
+  }
+  std::vector<double> scale, shift;
+  return (get_batch_normalization_affine(l, scale, shift)
+          && foldable->fold_channel_affine(scale, shift));
+}
+
+} // namespace <anon>
+
+inference_preparation_summary prepare_for_inference(model& m) {
+  inference_preparation_summary summary;
+
+  // Layers of a deserialized model only point to it after setup
+  for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+    m.get_layer(i).set_model(&m);
+  }
+
+  // Optimizer state and gradient buffers are never needed
+  for (auto* w : m.get_weights()) {
+    if (w->has_optimizer()) {
+      w->set_optimizer(nullptr);
+      ++summary.num_removed_optimizers;
+    }
+  }
+
+  // Find layers that are no-ops for inference
+  std::vector<Layer*> removed_layers;
+  for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+    auto& l = m.get_layer(i);
+    if (l.get_num_parents() != 1 || l.get_num_children() != 1) {
+      continue;
+    }
+    const auto type = l.get_type();
+    if (type == "dropout" || type == "identity") {
+      removed_layers.push_back(&l);
+      ++summary.num_removed_layers;
+    }
+    else if (type == "batch normalization" && fold_batch_normalization(l)) {
+      removed_layers.push_back(&l);
+      ++summary.num_folded_layers;
+    }
+  }
+
+  // Remove layers and the weights they leave behind
+  for (auto* l : removed_layers) {
+    m.remove_passthrough_layer(*l);
+  }
+  summary.num_removed_weights = m.remove_unused_weights();
+
+  return summary;
+}
+
+} // namespace lbann
@@ -43,15 +43,19 @@
 #include "lbann/data_store/data_store_conduit.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/summary_impl.hpp"
+#include "lbann/utils/timer.hpp"
 
 #include <model.pb.h>
 #include <optimizers.pb.h>
 
 #include <mpi.h>
 
+#include <algorithm>
 #include <string>
 #include <unistd.h>
+#include <cmath>
 #include <iomanip>
+#include <map>
 #include <queue>
 #include <unordered_set>
 
@@ -83,7 +87,8 @@ model::model(const model& other) :
   m_execution_context(other.m_execution_context),
   m_comm(other.m_comm),
   m_name(other.m_name),
-  m_model_is_setup(false) {
+  m_model_is_setup(false),
+  m_auto_checkpoint_activations(other.m_auto_checkpoint_activations) {
 
   // Deep copies
   m_default_optimizer_msg = (other.m_default_optimizer_msg
@@ -139,6 +144,7 @@ model& model::operator=(const model& other) {
   m_comm = other.m_comm;
   m_name = other.m_name;
   m_model_is_setup = false;
+  m_auto_checkpoint_activations = other.m_auto_checkpoint_activations;
 
   // Deep copies
   m_execution_context  = other.m_execution_context;
@@ -438,6 +444,79 @@ void model::add_weights(OwningWeightsPtr&& ptr) {
 
 }
 
+void model::remove_passthrough_layer(Layer& l) {
+  if (m_model_is_setup) {
+    LBANN_ERROR("attempted to remove layer \"",l.get_name(),"\" ",
+                "from model \"",get_name(),"\" after setup");
+  }
+  if (l.get_num_parents() != 1 || l.get_num_children() != 1) {
+    LBANN_ERROR("attempted to remove layer \"",l.get_name(),"\" ",
+                "from model \"",get_name(),"\", ",
+                "but it has ",l.get_num_parents()," parents ",
+                "and ",l.get_num_children()," children ",
+                "(expected one of each)");
+  }
+  auto parent_ptr = l.get_parent_layer_pointer(0);
+  auto child_ptr = l.get_child_layer_pointer(0);
+  auto parent = parent_ptr.lock();
+  if (parent == nullptr || child_ptr.expired()) {
+    LBANN_ERROR("layer \"",l.get_name(),"\" in model \"",get_name(),"\" ",
+                "has an invalid parent or child pointer");
+  }
+
+  // Connect parent directly to child
+  for (int i = 0; i < parent->get_num_children(); ++i) {
+    if (parent->get_child_layer_pointer(i).lock().get() == &l) {
+      parent->replace_child_layer(child_ptr, i);
+    }
+  }
+
+  // Redirect remaining pointers, including the child's parent
+  // pointer, to the parent
+  remap_pointers({{&l, parent_ptr}}, {});
+
+  // Remove layer from layer list
+  std::vector<El::Int> gather_indices;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    if (&get_layer(i) != &l) {
+      gather_indices.push_back(i);
+    }
+  }
+  reorder_layers(gather_indices);
+
+}
+
+size_t model::remove_unused_weights() {
+  if (m_model_is_setup) {
+    LBANN_ERROR("attempted to remove weights ",
+                "from model \"",get_name(),"\" after setup");
+  }
+
+  // Find weights referenced by layers and objective function
+  std::unordered_set<const weights*> used_weights;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    for (const auto& ptr : get_layer(i).get_weights_pointers()) {
+      used_weights.insert(ptr.lock().get());
+    }
+  }
+  if (m_objective_function != nullptr) {
+    for (const auto& ptr : m_objective_function->get_weights_pointers()) {
+      used_weights.insert(ptr.lock().get());
+    }
+  }
+
+  // Remove everything else
+  const auto num_weights = m_weights.size();
+  m_weights.erase(
+    std::remove_if(m_weights.begin(), m_weights.end(),
+                   [&used_weights](const OwningWeightsPtr& w) {
+                     return used_weights.count(w.get()) == 0;
+                   }),
+    m_weights.end());
+  return num_weights - m_weights.size();
+
+}
+
 void model::add_callback(std::shared_ptr<callback_base> cb) {
   if (cb == nullptr) {
     LBANN_ERROR(
@@ -601,6 +680,7 @@ void model::setup(size_t max_mini_batch_size, DataReaderMetaData& dr_metadata, b
   setup_layer_topology();
   setup_layer_execution_order();
   setup_layers(max_mini_batch_size, dr_metadata);
+  setup_activation_checkpointing();
 
   // Setup weights
   setup_weights();
@@ -1025,6 +1105,170 @@ void model::evaluate_metrics(execution_mode mode, size_t current_mini_batch_size
   }
 }
 
+void model::setup_activation_checkpointing() {
+  const El::Int num_layers = get_num_layers();
+  m_checkpoint_segments.clear();
+  m_layer_checkpoint_segment.assign(num_layers, -1);
+  m_layer_checkpoint_interior.assign(num_layers, false);
+  m_checkpoint_segment_released.clear();
+  m_checkpoint_bytes_released = 0;
+  reset_checkpoint_counters();
+
+  // Layer positions in execution order
+  std::unordered_map<const Layer*,El::Int> positions;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    positions[&get_layer(i)] = i;
+  }
+
+  // Segments requested explicitly
+  std::map<std::string,std::vector<El::Int>> named_segments;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = get_layer(i);
+    const auto& name = l.get_checkpoint_segment();
+    if (name.empty()) { continue; }
+    if (!l.can_recompute_forward_prop()) {
+      LBANN_ERROR(l.get_type()," layer \"",l.get_name(),"\" ",
+                  "is in activation checkpointing segment \"",name,"\", ",
+                  "but it cannot recompute its forward prop");
+    }
+    named_segments[name].push_back(i);
+  }
+  std::vector<std::vector<El::Int>> segments;
+  for (auto& s : named_segments) {
+    segments.emplace_back(std::move(s.second));
+  }
+
+  // Choose segments heuristically
+  // Note: Segments of about sqrt(n) layers balance stored
+  // checkpoints against recomputed activations. Segments are only
+  // closed where a single tensor crosses from earlier layers to
+  // later layers, so exactly one activation is kept per cut.
+  if (m_auto_checkpoint_activations) {
+    std::vector<El::Int> crossing_edges(num_layers+1, 0);
+    for (El::Int i = 0; i < num_layers; ++i) {
+      for (const auto* child : get_layer(i).get_child_layers()) {
+        const auto j = positions.at(child);
+        if (j > i) {
+          crossing_edges[i] += 1;
+          crossing_edges[j] -= 1;
+        }
+      }
+    }
+    for (El::Int i = 1; i < num_layers; ++i) {
+      crossing_edges[i] += crossing_edges[i-1];
+    }
+    const auto target_size = static_cast<size_t>(
+      std::ceil(std::sqrt(static_cast<double>(num_layers))));
+    std::vector<El::Int> current;
+    for (El::Int i = 0; i < num_layers; ++i) {
+      const auto& l = get_layer(i);
+      if (!l.get_checkpoint_segment().empty()
+          || !l.can_recompute_forward_prop()) {
+        if (current.size() > 1) { segments.emplace_back(std::move(current)); }
+        current.clear();
+        continue;
+      }
+      current.push_back(i);
+      if (current.size() >= target_size && crossing_edges[i] == 1) {
+        segments.emplace_back(std::move(current));
+        current.clear();
+      }
+    }
+    if (current.size() > 1) { segments.emplace_back(std::move(current)); }
+  }
+
+  // Register segments
+  for (auto& segment : segments) {
+    std::unordered_set<El::Int> members(segment.begin(), segment.end());
+
+    // Outputs consumed outside the segment are kept
+    for (const auto& pos : segment) {
+      bool is_interior = true;
+      for (const auto* child : get_layer(pos).get_child_layers()) {
+        if (members.count(positions.at(child)) == 0) {
+          is_interior = false;
+        }
+      }
+      m_layer_checkpoint_interior[pos] = is_interior;
+    }
+    const El::Int index = m_checkpoint_segments.size();
+    for (const auto& pos : segment) {
+      m_layer_checkpoint_segment[pos] = index;
+    }
+    m_checkpoint_segments.emplace_back(std::move(segment));
+  }
+  m_checkpoint_segment_released.assign(m_checkpoint_segments.size(), false);
+
+  // Report segments
+  if (!m_checkpoint_segments.empty() && m_comm->am_world_master()) {
+    std::ostringstream ss;
+    ss << "model \"" << get_name() << "\" "
+       << "checkpoints activations in "
+       << m_checkpoint_segments.size() << " segment(s):";
+    for (const auto& segment : m_checkpoint_segments) {
+      ss << " [" << get_layer(segment.front()).get_name()
+         << " ... " << get_layer(segment.back()).get_name()
+         << " (" << segment.size() << " layers)]";
+    }
+    std::cout << ss.str() << std::endl;
+  }
+
+}
+
+void model::release_checkpointed_activations(El::Int pos) {
+  if (m_checkpoint_segments.empty()) { return; }
+  const auto& index = m_layer_checkpoint_segment[pos];
+  if (index < 0) { return; }
+  const auto& segment = m_checkpoint_segments[index];
+  if (segment.back() != pos) { return; }
+  const auto& c = get_execution_context();
+  if (c.get_execution_mode() != execution_mode::training) { return; }
+
+  // Kept outputs must own their memory since they may view released
+  // tensors
+  for (const auto& i : segment) {
+    if (!m_layer_checkpoint_interior[i]
+        && get_layer(i).has_viewing_activations()) {
+      return;
+    }
+  }
+
+  for (const auto& i : segment) {
+    m_checkpoint_bytes_released
+      += get_layer(i).release_activations(m_layer_checkpoint_interior[i]);
+  }
+  m_checkpoint_segment_released[index] = true;
+}
+
+void model::recompute_checkpointed_activations(El::Int pos) {
+  if (m_checkpoint_segments.empty()) { return; }
+  const auto& index = m_layer_checkpoint_segment[pos];
+  if (index < 0 || !m_checkpoint_segment_released[index]) { return; }
+  const auto& segment = m_checkpoint_segments[index];
+  if (segment.back() != pos) { return; }
+
+  // Callbacks are not invoked for recomputed forward prop
+  const auto start = get_time();
+  for (const auto& i : segment) {
+    get_layer(i).forward_prop();
+  }
+  m_checkpoint_recompute_time += get_time() - start;
+  ++m_checkpoint_num_recomputes;
+  m_checkpoint_segment_released[index] = false;
+
+}
+
+void model::release_recomputed_activations(El::Int pos) {
+  if (m_checkpoint_segments.empty()) { return; }
+  const auto& index = m_layer_checkpoint_segment[pos];
+  if (index < 0) { return; }
+  const auto& segment = m_checkpoint_segments[index];
+  if (segment.front() != pos) { return; }
+  for (const auto& i : segment) {
+    get_layer(i).release_activations(m_layer_checkpoint_interior[i]);
+  }
+}
+
 void model::clear_gradients() {
   for (auto&& w : m_weights) {
     auto&& opt = w->get_optimizer();
@@ -1034,11 +1278,13 @@ void model::clear_gradients() {
 
 void model::forward_prop(execution_mode mode) {
   do_model_forward_prop_begin_cbs(mode);
+  if (mode == execution_mode::training) { m_checkpoint_bytes_released = 0; }
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     auto& l = get_layer(i);
     do_layer_forward_prop_begin_cbs(mode, &l);
     l.forward_prop();
     do_layer_forward_prop_end_cbs(mode, &l);
+    release_checkpointed_activations(i);
   }
   do_model_forward_prop_end_cbs(mode);
 }
@@ -1049,9 +1295,11 @@ void model::backward_prop() {
 
     // Perform backward prop step on current layer
     auto& l = get_layer(i);
+    recompute_checkpointed_activations(i);
     do_layer_backward_prop_begin_cbs(&l);
     l.back_prop();
     do_layer_backward_prop_end_cbs(&l);
+    release_recomputed_activations(i);
 
     // Terminate early if all gradients have been computed
     bool all_gradients_computed = true;
@@ -1285,6 +1533,11 @@ void model::summarize_stats(lbann_summary& summarizer) {
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     get_layer(i).summarize_stats(summarizer, c.get_step());
   }
+  for (const auto* w : get_weights()) {
+    if (const auto* opt = w->get_optimizer()) {
+      opt->summarize_stats(summarizer, w->get_name(), c.get_step());
+    }
+  }
   summarizer.reduce_scalar("objective",
                            m_objective_function->get_mean_value(c.get_execution_mode()),
                            c.get_step());
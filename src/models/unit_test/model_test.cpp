@@ -30,16 +30,25 @@
 #include "MPITestHelpers.hpp"
 
 #include <lbann/base.hpp>
+#include <lbann/execution_contexts/sgd_execution_context.hpp>
+#include <lbann/io/weights_bundle.hpp>
 #include <lbann/models/directed_acyclic_graph.hpp>
+#include <lbann/models/inference_preparation.hpp>
 #include <lbann/models/model.hpp>
+#include <lbann/layers/data_type_layer.hpp>
 #include <lbann/layers/io/input_layer.hpp>
 #include <lbann/utils/memory.hpp>
 #include <lbann/utils/serialize.hpp>
+#include <lbann/optimizers/data_type_optimizer.hpp>
+#include <lbann/weights/data_type_weights.hpp>
 #include <lbann/proto/factories.hpp>
 
 #include <lbann.pb.h>
 #include <google/protobuf/text_format.h>
 
+#include <cstdio>
+#include <omp.h>
+
 namespace pb = ::google::protobuf;
 
 namespace {
@@ -72,6 +81,575 @@ auto make_model(lbann::lbann_comm& comm)
   return my_model;
 }
 
+// Parallel branches of entrywise layers between layers that may
+// communicate
+std::string const branching_model_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "loss1"
+    }
+    layer_term {
+      scale_factor: 0.5
+      layer: "loss2"
+    }
+  }
+  layer {
+    name: "x"
+    children: "relu abs tanh fc"
+    weights: "x_vals"
+    weights_layer {
+      dims: "8"
+    }
+  }
+  layer {
+    name: "relu"
+    parents: "x"
+    children: "sum"
+    relu {}
+  }
+  layer {
+    name: "abs"
+    parents: "x"
+    children: "square"
+    abs {}
+  }
+  layer {
+    name: "square"
+    parents: "abs"
+    children: "sum"
+    square {}
+  }
+  layer {
+    name: "tanh"
+    parents: "x"
+    children: "sum"
+    tanh {}
+  }
+  layer {
+    name: "fc"
+    parents: "x"
+    children: "loss2"
+    fully_connected {
+      num_neurons: 4
+      has_bias: true
+    }
+  }
+  layer {
+    name: "sum"
+    parents: "relu square tanh"
+    children: "loss1"
+    sum {}
+  }
+  layer {
+    name: "loss1"
+    parents: "sum"
+    l2_norm2 {}
+  }
+  layer {
+    name: "loss2"
+    parents: "fc"
+    l2_norm2 {}
+  }
+  weights {
+    name: "x_vals"
+    initializer {
+      value_initializer {
+        values: "-0.75 -0.5 -0.25 0 0.25 0.5 0.75 1"
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.01
+  }
+}
+trainer {
+  mini_batch_size: 4
+}
+)ptext";
+
+auto make_branching_model(lbann::lbann_comm& comm)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(branching_model_prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  auto metadata = mock_datareader_metadata();
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model()) ;
+  my_model->setup(4UL, metadata);
+  return my_model;
+}
+
+// Batch normalization layers that can be folded into a convolution
+// with bias and a fully-connected layer without bias
+
+std::string const batchnorm_model_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "loss_conv"
+    }
+    layer_term {
+      scale_factor: 1.0
+      layer: "loss_fc"
+    }
+  }
+  layer {
+    name: "x_conv"
+    children: "conv"
+    weights: "x_conv_vals"
+    weights_layer {
+      dims: "2 5 5"
+    }
+  }
+  layer {
+    name: "conv"
+    parents: "x_conv"
+    children: "bn_conv"
+    convolution {
+      num_dims: 2
+      num_output_channels: 3
+      num_groups: 1
+      conv_dims_i: 3
+      conv_pads_i: 1
+      conv_strides_i: 1
+      conv_dilations_i: 1
+      has_bias: true
+    }
+  }
+  layer {
+    name: "bn_conv"
+    parents: "conv"
+    children: "tanh_conv"
+    weights: "bn_conv_scale bn_conv_bias bn_conv_mean bn_conv_var"
+    batch_normalization {
+      epsilon: 1e-5
+    }
+  }
+  layer {
+    name: "tanh_conv"
+    parents: "bn_conv"
+    children: "loss_conv"
+    tanh {}
+  }
+  layer {
+    name: "loss_conv"
+    parents: "tanh_conv"
+    l2_norm2 {}
+  }
+  layer {
+    name: "x_fc"
+    children: "fc"
+    weights: "x_fc_vals"
+    weights_layer {
+      dims: "6"
+    }
+  }
+  layer {
+    name: "fc"
+    parents: "x_fc"
+    children: "bn_fc"
+    fully_connected {
+      num_neurons: 4
+      has_bias: false
+    }
+  }
+  layer {
+    name: "bn_fc"
+    parents: "fc"
+    children: "tanh_fc"
+    weights: "bn_fc_scale bn_fc_bias bn_fc_mean bn_fc_var"
+    batch_normalization {
+      epsilon: 1e-5
+    }
+  }
+  layer {
+    name: "tanh_fc"
+    parents: "bn_fc"
+    children: "loss_fc"
+    tanh {}
+  }
+  layer {
+    name: "loss_fc"
+    parents: "tanh_fc"
+    l2_norm2 {}
+  }
+  weights {
+    name: "x_conv_vals"
+    initializer {
+      uniform_initializer {
+        min: -1
+        max: 1
+      }
+    }
+  }
+  weights {
+    name: "x_fc_vals"
+    initializer {
+      uniform_initializer {
+        min: -1
+        max: 1
+      }
+    }
+  }
+  weights {
+    name: "bn_conv_scale"
+    initializer {
+      value_initializer {
+        values: "1.5 0.5 -2"
+      }
+    }
+  }
+  weights {
+    name: "bn_conv_bias"
+    initializer {
+      value_initializer {
+        values: "0.25 -1 0.5"
+      }
+    }
+  }
+  weights {
+    name: "bn_conv_mean"
+    initializer {
+      value_initializer {
+        values: "0.1 -0.3 0.2"
+      }
+    }
+  }
+  weights {
+    name: "bn_conv_var"
+    initializer {
+      value_initializer {
+        values: "0.5 2 1.25"
+      }
+    }
+  }
+  weights {
+    name: "bn_fc_scale"
+    initializer {
+      value_initializer {
+        values: "0.75 -1.25 2 0.5"
+      }
+    }
+  }
+  weights {
+    name: "bn_fc_bias"
+    initializer {
+      value_initializer {
+        values: "-0.5 0.125 1 -0.25"
+      }
+    }
+  }
+  weights {
+    name: "bn_fc_mean"
+    initializer {
+      value_initializer {
+        values: "0.3 -0.1 0.05 -0.4"
+      }
+    }
+  }
+  weights {
+    name: "bn_fc_var"
+    initializer {
+      value_initializer {
+        values: "1.5 0.25 0.75 3"
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.01
+  }
+}
+trainer {
+  mini_batch_size: 4
+}
+)ptext";
+
+auto make_batchnorm_model(lbann::lbann_comm& comm)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(batchnorm_model_prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  auto metadata = mock_datareader_metadata();
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model()) ;
+  my_model->setup(4UL, metadata);
+  return my_model;
+}
+
+// Chain of layers with an activation checkpointing segment
+
+std::string const checkpointing_model_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "loss"
+    }
+  }
+  layer {
+    name: "x"
+    children: "fc1"
+    weights: "x_vals"
+    weights_layer {
+      dims: "8"
+    }
+  }
+  layer {
+    name: "fc1"
+    parents: "x"
+    children: "relu1"
+    fully_connected {
+      num_neurons: 6
+      has_bias: true
+    }
+  }
+  layer {
+    name: "relu1"
+    parents: "fc1"
+    children: "fc2"
+    checkpoint_segment: "segment"
+    relu {}
+  }
+  layer {
+    name: "fc2"
+    parents: "relu1"
+    children: "tanh2"
+    checkpoint_segment: "segment"
+    fully_connected {
+      num_neurons: 6
+      has_bias: true
+    }
+  }
+  layer {
+    name: "tanh2"
+    parents: "fc2"
+    children: "fc3"
+    checkpoint_segment: "segment"
+    tanh {}
+  }
+  layer {
+    name: "fc3"
+    parents: "tanh2"
+    children: "sigmoid3"
+    checkpoint_segment: "segment"
+    fully_connected {
+      num_neurons: 4
+      has_bias: true
+    }
+  }
+  layer {
+    name: "sigmoid3"
+    parents: "fc3"
+    children: "loss"
+    sigmoid {}
+  }
+  layer {
+    name: "loss"
+    parents: "sigmoid3"
+    l2_norm2 {}
+  }
+  weights {
+    name: "x_vals"
+    initializer {
+      uniform_initializer {
+        min: -1
+        max: 1
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.01
+  }
+}
+trainer {
+  mini_batch_size: 4
+}
+)ptext";
+
+/** Activation checkpointing segments are either disabled, taken
+ *  from the prototext, or chosen automatically. */
+enum class checkpointing_mode { none, named, automatic };
+
+auto make_checkpointing_model(lbann::lbann_comm& comm,
+                              checkpointing_mode mode)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(checkpointing_model_prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  auto& proto_model = *my_proto.mutable_model();
+  if (mode != checkpointing_mode::named) {
+    for (auto& proto_layer : *proto_model.mutable_layer()) {
+      proto_layer.clear_checkpoint_segment();
+    }
+  }
+  proto_model.set_auto_checkpoint_activations(
+    mode == checkpointing_mode::automatic);
+  auto metadata = mock_datareader_metadata();
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model()) ;
+  my_model->setup(4UL, metadata);
+  return my_model;
+}
+
+// Slice and concatenate layers, once with tensors that can be viewed
+// in-place and once with tensors that must be copied
+
+std::string const slice_concat_model_prototext = R"ptext(
+model {
+  objective_function {
+    layer_term {
+      scale_factor: 1.0
+      layer: "loss_in_place"
+    }
+    layer_term {
+      scale_factor: 1.0
+      layer: "loss_copy"
+    }
+  }
+  layer {
+    name: "x_in_place"
+    children: "slice_in_place"
+    weights: "x_in_place_vals"
+    weights_layer {
+      dims: "2 4"
+    }
+  }
+  layer {
+    name: "slice_in_place"
+    parents: "x_in_place"
+    children: "tanh_in_place0 tanh_in_place1"
+    slice {
+      axis: 0
+      slice_points: "0 1 2"
+    }
+  }
+  layer {
+    name: "tanh_in_place0"
+    parents: "slice_in_place"
+    children: "concat_in_place"
+    tanh {}
+  }
+  layer {
+    name: "tanh_in_place1"
+    parents: "slice_in_place"
+    children: "concat_in_place"
+    tanh {}
+  }
+  layer {
+    name: "concat_in_place"
+    parents: "tanh_in_place0 tanh_in_place1"
+    children: "loss_in_place"
+    concatenation {
+      axis: 0
+    }
+  }
+  layer {
+    name: "loss_in_place"
+    parents: "concat_in_place"
+    l2_norm2 {}
+  }
+  layer {
+    name: "x_copy"
+    children: "slice_copy"
+    weights: "x_copy_vals"
+    weights_layer {
+      dims: "2 4"
+    }
+  }
+  layer {
+    name: "slice_copy"
+    parents: "x_copy"
+    children: "tanh_copy0 tanh_copy1"
+    slice {
+      axis: 1
+      slice_points: "0 1 4"
+    }
+  }
+  layer {
+    name: "tanh_copy0"
+    parents: "slice_copy"
+    children: "concat_copy"
+    tanh {}
+  }
+  layer {
+    name: "tanh_copy1"
+    parents: "slice_copy"
+    children: "concat_copy"
+    tanh {}
+  }
+  layer {
+    name: "concat_copy"
+    parents: "tanh_copy0 tanh_copy1"
+    children: "loss_copy"
+    concatenation {
+      axis: 1
+    }
+  }
+  layer {
+    name: "loss_copy"
+    parents: "concat_copy"
+    l2_norm2 {}
+  }
+  weights {
+    name: "x_in_place_vals"
+    initializer {
+      value_initializer {
+        values: "-1 -0.5 0.25 0.75 1.5 -2 0.5 0.125"
+      }
+    }
+  }
+  weights {
+    name: "x_copy_vals"
+    initializer {
+      value_initializer {
+        values: "-1 -0.5 0.25 0.75 1.5 -2 0.5 0.125"
+      }
+    }
+  }
+}
+optimizer {
+  sgd {
+    learn_rate: 0.01
+  }
+}
+trainer {
+  mini_batch_size: 4
+}
+)ptext";
+
+auto make_slice_concat_model(lbann::lbann_comm& comm)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(slice_concat_model_prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  auto metadata = mock_datareader_metadata();
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model()) ;
+  my_model->setup(4UL, metadata);
+  return my_model;
+}
+
 }// namespace <anon>
 
 using unit_test::utilities::IsValidPtr;
@@ -163,3 +741,438 @@ TEST_CASE("Serializing models", "[mpi][model][serialize]")
   }
 #endif // LBANN_HAS_CEREAL_XML_ARCHIVES
 }
+
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+TEST_CASE("Preparing models for inference", "[mpi][model][inference]")
+{
+  using DataType = float;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  // Restore a trained model without setting it up, as
+  // load_inference_model does
+  std::stringstream ss;
+  std::unique_ptr<lbann::model> model_ptr;
+  {
+    auto model_src_ptr = make_model<DataType>(comm);
+    lbann::RootedBinaryOutputArchive oarchive(ss, g);
+    oarchive(model_src_ptr);
+  }
+  {
+    lbann::RootedBinaryInputArchive iarchive(ss, g);
+    iarchive(model_ptr);
+  }
+  REQUIRE(IsValidPtr(model_ptr));
+
+  auto count_identity_layers = [](lbann::model const& m) {
+    El::Int count = 0;
+    for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+      if (m.get_layer(i).get_type() == "identity") {
+        ++count;
+      }
+    }
+    return count;
+  };
+  auto const num_layers = model_ptr->get_num_layers();
+  auto const num_identity_layers = count_identity_layers(*model_ptr);
+
+  auto const summary = lbann::prepare_for_inference(*model_ptr);
+  CHECK(summary.num_removed_layers > 0);
+  CHECK(summary.num_removed_optimizers > 0);
+  CHECK(model_ptr->get_num_layers()
+        == num_layers - static_cast<El::Int>(summary.num_removed_layers));
+  CHECK(count_identity_layers(*model_ptr)
+        == num_identity_layers
+           - static_cast<El::Int>(summary.num_removed_layers));
+  for (auto const* w : model_ptr->get_weights()) {
+    CHECK_FALSE(w->has_optimizer());
+  }
+
+  auto metadata = mock_datareader_metadata();
+  REQUIRE_NOTHROW(model_ptr->setup(1UL, metadata));
+}
+
+TEST_CASE("Preparing models with batch normalization for inference",
+          "[mpi][model][inference]")
+{
+  using DataType = float;
+  using MatType = El::DistMatrix<DataType, El::STAR, El::STAR,
+                                 El::ELEMENT, El::Device::CPU>;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  // Evaluate model and copy outputs of the layers after batchnorm
+  std::vector<std::string> const output_names = {"tanh_conv", "tanh_fc"};
+  auto evaluate = [&](lbann::model& m) {
+    lbann::sgd_execution_context ctx(lbann::execution_mode::testing, 4UL);
+    m.reset_mode(ctx, lbann::execution_mode::testing);
+    m.forward_prop(lbann::execution_mode::testing);
+    std::vector<MatType> outputs;
+    for (auto const& name : output_names) {
+      for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+        auto const& l = m.get_layer(i);
+        if (l.get_name() == name) {
+          auto const& dtl =
+            dynamic_cast<lbann::data_type_layer<DataType> const&>(l);
+          outputs.emplace_back(g);
+          El::Copy(dtl.get_activations(), outputs.back());
+        }
+      }
+    }
+    REQUIRE(outputs.size() == output_names.size());
+    return outputs;
+  };
+
+  // Evaluate trained model and restore it without setting it up
+  std::stringstream ss;
+  std::vector<MatType> expected;
+  std::unique_ptr<lbann::model> model_ptr;
+  {
+    auto model_src_ptr = make_batchnorm_model(comm);
+    expected = evaluate(*model_src_ptr);
+    lbann::RootedBinaryOutputArchive oarchive(ss, g);
+    oarchive(model_src_ptr);
+  }
+  {
+    lbann::RootedBinaryInputArchive iarchive(ss, g);
+    iarchive(model_ptr);
+  }
+  REQUIRE(IsValidPtr(model_ptr));
+  auto const num_layers = model_ptr->get_num_layers();
+
+  // Both batchnorm layers are folded into their parents
+  auto const summary = lbann::prepare_for_inference(*model_ptr);
+  CHECK(summary.num_folded_layers == 2);
+  CHECK(summary.num_removed_layers == 0);
+  CHECK(summary.num_removed_weights == 8);
+  CHECK(model_ptr->get_num_layers() == num_layers - 2);
+  for (El::Int i = 0; i < model_ptr->get_num_layers(); ++i) {
+    CHECK(model_ptr->get_layer(i).get_type() != "batch normalization");
+  }
+
+  // Folded model must compute the same outputs
+  auto metadata = mock_datareader_metadata();
+  REQUIRE_NOTHROW(model_ptr->setup(4UL, metadata));
+  auto const results = evaluate(*model_ptr);
+  for (size_t i = 0; i < results.size(); ++i) {
+    REQUIRE(results[i].Height() == expected[i].Height());
+    REQUIRE(results[i].Width() == expected[i].Width());
+    for (El::Int col = 0; col < results[i].LocalWidth(); ++col) {
+      for (El::Int row = 0; row < results[i].LocalHeight(); ++row) {
+        CHECK(results[i].GetLocal(row, col)
+              == Approx(expected[i].GetLocal(row, col))
+                   .epsilon(1e-4).margin(1e-5));
+      }
+    }
+  }
+}
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
+
+TEST_CASE("Weights bundles", "[mpi][model][weights_bundle]")
+{
+  using DataType = float;
+  using ValuesType = El::DistMatrix<DataType, El::STAR, El::STAR,
+                                    El::ELEMENT, El::Device::CPU>;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  auto model_ptr = make_model<DataType>(comm);
+  auto get_values = [](lbann::weights& w) -> El::AbstractDistMatrix<DataType>& {
+    return dynamic_cast<lbann::data_type_weights<DataType>&>(w).get_values();
+  };
+
+  // Write bundle and clobber weights
+  std::string const path = El::BuildString("model_test_trainer",
+                                           comm.get_trainer_rank(),
+                                           ".lbw");
+  std::vector<ValuesType> expected;
+  for (auto* w : model_ptr->get_weights()) {
+    expected.emplace_back(g);
+    El::Copy(get_values(*w), expected.back());
+  }
+  REQUIRE_NOTHROW(lbann::write_weights_bundle(*model_ptr, path));
+  comm.trainer_barrier();
+  for (auto* w : model_ptr->get_weights()) {
+    El::Zero(get_values(*w));
+  }
+
+  // Checkpoint clobbered model with a trailing value
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+  std::stringstream checkpoint;
+  int const sentinel = 42;
+  {
+    lbann::RootedBinaryOutputArchive oarchive(checkpoint, g);
+    oarchive(model_ptr, sentinel);
+  }
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
+
+  auto const access = GENERATE(lbann::weights_bundle_access::map,
+                               lbann::weights_bundle_access::broadcast);
+  auto const weights_list = model_ptr->get_weights();
+  CHECK(lbann::read_weights_bundle(*model_ptr, path, access)
+        == weights_list.size());
+  for (size_t i = 0; i < weights_list.size(); ++i) {
+    ValuesType values(g);
+    El::Copy(get_values(*weights_list[i]), values);
+    REQUIRE(values.Height() == expected[i].Height());
+    REQUIRE(values.Width() == expected[i].Width());
+    for (El::Int col = 0; col < values.Width(); ++col) {
+      for (El::Int row = 0; row < values.Height(); ++row) {
+        CHECK(values.GetLocal(row, col) == expected[i].GetLocal(row, col));
+      }
+    }
+  }
+
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+  // Checkpointed values are skipped if they are in the bundle, and
+  // the rest of the checkpoint is still read correctly
+  {
+    std::unique_ptr<lbann::model> restored_ptr;
+    int restored_sentinel = 0;
+    {
+      lbann::weights_bundle_restore_scope scope(comm, path, access);
+      lbann::RootedBinaryInputArchive iarchive(checkpoint, g);
+      iarchive(restored_ptr, restored_sentinel);
+      REQUIRE(IsValidPtr(restored_ptr));
+      CHECK(scope.restore(*restored_ptr) == weights_list.size());
+    }
+    CHECK(restored_sentinel == sentinel);
+    auto const restored_weights = restored_ptr->get_weights();
+    REQUIRE(restored_weights.size() == expected.size());
+    for (size_t i = 0; i < restored_weights.size(); ++i) {
+      ValuesType values(g);
+      El::Copy(get_values(*restored_weights[i]), values);
+      REQUIRE(values.Height() == expected[i].Height());
+      REQUIRE(values.Width() == expected[i].Width());
+      for (El::Int col = 0; col < values.Width(); ++col) {
+        for (El::Int row = 0; row < values.Height(); ++row) {
+          CHECK(values.GetLocal(row, col) == expected[i].GetLocal(row, col));
+        }
+      }
+    }
+  }
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
+
+  comm.trainer_barrier();
+  if (comm.am_trainer_master()) {
+    std::remove(path.c_str());
+  }
+}
+
+TEST_CASE("Concurrent layer execution", "[mpi][model][concurrency]")
+{
+  using DataType = float;
+  using MatType = El::DistMatrix<DataType, El::STAR, El::STAR,
+                                 El::ELEMENT, El::Device::CPU>;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  auto model_ptr = make_branching_model(comm);
+  auto* dag = dynamic_cast<lbann::directed_acyclic_graph_model*>(model_ptr.get());
+  REQUIRE(dag != nullptr);
+  lbann::sgd_execution_context ctx(lbann::execution_mode::training, 4UL);
+  model_ptr->reset_mode(ctx, lbann::execution_mode::training);
+
+  // Run one fp/bp step and copy every activation and gradient
+  auto run_step = [&](size_t concurrency) {
+    dag->set_max_layer_concurrency(concurrency);
+    model_ptr->clear_gradients();
+    model_ptr->forward_prop(lbann::execution_mode::training);
+    model_ptr->get_objective_function()->start_evaluation(
+      lbann::execution_mode::training, 4UL);
+    model_ptr->get_objective_function()->differentiate();
+    model_ptr->backward_prop();
+    std::vector<MatType> results;
+    for (El::Int i = 0; i < model_ptr->get_num_layers(); ++i) {
+      auto const& l = dynamic_cast<lbann::data_type_layer<DataType> const&>(
+        model_ptr->get_layer(i));
+      for (int j = 0; j < l.get_num_children(); ++j) {
+        results.emplace_back(g);
+        El::Copy(l.get_activations(j), results.back());
+      }
+    }
+    for (auto* w : model_ptr->get_weights()) {
+      auto& opt = dynamic_cast<lbann::data_type_optimizer<DataType>&>(
+        *w->get_optimizer());
+      results.emplace_back(g);
+      El::Copy(opt.get_gradient(), results.back());
+    }
+    return results;
+  };
+
+  // Note: The fully-connected layer has weights and runs on a worker
+  // thread, so its gradient allreduce is started by the model.
+  auto const expected = run_step(1);
+  auto const concurrency = GENERATE(2UL, 4UL);
+  auto const omp_threads = omp_get_max_threads();
+  auto const results = run_step(concurrency);
+  CHECK(omp_get_max_threads() == omp_threads);
+  for (auto* w : model_ptr->get_weights()) {
+    CHECK(w->get_optimizer()->get_num_gradient_sources() == 0);
+  }
+  REQUIRE(results.size() == expected.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    REQUIRE(results[i].Height() == expected[i].Height());
+    REQUIRE(results[i].Width() == expected[i].Width());
+    for (El::Int col = 0; col < results[i].LocalWidth(); ++col) {
+      for (El::Int row = 0; row < results[i].LocalHeight(); ++row) {
+        CHECK(results[i].GetLocal(row, col)
+              == Approx(expected[i].GetLocal(row, col)));
+      }
+    }
+  }
+}
+
+TEST_CASE("In-place slice and concatenation", "[mpi][model][in_place]")
+{
+  using DataType = float;
+  using MatType = El::DistMatrix<DataType, El::STAR, El::STAR,
+                                 El::ELEMENT, El::Device::CPU>;
+  using LayerType = lbann::data_type_layer<DataType>;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  auto model_ptr = make_slice_concat_model(comm);
+  lbann::sgd_execution_context ctx(lbann::execution_mode::training, 4UL);
+  model_ptr->reset_mode(ctx, lbann::execution_mode::training);
+
+  auto get_layer = [&](std::string const& name) -> LayerType const& {
+    for (El::Int i = 0; i < model_ptr->get_num_layers(); ++i) {
+      if (model_ptr->get_layer(i).get_name() == name) {
+        return dynamic_cast<LayerType const&>(model_ptr->get_layer(i));
+      }
+    }
+    throw "Layer not found.";
+  };
+  auto get_gradient = [&](std::string const& name) {
+    MatType gradient(g);
+    for (auto* w : model_ptr->get_weights()) {
+      if (w->get_name() == name) {
+        auto& opt = dynamic_cast<lbann::data_type_optimizer<DataType>&>(
+          *w->get_optimizer());
+        El::Copy(opt.get_gradient(), gradient);
+      }
+    }
+    return gradient;
+  };
+  auto check_equal = [](MatType const& a, MatType const& b) {
+    REQUIRE(a.Height() == b.Height());
+    REQUIRE(a.Width() == b.Width());
+    for (El::Int col = 0; col < a.LocalWidth(); ++col) {
+      for (El::Int row = 0; row < a.LocalHeight(); ++row) {
+        CHECK(a.GetLocal(row, col) == Approx(b.GetLocal(row, col)));
+      }
+    }
+  };
+
+  // Run several steps, since in-place gradients view memory that is
+  // kept between steps
+  for (int step = 0; step < 2; ++step) {
+    model_ptr->clear_gradients();
+    model_ptr->forward_prop(lbann::execution_mode::training);
+    model_ptr->get_objective_function()->start_evaluation(
+      lbann::execution_mode::training, 4UL);
+    model_ptr->get_objective_function()->differentiate();
+    model_ptr->backward_prop();
+
+    // Parents of in-place concatenation write into its output
+    auto const& concat = get_layer("concat_in_place").get_activations();
+    auto const& input0 = get_layer("tanh_in_place0").get_activations();
+    auto const& input1 = get_layer("tanh_in_place1").get_activations();
+    if (concat.LocalWidth() > 0) {
+      CHECK(input0.LockedBuffer() == concat.LockedBuffer(0, 0));
+      CHECK(input1.LockedBuffer() == concat.LockedBuffer(4, 0));
+    }
+
+    // Outputs and input gradients must match copies
+    MatType output_in_place(g), output_copy(g);
+    El::Copy(concat, output_in_place);
+    El::Copy(get_layer("concat_copy").get_activations(), output_copy);
+    check_equal(output_in_place, output_copy);
+    check_equal(get_gradient("x_in_place_vals"),
+                get_gradient("x_copy_vals"));
+  }
+}
+
+TEST_CASE("Activation checkpointing", "[mpi][model][checkpointing]")
+{
+  using DataType = float;
+  using MatType = El::DistMatrix<DataType, El::STAR, El::STAR,
+                                 El::ELEMENT, El::Device::CPU>;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  auto const mode = GENERATE(checkpointing_mode::named,
+                             checkpointing_mode::automatic);
+  auto ref_model_ptr = make_checkpointing_model(comm, checkpointing_mode::none);
+  auto model_ptr = make_checkpointing_model(comm, mode);
+  REQUIRE(ref_model_ptr->get_num_checkpoint_segments() == 0);
+  REQUIRE(model_ptr->get_num_checkpoint_segments() > 0);
+
+  // Both models start from the same weights
+  auto get_values = [](lbann::weights& w) -> El::AbstractDistMatrix<DataType>& {
+    return dynamic_cast<lbann::data_type_weights<DataType>&>(w).get_values();
+  };
+  auto const ref_weights = ref_model_ptr->get_weights();
+  auto const weights = model_ptr->get_weights();
+  REQUIRE(weights.size() == ref_weights.size());
+  for (size_t i = 0; i < weights.size(); ++i) {
+    REQUIRE(weights[i]->get_name() == ref_weights[i]->get_name());
+    El::Copy(get_values(*ref_weights[i]), get_values(*weights[i]));
+  }
+
+  // Run one fp/bp step and copy every weights gradient
+  auto run_step = [&](lbann::model& m) {
+    lbann::sgd_execution_context ctx(lbann::execution_mode::training, 4UL);
+    m.reset_mode(ctx, lbann::execution_mode::training);
+    m.clear_gradients();
+    m.forward_prop(lbann::execution_mode::training);
+    m.get_objective_function()->start_evaluation(
+      lbann::execution_mode::training, 4UL);
+    m.get_objective_function()->differentiate();
+    m.backward_prop();
+    std::vector<MatType> gradients;
+    for (auto* w : m.get_weights()) {
+      auto& opt = dynamic_cast<lbann::data_type_optimizer<DataType>&>(
+        *w->get_optimizer());
+      gradients.emplace_back(g);
+      El::Copy(opt.get_gradient(), gradients.back());
+    }
+    return gradients;
+  };
+
+  // Gradients must not depend on recomputed activations
+  auto const expected = run_step(*ref_model_ptr);
+  auto const results = run_step(*model_ptr);
+  CHECK(model_ptr->get_checkpoint_bytes_released() > 0);
+  CHECK(model_ptr->get_checkpoint_num_recomputes() > 0);
+  REQUIRE(results.size() == expected.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    REQUIRE(results[i].Height() == expected[i].Height());
+    REQUIRE(results[i].Width() == expected[i].Width());
+    for (El::Int col = 0; col < results[i].LocalWidth(); ++col) {
+      for (El::Int row = 0; row < results[i].LocalHeight(); ++row) {
+        CHECK(results[i].GetLocal(row, col)
+              == Approx(expected[i].GetLocal(row, col)));
+      }
+    }
+  }
+}
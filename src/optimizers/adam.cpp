@@ -104,11 +104,8 @@ auto adam<TensorDataType>::get_moment2() -> AbsDistMatrixType& {
 template <typename TensorDataType>
 void adam<TensorDataType>::setup(WeightsType* w) {
   OptimizerType::setup(w);
-  const auto& gradient = this->get_gradient();
-  m_moment1.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
-  m_moment2.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
-  El::Zeros(*m_moment1, gradient.Height(), gradient.Width());
-  El::Zeros(*m_moment2, gradient.Height(), gradient.Width());
+  m_moment1 = this->make_state_matrix();
+  m_moment2 = this->make_state_matrix();
 }
 
 template <typename TensorDataType>
@@ -29,6 +29,7 @@
 #include "lbann/optimizers/data_type_optimizer.hpp"
 #include "lbann/optimizers/data_type_optimizer_impl.hpp"
 #include "lbann/weights/data_type_weights.hpp"
+#include "lbann/utils/hydrogen_utils.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/io/persist.hpp"
 
@@ -44,6 +45,9 @@ data_type_optimizer<TensorDataType>::data_type_optimizer(const data_type_optimiz
     m_weights(other.m_weights),
     m_gradient(other.m_gradient ? other.m_gradient->Copy() : nullptr),
     m_gradient_v(other.m_gradient_v ? other.m_gradient_v->Copy() : nullptr),
+    m_values_shard(other.m_values_shard ? other.m_values_shard->Copy() : nullptr),
+    m_gradient_shard(other.m_gradient_shard ? other.m_gradient_shard->Copy() : nullptr),
+    m_num_state_matrices(other.m_num_state_matrices),
     m_learning_rate(other.m_learning_rate) {}
 
 template <typename TensorDataType>
@@ -54,6 +58,9 @@ data_type_optimizer<TensorDataType>::operator=(
   m_weights = other.m_weights;
   m_gradient.reset(other.m_gradient ? other.m_gradient->Copy() : nullptr);
   m_gradient_v.reset(other.m_gradient_v ? other.m_gradient_v->Copy() : nullptr);
+  m_values_shard.reset(other.m_values_shard ? other.m_values_shard->Copy() : nullptr);
+  m_gradient_shard.reset(other.m_gradient_shard ? other.m_gradient_shard->Copy() : nullptr);
+  m_num_state_matrices = other.m_num_state_matrices;
   m_learning_rate = other.m_learning_rate;
   return *this;
 }
@@ -62,9 +69,43 @@ template <typename TensorDataType>
 description data_type_optimizer<TensorDataType>::get_description() const {
   description desc = optimizer::get_description();
   desc.add("Learning rate", m_learning_rate);
+  if (m_values_shard != nullptr) {
+    // Full-size state matrices are replaced by shards, at the cost of
+    // shards of the values and gradient
+    const El::Int size = m_values_shard->Height();
+    const El::Int local_size = m_values_shard->LocalHeight();
+    const El::Int bytes_saved =
+      (m_num_state_matrices * (size - local_size) - 2 * local_size)
+      * static_cast<El::Int>(sizeof(TensorDataType));
+    desc.add("Sharded state",
+             std::to_string(local_size) + " of " + std::to_string(size)
+             + " entries on rank "
+             + std::to_string(m_values_shard->DistRank()) + ", "
+             + std::to_string(bytes_saved) + " bytes saved");
+  }
   return desc;
 }
 
+template <typename TensorDataType>
+size_t data_type_optimizer<TensorDataType>::get_host_state_bytes() const {
+  size_t bytes = (get_host_memory_bytes(m_gradient.get())
+                  + get_host_memory_bytes(m_gradient_v.get())
+                  + get_host_memory_bytes(m_values_shard.get())
+                  + get_host_memory_bytes(m_gradient_shard.get()));
+  // State matrices are constructed like the values shard, if it
+  // exists, or else like the gradient
+  const auto* like = (m_values_shard != nullptr
+                      ? m_values_shard.get()
+                      : m_gradient.get());
+  if (like != nullptr && like->GetLocalDevice() == El::Device::CPU) {
+    bytes += (static_cast<size_t>(m_num_state_matrices)
+              * static_cast<size_t>(like->LocalHeight())
+              * static_cast<size_t>(like->LocalWidth())
+              * sizeof(TensorDataType));
+  }
+  return bytes;
+}
+
 template <typename TensorDataType>
 auto data_type_optimizer<TensorDataType>::get_weights() -> WeightsType& {
   // Item 3, p. 23 in "Effective C++", 3rd ed., by Scott Meyers
@@ -140,6 +181,49 @@ void data_type_optimizer<TensorDataType>::setup_base(WeightsType* w) {
   }
 #endif // HYDROGEN_HAVE_CUB
 
+  // Shard flattened values and gradient over the trainer. Weights
+  // that are already distributed (or stored non-contiguously) are
+  // optimized as usual.
+  m_values_shard.reset();
+  m_gradient_shard.reset();
+  m_num_state_matrices = 0;
+  const auto dist = values.DistData();
+  if (this->get_sharded_state()) {
+    if (dist.colDist == El::STAR && dist.rowDist == El::STAR
+        && values.Grid().Size() > 1
+        && (width <= 1 || values.LDim() == height)) {
+      m_values_shard.reset(AbsDistMatrixType::Instantiate(values.Grid(),
+                                                          dist.root,
+                                                          El::VC,
+                                                          El::STAR,
+                                                          El::ELEMENT,
+                                                          dist.device));
+      m_values_shard->Resize(height * width, 1);
+      m_gradient_shard.reset(m_values_shard->Construct(values.Grid(),
+                                                       dist.root));
+      m_gradient_shard->Resize(height * width, 1);
+    }
+    else {
+      this->set_sharded_state(false);
+    }
+  }
+
+}
+
+template <typename TensorDataType>
+auto data_type_optimizer<TensorDataType>::make_state_matrix()
+  -> std::unique_ptr<AbsDistMatrixType> {
+  if (m_gradient == nullptr) {
+    LBANN_ERROR("attempted to construct optimizer state before setup");
+  }
+  const auto& like = (m_values_shard != nullptr
+                      ? *m_values_shard
+                      : *m_gradient);
+  std::unique_ptr<AbsDistMatrixType> state{
+    AbsDistMatrixType::Instantiate(like.DistData())};
+  El::Zeros(*state, like.Height(), like.Width());
+  ++m_num_state_matrices;
+  return state;
 }
 
 template <typename TensorDataType>
@@ -158,10 +242,30 @@ void data_type_optimizer<TensorDataType>::step() {
     LBANN_ERROR("attempted to perform optimization step without weights");
   }
   const auto start_time = get_time();
-  this->step_compute(m_weights->get_values(), this->get_gradient());
+  if (m_values_shard != nullptr) {
+    // Update this rank's shard, then allgather the updated values
+    auto values = this->make_flat_view(m_weights->get_values());
+    El::Copy(*values, *m_values_shard);
+    this->reduce_scatter_all_gradient_contributions(*m_gradient_shard);
+    this->step_compute(*m_values_shard, *m_gradient_shard);
+    El::Copy(*m_values_shard, *values);
+  }
+  else {
+    this->step_compute(m_weights->get_values(), this->get_gradient());
+  }
   this->inc_step_time(get_time() - start_time);
 }
 
+template <typename TensorDataType>
+void data_type_optimizer<TensorDataType>::synchronize_gradient() {
+  if (m_values_shard != nullptr) {
+    this->reduce_scatter_all_gradient_contributions(*m_gradient_shard);
+  }
+  else {
+    this->get_gradient();
+  }
+}
+
 template <typename TensorDataType>
 std::tuple<El::Int,El::Int,El::DistData>
 data_type_optimizer<TensorDataType>::get_matrix_info() const {
@@ -0,0 +1,411 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/optimizers/gradient_compression.hpp"
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace lbann {
+
+namespace {
+
+/** @brief Modified Gram-Schmidt on the columns of a matrix.
+ *
+ *  Columns that are (numerically) linearly dependent on earlier ones
+ *  are zeroed.
+ */
+template <typename T>
+void orthonormalize_columns(El::Matrix<T, El::Device::CPU>& P)
+{
+  const El::Int height = P.Height();
+  for (El::Int j = 0; j < P.Width(); ++j) {
+    T* pj = P.Buffer(0, j);
+    for (El::Int i = 0; i < j; ++i) {
+      const T* pi = P.LockedBuffer(0, i);
+      T dot = 0;
+      for (El::Int r = 0; r < height; ++r) {
+        dot += pi[r] * pj[r];
+      }
+      for (El::Int r = 0; r < height; ++r) {
+        pj[r] -= dot * pi[r];
+      }
+    }
+    T norm = 0;
+    for (El::Int r = 0; r < height; ++r) {
+      norm += pj[r] * pj[r];
+    }
+    norm = std::sqrt(norm);
+    const T scale =
+      (norm > std::numeric_limits<T>::epsilon() ? T(1) / norm : T(0));
+    for (El::Int r = 0; r < height; ++r) {
+      pj[r] *= scale;
+    }
+  }
+}
+
+} // namespace
+
+// ---------------------------------------------
+// gradient_compressor
+// ---------------------------------------------
+
+template <typename TensorDataType>
+void gradient_compressor<TensorDataType>::start_allreduce(
+  El::AbstractMatrix<TensorDataType>& gradient,
+  lbann_comm& comm,
+  const El::mpi::Comm& c)
+{
+  if (gradient.GetDevice() != El::Device::CPU) {
+    LBANN_ERROR(get_type(), " gradient compression only supports CPU gradients");
+  }
+  if (m_in_progress) {
+    LBANN_ERROR("attempted to start a ", get_type(),
+                " gradient allreduce while another is in progress");
+  }
+  auto& local_gradient = static_cast<LocalMatType&>(gradient);
+  const El::Int height = gradient.Height();
+  const El::Int width = gradient.Width();
+
+  // Error feedback: compress the gradient plus last step's residual
+  if (m_error_feedback && m_residual.Height() == height &&
+      m_residual.Width() == width) {
+    El::Axpy(TensorDataType(1), local_gradient, m_residual);
+  }
+  else {
+    El::Copy(local_gradient, m_residual);
+  }
+
+  m_dense_in_progress = false;
+  m_sent = start_compress_and_reduce(m_residual, comm, c);
+  m_in_progress = true;
+}
+
+template <typename TensorDataType>
+void gradient_compressor<TensorDataType>::finish_allreduce(
+  El::AbstractMatrix<TensorDataType>& gradient,
+  lbann_comm& comm,
+  const El::mpi::Comm& c)
+{
+  if (gradient.GetDevice() != El::Device::CPU) {
+    LBANN_ERROR(get_type(), " gradient compression only supports CPU gradients");
+  }
+  if (!m_in_progress) {
+    LBANN_ERROR("attempted to finish a ", get_type(),
+                " gradient allreduce before starting it");
+  }
+  m_in_progress = false;
+  auto& local_gradient = static_cast<LocalMatType&>(gradient);
+  if (m_dense_in_progress) {
+    comm.wait(m_dense_req);
+    El::Copy(m_dense, local_gradient);
+    m_dense_in_progress = false;
+  }
+  else {
+    finish_compress_and_reduce(m_residual, local_gradient, comm, c);
+  }
+  const size_t dense = gradient.Height() * gradient.Width();
+  m_compression_ratio =
+    (m_sent > 0 ? static_cast<double>(dense) / m_sent : 1.);
+  m_residual_norm = El::FrobeniusNorm(m_residual);
+}
+
+template <typename TensorDataType>
+void gradient_compressor<TensorDataType>::allreduce(
+  El::AbstractMatrix<TensorDataType>& gradient,
+  lbann_comm& comm,
+  const El::mpi::Comm& c)
+{
+  start_allreduce(gradient, comm, c);
+  finish_allreduce(gradient, comm, c);
+}
+
+template <typename TensorDataType>
+size_t gradient_compressor<TensorDataType>::start_dense_allreduce(
+  LocalMatType& local,
+  lbann_comm& comm,
+  const El::mpi::Comm& c)
+{
+  El::Copy(local, m_dense);
+  comm.nb_allreduce(static_cast<El::AbstractMatrix<TensorDataType>&>(m_dense),
+                    c,
+                    m_dense_req);
+  El::Zero(local);
+  m_dense_in_progress = true;
+  return local.Height() * local.Width();
+}
+
+// ---------------------------------------------
+// top_k_compressor
+// ---------------------------------------------
+
+template <typename TensorDataType>
+top_k_compressor<TensorDataType>::top_k_compressor(double ratio,
+                                                   bool error_feedback)
+  : BaseType(error_feedback), m_ratio{ratio}
+{
+  if (m_ratio <= 0. || m_ratio > 1.) {
+    LBANN_ERROR("top-k gradient compression ratio must be in (0,1], "
+                "but got ",
+                m_ratio);
+  }
+}
+
+template <typename TensorDataType>
+size_t top_k_compressor<TensorDataType>::start_compress_and_reduce(
+  LocalMatType& local,
+  lbann_comm& comm,
+  const El::mpi::Comm& c)
+{
+  const El::Int height = local.Height();
+  const El::Int ldim = local.LDim();
+  const size_t n = height * local.Width();
+  m_indices.clear();
+  m_values.clear();
+  m_all_indices.clear();
+  m_all_values.clear();
+  if (n == 0) {
+    return 0;
+  }
+  const size_t k =
+    std::min(n, std::max<size_t>(1, std::ceil(m_ratio * n)));
+
+  // An (index, value) pair costs about two dense entries
+  if (2 * k >= n || n > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return this->start_dense_allreduce(local, comm, c);
+  }
+
+  // Select the k largest-magnitude local entries
+  TensorDataType* buf = local.Buffer();
+  auto const offset = [height, ldim](int i) {
+    return (i % height) + (i / height) * ldim;
+  };
+  m_indices.resize(n);
+  std::iota(m_indices.begin(), m_indices.end(), 0);
+  std::nth_element(m_indices.begin(),
+                   m_indices.begin() + k,
+                   m_indices.end(),
+                   [&](int a, int b) {
+                     return std::abs(buf[offset(a)]) > std::abs(buf[offset(b)]);
+                   });
+  m_indices.resize(k);
+
+  // Selected entries are transmitted; the rest stay in the residual
+  m_values.resize(k);
+  for (size_t j = 0; j < k; ++j) {
+    auto& entry = buf[offset(m_indices[j])];
+    m_values[j] = entry;
+    entry = TensorDataType(0);
+  }
+
+  // Start allgathering the sparse contributions
+  const int num_procs = El::mpi::Size(c);
+  m_all_indices.resize(k * num_procs);
+  m_all_values.resize(k * num_procs);
+  comm.nb_all_gather(m_indices.data(), k, m_all_indices.data(), k, c,
+                     m_indices_req);
+  comm.nb_all_gather(m_values.data(), k, m_all_values.data(), k, c,
+                     m_values_req);
+  return 2 * k;
+}
+
+template <typename TensorDataType>
+void top_k_compressor<TensorDataType>::finish_compress_and_reduce(
+  LocalMatType& local,
+  LocalMatType& reduced,
+  lbann_comm& comm,
+  const El::mpi::Comm& /*c*/)
+{
+  comm.wait(m_indices_req);
+  comm.wait(m_values_req);
+
+  // Sum the sparse contributions
+  const El::Int height = local.Height();
+  El::Zero(reduced);
+  TensorDataType* reduced_buf = reduced.Buffer();
+  const El::Int reduced_ldim = reduced.LDim();
+  for (size_t j = 0; j < m_all_indices.size(); ++j) {
+    const int i = m_all_indices[j];
+    reduced_buf[(i % height) + (i / height) * reduced_ldim] += m_all_values[j];
+  }
+}
+
+// ---------------------------------------------
+// power_sgd_compressor
+// ---------------------------------------------
+
+template <typename TensorDataType>
+power_sgd_compressor<TensorDataType>::power_sgd_compressor(El::Int rank,
+                                                           bool error_feedback)
+  : BaseType(error_feedback), m_rank{rank}
+{
+  if (m_rank < 1) {
+    LBANN_ERROR("PowerSGD rank must be positive, but got ", m_rank);
+  }
+}
+
+template <typename TensorDataType>
+size_t power_sgd_compressor<TensorDataType>::start_compress_and_reduce(
+  LocalMatType& local,
+  lbann_comm& comm,
+  const El::mpi::Comm& c)
+{
+  const El::Int height = local.Height();
+  const El::Int width = local.Width();
+  const El::Int rank = std::min({m_rank, height, width});
+  const size_t sent = (height + width) * rank;
+  if (height <= 1 || width <= 1 || sent >= static_cast<size_t>(height * width)) {
+    return this->start_dense_allreduce(local, comm, c);
+  }
+
+  // Every process starts from the same pseudo-random Q
+  if (m_Q.Height() != width || m_Q.Width() != rank) {
+    m_Q.Resize(width, rank);
+    std::mt19937 gen(width * rank);
+    std::normal_distribution<double> dist;
+    for (El::Int col = 0; col < rank; ++col) {
+      for (El::Int row = 0; row < width; ++row) {
+        m_Q(row, col) = TensorDataType(dist(gen));
+      }
+    }
+  }
+
+  // Start P = sum(M Q)
+  using AbsMatType = El::AbstractMatrix<TensorDataType>;
+  m_P.Resize(height, rank);
+  El::Gemm(El::NORMAL,
+           El::NORMAL,
+           TensorDataType(1),
+           local,
+           m_Q,
+           TensorDataType(0),
+           m_P);
+  comm.nb_allreduce(static_cast<AbsMatType&>(m_P), c, m_P_req);
+  return sent;
+}
+
+template <typename TensorDataType>
+void power_sgd_compressor<TensorDataType>::finish_compress_and_reduce(
+  LocalMatType& local,
+  LocalMatType& reduced,
+  lbann_comm& comm,
+  const El::mpi::Comm& c)
+{
+  // P = orth(sum(M Q))
+  using AbsMatType = El::AbstractMatrix<TensorDataType>;
+  comm.wait(m_P_req);
+  orthonormalize_columns(m_P);
+
+  // Q = sum(M^T P). The local component outside span(P) is not
+  // transmitted and stays in the residual: M -= P (M^T P)^T.
+  El::Gemm(El::TRANSPOSE,
+           El::NORMAL,
+           TensorDataType(1),
+           local,
+           m_P,
+           TensorDataType(0),
+           m_Q);
+  El::Gemm(El::NORMAL,
+           El::TRANSPOSE,
+           TensorDataType(-1),
+           m_P,
+           m_Q,
+           TensorDataType(1),
+           local);
+  comm.allreduce(static_cast<AbsMatType&>(m_Q), c);
+
+  // Sum is approximated by P Q^T
+  El::Gemm(El::NORMAL,
+           El::TRANSPOSE,
+           TensorDataType(1),
+           m_P,
+           m_Q,
+           TensorDataType(0),
+           reduced);
+}
+
+// ---------------------------------------------
+// Builder
+// ---------------------------------------------
+
+template <typename TensorDataType>
+std::unique_ptr<gradient_compressor<TensorDataType>>
+make_gradient_compressor(gradient_compression_params const& params)
+{
+  using method = gradient_compression_params::method;
+  if (params.type == method::NONE) {
+    return nullptr;
+  }
+  if constexpr (std::is_same<TensorDataType, float>::value ||
+                std::is_same<TensorDataType, double>::value) {
+    switch (params.type) {
+    case method::TOP_K:
+      return make_unique<top_k_compressor<TensorDataType>>(
+        params.top_k_ratio,
+        params.error_feedback);
+    case method::POWER_SGD:
+      return make_unique<power_sgd_compressor<TensorDataType>>(
+        params.power_sgd_rank,
+        params.error_feedback);
+    default:
+      LBANN_ERROR("unknown gradient compression method");
+    }
+  }
+  else {
+    LBANN_WARNING("gradient compression is only supported for float and "
+                  "double gradients; using a dense allreduce");
+  }
+  return nullptr;
+}
+
+#define PROTO(T)                                                               \
+  template class gradient_compressor<T>;                                       \
+  template class top_k_compressor<T>;                                          \
+  template class power_sgd_compressor<T>
+
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+
+#define PROTO(T)                                                               \
+  template std::unique_ptr<gradient_compressor<T>>                             \
+  make_gradient_compressor<T>(gradient_compression_params const&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+
+} // namespace lbann
@@ -90,13 +90,9 @@ description hypergradient_adam<TensorDataType>::get_description() const {
 template <typename TensorDataType>
 void hypergradient_adam<TensorDataType>::setup(WeightsType* w) {
   OptimizerType::setup(w);
-  const auto& gradient = this->get_gradient();
-  m_moment1.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
-  m_moment2.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
-  m_old_gradient.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
-  El::Zeros(*m_moment1, gradient.Height(), gradient.Width());
-  El::Zeros(*m_moment2, gradient.Height(), gradient.Width());
-  El::Zeros(*m_old_gradient, gradient.Height(), gradient.Width());
+  m_moment1 = this->make_state_matrix();
+  m_moment2 = this->make_state_matrix();
+  m_old_gradient = this->make_state_matrix();
 }
 
 template <typename TensorDataType>
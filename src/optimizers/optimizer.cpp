@@ -27,6 +27,7 @@
 #include "lbann/comm_impl.hpp"
 #include "lbann/optimizers/optimizer.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/summary_impl.hpp"
 #include "lbann/utils/timer.hpp"
 
 namespace lbann {
@@ -53,7 +54,10 @@ optimizer::optimizer(const optimizer& other)
   : m_comm(other.m_comm),
     m_gradient_sources(other.m_gradient_sources),
     m_gradient_status(other.m_gradient_status),
-    m_step_time(other.m_step_time) {
+    m_step_time(other.m_step_time),
+    m_gradient_compression(other.m_gradient_compression),
+    m_sharded_state(other.m_sharded_state),
+    m_skip_gradient_allreduce(other.m_skip_gradient_allreduce) {
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
     LBANN_ERROR("attempted to copy optimizer while a "
                 "gradient allreduce is in progress");
@@ -65,6 +69,9 @@ optimizer& optimizer::operator=(const optimizer& other) {
   m_gradient_sources = other.m_gradient_sources;
   m_gradient_status = other.m_gradient_status;
   m_step_time = other.m_step_time;
+  m_gradient_compression = other.m_gradient_compression;
+  m_sharded_state = other.m_sharded_state;
+  m_skip_gradient_allreduce = other.m_skip_gradient_allreduce;
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
     LBANN_ERROR("attempted to copy optimizer while a "
                 "gradient allreduce is in progress");
@@ -79,9 +86,38 @@ void optimizer::serialize(Archive & ar) {
 
 description optimizer::get_description() const {
   description desc(get_type() + " optimizer");
+  switch (m_gradient_compression.type) {
+  case gradient_compression_params::method::TOP_K:
+    desc.add("Gradient compression",
+             "top-k (ratio " + std::to_string(m_gradient_compression.top_k_ratio)
+             + ")");
+    break;
+  case gradient_compression_params::method::POWER_SGD:
+    desc.add("Gradient compression",
+             "PowerSGD (rank "
+             + std::to_string(m_gradient_compression.power_sgd_rank) + ")");
+    break;
+  default:
+    break;
+  }
   return desc;
 }
 
+void optimizer::summarize_stats(lbann_summary& summarizer,
+                                const std::string& prefix,
+                                int step) const {
+  for (auto const& g : gradients_) {
+    if (auto const* compressor = g.second->compressor()) {
+      summarizer.reduce_scalar(prefix + "/gradient_compression_ratio",
+                               compressor->get_compression_ratio(),
+                               step);
+      summarizer.reduce_scalar(prefix + "/gradient_residual_norm",
+                               compressor->get_residual_norm(),
+                               step);
+    }
+  }
+}
+
 El::Int optimizer::get_num_gradient_sources() const {
   return m_gradient_sources.size();
 }
@@ -95,7 +131,9 @@ void optimizer::add_gradient_source(const void* source) {
 void optimizer::remove_gradient_source(const void* source) {
   m_gradient_sources.erase(nullptr);
   m_gradient_sources.erase(source);
-  if (get_gradient_sources().empty()) {
+  // Sharded optimizers reduce-scatter the gradient in the
+  // optimization step instead
+  if (get_gradient_sources().empty() && !m_sharded_state) {
     start_gradient_allreduce();
   }
 }
@@ -80,9 +80,7 @@ auto sgd<TensorDataType>::get_velocity() -> AbsDistMatrixType& {
 template <typename TensorDataType>
 void sgd<TensorDataType>::setup(WeightsType* w) {
   OptimizerType::setup(w);
-  const auto& gradient = this->get_gradient();
-  m_velocity.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
-  El::Zeros(*m_velocity, gradient.Height(), gradient.Width());
+  m_velocity = this->make_state_matrix();
 }
 
 template <typename TensorDataType>
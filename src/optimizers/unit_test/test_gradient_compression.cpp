@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/comm_impl.hpp>
+#include <lbann/optimizers/gradient_compression.hpp>
+
+#include <cmath>
+#include <type_traits>
+
+TEST_CASE("Top-k gradient compression",
+          "[mpi][optimizer][gradient_compression]")
+{
+  using DataType = float;
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& world = comm.get_world_comm();
+  DataType const num_procs = El::mpi::Size(world);
+
+  // Every process contributes the same gradient, with distinct
+  // magnitudes 1,...,16
+  El::Matrix<DataType, El::Device::CPU> local(4, 4), gradient;
+  for (El::Int j = 0; j < 4; ++j) {
+    for (El::Int i = 0; i < 4; ++i) {
+      DataType const val = 1 + i + 4 * j;
+      local(i, j) = ((i + j) % 2 == 0 ? val : -val);
+    }
+  }
+  El::Copy(local, gradient);
+
+  lbann::top_k_compressor<DataType> compressor(0.25, true);
+  compressor.allreduce(gradient, comm, world);
+
+  // The four largest entries are summed, everything else is dropped
+  for (El::Int j = 0; j < 4; ++j) {
+    for (El::Int i = 0; i < 4; ++i) {
+      DataType const expected =
+        (std::abs(local(i, j)) > 12 ? num_procs * local(i, j) : 0);
+      CHECK(gradient(i, j) == Approx(expected));
+    }
+  }
+  CHECK(compressor.get_compression_ratio() == Approx(2.));
+
+  // Dropped entries are kept in the residual
+  double residual_sqnorm = 0;
+  for (int v = 1; v <= 12; ++v) {
+    residual_sqnorm += v * v;
+  }
+  CHECK(compressor.get_residual_norm() == Approx(std::sqrt(residual_sqnorm)));
+
+  SECTION("Residual is added to the next step")
+  {
+    El::Zero(gradient);
+    compressor.allreduce(gradient, comm, world);
+    for (El::Int j = 0; j < 4; ++j) {
+      for (El::Int i = 0; i < 4; ++i) {
+        auto const mag = std::abs(local(i, j));
+        DataType const expected =
+          (mag > 8 && mag <= 12 ? num_procs * local(i, j) : 0);
+        CHECK(gradient(i, j) == Approx(expected));
+      }
+    }
+  }
+}
+
+TEST_CASE("PowerSGD gradient compression",
+          "[mpi][optimizer][gradient_compression]")
+{
+  using DataType = double;
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& world = comm.get_world_comm();
+  DataType const num_procs = El::mpi::Size(world);
+
+  // Rank-1 gradient is recovered exactly by a rank-1 approximation
+  El::Int const height = 6, width = 5;
+  El::Matrix<DataType, El::Device::CPU> local(height, width), gradient;
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      local(i, j) = (i + 1) * (j - 2.5);
+    }
+  }
+  El::Copy(local, gradient);
+
+  lbann::power_sgd_compressor<DataType> compressor(1, true);
+  compressor.allreduce(gradient, comm, world);
+
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      CHECK(gradient(i, j) == Approx(num_procs * local(i, j)));
+    }
+  }
+  CHECK(compressor.get_compression_ratio() ==
+        Approx(double(height * width) / (height + width)));
+  CHECK(compressor.get_residual_norm() == Approx(0.).margin(1e-10));
+}
+
+TEMPLATE_TEST_CASE("Split-phase compressed allreduce",
+                   "[mpi][optimizer][gradient_compression]",
+                   lbann::top_k_compressor<float>,
+                   lbann::power_sgd_compressor<float>)
+{
+  using DataType = float;
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& world = comm.get_world_comm();
+  int const rank = El::mpi::Rank(world);
+
+  // Each process contributes a different gradient
+  El::Int const height = 8, width = 6;
+  El::Matrix<DataType, El::Device::CPU> local(height, width);
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      local(i, j) = std::sin(DataType(1 + i + height * j + 7 * rank));
+    }
+  }
+
+  auto make_compressor = []() {
+    if constexpr (std::is_same<TestType,
+                               lbann::top_k_compressor<DataType>>::value) {
+      return TestType(0.125, true);
+    }
+    else {
+      return TestType(2, true);
+    }
+  };
+  auto blocking = make_compressor();
+  auto split = make_compressor();
+
+  // Two steps, so that the residual is carried over
+  for (int step = 0; step < 2; ++step) {
+    El::Matrix<DataType, El::Device::CPU> expected, result;
+    El::Copy(local, expected);
+    El::Copy(local, result);
+    blocking.allreduce(expected, comm, world);
+    split.start_allreduce(result, comm, world);
+    split.finish_allreduce(result, comm, world);
+    for (El::Int j = 0; j < width; ++j) {
+      for (El::Int i = 0; i < height; ++i) {
+        CHECK(result(i, j) == Approx(expected(i, j)));
+      }
+    }
+    CHECK(split.get_compression_ratio() ==
+          Approx(blocking.get_compression_ratio()));
+    CHECK(split.get_residual_norm() == Approx(blocking.get_residual_norm()));
+  }
+
+  SECTION("Finishing without starting is an error")
+  {
+    El::Matrix<DataType, El::Device::CPU> gradient(height, width);
+    CHECK_THROWS(split.finish_allreduce(gradient, comm, world));
+  }
+}
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+
+#include <catch2/catch.hpp>
+
+#include "MPITestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/optimizers/adam.hpp>
+#include <lbann/optimizers/sgd.hpp>
+#include <lbann/utils/memory.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+
+#include <functional>
+
+namespace {
+
+using DataType = float;
+using StarMatType = El::DistMatrix<DataType, El::STAR, El::STAR,
+                                   El::ELEMENT, El::Device::CPU>;
+using OptimizerFactory = std::function<std::unique_ptr<lbann::optimizer>()>;
+
+El::Int const height = 7;
+El::Int const width = 3;
+int const num_steps = 4;
+
+/** @brief Train weights for a few steps and return their values.
+ *
+ *  Every rank contributes a different gradient, so the result depends
+ *  on the gradients being reduced over the trainer.
+ */
+El::Matrix<DataType, El::Device::CPU>
+train_weights(lbann::lbann_comm& comm,
+              OptimizerFactory const& make_optimizer,
+              bool sharded)
+{
+  auto const& g = comm.get_trainer_grid();
+  int const rank = comm.get_rank_in_trainer();
+
+  lbann::data_type_weights<DataType> w(comm);
+  w.set_name(sharded ? "sharded" : "replicated");
+  w.set_dims({static_cast<size_t>(height)}, {static_cast<size_t>(width)});
+  w.set_optimizer(make_optimizer());
+  w.get_optimizer()->set_sharded_state(sharded);
+  w.setup();
+
+  StarMatType values(height, width, g);
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      values.SetLocal(i, j, DataType(0.1) * (i - 2 * j));
+    }
+  }
+  w.set_values(values);
+
+  auto& opt = *w.get_optimizer();
+  StarMatType gradient(height, width, g);
+  for (int step = 0; step < num_steps; ++step) {
+    opt.clear_gradient();
+    for (El::Int j = 0; j < width; ++j) {
+      for (El::Int i = 0; i < height; ++i) {
+        gradient.SetLocal(i, j,
+                          DataType(0.01) * ((i + 1) * (rank + 1) - j * step));
+      }
+    }
+    opt.add_to_gradient(gradient, DataType(1), true);
+    opt.step();
+  }
+
+  El::Matrix<DataType, El::Device::CPU> result;
+  El::Copy(w.get_values().LockedMatrix(), result);
+  return result;
+}
+
+} // namespace <anon>
+
+TEST_CASE("Sharded optimizer state", "[mpi][optimizer][sharded]")
+{
+  auto& comm = unit_test::utilities::current_world_comm();
+
+  OptimizerFactory make_optimizer;
+  SECTION("SGD with momentum")
+  {
+    make_optimizer = [] {
+      return lbann::make_unique<lbann::sgd<DataType>>(0.1f, 0.9f, true);
+    };
+  }
+  SECTION("Adam")
+  {
+    make_optimizer = [] {
+      return lbann::make_unique<lbann::adam<DataType>>(0.01f);
+    };
+  }
+
+  auto const expected = train_weights(comm, make_optimizer, false);
+  auto const result = train_weights(comm, make_optimizer, true);
+  REQUIRE(result.Height() == height);
+  REQUIRE(result.Width() == width);
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      CHECK(result(i, j) == Approx(expected(i, j)));
+    }
+  }
+}
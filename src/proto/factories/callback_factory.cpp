@@ -45,8 +45,10 @@
 #include "lbann/callbacks/dump_weights.hpp"
 #include "lbann/callbacks/early_stopping.hpp"
 #include "lbann/callbacks/gpu_memory_usage.hpp"
+#include "lbann/callbacks/host_memory_usage.hpp"
 #include "lbann/callbacks/hang.hpp"
 #include "lbann/callbacks/imcomm.hpp"
+#include "lbann/callbacks/int8_calibration.hpp"
 #include "lbann/callbacks/learning_rate.hpp"
 #include "lbann/callbacks/ltfb.hpp"
 #include "lbann/callbacks/mixup.hpp"
@@ -58,6 +60,7 @@
 #include "lbann/callbacks/print_statistics.hpp"
 #include "lbann/callbacks/profiler.hpp"
 #include "lbann/callbacks/replace_weights.hpp"
+#include "lbann/callbacks/roofline.hpp"
 #include "lbann/callbacks/save_images.hpp"
 #include "lbann/callbacks/save_model.hpp"
 #include "lbann/callbacks/load_model.hpp"
@@ -145,8 +148,12 @@ void register_default_builders(factory_type& factory)
                            build_gpu_memory_usage_callback_from_pbuf);
   factory.register_builder("CallbackHang",
                            build_hang_callback_from_pbuf);
+  factory.register_builder("CallbackHostMemoryUsage",
+                           build_host_memory_usage_callback_from_pbuf);
   factory.register_builder("CallbackImComm",
                            build_imcomm_callback_from_pbuf);
+  factory.register_builder("CallbackInt8Calibration",
+                           build_int8_calibration_callback_from_pbuf);
   factory.register_builder(
     "CallbackLinearGrowthLearningRate",
     build_linear_growth_learning_rate_callback_from_pbuf);
@@ -175,6 +182,8 @@ void register_default_builders(factory_type& factory)
                            build_profiler_callback_from_pbuf);
   factory.register_builder("CallbackReplaceWeights",
                            build_replace_weights_callback_from_pbuf);
+  factory.register_builder("CallbackRoofline",
+                           build_roofline_callback_from_pbuf);
   factory.register_builder("CallbackSaveImages",
                            build_save_images_callback_from_pbuf);
   factory.register_builder("CallbackSaveModel",
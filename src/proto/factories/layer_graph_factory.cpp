@@ -213,6 +213,9 @@ std::vector<OwningLayerPtr> construct_layer_graph(
       #endif
       l->freeze();
     }
+    if (!proto_layer.checkpoint_segment().empty()) {
+      l->set_checkpoint_segment(proto_layer.checkpoint_segment());
+    }
     // Add layer to list
     layers.emplace_back(std::move(l));
 
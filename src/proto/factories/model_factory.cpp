@@ -294,6 +294,8 @@ std::unique_ptr<model> construct_model(
   if (!name.empty()) {
     m->set_name(name);
   }
+  m->set_auto_checkpoint_activations(
+    proto_model.auto_checkpoint_activations());
   return m;
 
 }
@@ -168,6 +168,41 @@ std::unique_ptr<weights> construct_weights(
     w->set_name(name);
   }
 
+  // Configure gradient compression
+  if (opt && proto_weights.has_gradient_compression()) {
+    const auto& params = proto_weights.gradient_compression();
+    gradient_compression_params compression;
+    compression.error_feedback = !params.disable_error_feedback();
+    switch (params.compression_type_case()) {
+    case lbann_data::GradientCompression::kTopK:
+      compression.type = gradient_compression_params::method::TOP_K;
+      if (params.top_k().ratio() > 0.) {
+        compression.top_k_ratio = params.top_k().ratio();
+      }
+      break;
+    case lbann_data::GradientCompression::kPowerSgd:
+      compression.type = gradient_compression_params::method::POWER_SGD;
+      if (params.power_sgd().rank() > 0) {
+        compression.power_sgd_rank = params.power_sgd().rank();
+      }
+      break;
+    default:
+      break;
+    }
+    opt->set_gradient_compression(compression);
+  }
+
+  // Configure sharded optimizer state
+  if (opt && proto_weights.sharded_optimizer_state()) {
+    if (proto_weights.has_gradient_compression()) {
+      err << "weights \"" << name << "\" requests both gradient "
+          << "compression and sharded optimizer state, "
+          << "which are incompatible";
+      LBANN_ERROR(err.str());
+    }
+    opt->set_sharded_state(true);
+  }
+
   // Set weights initializer and optimizer
   w->set_initializer(std::move(init));
   w->set_optimizer(std::move(opt));
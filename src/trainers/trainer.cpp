@@ -31,6 +31,8 @@
 #include "lbann/base.hpp"
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/data_coordinator/data_coordinator_metadata.hpp"
+#include "lbann/execution_algorithms/local_sgd.hpp"
+#include "lbann/execution_algorithms/pipeline_parallel.hpp"
 #include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
 #include "lbann/execution_algorithms/training_algorithm.hpp"
 #include "lbann/execution_contexts/sgd_execution_context.hpp"
@@ -145,6 +147,14 @@ trainer::check_and_build_execution_context(training_algorithm& alg,
       context =
         make_unique<sgd_execution_context>(mode, get_max_mini_batch_size());
     }
+    else if (dynamic_cast<observer_ptr<LocalSGD>>(&alg) != nullptr) {
+      context =
+        make_unique<local_sgd::ExecutionContext>(get_max_mini_batch_size());
+    }
+    else if (dynamic_cast<observer_ptr<PipelineParallel>>(&alg) != nullptr) {
+      context = make_unique<pipeline_parallel::ExecutionContext>(
+        get_max_mini_batch_size());
+    }
     else {
       LBANN_ERROR("Unknown execution algorithm type.");
     }
@@ -190,8 +200,7 @@ trainer::get_execution_context(execution_context_key_pair_t key)
   if (m_model_execution_context.count(key) == 0) {
     LBANN_ERROR("No execution context for this model / mode pair");
   }
-  return static_cast<sgd_execution_context&>(
-    *(m_model_execution_context[key].get()));
+  return *(m_model_execution_context[key].get());
 }
 
 void trainer::delete_execution_context(execution_context_key_pair_t key)
@@ -243,7 +252,12 @@ void trainer::train(observer_ptr<model> model,
   // checkpoint/restart mechanisms. This needs to be refactored to be
   // agnostic to the training algorithm. At this time, only SGD is
   // properly C/R-able.
-  if (m_training_alg->get_type() == "sgd") {
+  if (m_training_alg->get_type() == "sgd"
+      || m_training_alg->get_type() == "LocalSGD"
+      || m_training_alg->get_type() == "PipelineParallel"
+      || m_training_alg->get_type() == "BottleneckAnalysis"
+      || m_training_alg->get_type() == "ReplayBenchmark"
+      || m_training_alg->get_type() == "AsyncValidation") {
     auto key = check_and_build_execution_context(*m_training_alg,
                                                  model,
                                                  execution_mode::training);
@@ -325,6 +339,19 @@ bool trainer::load_from_checkpoint_shared(persist& p)
   return get_data_coordinator().load_from_checkpoint_shared(p);
 }
 
+execution_context& trainer::get_restart_context(model& m,
+                                                execution_context& c)
+{
+  // The training algorithm's context may wrap the model's context
+  // (e.g. local SGD), in which case the whole context is restored
+  auto key = std::make_pair(&m, c.get_execution_mode());
+  auto iter = m_model_execution_context.find(key);
+  if (iter != m_model_execution_context.end()) {
+    return *(iter->second);
+  }
+  return c;
+}
+
 bool trainer::load_from_checkpoint_shared(model& m, execution_context& c)
 {
   // Reload the RNG once the trainer and all of the  models are setup
@@ -342,7 +369,8 @@ bool trainer::load_from_checkpoint_shared(model& m, execution_context& c)
       if (current_mode == mode) {
         /// Restart has to be able to load the currently running execution
         /// context
-        c.load_from_checkpoint_shared(get_persist_obj());
+        get_restart_context(m, c).load_from_checkpoint_shared(
+          get_persist_obj());
       }
       else {
         key = check_and_build_execution_context(c, m, mode);
@@ -407,7 +435,8 @@ bool trainer::load_from_checkpoint_distributed(model& m, execution_context& c)
       if (current_mode == mode) {
         /// Restart has to be able to load the currently running  execution
         /// context
-        c.load_from_checkpoint_distributed(get_persist_obj());
+        get_restart_context(m, c).load_from_checkpoint_distributed(
+          get_persist_obj());
       }
       else {
         key = check_and_build_execution_context(c, m, mode);
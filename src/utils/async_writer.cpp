@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/utils/async_writer.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+
+#include <zstr.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+namespace lbann {
+
+async_writer::async_writer(size_t num_buffers)
+  : m_num_buffers{num_buffers},
+    m_free_buffers(num_buffers)
+{
+  if (m_num_buffers == 0) {
+    LBANN_ERROR("asynchronous writer needs at least one staging buffer");
+  }
+  m_thread = std::thread(&async_writer::run, this);
+}
+
+async_writer::~async_writer()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shutdown = true;
+  }
+  m_job_cv.notify_all();
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+  if (m_error) {
+    try {
+      std::rethrow_exception(m_error);
+    }
+    catch (std::exception const& e) {
+      std::cerr << "asynchronous write failed: " << e.what() << std::endl;
+    }
+    catch (...) {
+      std::cerr << "asynchronous write failed" << std::endl;
+    }
+  }
+}
+
+async_writer::buffer_type async_writer::acquire()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  check_error();
+  if (m_free_buffers.empty()) {
+    ++m_num_stalls;
+    m_done_cv.wait(lock, [this] {
+      return !m_free_buffers.empty() || m_error != nullptr;
+    });
+    check_error();
+  }
+  auto buffer = std::move(m_free_buffers.back());
+  m_free_buffers.pop_back();
+  return buffer;
+}
+
+void async_writer::submit(buffer_type buffer, write_function write)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back({std::move(buffer), std::move(write), true});
+    ++m_num_pending;
+  }
+  m_job_cv.notify_one();
+}
+
+void async_writer::submit(std::function<void()> func)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_jobs.push_back({buffer_type{},
+                      [func](buffer_type const&) { func(); },
+                      false});
+    ++m_num_pending;
+  }
+  m_job_cv.notify_one();
+}
+
+void async_writer::flush()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done_cv.wait(lock, [this] { return m_num_pending == 0; });
+  check_error();
+}
+
+size_t async_writer::get_num_stalls() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_num_stalls;
+}
+
+void async_writer::run()
+{
+  while (true) {
+    job j;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_job_cv.wait(lock, [this] { return m_shutdown || !m_jobs.empty(); });
+      if (m_jobs.empty()) {
+        return;
+      }
+      j = std::move(m_jobs.front());
+      m_jobs.pop_front();
+    }
+    std::exception_ptr error;
+    try {
+      j.write(j.buffer);
+    }
+    catch (...) {
+      error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (error && !m_error) {
+        m_error = error;
+      }
+      if (j.uses_buffer) {
+        m_free_buffers.push_back(std::move(j.buffer));
+      }
+      --m_num_pending;
+    }
+    m_done_cv.notify_all();
+  }
+}
+
+void async_writer::check_error()
+{
+  if (!m_error) {
+    return;
+  }
+  auto error = m_error;
+  m_error = nullptr;
+  try {
+    std::rethrow_exception(error);
+  }
+  catch (std::exception const& e) {
+    LBANN_ERROR("asynchronous write failed: ", e.what());
+  }
+}
+
+async_writer& get_async_writer()
+{
+  static async_writer writer(4);
+  return writer;
+}
+
+std::unique_ptr<std::ostream> open_output_file(std::string const& file_name,
+                                               bool compress)
+{
+  std::unique_ptr<std::ostream> fs;
+  if (compress) {
+    fs = make_unique<zstr::ofstream>(file_name + ".gz");
+  }
+  else {
+    auto file = make_unique<std::ofstream>(file_name, std::ios::binary);
+    if (!file->is_open()) {
+      LBANN_ERROR("failed to open output file (", file_name, ")");
+    }
+    fs = std::move(file);
+  }
+  if (!fs->good()) {
+    LBANN_ERROR("failed to open output file (", file_name, ")");
+  }
+  return fs;
+}
+
+void finish_output_file(std::ostream& fs, std::string const& file_name)
+{
+  fs.flush();
+  if (!fs.good()) {
+    LBANN_ERROR("failed to write output file (", file_name, ")");
+  }
+}
+
+} // namespace lbann
@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/int8_quantization.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#ifdef LBANN_HAS_ONEDNN_CPU
+#include <dnnl.hpp>
+#endif // LBANN_HAS_ONEDNN_CPU
+
+#include <algorithm>
+#include <cmath>
+
+namespace lbann {
+
+namespace {
+
+/** @brief Largest value of symmetric int8 quantization. */
+constexpr float int8_max = 127.f;
+
+inline std::int8_t quantize_entry(float x, float inv_scale) {
+  const auto q = std::nearbyint(x * inv_scale);
+  return static_cast<std::int8_t>(std::min(std::max(q, -int8_max), int8_max));
+}
+
+/** @brief Copy op(A) into a row-major @f$ m \times k @f$ buffer. */
+void pack_rows(El::Orientation orient,
+               El::Int m, El::Int k,
+               const std::int8_t* A, El::Int lda,
+               std::vector<std::int8_t>& packed) {
+  packed.resize(m * k);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int i = 0; i < m; ++i) {
+    for (El::Int l = 0; l < k; ++l) {
+      packed[i*k+l] = (orient == El::NORMAL
+                       ? A[i + l*lda]
+                       : A[l + i*lda]);
+    }
+  }
+}
+
+} // namespace <anon>
+
+template <typename TensorDataType>
+void quantize_int8_per_channel(const CPUMatDT<TensorDataType>& mat,
+                               bool column_channels,
+                               int8_quantized_matrix& result) {
+  const El::Int height = mat.Height();
+  const El::Int width = mat.Width();
+  const El::Int num_channels = column_channels ? width : height;
+  result.height = height;
+  result.width = width;
+  result.column_channels = column_channels;
+  result.values.resize(height * width);
+  result.scales.assign(num_channels, 0.f);
+
+  // Find largest magnitude in each channel
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      const auto x = std::fabs(static_cast<float>(mat(row, col)));
+      auto& s = result.scales[column_channels ? col : row];
+      s = std::max(s, x);
+    }
+  }
+  for (auto& s : result.scales) {
+    s = (s > 0.f ? s / int8_max : 1.f);
+  }
+
+  // Quantize entries
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      const auto& s = result.scales[column_channels ? col : row];
+      result.values[row + col*height]
+        = quantize_entry(static_cast<float>(mat(row, col)), 1.f / s);
+    }
+  }
+
+}
+
+template <typename TensorDataType>
+void quantize_int8(const CPUMatDT<TensorDataType>& mat,
+                   float scale,
+                   std::vector<std::int8_t>& result) {
+  const El::Int height = mat.Height();
+  const El::Int width = mat.Width();
+  const float inv_scale = (scale > 0.f ? 1.f / scale : 0.f);
+  result.resize(height * width);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      result[row + col*height]
+        = quantize_entry(static_cast<float>(mat(row, col)), inv_scale);
+    }
+  }
+}
+
+template <typename TensorDataType>
+float max_abs(const CPUMatDT<TensorDataType>& mat) {
+  const El::Int height = mat.Height();
+  const El::Int width = mat.Width();
+  float result = 0.f;
+  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(max:result))
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      result = std::max(result, std::fabs(static_cast<float>(mat(row, col))));
+    }
+  }
+  return result;
+}
+
+void int8_gemm(El::Orientation orient_a,
+               El::Orientation orient_b,
+               El::Int m, El::Int n, El::Int k,
+               const std::int8_t* A, El::Int lda,
+               const std::int8_t* B, El::Int ldb,
+               std::int32_t* C, El::Int ldc) {
+  if (m < 1 || n < 1) { return; }
+  if (k < 1) {
+    for (El::Int j = 0; j < n; ++j) {
+      std::fill(C + j*ldc, C + j*ldc + m, 0);
+    }
+    return;
+  }
+
+#ifdef LBANN_HAS_ONEDNN_CPU
+  // oneDNN GEMM is row-major, so compute C^T = op(B)^T op(A)^T
+  const std::int32_t zero_offset = 0;
+  auto status = dnnl::gemm_s8s8s32(
+    orient_b == El::NORMAL ? 'N' : 'T',
+    orient_a == El::NORMAL ? 'N' : 'T',
+    'F',
+    n, m, k,
+    1.f,
+    B, ldb, 0,
+    A, lda, 0,
+    0.f,
+    C, ldc,
+    &zero_offset);
+  if (status != dnnl::status::success) {
+    LBANN_ERROR("oneDNN int8 GEMM failed");
+  }
+#else
+  // Pack op(A) by rows and op(B) by columns so that each output
+  // entry is a contiguous int8 dot product
+  std::vector<std::int8_t> packed_a, packed_b;
+  pack_rows(orient_a, m, k, A, lda, packed_a);
+  pack_rows(orient_b == El::NORMAL ? El::TRANSPOSE : El::NORMAL,
+            n, k, B, ldb, packed_b);
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < n; ++j) {
+    for (El::Int i = 0; i < m; ++i) {
+      const std::int8_t* __restrict__ a = &packed_a[i*k];
+      const std::int8_t* __restrict__ b = &packed_b[j*k];
+      std::int32_t sum = 0;
+      for (El::Int l = 0; l < k; ++l) {
+        sum += static_cast<std::int32_t>(a[l]) * static_cast<std::int32_t>(b[l]);
+      }
+      C[i + j*ldc] = sum;
+    }
+  }
+#endif // LBANN_HAS_ONEDNN_CPU
+
+}
+
+#define PROTO(T)                                                \
+  template void quantize_int8_per_channel<T>(                   \
+    const CPUMatDT<T>&, bool, int8_quantized_matrix&);          \
+  template void quantize_int8<T>(                               \
+    const CPUMatDT<T>&, float, std::vector<std::int8_t>&);      \
+  template float max_abs<T>(const CPUMatDT<T>&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
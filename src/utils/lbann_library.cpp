@@ -27,8 +27,11 @@
 #include "lbann/comm.hpp"
 #include "lbann/comm_impl.hpp"
 #include "lbann/data_readers/data_reader.hpp"
+#include "lbann/io/weights_bundle.hpp"
 #include "lbann/models/directed_acyclic_graph.hpp"
+#include "lbann/models/inference_preparation.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/file_utils.hpp"
 #include "lbann/utils/lbann_library.hpp"
 
 #include "lbann/proto/factories.hpp"
@@ -105,6 +108,13 @@ void construct_std_options() {
                         "Size of the read buffer for the SMILES "
                         "data reader.",
                         16*1024*1024UL);
+  arg_parser.add_option(LAYER_CONCURRENCY,
+                        {"--layer_concurrency"},
+                        utils::ENV("LBANN_LAYER_CONCURRENCY"),
+                        "Maximum number of independent layers in a DAG "
+                        "model that are executed at the same time. "
+                        "A value of 1 executes layers sequentially.",
+                        1);
 }
 
 // Creates a datareader metadata to get around the need for an actual
@@ -124,13 +134,43 @@ load_inference_model(lbann_comm* lc,
                      std::string cp_dir,
                      int mbs,
                      std::vector<int> input_dims,
-                     std::vector<int> output_dims) {
+                     std::vector<int> output_dims,
+                     bool prepare) {
   persist p;
   p.open_restart(cp_dir.c_str());
   auto m = make_unique<directed_acyclic_graph_model>(lc, nullptr, nullptr);
-  m->load_from_checkpoint_shared(p);
+
+  // Replicated weights can view a weights bundle instead of keeping
+  // private copies, so ranks on a node share one copy of the values.
+  // Values in the bundle are not read from the checkpoint.
+  const auto bundle_file = file::join_path(cp_dir,
+                                           m->get_name(),
+                                           weights_bundle::file_name);
+  if (file::file_exists(bundle_file)) {
+    weights_bundle_restore_scope bundle_scope(*lc, bundle_file);
+    m->load_from_checkpoint_shared(p);
+    bundle_scope.restore(*m);
+  }
+  else {
+    m->load_from_checkpoint_shared(p);
+  }
   p.close_restart();
 
+  // Drop training-only layers and state before anything is allocated
+  if (prepare) {
+    const auto summary = prepare_for_inference(*m);
+    if (lc->am_world_master()) {
+      std::cout << "Prepared model \"" << m->get_name() << "\" "
+                << "for inference: "
+                << "folded " << summary.num_folded_layers << " "
+                << "batch normalization layers, "
+                << "removed " << summary.num_removed_layers << " layers, "
+                << summary.num_removed_weights << " weights and "
+                << summary.num_removed_optimizers << " optimizers"
+                << std::endl;
+    }
+  }
+
   // Must use a mock datareader with input and output dims for setup
   // TODO: avoid need for datareader altogether
   auto dr_metadata = mock_dr_metadata(input_dims, output_dims);
@@ -410,6 +450,14 @@ std::unique_ptr<model> build_model_from_prototext(
     ret_model->add_callback(c);
   }
 
+  // Configure concurrent execution of independent layers
+  auto& arg_parser = global_argument_parser();
+  auto* dag_model = dynamic_cast<directed_acyclic_graph_model*>(ret_model.get());
+  if (dag_model != nullptr) {
+    const int layer_concurrency = arg_parser.get<int>(LAYER_CONCURRENCY);
+    dag_model->set_max_layer_concurrency(std::max(layer_concurrency, 1));
+  }
+
   // If the checkpoint directory has been overridden reset it before
   // setting up the model
   if (opts && opts->has_string("ckpt_dir")) {
@@ -104,6 +104,8 @@ El::Grid const& get_default_grid_() noexcept
   El::Grid const& default_grid_ = El::Grid::Default();
   return default_grid_;
 }
+std::stack<bool> skip_values_stack_;
+
 }// namespace <anon>
 
 El::Grid const& get_current_grid() noexcept
@@ -123,5 +125,20 @@ grid_manager::~grid_manager()
   pop_grid_();
 }
 
+skip_matrix_values_manager::skip_matrix_values_manager(bool skip)
+{
+  skip_values_stack_.push(skip);
+}
+
+skip_matrix_values_manager::~skip_matrix_values_manager()
+{
+  skip_values_stack_.pop();
+}
+
+bool skipping_matrix_values() noexcept
+{
+  return !skip_values_stack_.empty() && skip_values_stack_.top();
+}
+
 }// namespace utils
 }// namespace lbann
@@ -28,6 +28,8 @@
 
 #include "lbann/utils/environment_variable.hpp"
 
+#include <fstream>
+#include <limits>
 #include <stdexcept>
 #include <string>
 
@@ -162,5 +164,30 @@ SystemInfo::env_variable_value(std::string const& var_name) const
   return ENV(var_name).raw_value();
 }
 
+size_t SystemInfo::resident_memory() const
+{
+  // Second field of statm is the number of resident pages
+  std::ifstream statm("/proc/self/statm");
+  size_t total_pages = 0, resident_pages = 0;
+  if (!(statm >> total_pages >> resident_pages))
+    return 0;
+  return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+size_t SystemInfo::peak_resident_memory() const
+{
+  // High-water mark is reported in kB, e.g. "VmHWM:  1234 kB"
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmHWM:") {
+      size_t kib = 0;
+      return (status >> kib) ? kib * 1024 : 0;
+    }
+    status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+  return 0;
+}
+
 }// namespace utils
 }// namespace lbann
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+
+#include "lbann/utils/async_writer.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("Asynchronous writer", "[utils][async_writer]")
+{
+  lbann::async_writer writer(2);
+  REQUIRE(writer.get_num_buffers() == 2);
+
+  SECTION("Writes run in submission order")
+  {
+    std::vector<int> written;
+    for (int i = 0; i < 10; ++i) {
+      auto buffer = writer.acquire();
+      buffer.assign(1, static_cast<unsigned char>(i));
+      writer.submit(std::move(buffer),
+                    [&written](lbann::async_writer::buffer_type const& b) {
+                      written.push_back(b.at(0));
+                    });
+    }
+    writer.submit([&written]() { written.push_back(-1); });
+    writer.flush();
+    REQUIRE(written.size() == 11);
+    for (int i = 0; i < 10; ++i) {
+      CHECK(written[i] == i);
+    }
+    CHECK(written.back() == -1);
+  }
+
+  SECTION("Buffers are returned to the pool")
+  {
+    auto buffer = writer.acquire();
+    buffer.resize(1024);
+    writer.submit(std::move(buffer),
+                  [](lbann::async_writer::buffer_type const&) {});
+    writer.flush();
+    auto first = writer.acquire();
+    auto second = writer.acquire();
+    CHECK((first.capacity() >= 1024 || second.capacity() >= 1024));
+    writer.submit(std::move(first),
+                  [](lbann::async_writer::buffer_type const&) {});
+    writer.submit(std::move(second),
+                  [](lbann::async_writer::buffer_type const&) {});
+    writer.flush();
+  }
+
+  SECTION("Write errors are reported")
+  {
+    writer.submit([]() { throw std::runtime_error("disk full"); });
+    CHECK_THROWS(writer.flush());
+    CHECK_NOTHROW(writer.flush());
+  }
+}
+
+TEST_CASE("Output file errors", "[utils][async_writer]")
+{
+  SECTION("Opening a file in a missing directory fails")
+  {
+    CHECK_THROWS(lbann::open_output_file(
+                   "/nonexistent_lbann_dir/output.bin", false));
+  }
+
+#ifdef __linux__
+  // Writes to /dev/full fail with ENOSPC
+  SECTION("Failed writes are reported")
+  {
+    auto fs = lbann::open_output_file("/dev/full", false);
+    const std::vector<char> data(1 << 16, 'x');
+    fs->write(data.data(), data.size());
+    CHECK_THROWS(lbann::finish_output_file(*fs, "/dev/full"));
+  }
+
+  SECTION("Failed asynchronous writes are reported")
+  {
+    lbann::async_writer writer(1);
+    auto buffer = writer.acquire();
+    buffer.resize(1 << 16);
+    writer.submit(std::move(buffer),
+                  [](lbann::async_writer::buffer_type const& b) {
+                    const std::string file_name = "/dev/full";
+                    auto fs = lbann::open_output_file(file_name, false);
+                    fs->write(reinterpret_cast<const char*>(b.data()),
+                              b.size());
+                    lbann::finish_output_file(*fs, file_name);
+                  });
+    CHECK_THROWS(writer.flush());
+  }
+#endif // __linux__
+}
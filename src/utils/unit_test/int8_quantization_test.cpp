@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2021, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+// MUST include this
+#include <catch2/catch.hpp>
+
+#include <lbann/base.hpp>
+#include <lbann/utils/int8_quantization.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace lbann;
+
+TEST_CASE("Int8 quantization", "[quantization][utilities]")
+{
+  El::Matrix<float, El::Device::CPU> mat(3, 2);
+  mat(0, 0) = 1.f;   mat(0, 1) = -0.5f;
+  mat(1, 0) = -2.f;  mat(1, 1) = 0.25f;
+  mat(2, 0) = 0.f;   mat(2, 1) = 4.f;
+
+  SECTION("Max magnitude")
+  {
+    CHECK(max_abs(mat) == 4.f);
+  }
+
+  SECTION("Single scaling factor")
+  {
+    std::vector<std::int8_t> q;
+    quantize_int8(mat, 4.f / 127.f, q);
+    REQUIRE(q.size() == 6);
+    CHECK(q[5] == 127);
+    CHECK(q[1] == -64);
+    CHECK(q[2] == 0);
+  }
+
+  SECTION("Per-channel scaling factors")
+  {
+    int8_quantized_matrix q;
+    quantize_int8_per_channel(mat, true, q);
+    REQUIRE(q.scales.size() == 2);
+    CHECK(q.scales[0] == Approx(2.f / 127.f));
+    CHECK(q.scales[1] == Approx(4.f / 127.f));
+    CHECK(q.values[1] == -127);
+    CHECK(q.values[5] == 127);
+    for (El::Int j = 0; j < mat.Width(); ++j) {
+      for (El::Int i = 0; i < mat.Height(); ++i) {
+        const float x = q.values[i + j*q.height] * q.scales[j];
+        CHECK(std::abs(x - mat(i, j)) <= q.scales[j] / 2 + 1e-6f);
+      }
+    }
+  }
+}
+
+TEST_CASE("Int8 matrix multiplication", "[quantization][utilities]")
+{
+  const El::Int m = 5, n = 4, k = 7;
+  std::vector<std::int8_t> A(m*k), B(k*n);
+  for (size_t i = 0; i < A.size(); ++i) {
+    A[i] = static_cast<std::int8_t>((7 * i) % 23) - 11;
+  }
+  for (size_t i = 0; i < B.size(); ++i) {
+    B[i] = static_cast<std::int8_t>((5 * i) % 19) - 9;
+  }
+
+  SECTION("Non-transposed operands")
+  {
+    std::vector<std::int32_t> C(m*n);
+    int8_gemm(El::NORMAL, El::NORMAL, m, n, k,
+              A.data(), m, B.data(), k, C.data(), m);
+    for (El::Int j = 0; j < n; ++j) {
+      for (El::Int i = 0; i < m; ++i) {
+        std::int32_t ref = 0;
+        for (El::Int l = 0; l < k; ++l) {
+          ref += std::int32_t(A[i+l*m]) * std::int32_t(B[l+j*k]);
+        }
+        CHECK(C[i+j*m] == ref);
+      }
+    }
+  }
+
+  SECTION("Transposed operands")
+  {
+    // Interpret A as k x m and B as n x k
+    std::vector<std::int32_t> C(m*n);
+    int8_gemm(El::TRANSPOSE, El::TRANSPOSE, m, n, k,
+              A.data(), k, B.data(), n, C.data(), m);
+    for (El::Int j = 0; j < n; ++j) {
+      for (El::Int i = 0; i < m; ++i) {
+        std::int32_t ref = 0;
+        for (El::Int l = 0; l < k; ++l) {
+          ref += std::int32_t(A[l+i*k]) * std::int32_t(B[j+l*n]);
+        }
+        CHECK(C[i+j*m] == ref);
+      }
+    }
+  }
+}
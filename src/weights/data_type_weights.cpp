@@ -30,6 +30,7 @@
 #include "lbann/weights/data_type_weights_impl.hpp"
 #include "lbann/optimizers/optimizer.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/hydrogen_utils.hpp"
 #include "lbann/io/file_io.hpp"
 
 #include <layers.pb.h>
@@ -95,6 +96,7 @@ auto data_type_weights<TensorDataType>::operator=(const WeightsType& other) -> W
 
   // Deep copies
   m_values.reset(other.m_values ? other.m_values->Copy() : nullptr);
+  m_values_storage.reset();
   m_initializer = (other.m_initializer
                    ? other.m_initializer->clone() : nullptr);
   m_optimizer = (other.m_optimizer
@@ -258,6 +260,11 @@ auto data_type_weights<TensorDataType>::get_values() const
   return *m_values;
 }
 
+template <typename TensorDataType>
+size_t data_type_weights<TensorDataType>::get_host_values_bytes() const {
+  return get_host_memory_bytes(m_values.get());
+}
+
 template <typename TensorDataType>
 void data_type_weights<TensorDataType>::set_values(const AbsDistMatrixType& values) {
   if ((values.Height() != get_values().Height())
@@ -341,6 +348,31 @@ void data_type_weights<TensorDataType>::set_value(TensorDataType value, size_t r
 
 }
 
+template <typename TensorDataType>
+bool data_type_weights<TensorDataType>::attach_values(
+  TensorDataType* buffer,
+  std::shared_ptr<const void> storage) {
+  if (m_values == nullptr) {
+    LBANN_ERROR("attempted to attach values to "
+                "weights \"" + this->get_name() + "\" "
+                "before they are setup");
+  }
+  const auto dist = m_values->DistData();
+  auto* values = dynamic_cast<El::ElementalMatrix<TensorDataType>*>(m_values.get());
+  if (values == nullptr
+      || dist.colDist != El::STAR
+      || dist.rowDist != El::STAR
+      || dist.device != El::Device::CPU) {
+    return false;
+  }
+  const auto height = values->Height();
+  const auto width = values->Width();
+  values->Attach(height, width, values->Grid(), 0, 0,
+                 buffer, std::max(height, El::Int(1)), values->Root());
+  m_values_storage = std::move(storage);
+  return true;
+}
+
 template <typename TensorDataType>
 void data_type_weights<TensorDataType>::reconcile_values() {
   auto& values = get_values();
@@ -441,6 +473,7 @@ void data_type_weights<TensorDataType>::do_move_values_(
   data_type_weights& other)
 {
   m_values = std::move(other.m_values);
+  m_values_storage = std::move(other.m_values_storage);
 }
 
 template <typename TensorDataType>
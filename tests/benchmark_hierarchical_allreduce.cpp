@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2019, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// benchmark_hierarchical_allreduce.cpp - Compare the flat and the
+// node-aware hierarchical CPU allreduce across message sizes, and a
+// blocking allreduce followed by computation with flat and
+// hierarchical non-blocking allreduces overlapped with the same
+// computation
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/lbann.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+using namespace lbann;
+
+namespace {
+
+/** @brief Average time per allreduce, synchronized across ranks. */
+template <typename AllreduceFunc>
+double time_allreduce(lbann_comm& comm,
+                      El::Matrix<float, El::Device::CPU>& buffer,
+                      int num_iters,
+                      AllreduceFunc&& allreduce)
+{
+  // Warm-up also builds any cached sub-communicators
+  allreduce(buffer);
+  comm.global_barrier();
+  const double start = get_time();
+  for (int i = 0; i < num_iters; ++i) {
+    allreduce(buffer);
+  }
+  const double local_time = (get_time() - start) / num_iters;
+  return comm.allreduce(local_time, comm.get_world_comm(), El::mpi::MAX);
+}
+
+/** @brief Local work to overlap with communication.
+ *
+ *  If @c req is provided, it is tested after each sweep, like a
+ *  training loop that polls for completed gradient allreduces, so
+ *  that multi-step non-blocking allreduces make progress.
+ */
+void compute(El::Matrix<float, El::Device::CPU>& work,
+             int num_sweeps,
+             lbann_comm const& comm,
+             Al::request* req = nullptr)
+{
+  for (int i = 0; i < num_sweeps; ++i) {
+    El::Scale(0.5f, work);
+    El::Shift(work, 1.f);
+    if (req != nullptr) {
+      comm.test(*req);
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  world_comm_ptr comm = initialize(argc, argv);
+
+  try {
+    // Usage: benchmark_hierarchical_allreduce [max_bytes] [num_iters]
+    //          [num_compute_sweeps]
+    const size_t max_bytes =
+      (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256ull << 20);
+    const int num_iters = (argc > 2 ? std::atoi(argv[2]) : 20);
+    const int num_sweeps = (argc > 3 ? std::atoi(argv[3]) : 4);
+    const auto& world = comm->get_world_comm();
+    const size_t default_threshold =
+      comm->get_hierarchical_allreduce_threshold();
+    comm->set_hierarchical_blocking_allreduce(false);
+
+    if (comm->am_world_master()) {
+      std::cout << "ranks: " << comm->get_procs_in_world()
+                << ", ranks per node: " << comm->get_procs_per_node()
+                << ", hierarchical threshold: " << default_threshold
+                << " bytes\n"
+                << std::setw(14) << "bytes" << std::setw(14) << "flat (us)"
+                << std::setw(14) << "hier (us)" << std::setw(14)
+                << "nb hier (us)" << std::setw(10) << "speedup"
+                << std::setw(14) << "comp (us)" << std::setw(14)
+                << "blk+comp (us)" << std::setw(16) << "nb flat+comp"
+                << std::setw(16) << "nb hier+comp" << std::endl;
+    }
+
+    for (size_t bytes = 4; bytes <= max_bytes; bytes *= 4) {
+      const El::Int count = bytes / sizeof(float);
+      El::Matrix<float, El::Device::CPU> buffer(count, 1);
+      El::Fill(buffer, 1.f);
+
+      const double flat_time =
+        time_allreduce(*comm, buffer, num_iters, [&](auto& m) {
+          comm->allreduce(m, world);
+        });
+      const double hier_time =
+        time_allreduce(*comm, buffer, num_iters, [&](auto& m) {
+          comm->hierarchical_allreduce(m, world);
+        });
+      const double nb_hier_time =
+        time_allreduce(*comm, buffer, num_iters, [&](auto& m) {
+          Al::request req;
+          comm->nb_hierarchical_allreduce(m, world, req);
+          comm->wait(req);
+        });
+
+      // Blocking flat allreduce followed by local work, versus
+      // non-blocking allreduces overlapped with it
+      El::Matrix<float, El::Device::CPU> work(count, 1);
+      El::Fill(work, 1.f);
+      const double compute_time =
+        time_allreduce(*comm, buffer, num_iters, [&](auto&) {
+          compute(work, num_sweeps, *comm);
+        });
+      const double blocking_time =
+        time_allreduce(*comm, buffer, num_iters, [&](auto& m) {
+          comm->allreduce(m, world);
+          compute(work, num_sweeps, *comm);
+        });
+      comm->set_hierarchical_allreduce_threshold(
+        std::numeric_limits<size_t>::max());
+      const double nb_flat_overlap_time =
+        time_allreduce(*comm, buffer, num_iters, [&](auto& m) {
+          Al::request req;
+          comm->nb_allreduce(m, world, req);
+          compute(work, num_sweeps, *comm, &req);
+          comm->wait(req);
+        });
+      comm->set_hierarchical_allreduce_threshold(default_threshold);
+      const double nb_hier_overlap_time =
+        time_allreduce(*comm, buffer, num_iters, [&](auto& m) {
+          Al::request req;
+          comm->nb_hierarchical_allreduce(m, world, req);
+          compute(work, num_sweeps, *comm, &req);
+          comm->wait(req);
+        });
+
+      if (comm->am_world_master()) {
+        std::cout << std::setw(14) << bytes << std::setw(14) << std::fixed
+                  << std::setprecision(1) << flat_time * 1e6 << std::setw(14)
+                  << hier_time * 1e6 << std::setw(14) << nb_hier_time * 1e6
+                  << std::setw(10) << std::setprecision(2)
+                  << flat_time / hier_time << std::setw(14)
+                  << std::setprecision(1) << compute_time * 1e6
+                  << std::setw(14) << blocking_time * 1e6 << std::setw(16)
+                  << nb_flat_overlap_time * 1e6 << std::setw(16)
+                  << nb_hier_overlap_time * 1e6 << std::endl;
+      }
+    }
+  }
+  catch (lbann_exception& e) {
+    e.print_report();
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}